@@ -0,0 +1,83 @@
+#ifndef GRASS_COST_H
+#define GRASS_COST_H
+
+#include <grass/gis.h>
+#include <grass/segment.h>
+
+/* cell waiting in the priority queue */
+struct Cost_point {
+    double min_cost; /* cumulative cost */
+    long age;        /* insertion order, breaks ties */
+    int row;
+    int col;
+};
+
+/* min heap of cells, sorted by cost, then by age */
+struct Cost_heap {
+    long next_point;
+    long heap_size;
+    long heap_alloced;
+    struct Cost_point **heap_index;
+    struct Cost_point *free_point;
+};
+
+/* records in the cost segment of a search start with this structure */
+struct Cost_cell {
+    double cost_out; /* cumulative costs */
+    double nearest;  /* nearest start point */
+};
+
+/* start point given by coordinates */
+struct Cost_start_pt {
+    int row;
+    int col;
+    int value;
+    struct Cost_start_pt *next;
+};
+
+struct Cost_rc {
+    int r;
+    int c;
+};
+
+struct Cost_search;
+
+/* cumulative cost of moving to neighbor rec[n] of cell rec[0]
+ * with cumulative cost min_cost, null if the move is not possible */
+typedef double Cost_move_fn(const struct Cost_search *, double min_cost,
+                            void **rec, int n);
+
+/* whether the search may continue from the cell record rec */
+typedef int Cost_passable_fn(const struct Cost_search *, const void *rec);
+
+/* Dijkstra search for cumulative cost surfaces */
+struct Cost_search {
+    SEGMENT *cost_seg;  /* cost records starting with struct Cost_cell */
+    SEGMENT *dir_seg;   /* FCELL movement directions, NULL for none */
+    SEGMENT *solve_seg; /* DCELL[2] solver values, NULL for none */
+    int nrows, ncols;
+    int n_neighbors;            /* 8, or 16 with the knight's move */
+    int dir_bin;                /* bitmask encoded directions */
+    double max_cost;            /* maximum cumulative cost, 0 for none */
+    long total_cells;           /* cells for progress, 0 for no progress */
+    Cost_move_fn *move_cost;    /* costs of moving to a neighbor */
+    Cost_passable_fn *passable; /* NULL if all cells are passable */
+    void *closure;              /* passed through to the callbacks */
+    int keep_reached;           /* list reached cells, for resetting */
+
+    struct Cost_heap heap;
+    unsigned char *visited;
+    int visited_len;
+    struct Cost_rc *stop_pnts;
+    int n_stop_pnts;
+    int stop_pnts_alloc;
+    int stop_hits;
+    char *rec_buf;
+    struct Cost_rc *reached; /* cells with a cumulative cost */
+    long n_reached;
+    long reached_alloc;
+};
+
+#include <grass/defs/cost.h>
+
+#endif /* GRASS_COST_H */
@@ -0,0 +1,25 @@
+#ifndef GRASS_COSTDEFS_H
+#define GRASS_COSTDEFS_H
+
+/* heap.c */
+void Cost_heap_init(struct Cost_heap *);
+void Cost_heap_free(struct Cost_heap *);
+struct Cost_point *Cost_heap_insert(struct Cost_heap *, double, int, int);
+struct Cost_point *Cost_heap_get_lowest(struct Cost_heap *);
+void Cost_heap_delete(struct Cost_heap *, struct Cost_point *);
+
+/* points.c */
+struct Cost_start_pt *Cost_parse_start_coords(char **, struct Cost_start_pt *,
+                                              const struct Cell_head *);
+int Cost_parse_stop_coords(struct Cost_search *, char **,
+                           const struct Cell_head *);
+void Cost_add_stop_point(struct Cost_search *, int, int);
+
+/* search.c */
+void Cost_init_search(struct Cost_search *, int, int, int);
+void Cost_add_start_point(struct Cost_search *, int, int, double, double);
+long Cost_run_search(struct Cost_search *);
+void Cost_reset_search(struct Cost_search *);
+void Cost_free_search(struct Cost_search *);
+
+#endif /* GRASS_COSTDEFS_H */
@@ -240,6 +240,8 @@ int G_check_compressor(int);
 int G_write_compressed(int, unsigned char *, int, int);
 int G_write_unompressed(int, unsigned char *, int);
 int G_read_compressed(int, int, unsigned char *, int, int);
+int G_expand_compressed(unsigned char *, int, unsigned char *, int, int);
+int G_compress_chunk(unsigned char *, int, unsigned char *, int, int);
 int G_compress_bound(int, int);
 int G_compress(unsigned char *, int, unsigned char *, int, int);
 int G_expand(unsigned char *, int, unsigned char *, int, int);
@@ -898,6 +900,7 @@ void G__init_window(void);
 void G_begin_execute(void (*func)(void *), void *, void **, int);
 void G_end_execute(void **);
 void G_init_workers(void);
+int G_num_workers(void);
 void G_finish_workers(void);
 
 /* wr_cellhd.c */
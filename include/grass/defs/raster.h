@@ -35,6 +35,7 @@ char *Rast_allocate_null_output_buf(void);
 
 /* auto_mask.c */
 int Rast__check_for_auto_masking(void);
+int Rast__open_mask_reader(void);
 void Rast_suppress_masking(void);
 void Rast_unsuppress_masking(void);
 
@@ -85,6 +86,7 @@ int Rast_sort_cats(struct Categories *);
 /* cell_stats.c */
 void Rast_init_cell_stats(struct Cell_stats *);
 int Rast_update_cell_stats(const CELL *, int, struct Cell_stats *);
+void Rast_merge_cell_stats(struct Cell_stats *, const struct Cell_stats *);
 int Rast_find_cell_stat(CELL, long *, const struct Cell_stats *);
 int Rast_rewind_cell_stats(struct Cell_stats *);
 int Rast_next_cell_stat(CELL *, long *, struct Cell_stats *);
@@ -329,8 +331,12 @@ void Rast_get_row(int, void *, int, RASTER_MAP_TYPE);
 void Rast_get_c_row(int, CELL *, int);
 void Rast_get_f_row(int, FCELL *, int);
 void Rast_get_d_row(int, DCELL *, int);
+void Rast_get_tile(int, void *, int, int, int, int, RASTER_MAP_TYPE);
+void Rast_get_rows(int, void *, int, int, RASTER_MAP_TYPE);
 void Rast_get_null_value_row(int, char *, int);
 int Rast__read_null_bits(int, int, unsigned char *);
+int Rast__expand_row(unsigned char *, size_t, unsigned char *, int *,
+                     RASTER_MAP_TYPE, int, int, int);
 
 /* get_row_colr.c */
 void Rast_get_row_colors(int, int, struct Colors *, unsigned char *,
@@ -405,10 +411,17 @@ bool Rast_mask_status(char *, char *, bool *, char[GNAME_MAX],
 int Rast__mask_info(char *, char *);
 bool Rast_mask_is_present(void);
 int Rast_disable_omp_on_mask(int);
+int Rast_set_mask_threads(int);
 
 /* maskfd.c */
 int Rast_maskfd(void);
 
+/* mmap.c */
+const unsigned char *Rast__get_mapped_row(int, int, unsigned char *, int *);
+int Rast__read_mapped_null_bits(int, int, unsigned char *);
+void Rast__free_mmap(int);
+int Rast_set_mmap(int, int);
+
 /* null_val.c */
 #define Rast_is_c_null_value(cellVal) \
     (*(const CELL *)(cellVal) == (CELL)0x80000000)
@@ -445,6 +458,8 @@ void Rast__init_null_bits(unsigned char *, int);
 /* open.c */
 int Rast_open_old(const char *, const char *);
 int Rast__open_old(const char *, const char *);
+int Rast_open_old_dup(int);
+int Rast__open_old_dup(int);
 int Rast_open_c_new(const char *);
 int Rast_open_c_new_uncompressed(const char *);
 void Rast_want_histogram(int);
@@ -471,6 +486,7 @@ void Rast_put_c_row(int, const CELL *);
 void Rast_put_f_row(int, const FCELL *);
 void Rast_put_d_row(int, const DCELL *);
 void Rast__write_null_bits(int, const unsigned char *);
+int Rast_set_write_behind(int, int);
 
 /* put_title.c */
 int Rast_put_cell_title(const char *, const char *);
@@ -527,6 +543,8 @@ void Rast_row_update_range(const CELL *, int, struct Range *);
 void Rast__row_update_range(const CELL *, int, struct Range *, int);
 void Rast_row_update_fp_range(const void *, int, struct FPRange *,
                               RASTER_MAP_TYPE);
+void Rast_merge_range(struct Range *, const struct Range *);
+void Rast_merge_fp_range(struct FPRange *, const struct FPRange *);
 void Rast_init_range(struct Range *);
 void Rast_get_range_min_max(const struct Range *, CELL *, CELL *);
 void Rast_init_fp_range(struct FPRange *);
@@ -558,6 +576,11 @@ bool Rast_legal_semantic_label(const char *);
 /* rast_to_img_string.c */
 int Rast_map_to_img_str(char *, int, unsigned char *);
 
+/* read_ahead.c */
+int Rast_set_read_ahead(int, int);
+void Rast__read_ahead_row(int, int, unsigned char *, int *);
+void Rast__free_read_ahead(int);
+
 /* reclass.c */
 int Rast_is_reclass(const char *, const char *, char[GNAME_MAX],
                     char[GMAPSET_MAX]);
@@ -566,6 +589,13 @@ int Rast_get_reclass(const char *, const char *, struct Reclass *);
 void Rast_free_reclass(struct Reclass *);
 int Rast_put_reclass(const char *, const struct Reclass *);
 
+/* row_cache.c */
+int Rast__read_cached_row(int, int, unsigned char *, int *);
+void Rast__write_cached_row(int, int, const unsigned char *, int);
+void Rast__free_row_cache(int);
+char *Rast__row_cache_dir(const char *);
+int Rast_set_row_cache(int, int);
+
 /* sample.c */
 DCELL Rast_get_sample_nearest(int, const struct Cell_head *,
                               struct Categories *, double, double, int);
@@ -605,8 +635,22 @@ double Rast_col_to_easting(double, const struct Cell_head *);
 
 /* window_map.c */
 void Rast__create_window_mapping(int);
+void Rast__free_window_mapping(int);
 int Rast_row_repeat_nomask(int, int);
 
+/* write_behind.c */
+struct R_write_behind *
+Rast__create_write_behind(int, int, int,
+                          void (*)(struct R_write_behind_slot *), int);
+struct R_write_behind_slot *
+Rast__get_write_behind_slot(int, struct R_write_behind *);
+void Rast__write_behind_stats(struct R_write_behind_slot *, const void *, int,
+                              RASTER_MAP_TYPE, int, int);
+void Rast__queue_write_behind(struct R_write_behind *,
+                              struct R_write_behind_slot *, int, int);
+void Rast__flush_write_behind(int);
+void Rast__free_write_behind(int);
+
 /* zero_cell.c */
 void Rast_zero_buf(void *, RASTER_MAP_TYPE);
 void Rast_zero_input_buf(void *, RASTER_MAP_TYPE);
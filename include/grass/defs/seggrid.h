@@ -0,0 +1,23 @@
+#ifndef GRASS_SEGGRIDDEFS_H
+#define GRASS_SEGGRIDDEFS_H
+
+/* open.c */
+int Seggrid_open(SEGGRID *, int, int, int, int);
+int Seggrid_open_records(SEGGRID *, off_t, off_t, int, int, int, int);
+int Seggrid_close(SEGGRID *);
+int Seggrid_set_concurrent(SEGGRID *, int);
+
+/* get.c */
+int Seggrid_get(SEGGRID *, void *, off_t, off_t);
+int Seggrid_get_row(SEGGRID *, void *, off_t);
+
+/* put.c */
+int Seggrid_put(SEGGRID *, const void *, off_t, off_t);
+int Seggrid_put_row(SEGGRID *, const void *, off_t);
+int Seggrid_flush(SEGGRID *);
+
+/* raster.c */
+int Seggrid_read_raster(SEGGRID *, const char *, const char *);
+int Seggrid_write_raster(SEGGRID *, const char *);
+
+#endif /* GRASS_SEGGRIDDEFS_H */
@@ -9,8 +9,11 @@ int Segment_format_nofill(int, off_t, off_t, int, int, int);
 int Segment_get(SEGMENT *, void *, off_t, off_t);
 int Segment_get_row(const SEGMENT *, void *, off_t);
 int Segment_init(SEGMENT *, int, int);
+int Segment_prefetch(SEGMENT *, off_t, off_t, int);
 int Segment_put(SEGMENT *, const void *, off_t, off_t);
 int Segment_put_row(const SEGMENT *, const void *, off_t);
 int Segment_release(SEGMENT *);
+int Segment_set_concurrent(SEGMENT *, int);
+int Segment_set_policy(SEGMENT *, int);
 
 #endif /* GRASS_SEGMENTDEFS_H */
@@ -50,7 +50,40 @@ extern stat_func_w w_var;
 extern stat_func_w w_skew;
 extern stat_func_w w_kurt;
 
+/* for values sorted in ascending order without NULL values */
+extern stat_func s_divr;
+extern stat_func s_median;
+extern stat_func s_mode;
+extern stat_func s_quart1;
+extern stat_func s_quart3;
+extern stat_func s_perc90;
+extern stat_func s_quant;
+
+extern int compact_cell(DCELL *, int);
 extern int sort_cell(DCELL *, int);
+extern void select_cell(DCELL *, int, int);
 extern int sort_cell_w(DCELL (*)[2], int);
 
+extern void stat_window_init(struct stat_window *, int);
+extern void stat_window_clear(struct stat_window *);
+extern void stat_window_insert(struct stat_window *, DCELL);
+extern void stat_window_update(struct stat_window *, DCELL, DCELL);
+extern void stat_window_free(struct stat_window *);
+
+extern void cell_table_init(struct cell_table *, int, int);
+extern int cell_table_add(struct cell_table *, const CELL *, DCELL);
+extern void cell_table_add_value(struct cell_table *, int, DCELL);
+extern void cell_table_merge(struct cell_table *, const struct cell_table *);
+extern int cell_table_compare_keys(const struct cell_table *, int, int);
+extern int *cell_table_sort(const struct cell_table *,
+                            int (*)(const struct cell_table *, int, int));
+extern void cell_table_free(struct cell_table *);
+
+extern void quantile_sketch_init(struct quantile_sketch *, double);
+extern void quantile_sketch_add(struct quantile_sketch *, DCELL);
+extern void quantile_sketch_merge(struct quantile_sketch *,
+                                  const struct quantile_sketch *);
+extern DCELL quantile_sketch_value(struct quantile_sketch *, grass_int64);
+extern void quantile_sketch_free(struct quantile_sketch *);
+
 #endif
@@ -234,6 +234,8 @@ struct FP_stats {
 
 struct GDAL_link;
 struct R_vrt;
+struct R_write_behind;
+struct R_write_behind_slot;
 
 /*** prototypes ***/
 #include <grass/defs/raster.h>
@@ -0,0 +1,24 @@
+#ifndef GRASS_SEGGRID_H
+#define GRASS_SEGGRID_H
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/segment.h>
+
+/* cell types of a grid besides CELL_TYPE, FCELL_TYPE and DCELL_TYPE */
+#define SEGGRID_BYTE   -1 /* one byte per cell, read and written as CELL */
+#define SEGGRID_RECORD -2 /* records defined by the module, no raster I/O */
+
+/* grid of cells in a segment file, or in memory if it fits */
+typedef struct {
+    SEGMENT seg;    /* segment structure */
+    int type;       /* cell type */
+    int block_rows; /* rows read ahead or written behind, segment height */
+    char *filename; /* name of segment file */
+    char *name;     /* raster map read into the grid */
+    char *mapset;
+} SEGGRID;
+
+#include <grass/defs/seggrid.h>
+
+#endif /* GRASS_SEGGRID_H */
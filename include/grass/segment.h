@@ -11,6 +11,13 @@
 #include <sys/types.h>
 #endif
 
+struct seg_shard; /* page table of segments in memory */
+
+/* eviction policies, see Segment_set_policy() */
+#define SEGMENT_LRU       0 /* least recently used segment */
+#define SEGMENT_CLOCK     1 /* second chance */
+#define SEGMENT_WAVEFRONT 2 /* segment farthest from the last prefetch */
+
 struct aq {                     /* age queue */
     int cur;                    /* segment number */
     struct aq *younger, *older; /* pointer to next younger and next older */
@@ -48,17 +55,15 @@ typedef struct SEGMENT {
         struct aq *age; /* pointer to position in age queue */
         int n;          /* segment number */
     } *scb;
-    int *load_idx;       /* index of loaded segments */
-    int nfreeslots;      /* number of free slots */
-    int *freeslot;       /* array of free slots */
-    struct aq *agequeue, /* queue of age for order of access */
-        *youngest,       /* youngest in age queue */
-        *oldest;         /* oldest in age queue */
-    int nseg;            /* number of segments in memory */
-    int cur;             /* last accessed segment */
-    int offset;          /* offset of data past header */
+    int *load_idx; /* index of loaded segments */
+    int nseg;      /* number of segments in memory */
+    int offset;    /* offset of data past header */
 
     char *cache; /* all in memory cache */
+
+    struct seg_shard *shards; /* page tables of segments in memory */
+    int nshards;              /* number of page tables */
+    int concurrent;           /* page tables are locked */
 } SEGMENT;
 
 #include <grass/defs/segment.h>
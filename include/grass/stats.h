@@ -4,6 +4,42 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
 
+/* values of a moving window in ascending order, see stat_window_update() */
+struct stat_window {
+    DCELL *values; /* non-NULL values, sorted */
+    int n;         /* number of values */
+    int size;      /* allocated number of values */
+};
+
+/* cells per combination of CELL values, see cell_table_add() */
+struct cell_table {
+    int nkeys;                     /* number of values of a combination */
+    int nmoments;                  /* number of sums of powers of values */
+    int n;                         /* number of combinations */
+    int max;                       /* allocated number of combinations */
+    unsigned int mask;             /* number of slots minus 1 */
+    struct cell_table_slot *slots; /* hash slots, see cell_table.c */
+    CELL *keys;                    /* nkeys values per combination */
+    long *counts;                  /* number of cells per combination */
+    DCELL *areas;                  /* sum of cell areas per combination */
+    DCELL *sums;                   /* nmoments sums per combination */
+};
+
+/* mergeable summary of values for quantiles, see quantile_sketch_add() */
+struct quantile_sketch {
+    int k;              /* number of values of the top level */
+    int nlevels;        /* number of levels */
+    int *n;             /* number of values per level */
+    int *size;          /* allocated number of values per level */
+    DCELL **values;     /* values per level, weighing 2^level each */
+    grass_int64 count;  /* number of values added */
+    int retained;       /* number of values of all levels */
+    int capacity;       /* number of values that triggers a compaction */
+    unsigned int seed;  /* state of the choice of the values kept */
+    int nsorted;        /* number of sorted values, -1 if outdated */
+    DCELL (*sorted)[2]; /* values and accumulated weights, ascending */
+};
+
 #include <grass/defs/stats.h>
 
 #endif
@@ -0,0 +1,226 @@
+/*!
+   \file lib/cost/heap.c
+
+   \brief Cost library - min heap of grid cells
+
+   The cells are sorted first by cumulative cost, then by the order in
+   which they were added.
+
+   (C) 2006-2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author min heap by Markus Metz (from r.cost)
+ */
+
+#include <stdlib.h>
+#include <grass/gis.h>
+#include <grass/cost.h>
+
+#define GET_PARENT(c) (((c) - 2) / 3 + 1)
+#define GET_CHILD(p)  (((p) * 3) - 1)
+
+/*!
+   \brief Initialize an empty heap
+
+   \param heap pointer to heap structure
+ */
+void Cost_heap_init(struct Cost_heap *heap)
+{
+    heap->next_point = 0;
+    heap->heap_size = 0;
+    heap->heap_alloced = 1000;
+    heap->heap_index = (struct Cost_point **)G_malloc(
+        heap->heap_alloced * sizeof(struct Cost_point *));
+
+    heap->free_point = NULL;
+}
+
+/*!
+   \brief Free the memory allocated by a heap
+
+   Points still in the heap must be released by the caller.
+
+   \param heap pointer to heap structure
+ */
+void Cost_heap_free(struct Cost_heap *heap)
+{
+    if (heap->heap_alloced)
+        G_free(heap->heap_index);
+
+    if (heap->free_point)
+        G_free(heap->free_point);
+
+    heap->heap_index = NULL;
+    heap->free_point = NULL;
+    heap->heap_alloced = heap->heap_size = 0;
+}
+
+/* compare two costs
+ * return 1 if a < b else 0 */
+static int cmp_costs(struct Cost_point *a, struct Cost_point *b)
+{
+    if (a->min_cost < b->min_cost)
+        return 1;
+    else if (a->min_cost == b->min_cost) {
+        if (a->age < b->age)
+            return 1;
+    }
+
+    return 0;
+}
+
+static long sift_up(struct Cost_point **heap_index, long start,
+                    struct Cost_point *child_pnt)
+{
+    register long parent, child;
+
+    child = start;
+
+    while (child > 1) {
+        parent = GET_PARENT(child);
+
+        /* child is smaller */
+        if (cmp_costs(child_pnt, heap_index[parent])) {
+            /* push parent point down */
+            heap_index[child] = heap_index[parent];
+            child = parent;
+        }
+        else
+            /* no more sifting up, found new slot for child */
+            break;
+    }
+
+    /* put point in new slot */
+    if (child < start) {
+        heap_index[child] = child_pnt;
+    }
+
+    return child;
+}
+
+/*!
+   \brief Insert a cell into the heap
+
+   \param heap pointer to heap structure
+   \param min_cost cumulative cost of the cell
+   \param row,col cell position
+
+   \return pointer to the new heap point
+ */
+struct Cost_point *Cost_heap_insert(struct Cost_heap *heap, double min_cost,
+                                    int row, int col)
+{
+    struct Cost_point *new_cell;
+
+    if (heap->free_point) {
+        new_cell = heap->free_point;
+        heap->free_point = NULL;
+    }
+    else
+        new_cell = (struct Cost_point *)(G_malloc(sizeof(struct Cost_point)));
+
+    new_cell->min_cost = min_cost;
+    new_cell->age = heap->next_point;
+    new_cell->row = row;
+    new_cell->col = col;
+
+    heap->next_point++;
+    heap->heap_size++;
+    if (heap->heap_size >= heap->heap_alloced) {
+        heap->heap_alloced += 1000;
+        heap->heap_index = (struct Cost_point **)G_realloc(
+            (void *)heap->heap_index,
+            heap->heap_alloced * sizeof(struct Cost_point *));
+    }
+
+    heap->heap_index[heap->heap_size] = new_cell;
+    sift_up(heap->heap_index, heap->heap_size, new_cell);
+
+    return (new_cell);
+}
+
+/*!
+   \brief Remove the cell with the lowest cost from the heap
+
+   The returned point must be released with Cost_heap_delete().
+
+   \param heap pointer to heap structure
+
+   \return pointer to the heap point
+   \return NULL if the heap is empty
+ */
+struct Cost_point *Cost_heap_get_lowest(struct Cost_heap *heap)
+{
+    struct Cost_point **heap_index = heap->heap_index;
+    struct Cost_point *next_cell;
+    register long parent, child, childr, i;
+    long heap_size = heap->heap_size;
+
+    if (heap_size == 0)
+        return NULL;
+
+    next_cell = heap_index[1];
+    heap_index[0] = next_cell;
+
+    if (heap_size == 1) {
+        heap->heap_size--;
+
+        heap_index[1] = NULL;
+
+        return next_cell;
+    }
+
+    /* start with root */
+    parent = 1;
+
+    /* sift down: move hole back towards bottom of heap */
+
+    while ((child = GET_CHILD(parent)) <= heap_size) {
+        /* select smallest child */
+        if (child < heap_size) {
+            childr = child + 1;
+            i = child + 3;
+            while (childr < i && childr <= heap_size) {
+                /* get smallest child */
+                if (cmp_costs(heap_index[childr], heap_index[child])) {
+                    child = childr;
+                }
+                childr++;
+            }
+        }
+
+        /* move hole down */
+        heap_index[parent] = heap_index[child];
+        parent = child;
+    }
+
+    /* hole is in lowest layer, move to heap end */
+    if (parent < heap_size) {
+        heap_index[parent] = heap_index[heap_size];
+
+        /* sift up last swapped point, only necessary if hole moved to heap end
+         */
+        sift_up(heap_index, parent, heap_index[parent]);
+    }
+
+    /* the actual drop */
+    heap->heap_size--;
+
+    return next_cell;
+}
+
+/*!
+   \brief Release a point returned by Cost_heap_get_lowest()
+
+   \param heap pointer to heap structure
+   \param delete_cell point to release
+ */
+void Cost_heap_delete(struct Cost_heap *heap, struct Cost_point *delete_cell)
+{
+    if (heap->free_point)
+        G_free(delete_cell);
+    else
+        heap->free_point = delete_cell;
+}
@@ -0,0 +1,12 @@
+#ifndef Cost_LOCAL_H
+#define Cost_LOCAL_H
+
+#include <grass/cost.h>
+
+/* internal functions */
+
+/* points.c */
+void Cost__prune_stop_points(struct Cost_search *);
+int Cost__time_to_stop(struct Cost_search *, int, int);
+
+#endif /* Cost_LOCAL_H */
@@ -0,0 +1,205 @@
+/*!
+   \file lib/cost/points.c
+
+   \brief Cost library - start and stop points
+
+   (C) 2006-2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Eric G. Miller, Markus Metz (from r.cost)
+ */
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+static int cmp_rc(const struct Cost_rc *a, const struct Cost_rc *b)
+{
+    if (a->r == b->r)
+        return (a->c - b->c);
+
+    return (a->r - b->r);
+}
+
+/*!
+   \brief Parse start point coordinates
+
+   Coordinates are given as pairs of easting and northing, points
+   outside the window are skipped with a warning. The points are
+   numbered from 1 in the order in which they are given and added to
+   the front of the list.
+
+   \param answers option answers with easting, northing pairs
+   \param top_start_pt list to add points to, NULL for a new list
+   \param window current region
+
+   \return pointer to the head of the list
+ */
+struct Cost_start_pt *
+Cost_parse_start_coords(char **answers, struct Cost_start_pt *top_start_pt,
+                        const struct Cell_head *window)
+{
+    int col, row;
+    double east, north;
+    struct Cost_start_pt *new_start_pt;
+    int point_no = 0;
+
+    if (!answers)
+        return (0);
+
+    for (; *answers != NULL; answers += 2) {
+        if (!G_scan_easting(*answers, &east, G_projection()))
+            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
+        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
+            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
+
+        if (east < window->west || east > window->east ||
+            north < window->south || north > window->north) {
+            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
+                      north);
+            continue;
+        }
+
+        row = (window->north - north) / window->ns_res;
+        col = (east - window->west) / window->ew_res;
+
+        new_start_pt = G_malloc(sizeof(struct Cost_start_pt));
+
+        new_start_pt->row = row;
+        new_start_pt->col = col;
+        new_start_pt->value = ++point_no;
+        new_start_pt->next = top_start_pt;
+        top_start_pt = new_start_pt;
+    }
+
+    return top_start_pt;
+}
+
+/*!
+   \brief Parse stop point coordinates
+
+   Coordinates are given as pairs of easting and northing, points
+   outside the window are skipped with a warning.
+
+   \param cs pointer to search structure
+   \param answers option answers with easting, northing pairs
+   \param window current region
+
+   \return 1 if the search has stop points
+   \return 0 otherwise
+ */
+int Cost_parse_stop_coords(struct Cost_search *cs, char **answers,
+                           const struct Cell_head *window)
+{
+    int col, row;
+    double east, north;
+
+    if (!answers)
+        return 0;
+
+    for (; *answers != NULL; answers += 2) {
+        if (!G_scan_easting(*answers, &east, G_projection()))
+            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
+        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
+            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
+
+        if (east < window->west || east > window->east ||
+            north < window->south || north > window->north) {
+            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
+                      north);
+            continue;
+        }
+
+        row = (window->north - north) / window->ns_res;
+        col = (east - window->west) / window->ew_res;
+
+        Cost_add_stop_point(cs, row, col);
+    }
+
+    return (cs->n_stop_pnts > 0);
+}
+
+/*!
+   \brief Add a stop point to a search
+
+   The search ends as soon as all stop points have been reached.
+
+   \param cs pointer to search structure
+   \param r,c row and column of the stop point
+ */
+void Cost_add_stop_point(struct Cost_search *cs, int r, int c)
+{
+    int i;
+    struct Cost_rc sp;
+
+    if (cs->n_stop_pnts == cs->stop_pnts_alloc) {
+        cs->stop_pnts_alloc += 100;
+        cs->stop_pnts = (struct Cost_rc *)G_realloc(
+            cs->stop_pnts, cs->stop_pnts_alloc * sizeof(struct Cost_rc));
+    }
+
+    sp.r = r;
+    sp.c = c;
+    i = cs->n_stop_pnts;
+    while (i > 0 && cmp_rc(cs->stop_pnts + i - 1, &sp) > 0) {
+        cs->stop_pnts[i] = cs->stop_pnts[i - 1];
+        i--;
+    }
+    cs->stop_pnts[i] = sp;
+
+    cs->n_stop_pnts++;
+}
+
+/* remove duplicate stop points */
+void Cost__prune_stop_points(struct Cost_search *cs)
+{
+    int i, j;
+
+    if (cs->n_stop_pnts < 2)
+        return;
+
+    j = 1;
+    for (i = 1; i < cs->n_stop_pnts; i++) {
+        if (cs->stop_pnts[i].r != cs->stop_pnts[j - 1].r ||
+            cs->stop_pnts[i].c != cs->stop_pnts[j - 1].c) {
+            cs->stop_pnts[j].r = cs->stop_pnts[i].r;
+            cs->stop_pnts[j].c = cs->stop_pnts[i].c;
+            j++;
+        }
+    }
+    if (cs->n_stop_pnts > j) {
+        G_message(_("Number of duplicate stop points: %d"),
+                  cs->n_stop_pnts - j);
+        cs->n_stop_pnts = j;
+    }
+}
+
+/* whether all stop points have been reached with the cell at row, col */
+int Cost__time_to_stop(struct Cost_search *cs, int row, int col)
+{
+    int lo, mid, hi;
+    struct Cost_rc sp;
+
+    sp.r = row;
+    sp.c = col;
+
+    lo = 0;
+    hi = cs->n_stop_pnts - 1;
+
+    /* bsearch with deferred test for equality
+     * slightly more efficient for worst case: no match */
+    while (lo < hi) {
+        mid = lo + ((hi - lo) >> 1);
+        if (cmp_rc(cs->stop_pnts + mid, &sp) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (cmp_rc(cs->stop_pnts + lo, &sp) == 0) {
+        return (++cs->stop_hits == cs->n_stop_pnts);
+    }
+
+    return 0;
+}
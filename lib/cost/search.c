@@ -0,0 +1,452 @@
+/*!
+   \file lib/cost/search.c
+
+   \brief Cost library - Dijkstra search for cumulative cost surfaces
+
+   The search is shared by r.cost and r.walk. Modules store their cell
+   records in a segment file, with struct Cost_cell at the start of
+   each record, and provide a callback computing the cumulative cost
+   of moving from a cell to one of its neighbors.
+
+   (C) 2006-2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Antony Awaida, James Westervelt, Pierre de Mouveaux,
+   Eric G. Miller, Colin Nielsen, Markus Metz (from r.cost)
+ */
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+#define VISITED_SET(cs, row, col) \
+    (cs)->visited[(size_t)(row) * (cs)->visited_len + ((col) >> 3)] |= \
+        (1 << ((col) & 7))
+
+#define VISITED_GET(cs, row, col) \
+    ((cs)->visited[(size_t)(row) * (cs)->visited_len + ((col) >> 3)] & \
+     (1 << ((col) & 7)))
+
+/*          9    10       Order in which neighbors
+ *       13 5  3  6 14    are visited (Knight move).
+ *          1     2
+ *       16 8  4  7 15
+ *         12    11
+ */
+static const int nbr_row[17] = {0,  0, 0,  -1, 1, -1, -1, 1, 1,
+                                -2, -2, 2, 2,  -1, -1, 1, 1};
+static const int nbr_col[17] = {0,  -1, 1,  0,  0,  -1, 1, 1, -1,
+                                -1, 1,  1, -1, -2, 2,  2, -2};
+
+/* drainage directions in degrees CCW from East
+ * drainage directions are set for each neighbor and must be
+ * read as from neighbor to current cell
+ *
+ * X = neighbor:
+ *
+ *       112.5       67.5
+ * 157.5 135    90   45   22.5
+ *       180     X  360
+ * 202.5 225   270  315   337.5
+ *       247.5      292.5
+ *
+ * X = current cell:
+ *
+ *       292.5      247.5
+ * 337.5 315   270  225    202.5
+ *       360     X  180
+ *  22.5  45    90  135    157.5
+ *        67.5      112.5
+ */
+static const FCELL nbr_dir[17] = {0,     360.0, 180.0, 270.0, 90.0, 315.0,
+                                  225.0, 135.0, 45.0,  292.5, 247.5, 112.5,
+                                  67.5,  337.5, 202.5, 157.5, 22.5};
+
+/* drainage directions bitmask encoded CW from North
+ * drainage directions are set for each neighbor and must be
+ * read as from neighbor to current cell
+ *
+ * bit positions, zero-based, from neighbor to current cell
+ *
+ *     X = neighbor                X = current cell
+ *
+ *      15       8                   11      12
+ *    14 6   7   0  9              10 2   3   4 13
+ *       5   X   1                    1   X   5
+ *    13 4   3   2 10               9 0   7   6 14
+ *      12      11                    8      15
+ */
+static const FCELL nbr_dir_bin[17] = {0, 1, 5,  3,  7,  2,  4,  6, 0,
+                                      11, 12, 15, 8, 10, 13, 14, 9};
+
+/*!
+   \brief Initialize a search
+
+   The caller sets the segments, callbacks and options in the search
+   structure before adding start points and running the search.
+
+   \param cs pointer to search structure
+   \param nrows,ncols number of rows and columns of the grid
+   \param knight non-zero to use the knight's move
+ */
+void Cost_init_search(struct Cost_search *cs, int nrows, int ncols, int knight)
+{
+    G_zero(cs, sizeof(struct Cost_search));
+
+    cs->nrows = nrows;
+    cs->ncols = ncols;
+    cs->n_neighbors = knight ? 16 : 8;
+
+    Cost_heap_init(&cs->heap);
+}
+
+/* remember a cell that got a cumulative cost */
+static void add_reached(struct Cost_search *cs, int row, int col)
+{
+    if (cs->n_reached == cs->reached_alloc) {
+        cs->reached_alloc += 1000;
+        cs->reached = (struct Cost_rc *)G_realloc(
+            cs->reached, cs->reached_alloc * sizeof(struct Cost_rc));
+    }
+    cs->reached[cs->n_reached].r = row;
+    cs->reached[cs->n_reached].c = col;
+    cs->n_reached++;
+}
+
+/*!
+   \brief Add a start point to a search
+
+   Sets the cumulative cost and the nearest start point of the cell
+   and queues the cell. Start points must be added after the cost
+   segment has been initialized.
+
+   \param cs pointer to search structure
+   \param row,col cell of the start point
+   \param cost cumulative cost at the start point
+   \param nearest value identifying the start point
+ */
+void Cost_add_start_point(struct Cost_search *cs, int row, int col,
+                          double cost, double nearest)
+{
+    char *rec = G_malloc(cs->cost_seg->len);
+    struct Cost_cell *cell = (struct Cost_cell *)rec;
+
+    Cost_heap_insert(&cs->heap, cost, row, col);
+    if (Segment_get(cs->cost_seg, rec, row, col) < 0)
+        G_fatal_error(_("Can not read from temporary file"));
+    if (cs->keep_reached && Rast_is_d_null_value(&cell->cost_out))
+        add_reached(cs, row, col);
+    cell->cost_out = cost;
+    cell->nearest = nearest;
+    if (Segment_put(cs->cost_seg, rec, row, col) < 0)
+        G_fatal_error(_("Can not write to temporary file"));
+
+    G_free(rec);
+}
+
+/* set the direction of a cell */
+static void put_dir(struct Cost_search *cs, FCELL cur_dir, int row, int col)
+{
+    if (cs->dir_bin)
+        cur_dir = (1 << (int)cur_dir);
+    if (Segment_put(cs->dir_seg, &cur_dir, row, col) < 0)
+        G_fatal_error(_("Can not write to temporary file"));
+}
+
+/* set the solver value of the cell a cell was reached from */
+static void put_solver(struct Cost_search *cs, DCELL mysolver, int row,
+                       int col)
+{
+    DCELL solvedir[2];
+
+    if (Segment_get(cs->solve_seg, solvedir, row, col) < 0)
+        G_fatal_error(_("Can not read from temporary file"));
+    solvedir[1] = mysolver;
+    if (Segment_put(cs->solve_seg, solvedir, row, col) < 0)
+        G_fatal_error(_("Can not write to temporary file"));
+}
+
+/*!
+   \brief Run a search
+
+   Cells are taken from the heap in order of increasing cumulative
+   cost, ties are resolved by the order in which cells were queued. For
+   each cell, all neighbors are read once and the cumulative costs of
+   the moves are obtained from the move_cost callback. A neighbor is
+   updated if it has no cost yet or if the new cost is lower. With
+   equal costs, the solver values or the bitmask encoded directions
+   decide.
+
+   The search ends when the heap is empty, the maximum cost is
+   exceeded or all stop points have been reached.
+
+   \param cs pointer to search structure
+
+   \return number of cells processed
+ */
+long Cost_run_search(struct Cost_search *cs)
+{
+    struct Cost_point *pres_cell, *ct;
+    struct Cost_cell *costs;
+    void *rec[17];
+    int reclen = cs->cost_seg->len;
+    int row, col, neighbor;
+    double min_cost, old_min_cost, nearest, dnullval;
+    DCELL mysolvedir[2], solvedir[2];
+    FCELL cur_dir;
+    long n_processed = 0;
+    int dir_inv[16] = {4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11};
+
+    Rast_set_d_null_value(&dnullval, 1);
+
+    Cost__prune_stop_points(cs);
+
+    /* kept for searches restarted with Cost_reset_search() */
+    if (!cs->visited) {
+        cs->visited_len = (cs->ncols + 7) / 8;
+        cs->visited = G_calloc((size_t)cs->nrows * cs->visited_len, 1);
+        cs->rec_buf = G_malloc((size_t)reclen * 17);
+    }
+    for (neighbor = 0; neighbor <= 16; neighbor++)
+        rec[neighbor] = cs->rec_buf + (size_t)reclen * neighbor;
+    mysolvedir[0] = mysolvedir[1] = dnullval;
+
+    pres_cell = Cost_heap_get_lowest(&cs->heap);
+    while (pres_cell != NULL) {
+        /* If we have surpassed the user specified maximum cost, then quit */
+        if (cs->max_cost && (cs->max_cost < pres_cell->min_cost))
+            break;
+
+        /* If I've already been updated, delete me */
+        row = pres_cell->row;
+        col = pres_cell->col;
+        if (Segment_get(cs->cost_seg, rec[0], row, col) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
+        costs = rec[0];
+        old_min_cost = costs->cost_out;
+        if (!Rast_is_d_null_value(&old_min_cost)) {
+            if (pres_cell->min_cost > old_min_cost) {
+                Cost_heap_delete(&cs->heap, pres_cell);
+                pres_cell = Cost_heap_get_lowest(&cs->heap);
+                continue;
+            }
+        }
+        if (cs->passable && !cs->passable(cs, rec[0])) {
+            Cost_heap_delete(&cs->heap, pres_cell);
+            pres_cell = Cost_heap_get_lowest(&cs->heap);
+            continue;
+        }
+        if (VISITED_GET(cs, pres_cell->row, pres_cell->col)) {
+            Cost_heap_delete(&cs->heap, pres_cell);
+            pres_cell = Cost_heap_get_lowest(&cs->heap);
+            continue;
+        }
+        VISITED_SET(cs, pres_cell->row, pres_cell->col);
+
+        /* start reading the segments of the neighbors at once */
+        if (Segment_prefetch(cs->cost_seg, pres_cell->row, pres_cell->col,
+                             cs->n_neighbors == 16 ? 2 : 1) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
+
+        if (cs->solve_seg) {
+            if (Segment_get(cs->solve_seg, mysolvedir, pres_cell->row,
+                            pres_cell->col) < 0)
+                G_fatal_error(_("Can not read from temporary file"));
+        }
+
+        nearest = costs->nearest;
+
+        if (cs->total_cells)
+            G_percent(n_processed, cs->total_cells, 1);
+        n_processed++;
+
+        /* read all neighbors first: the costs of knight's moves depend
+         * on the cells passed */
+        for (neighbor = 1; neighbor <= cs->n_neighbors; neighbor++) {
+            row = pres_cell->row + nbr_row[neighbor];
+            col = pres_cell->col + nbr_col[neighbor];
+
+            if (row < 0 || row >= cs->nrows || col < 0 || col >= cs->ncols) {
+                rec[neighbor] = NULL;
+                continue;
+            }
+            rec[neighbor] = cs->rec_buf + (size_t)reclen * neighbor;
+            if (Segment_get(cs->cost_seg, rec[neighbor], row, col) < 0)
+                G_fatal_error(_("Can not read from temporary file"));
+        }
+
+        for (neighbor = 1; neighbor <= cs->n_neighbors; neighbor++) {
+            if (!rec[neighbor])
+                continue;
+
+            row = pres_cell->row + nbr_row[neighbor];
+            col = pres_cell->col + nbr_col[neighbor];
+            cur_dir = cs->dir_bin ? nbr_dir_bin[neighbor] : nbr_dir[neighbor];
+
+            min_cost = cs->move_cost(cs, pres_cell->min_cost, rec, neighbor);
+
+            /* skip if costs could not be calculated */
+            if (Rast_is_d_null_value(&min_cost))
+                continue;
+
+            costs = rec[neighbor];
+            old_min_cost = costs->cost_out;
+
+            /* add to list, or update with lower costs */
+            if (Rast_is_d_null_value(&old_min_cost) ||
+                old_min_cost > min_cost) {
+                costs->cost_out = min_cost;
+                costs->nearest = nearest;
+                if (Segment_put(cs->cost_seg, costs, row, col) < 0)
+                    G_fatal_error(_("Can not write to temporary file"));
+                if (cs->keep_reached && Rast_is_d_null_value(&old_min_cost))
+                    add_reached(cs, row, col);
+                Cost_heap_insert(&cs->heap, min_cost, row, col);
+                if (cs->dir_seg)
+                    put_dir(cs, cur_dir, row, col);
+                if (cs->solve_seg)
+                    put_solver(cs, mysolvedir[0], row, col);
+            }
+            else if (old_min_cost == min_cost &&
+                     (cs->dir_bin || cs->solve_seg) &&
+                     !(VISITED_GET(cs, row, col))) {
+                FCELL old_dir;
+                int dir_fwd;
+                int equal = 1;
+
+                /* only update neighbors that have not yet been processed,
+                 * otherwise we might get circular paths */
+
+                if (cs->solve_seg) {
+                    if (Segment_get(cs->solve_seg, solvedir, row, col) < 0)
+                        G_fatal_error(_("Can not read from temporary file"));
+                    equal = (solvedir[1] == mysolvedir[0]);
+                    if (solvedir[1] > mysolvedir[0]) {
+                        solvedir[1] = mysolvedir[0];
+                        if (Segment_put(cs->solve_seg, solvedir, row, col) < 0)
+                            G_fatal_error(_("Can not write to temporary file"));
+
+                        costs->nearest = nearest;
+                        if (Segment_put(cs->cost_seg, costs, row, col) < 0)
+                            G_fatal_error(_("Can not write to temporary file"));
+
+                        if (cs->dir_seg)
+                            put_dir(cs, cur_dir, row, col);
+                    }
+                }
+
+                if (cs->dir_bin && equal) {
+                    /* this can create circular paths:
+                     * set only if current cell does not point to neighbor
+                     * does not avoid longer circular paths */
+                    if (Segment_get(cs->dir_seg, &old_dir, pres_cell->row,
+                                    pres_cell->col) < 0)
+                        G_fatal_error(_("Can not read from temporary file"));
+                    dir_fwd = (1 << dir_inv[(int)cur_dir]);
+                    if (!((int)old_dir & dir_fwd)) {
+                        if (Segment_get(cs->dir_seg, &old_dir, row, col) < 0)
+                            G_fatal_error(
+                                _("Can not read from temporary file"));
+                        cur_dir = ((1 << (int)cur_dir) | (int)old_dir);
+                        if (Segment_put(cs->dir_seg, &cur_dir, row, col) < 0)
+                            G_fatal_error(_("Can not write to temporary file"));
+                    }
+                }
+            }
+        }
+
+        if (cs->n_stop_pnts &&
+            Cost__time_to_stop(cs, pres_cell->row, pres_cell->col))
+            break;
+
+        ct = pres_cell;
+        Cost_heap_delete(&cs->heap, pres_cell);
+        pres_cell = Cost_heap_get_lowest(&cs->heap);
+
+        if (ct == pres_cell)
+            G_warning(_("Error, ct == pres_cell"));
+    }
+    if (cs->total_cells)
+        G_percent(1, 1, 1);
+
+    return n_processed;
+}
+
+/*!
+   \brief Prepare a search to be run again
+
+   Removes the cumulative costs and nearest start points of all cells
+   reached by the previous run, which requires keep_reached to be set
+   before start points are added. Costs are set to null and nearest
+   start points to 0, directions and solver values are not reset.
+   Stop points are kept. Afterwards, new start points can be added
+   and the search can be run again, without initializing the segments
+   again.
+
+   \param cs pointer to search structure
+ */
+void Cost_reset_search(struct Cost_search *cs)
+{
+    struct Cost_point *pnt;
+    struct Cost_cell *cell;
+    char *rec;
+    long i;
+    int row, col;
+
+    if (!cs->keep_reached)
+        G_fatal_error(_("Reached cells of the search are not kept"));
+
+    while ((pnt = Cost_heap_get_lowest(&cs->heap)) != NULL)
+        Cost_heap_delete(&cs->heap, pnt);
+    cs->heap.next_point = 0;
+
+    rec = G_malloc(cs->cost_seg->len);
+    cell = (struct Cost_cell *)rec;
+    for (i = 0; i < cs->n_reached; i++) {
+        row = cs->reached[i].r;
+        col = cs->reached[i].c;
+        if (Segment_get(cs->cost_seg, rec, row, col) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
+        Rast_set_d_null_value(&cell->cost_out, 1);
+        cell->nearest = 0;
+        if (Segment_put(cs->cost_seg, rec, row, col) < 0)
+            G_fatal_error(_("Can not write to temporary file"));
+        /* visited cells are all in the list, clear the whole byte */
+        if (cs->visited)
+            cs->visited[(size_t)row * cs->visited_len + (col >> 3)] = 0;
+    }
+    G_free(rec);
+
+    cs->n_reached = 0;
+    cs->stop_hits = 0;
+}
+
+/*!
+   \brief Free the memory allocated by a search
+
+   The segments are not closed.
+
+   \param cs pointer to search structure
+ */
+void Cost_free_search(struct Cost_search *cs)
+{
+    struct Cost_point *pnt;
+
+    while ((pnt = Cost_heap_get_lowest(&cs->heap)) != NULL)
+        Cost_heap_delete(&cs->heap, pnt);
+    Cost_heap_free(&cs->heap);
+
+    G_free(cs->visited);
+    G_free(cs->rec_buf);
+    G_free(cs->stop_pnts);
+    G_free(cs->reached);
+    cs->visited = NULL;
+    cs->rec_buf = NULL;
+    cs->stop_pnts = NULL;
+    cs->reached = NULL;
+    cs->n_stop_pnts = cs->stop_pnts_alloc = cs->stop_hits = 0;
+    cs->n_reached = cs->reached_alloc = 0;
+}
@@ -49,6 +49,16 @@
  *                                                                  *
  * ================================================================ *
  * int                                                              *
+ * G_expand_compressed (src, src_sz, dst, nbytes, compression_type) *
+ *     int src_sz, nbytes;                                          *
+ *     unsigned char *src, *dst;                                    *
+ * ---------------------------------------------------------------- *
+ * Same as G_read_compressed() but the chunk has already been read  *
+ * into 'src' (including the leading compression flag byte).        *
+ * Returns the number of bytes decompressed into dst, or -1.        *
+ *                                                                  *
+ * ================================================================ *
+ * int                                                              *
  * G_write_compressed (fd, src, nbytes, compression_type)           *
  *     int fd, nbytes;                                              *
  *     unsigned char *src;                                          *
@@ -65,6 +75,17 @@
  *                                                                  *
  * ================================================================ *
  * int                                                              *
+ * G_compress_chunk (src, src_sz, dst, dst_sz, compression_type)    *
+ *     int src_sz, dst_sz;                                          *
+ *     unsigned char *src, *dst;                                    *
+ * ---------------------------------------------------------------- *
+ * Same as G_write_compressed() but the chunk (including the        *
+ * leading compression flag byte) is stored in 'dst' instead of     *
+ * being written to a file. Returns the number of bytes in 'dst',   *
+ * or -1 for an error.                                              *
+ *                                                                  *
+ * ================================================================ *
+ * int                                                              *
  * G_write_uncompressed (fd, src, nbytes)                           *
  *     int fd, nbytes;                                              *
  *     unsigned char *src;                                          *
@@ -290,35 +311,75 @@ int G_read_compressed(int fd, int rbytes, unsigned char *dst, int nbytes,
         return -1;
     }
 
+    err = G_expand_compressed(b, nread, dst, nbytes, number);
+
+    /* We're done with b */
+    G_free(b);
+
+    /* Return whatever G_expand_compressed() returned */
+    return err;
+
+} /* G_read_compressed() */
+
+/* Expand a chunk written by G_write_compressed() which has already
+ * been read into memory. The first byte of 'src' is the compression
+ * flag. Unlike G_read_compressed(), no file I/O is done and nothing
+ * global is modified, so this can be called from worker threads. */
+int G_expand_compressed(unsigned char *src, int src_sz, unsigned char *dst,
+                        int nbytes, int number)
+{
+    int i;
+
+    if (src == NULL || src_sz <= 0)
+        return -1;
+
     /* Test if row is compressed */
-    if (b[0] == G_COMPRESSED_NO) {
+    if (src[0] == G_COMPRESSED_NO) {
         /* Then just copy it to dst */
-        for (err = 0; err < nread - 1 && err < nbytes; err++)
-            dst[err] = b[err + 1];
+        for (i = 0; i < src_sz - 1 && i < nbytes; i++)
+            dst[i] = src[i + 1];
 
-        G_free(b);
-        return (nread - 1);
+        return (src_sz - 1);
     }
-    else if (b[0] != G_COMPRESSED_YES) {
+    else if (src[0] != G_COMPRESSED_YES) {
         /* We're not at the start of a row */
-        G_free(b);
         G_warning("Read error: We're not at the start of a row");
         return -1;
     }
     /* Okay it's a compressed row */
 
-    /* Just call G_expand() with the buffer we read,
+    /* Just call G_expand() with the buffer,
      * Account for first byte being a flag
      */
-    err = G_expand(b + 1, bsize - 1, dst, nbytes, number);
+    return G_expand(src + 1, src_sz - 1, dst, nbytes, number);
+}
 
-    /* We're done with b */
-    G_free(b);
+/* Compress 'src' into 'dst' in the format written by G_write_compressed():
+ * a compression flag byte followed by either the compressed data or, if
+ * compression does not reduce the size, a copy of 'src'. 'dst_sz' must be
+ * at least G_compress_bound(src_sz, number) + 1. Like G_expand_compressed()
+ * this does no file I/O and can be called from worker threads.
+ * Returns the number of bytes in 'dst', or -1 on error. */
+int G_compress_chunk(unsigned char *src, int src_sz, unsigned char *dst,
+                     int dst_sz, int number)
+{
+    int err;
 
-    /* Return whatever G_expand() returned */
-    return err;
+    if (src == NULL || src_sz < 0 || dst == NULL || dst_sz <= src_sz)
+        return -1;
 
-} /* G_read_compressed() */
+    err = G_compress(src, src_sz, dst + 1, dst_sz - 1, number);
+
+    if (err > 0 && err < src_sz) {
+        dst[0] = G_COMPRESSED_YES;
+        return err + 1;
+    }
+
+    dst[0] = G_COMPRESSED_NO;
+    memcpy(dst + 1, src, src_sz);
+
+    return src_sz + 1;
+}
 
 int G_write_compressed(int fd, unsigned char *src, int nbytes, int number)
 {
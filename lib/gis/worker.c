@@ -38,6 +38,7 @@ static int num_workers;
 static struct worker *workers;
 static pthread_cond_t worker_cond;
 static pthread_mutex_t worker_mutex;
+static int initialized;
 
 /****************************************************************************/
 
@@ -56,7 +57,7 @@ static void *worker(void *arg)
         w->closure = NULL;
         *w->ref = NULL;
         pthread_mutex_unlock(&w->mutex);
-        pthread_cond_signal(&w->cond);
+        pthread_cond_broadcast(&w->cond);
         pthread_cond_signal(&worker_cond);
     }
 
@@ -119,11 +120,22 @@ void G_end_execute(void **ref)
     pthread_mutex_unlock(&w->mutex);
 }
 
+int G_num_workers(void)
+{
+    return num_workers;
+}
+
 void G_init_workers(void)
 {
-    const char *p = getenv("WORKERS");
+    const char *p;
     int i;
 
+    /* the pool is shared by all users (r.mapcalc, raster library) */
+    if (G_is_initialized(&initialized))
+        return;
+
+    p = getenv("WORKERS");
+
     pthread_mutex_init(&worker_mutex, NULL);
     pthread_cond_init(&worker_cond, NULL);
 
@@ -137,16 +149,26 @@ void G_init_workers(void)
         pthread_cond_init(&w->cond, NULL);
         pthread_create(&w->thread, NULL, worker, w);
     }
+
+    G_initialize_done(&initialized);
 }
 
 void G_finish_workers(void)
 {
     int i;
 
+    if (!initialized)
+        return;
+
     for (i = 0; i < num_workers; i++) {
         struct worker *w = &workers[i];
 
+        /* don't cancel a worker with a pending task */
+        pthread_mutex_lock(&w->mutex);
+        while (w->func)
+            pthread_cond_wait(&w->cond, &w->mutex);
         w->cancel = 1;
+        pthread_mutex_unlock(&w->mutex);
         pthread_cancel(w->thread);
     }
 
@@ -160,6 +182,11 @@ void G_finish_workers(void)
 
     pthread_mutex_destroy(&worker_mutex);
     pthread_cond_destroy(&worker_cond);
+
+    G_free(workers);
+    workers = NULL;
+    num_workers = 0;
+    initialized = 0;
 }
 
 /****************************************************************************/
@@ -178,6 +205,11 @@ void G_end_execute(void **ref G_UNUSED)
 {
 }
 
+int G_num_workers(void)
+{
+    return 0;
+}
+
 void G_init_workers(void)
 {
 }
@@ -44,6 +44,95 @@ struct R_vrt {
     struct ilist *tlist;
 };
 
+struct R_read_ahead_slot /* One row of the read-ahead ring buffer */
+{
+    struct R_read_ahead *ra;  /* ring buffer this slot belongs to */
+    int row;                  /* cell file row held, -1 if empty */
+    int nbytes;               /* nbytes per cell of decompressed row */
+    int status;               /* > 0 if row was decompressed */
+    unsigned char *cmp;       /* compressed row as read from file */
+    size_t cmp_size;          /* bytes used in cmp */
+    size_t cmp_alloc;         /* bytes allocated for cmp */
+    unsigned char *data;      /* decompressed row */
+    void *worker;             /* worker decompressing the row */
+};
+
+struct R_read_ahead /* Rows decompressed in advance by worker threads */
+{
+    int nslots;               /* number of rows in ring buffer */
+    int next_row;             /* next cell file row to schedule */
+    RASTER_MAP_TYPE map_type; /* copies of fileinfo data used by workers */
+    int compressed;
+    int nbytes;
+    int cols;
+    struct R_read_ahead_slot *slots;
+};
+
+struct R_write_behind_slot /* One row queued for compression */
+{
+    struct R_write_behind *wb; /* queue this slot belongs to */
+    int row;                   /* row number, -1 if empty */
+    unsigned char *src;        /* uncompressed row */
+    int src_size;              /* bytes used in src */
+    unsigned char *dst;        /* compressed row */
+    int dst_size;              /* bytes allocated for dst */
+    unsigned char *out;        /* data to write, src or dst */
+    int out_size;              /* bytes to write from out */
+    void *worker;              /* worker compressing the row */
+    void *rast;                /* row values for the statistics */
+    int rast_n;                /* number of values, 0 if no statistics */
+    RASTER_MAP_TYPE rast_type; /* type of the values */
+    int ignore_zeros;          /* zeros are not part of the range */
+    int want_histogram;        /* also collect cell stats */
+    struct Cell_stats statf;   /* cell stats of the row, merged into the
+                                  map's when the row is written */
+};
+
+struct R_write_behind /* Rows compressed by worker threads, written in order */
+{
+    int nslots;      /* number of rows in the queue */
+    int next_row;    /* next row to be queued */
+    int null_file;   /* rows of the null file or of the cell/fcell file */
+    int compressor;  /* compression type */
+    void (*compress)(struct R_write_behind_slot *);
+    struct R_write_behind_slot *slots;
+};
+
+struct R_mapped /* Memory-mapped cell/fcell and null files */
+{
+    unsigned char *data; /* mapped cell/fcell file */
+    size_t data_size;
+    void *data_handle;   /* file mapping handle on Windows */
+    unsigned char *null; /* mapped null file, NULL if not mapped */
+    size_t null_size;
+    void *null_handle;
+};
+
+struct R_row_cache /* On-disk cache of decompressed rows */
+{
+    int fd;            /* cache file */
+    size_t row_size;   /* bytes reserved per row */
+    off_t data_offset; /* file offset of the first row */
+    off_t limit;       /* disk space the cache file may use */
+    off_t used;        /* disk space used by the cache file */
+};
+
+struct R_window_map /* Window column mapping shared by open maps */
+{
+    struct R_window_map *next;
+    int refs;                /* number of maps using the mapping */
+    double cell_west;        /* key: columns of the cell header */
+    double cell_ew_res;
+    int cell_cols;
+    double window_west;      /* and of the window */
+    double window_east;
+    double window_ew_res;
+    int window_cols;
+    int proj;
+    COLUMN_MAPPING *col_map; /* the mapping */
+    int identity;            /* window column i is cell file column i */
+};
+
 struct fileinfo /* Information for opened cell files */
 {
     int open_mode;           /* see defines below            */
@@ -76,6 +165,15 @@ struct fileinfo /* Information for opened cell files */
     int data_fd;         /* Raster data fd               */
     off_t *null_row_ptr; /* Null file row addresses      */
     struct R_vrt *vrt;
+    struct R_read_ahead *read_ahead;          /* Row read-ahead, NULL if off */
+    struct R_write_behind *write_behind;      /* Data rows compression queue */
+    struct R_write_behind *null_write_behind; /* Null rows compression queue */
+    struct R_mapped *mapped;                  /* Mapped files, NULL if off */
+    const unsigned char *cur_data;            /* Data of cur_row in memory */
+    int *shared_refs;                         /* Shared table refs or NULL */
+    struct R_row_cache *row_cache;            /* Row cache, NULL if off */
+    struct R_window_map *window_map;          /* Shared col_map */
+    int mask_fd;                              /* Private mask reader or -1 */
 };
 
 struct R__ /*  Structure of library globals */
@@ -83,10 +181,16 @@ struct R__ /*  Structure of library globals */
     RASTER_MAP_TYPE fp_type; /* type for writing floating maps */
     int mask_fd;             /* File descriptor for automatic mask   */
     int auto_mask;           /* Flag denoting automatic masking      */
+    int mask_threads;        /* Threads reading maps with the mask   */
     int want_histogram;
     int nbytes;
     int compression_type;
     int compress_nulls;
+    int read_ahead;             /* Rows to read ahead for old maps      */
+    int write_behind;           /* Rows to compress in background       */
+    int use_mmap;               /* Map data files of old maps           */
+    char *row_cache_dir;        /* Row cache directory, NULL if off     */
+    size_t row_cache_size;      /* Size limit of the row cache          */
     int window_set;             /* Flag: window set?                    */
     int split_window;           /* Separate windows for input and output */
     struct Cell_head rd_window; /* Window used for input        */
@@ -79,6 +79,28 @@ int Rast__check_for_auto_masking(void)
     return 1;
 }
 
+/**
+ * \brief Opens a private reader of the mask.
+ *
+ * Raster maps read by several threads get a descriptor of the mask of
+ * their own, so that the mask rows of different maps can be read at
+ * the same time. Other maps share the descriptor of the mask opened by
+ * Rast__check_for_auto_masking(). The new descriptor shares the row
+ * index and the reclass table with it, see Rast_open_old_dup().
+ *
+ * \return new descriptor of the mask
+ * \return -1 if masking is off
+ */
+int Rast__open_mask_reader(void)
+{
+    if (R__.auto_mask <= 0 || R__.mask_fd < 0)
+        return -1;
+
+    /* the mask is read without masking, Rast_open_old_dup() would
+       attach a mask reader to the mask reader */
+    return Rast__open_old_dup(R__.mask_fd);
+}
+
 /**
  * \brief Suppresses masking.
  *
@@ -168,6 +168,85 @@ static void init_node(NODE *node, int idx, int offset)
     node->left = 0;
 }
 
+/* find the node for idx, a new node with zero counts is added if needed */
+static NODE *find_or_add_node(struct Cell_stats *s, int idx)
+{
+    NODE *node = s->node;
+    NODE *pnode = NULL;
+    NODE *new_node;
+    int p = 0, q;
+    int N;
+
+    if (s->N == 0) {
+        init_node(&node[1], idx, 0);
+        node[1].count[0] = 0;
+        node[1].right = 0;
+        s->N = 1;
+        return &node[1];
+    }
+
+    q = 1;
+    while (q > 0) {
+        pnode = &node[p = q];
+        if (pnode->idx == idx)
+            return pnode;
+        if (pnode->idx > idx)
+            q = pnode->left; /* go left */
+        else
+            q = pnode->right; /* go right */
+    }
+
+    N = ++s->N;
+
+    /* grow the tree? */
+    if (N >= s->tlen) {
+        node = s->node =
+            (NODE *)G_realloc((char *)node, sizeof(NODE) * (s->tlen += INCR));
+        pnode = &node[p];
+    }
+
+    init_node(new_node = &node[N], idx, 0);
+    new_node->count[0] = 0;
+
+    if (pnode->idx > idx) {
+        new_node->right = -p; /* create thread */
+        pnode->left = N;      /* insert left */
+    }
+    else {
+        new_node->right = pnode->right; /* copy right link/thread */
+        pnode->right = N;               /* add right */
+    }
+
+    return new_node;
+}
+
+/*!
+ * \brief Merge cell stats
+ *
+ * The counts of <i>src</i>, including the count of NULL-values, are
+ * added to <i>s</i>, as if the values counted in <i>src</i> had been
+ * passed to Rast_update_cell_stats() for <i>s</i>. This allows to
+ * collect cell stats of parts of a raster map separately, e.g. in
+ * different threads, and to combine them afterwards.
+ *
+ * \param s pointer to Cell_stats structure to be updated
+ * \param src pointer to Cell_stats structure to be merged into s
+ */
+void Rast_merge_cell_stats(struct Cell_stats *s, const struct Cell_stats *src)
+{
+    int i, j;
+
+    for (i = 1; i <= src->N; i++) {
+        const NODE *snode = &src->node[i];
+        NODE *node = find_or_add_node(s, snode->idx);
+
+        for (j = 0; j < NCATS; j++)
+            node->count[j] += snode->count[j];
+    }
+
+    s->null_data_count += src->null_data_count;
+}
+
 /*!
  * \brief Random query of cell stats
  *
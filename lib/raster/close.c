@@ -169,6 +169,7 @@ void Rast__unopen_all(void)
 static int close_old(int fd)
 {
     struct fileinfo *fcb = &R__.fileinfo[fd];
+    int shared;
 
     /* if R__.auto_mask was only allocated for reading map rows to create
        non-existent null rows, and not for actual mask, free R__.mask_row
@@ -182,25 +183,43 @@ static int close_old(int fd)
     if (fcb->vrt)
         Rast_close_vrt(fcb->vrt);
 
+    Rast__free_read_ahead(fd);
+    Rast__free_mmap(fd);
+    Rast__free_row_cache(fd);
+
+    if (fcb->mask_fd >= 0)
+        close_old(fcb->mask_fd);
+    fcb->mask_fd = -1;
+
+    /* tables shared with descriptors from Rast_open_old_dup() are freed
+       by the last one closed */
+    if (fcb->shared_refs && --(*fcb->shared_refs) > 0)
+        shared = 1;
+    else {
+        G_free(fcb->shared_refs);
+        shared = 0;
+    }
+    fcb->shared_refs = NULL;
+
     if (fcb->null_bits)
         G_free(fcb->null_bits);
-    if (fcb->null_row_ptr)
+    if (fcb->null_row_ptr && !shared)
         G_free(fcb->null_row_ptr);
     if (fcb->null_fd >= 0)
         close(fcb->null_fd);
     fcb->null_fd = -1;
 
-    if (fcb->cellhd.compressed)
+    if (fcb->cellhd.compressed && !shared)
         G_free(fcb->row_ptr);
-    G_free(fcb->col_map);
+    Rast__free_window_mapping(fd);
     G_free(fcb->mapset);
     G_free(fcb->data);
     G_free(fcb->name);
-    if (fcb->reclass_flag)
+    if (fcb->reclass_flag && !shared)
         Rast_free_reclass(&fcb->reclass);
     fcb->open_mode = -1;
 
-    if (fcb->map_type != CELL_TYPE) {
+    if (fcb->map_type != CELL_TYPE && !shared) {
         Rast_quant_free(&fcb->quant);
     }
     if (fcb->data_fd >= 0)
@@ -393,6 +412,9 @@ static int close_new(int fd, int ok)
             fcb->data = NULL;
         }
 
+        /* write the rows still queued for compression */
+        Rast__flush_write_behind(fd);
+
         if (fcb->null_row_ptr) { /* compressed nulls */
             fcb->null_row_ptr[fcb->cellhd.rows] =
                 lseek(fcb->null_fd, 0L, SEEK_CUR);
@@ -473,6 +495,10 @@ static int close_new(int fd, int ok)
             CELL_DIR = "cell";
         }
     } /* ok */
+
+    /* rows not written yet are discarded if !ok */
+    Rast__free_write_behind(fd);
+
     /* NOW CLOSE THE FILE DESCRIPTOR */
 
     sync_and_close(fcb->data_fd,
@@ -127,6 +127,40 @@ static void rle_decompress(unsigned char *dst, const unsigned char *src,
     }
 }
 
+/* decompress a CELL row, returns 1 on success, 0 on failure */
+static int expand_data_compressed(unsigned char *cmp, size_t readamount,
+                                  unsigned char *data_buf, int *nbytes,
+                                  int compressed, int map_nbytes, int cols)
+{
+    size_t bufsize;
+    int n;
+
+    if (compressed > 0) {
+        /* one byte is nbyte count */
+        n = *nbytes = *cmp++;
+        readamount--;
+    }
+    else
+        /* pre 3.0 compression */
+        n = *nbytes = map_nbytes;
+
+    bufsize = (size_t)n * cols;
+    if (compressed < 0 || readamount < bufsize) {
+        if (compressed == 1)
+            rle_decompress(data_buf, cmp, n, readamount);
+        else {
+            if ((n = G_expand(cmp, readamount, data_buf, bufsize,
+                              compressed)) < 0 ||
+                (unsigned int)n != bufsize)
+                return 0;
+        }
+    }
+    else
+        memcpy(data_buf, cmp, readamount);
+
+    return 1;
+}
+
 static void read_data_compressed(int fd, int row, unsigned char *data_buf,
                                  int *nbytes)
 {
@@ -134,9 +168,7 @@ static void read_data_compressed(int fd, int row, unsigned char *data_buf,
     off_t t1 = fcb->row_ptr[row];
     off_t t2 = fcb->row_ptr[row + 1];
     ssize_t readamount = t2 - t1;
-    size_t bufsize;
-    unsigned char *cmp, *cmp2;
-    int n;
+    unsigned char *cmp;
 
     if (lseek(fcb->data_fd, t1, SEEK_SET) == -1)
         G_fatal_error(
@@ -151,37 +183,47 @@ static void read_data_compressed(int fd, int row, unsigned char *data_buf,
                       row, fcb->name, strerror(errno));
     }
 
-    /* save cmp for free below */
-    cmp2 = cmp;
-
     /* Now decompress the row */
-    if (fcb->cellhd.compressed > 0) {
-        /* one byte is nbyte count */
-        n = *nbytes = *cmp++;
-        readamount--;
-    }
-    else
-        /* pre 3.0 compression */
-        n = *nbytes = fcb->nbytes;
+    if (!expand_data_compressed(cmp, readamount, data_buf, nbytes,
+                                fcb->cellhd.compressed, fcb->nbytes,
+                                fcb->cellhd.cols))
+        G_fatal_error(_("Error uncompressing raster data for row %d of <%s>"),
+                      row, fcb->name);
 
-    bufsize = (size_t)n * fcb->cellhd.cols;
-    if (fcb->cellhd.compressed < 0 || (size_t)readamount < bufsize) {
-        if (fcb->cellhd.compressed == 1)
-            rle_decompress(data_buf, cmp, n, readamount);
-        else {
-            if ((n = G_expand(cmp, readamount, data_buf, bufsize,
-                              fcb->cellhd.compressed)) < 0 ||
-                (unsigned int)n != bufsize) {
-                G_fatal_error(
-                    _("Error uncompressing raster data for row %d of <%s>"),
-                    row, fcb->name);
-            }
-        }
-    }
-    else
-        memcpy(data_buf, cmp, readamount);
+    G_free(cmp);
+}
+
+/*!
+   \brief Decompress a row read from a compressed raster data file
+
+   Only the arguments are used, the file descriptor table is not
+   accessed. This allows rows to be decompressed by worker threads
+   (see Rast_set_read_ahead()).
+
+   \param cmp compressed row as stored in the cell/fcell file
+   \param size number of bytes in cmp
+   \param[out] data_buf buffer for decompressed row
+   \param[out] nbytes number of bytes per cell of decompressed row
+   \param map_type map type of the raster data file
+   \param compressed compression type of the raster data file
+   \param map_nbytes number of bytes per cell of the map
+   \param cols number of columns of the map
+
+   \return 1 on success
+   \return 0 on error
+ */
+int Rast__expand_row(unsigned char *cmp, size_t size, unsigned char *data_buf,
+                     int *nbytes, RASTER_MAP_TYPE map_type, int compressed,
+                     int map_nbytes, int cols)
+{
+    if (map_type == CELL_TYPE)
+        return expand_data_compressed(cmp, size, data_buf, nbytes, compressed,
+                                      map_nbytes, cols);
+
+    *nbytes = map_nbytes;
 
-    G_free(cmp2);
+    return G_expand_compressed(cmp, size, data_buf, map_nbytes * cols,
+                               compressed) > 0;
 }
 
 static void read_data_uncompressed(int fd, int row, unsigned char *data_buf,
@@ -236,21 +278,34 @@ static void read_data_gdal(int fd, int row, unsigned char *data_buf,
             fcb->name);
 }
 
-static void read_data(int fd, int row, unsigned char *data_buf, int *nbytes)
+/* read a cell file row, returns data_buf or a pointer into the mapped
+   cell file */
+static const unsigned char *read_data(int fd, int row, unsigned char *data_buf,
+                                      int *nbytes)
 {
     struct fileinfo *fcb = &R__.fileinfo[fd];
+    const unsigned char *data = data_buf;
 
-    if (fcb->gdal) {
-        read_data_gdal(fd, row, data_buf, nbytes);
-        return;
-    }
+    if (fcb->row_cache && Rast__read_cached_row(fd, row, data_buf, nbytes))
+        return data_buf;
 
-    if (!fcb->cellhd.compressed)
+    if (fcb->gdal)
+        read_data_gdal(fd, row, data_buf, nbytes);
+    else if (fcb->read_ahead)
+        Rast__read_ahead_row(fd, row, data_buf, nbytes);
+    else if (fcb->mapped)
+        data = Rast__get_mapped_row(fd, row, data_buf, nbytes);
+    else if (!fcb->cellhd.compressed)
         read_data_uncompressed(fd, row, data_buf, nbytes);
     else if (fcb->map_type == CELL_TYPE)
         read_data_compressed(fd, row, data_buf, nbytes);
     else
         read_data_fp_compressed(fd, row, data_buf, nbytes);
+
+    if (fcb->row_cache)
+        Rast__write_cached_row(fd, row, data, *nbytes);
+
+    return data;
 }
 
 /* copy cell file data to user buffer translated by window column mapping */
@@ -299,44 +354,107 @@ static void cell_values_int(int fd G_UNUSED, const unsigned char *data G_UNUSED,
     }
 }
 
-static void cell_values_float(int fd, const unsigned char *data G_UNUSED,
+/* decode XDR (big endian IEEE) values; written without a test for the
+   host byte order so that the compiler turns them into byte swaps */
+static FCELL xdr_get_float(const unsigned char *p)
+{
+    uint32_t u = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                 ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    FCELL f;
+
+    memcpy(&f, &u, sizeof(f));
+
+    return f;
+}
+
+static DCELL xdr_get_double(const unsigned char *p)
+{
+    uint64_t u = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) |
+                 ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+                 ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+                 ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+    DCELL d;
+
+    memcpy(&d, &u, sizeof(d));
+
+    return d;
+}
+
+static void cell_values_float(int fd G_UNUSED, const unsigned char *data,
                               const COLUMN_MAPPING *cmap, int nbytes G_UNUSED,
                               void *cell, int n)
 {
-    struct fileinfo *fcb = &R__.fileinfo[fd];
-    const float *work_buf = (const float *)fcb->data;
     FCELL *c = cell;
     int i;
 
+    /* cmap[i] == 0 (outside of the cell file) reads the first cell,
+       which is discarded */
     for (i = 0; i < n; i++) {
-        if (!cmap[i]) {
-            c[i] = 0;
-            continue;
-        }
+        COLUMN_MAPPING col = cmap[i] ? cmap[i] - 1 : 0;
+        FCELL f = xdr_get_float(data + (size_t)col * XDR_FLOAT_NBYTES);
 
-        G_xdr_get_float(&c[i], &work_buf[cmap[i] - 1]);
+        c[i] = cmap[i] ? f : 0;
     }
 }
 
-static void cell_values_double(int fd, const unsigned char *data G_UNUSED,
+static void cell_values_double(int fd G_UNUSED, const unsigned char *data,
                                const COLUMN_MAPPING *cmap, int nbytes G_UNUSED,
                                void *cell, int n)
 {
-    struct fileinfo *fcb = &R__.fileinfo[fd];
-    const double *work_buf = (const double *)fcb->data;
     DCELL *c = cell;
     int i;
 
+    /* cmap[i] == 0 (outside of the cell file) reads the first cell,
+       which is discarded */
     for (i = 0; i < n; i++) {
-        if (!cmap[i]) {
-            c[i] = 0;
-            continue;
-        }
+        COLUMN_MAPPING col = cmap[i] ? cmap[i] - 1 : 0;
+        DCELL d = xdr_get_double(data + (size_t)col * XDR_DOUBLE_NBYTES);
+
+        c[i] = cmap[i] ? d : 0;
+    }
+}
 
-        G_xdr_get_double(&c[i], &work_buf[cmap[i] - 1]);
+/* copy cell file data to user buffer when window column i is cell
+   file column i */
+static void cell_values_int_identity(const unsigned char *data, int nbytes,
+                                     void *cell, int n)
+{
+    CELL *c = cell;
+    int big = (size_t)nbytes >= sizeof(CELL);
+    int i, j;
+
+    for (i = 0; i < n; i++) {
+        const unsigned char *d = data + (size_t)i * nbytes;
+        int neg = big && (*d & 0x80);
+        CELL v = neg ? *d & 0x7f : *d;
+
+        for (j = 1; j < nbytes; j++)
+            v = (v << 8) + d[j];
+
+        c[i] = neg ? -v : v;
     }
 }
 
+static void cell_values_float_identity(const unsigned char *data,
+                                       int nbytes G_UNUSED, void *cell, int n)
+{
+    FCELL *c = cell;
+    int i;
+
+    for (i = 0; i < n; i++)
+        c[i] = xdr_get_float(data + (size_t)i * XDR_FLOAT_NBYTES);
+}
+
+static void cell_values_double_identity(const unsigned char *data,
+                                        int nbytes G_UNUSED, void *cell, int n)
+{
+    DCELL *c = cell;
+    int i;
+
+    for (i = 0; i < n; i++)
+        c[i] = xdr_get_double(data + (size_t)i * XDR_DOUBLE_NBYTES);
+}
+
 static void gdal_values_int(int fd, const unsigned char *data,
                             const COLUMN_MAPPING *cmap, int nbytes, void *cell,
                             int n)
@@ -441,7 +559,7 @@ static void gdal_values_double(int fd G_UNUSED, const unsigned char *data,
     }
 }
 
-/* transfer_to_cell_XY takes bytes from fcb->data, converts these bytes with
+/* transfer_to_cell_XY takes bytes from fcb->cur_data, converts these bytes with
    the appropriate procedure (e.g. XDR or byte reordering) into type X
    values which are put into array work_buf.
    finally the values in work_buf are converted into
@@ -458,14 +576,22 @@ static void transfer_to_cell_XX(int fd, void *cell)
     static void (*gdal_values_type[3])(
         int, const unsigned char *, const COLUMN_MAPPING *, int, void *,
         int) = {gdal_values_int, gdal_values_float, gdal_values_double};
+    static void (*identity_values_type[3])(const unsigned char *, int, void *,
+                                           int) = {
+        cell_values_int_identity, cell_values_float_identity,
+        cell_values_double_identity};
     struct fileinfo *fcb = &R__.fileinfo[fd];
 
-    if (fcb->gdal)
-        (gdal_values_type[fcb->map_type])(fd, fcb->data, fcb->col_map,
+    if (fcb->window_map->identity && !fcb->gdal)
+        /* map and window columns match, no column mapping needed */
+        (identity_values_type[fcb->map_type])(
+            fcb->cur_data, fcb->cur_nbytes, cell, R__.rd_window.cols);
+    else if (fcb->gdal)
+        (gdal_values_type[fcb->map_type])(fd, fcb->cur_data, fcb->col_map,
                                           fcb->cur_nbytes, cell,
                                           R__.rd_window.cols);
     else
-        (cell_values_type[fcb->map_type])(fd, fcb->data, fcb->col_map,
+        (cell_values_type[fcb->map_type])(fd, fcb->cur_data, fcb->col_map,
                                           fcb->cur_nbytes, cell,
                                           R__.rd_window.cols);
 }
@@ -587,7 +713,8 @@ static int get_map_row_nomask(int fd, void *rast, int row,
     /* read cell file row if not in memory */
     if (r != fcb->cur_row) {
         fcb->cur_row = r;
-        read_data(fd, fcb->cur_row, fcb->data, &fcb->cur_nbytes);
+        fcb->cur_data =
+            read_data(fd, fcb->cur_row, fcb->data, &fcb->cur_nbytes);
     }
 
     (transfer_to_cell_FtypeOtype[fcb->map_type][data_type])(fd, rast);
@@ -831,6 +958,96 @@ void Rast_get_d_row(int fd, DCELL *buf, int row)
     Rast_get_row(fd, buf, row, DCELL_TYPE);
 }
 
+/*!
+ * \brief Get a rectangular block of raster cells
+ *
+ * Reads the block of <em>nrows</em> rows and <em>ncols</em> columns
+ * starting at window row <em>row</em> and window column <em>col</em>
+ * from the raster map open on file descriptor <em>fd</em> into
+ * <em>buf</em>. The block is stored row by row, i.e. the cell at
+ * block row i and block column j is at index i * ncols + j. Null
+ * values and the mask are handled like by Rast_get_row().
+ *
+ * The block is cut out of whole window rows read with Rast_get_row(),
+ * so reading a map block by block costs about the same as reading it
+ * row by row as long as the blocks of a row of blocks are read one
+ * after the other, since the last cell file row read is kept.
+ *
+ * \param fd file descriptor for the opened raster map
+ * \param buf buffer for nrows * ncols cells of type data_type
+ * \param row first window row of the block
+ * \param col first window column of the block
+ * \param nrows number of rows of the block
+ * \param ncols number of columns of the block
+ * \param data_type data type of buf
+ *
+ * \return void
+ */
+void Rast_get_tile(int fd, void *buf, int row, int col, int nrows, int ncols,
+                   RASTER_MAP_TYPE data_type)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    size_t size = Rast_cell_size(data_type);
+    void *row_buf;
+    int i;
+
+    if (row < 0 || col < 0 || nrows < 0 || ncols < 0 ||
+        row + nrows > R__.rd_window.rows || col + ncols > R__.rd_window.cols)
+        G_fatal_error(_("Reading raster map <%s@%s> request for block at row "
+                        "%d, column %d of %d x %d cells is outside region"),
+                      fcb->name, fcb->mapset, row, col, nrows, ncols);
+
+    row_buf = G_malloc(R__.rd_window.cols * size);
+
+    for (i = 0; i < nrows; i++) {
+        Rast_get_row(fd, row_buf, row + i, data_type);
+        memcpy(G_incr_void_ptr(buf, (size_t)i * ncols * size),
+               G_incr_void_ptr(row_buf, (size_t)col * size), ncols * size);
+    }
+
+    G_free(row_buf);
+}
+
+/*!
+ * \brief Get a block of consecutive raster rows
+ *
+ * Reads the <em>nrows</em> window rows starting at <em>row</em> from
+ * the raster map open on file descriptor <em>fd</em> into
+ * <em>buf</em>, which holds nrows * Rast_window_cols() cells of type
+ * <em>data_type</em>. Row i of the block starts at index
+ * i * Rast_window_cols(). Null values and the mask are handled like by
+ * Rast_get_row().
+ *
+ * The rows are read one by one with Rast_get_row(), the settings of
+ * the descriptor are left unchanged. Rows of compressed maps are
+ * decompressed in parallel if read-ahead of at least <em>nrows</em>
+ * rows is enabled on the descriptor, see Rast_set_read_ahead().
+ *
+ * \param fd file descriptor for the opened raster map
+ * \param buf buffer for nrows rows of type data_type
+ * \param row first window row of the block
+ * \param nrows number of rows of the block
+ * \param data_type data type of buf
+ *
+ * \return void
+ */
+void Rast_get_rows(int fd, void *buf, int row, int nrows,
+                   RASTER_MAP_TYPE data_type)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    size_t row_size = Rast_window_cols() * Rast_cell_size(data_type);
+    int i;
+
+    if (row < 0 || nrows < 0 || row + nrows > R__.rd_window.rows)
+        G_fatal_error(_("Reading raster map <%s@%s> request for rows %d to "
+                        "%d is outside region"),
+                      fcb->name, fcb->mapset, row, row + nrows - 1);
+
+    for (i = 0; i < nrows; i++)
+        Rast_get_row(fd, G_incr_void_ptr(buf, (size_t)i * row_size), row + i,
+                     data_type);
+}
+
 static int read_null_bits_compressed(int null_fd, unsigned char *flags, int row,
                                      size_t size, int fd)
 {
@@ -896,6 +1113,9 @@ int Rast__read_null_bits(int fd, int row, unsigned char *flags)
 
     size = Rast__null_bitstream_size(cols);
 
+    if (fcb->mapped && fcb->mapped->null)
+        return Rast__read_mapped_null_bits(fd, R, flags);
+
     if (fcb->null_row_ptr)
         return read_null_bits_compressed(null_fd, flags, R, size, fd);
 
@@ -993,29 +1213,48 @@ static void get_null_value_row_gdal(int fd, char *flags, int row)
 
 /*--------------------------------------------------------------------------*/
 
-static void embed_mask(char *flags, int row)
+static int read_mask_row(int mask_fd, CELL *mask_buf, int row)
 {
-    CELL *mask_buf = G_malloc(R__.rd_window.cols * sizeof(CELL));
-    int i;
+    if (get_map_row_nomask(mask_fd, mask_buf, row, CELL_TYPE) < 0)
+        return 0;
 
-    if (R__.auto_mask <= 0) {
-        G_free(mask_buf);
-        return;
+    if (R__.fileinfo[mask_fd].reclass_flag) {
+        embed_nulls(mask_fd, mask_buf, row, CELL_TYPE, 0, 0);
+        do_reclass_int(mask_fd, mask_buf, 1);
     }
 
-    if (get_map_row_nomask(R__.mask_fd, mask_buf, row, CELL_TYPE) < 0) {
-        G_free(mask_buf);
+    return 1;
+}
+
+static void embed_mask(int fd, char *flags, int row)
+{
+    CELL *mask_buf;
+    int mask_fd, ok;
+    int i;
+
+    if (R__.auto_mask <= 0)
         return;
-    }
 
-    if (R__.fileinfo[R__.mask_fd].reclass_flag) {
-        embed_nulls(R__.mask_fd, mask_buf, row, CELL_TYPE, 0, 0);
-        do_reclass_int(R__.mask_fd, mask_buf, 1);
+    mask_buf = G_malloc(R__.rd_window.cols * sizeof(CELL));
+
+    /* a mask reader of its own lets fd be read by several threads,
+       other maps share the mask descriptor one thread at a time */
+    mask_fd = R__.fileinfo[fd].mask_fd;
+    if (mask_fd >= 0)
+        ok = read_mask_row(mask_fd, mask_buf, row);
+    else {
+        /* the shared mask descriptor keeps its last row in its data and
+           null_bits buffers, with cur_row and null_cur_row, and reads
+           through one data_fd and null_fd file offset */
+#pragma omp critical(raster_mask)
+        ok = read_mask_row(R__.mask_fd, mask_buf, row);
     }
 
-    for (i = 0; i < R__.rd_window.cols; i++)
-        if (mask_buf[i] == 0 || Rast_is_c_null_value(&mask_buf[i]))
-            flags[i] = 1;
+    if (ok) {
+        for (i = 0; i < R__.rd_window.cols; i++)
+            if (mask_buf[i] == 0 || Rast_is_c_null_value(&mask_buf[i]))
+                flags[i] = 1;
+    }
 
     G_free(mask_buf);
 }
@@ -1030,14 +1269,14 @@ static void get_null_value_row(int fd, char *flags, int row, int with_mask)
         get_null_value_row_nomask(fd, flags, row);
 
     if (with_mask)
-        embed_mask(flags, row);
+        embed_mask(fd, flags, row);
 }
 
 static void embed_nulls(int fd, void *buf, int row, RASTER_MAP_TYPE map_type,
                         int null_is_zero, int with_mask)
 {
     struct fileinfo *fcb = &R__.fileinfo[fd];
-    size_t size = Rast_cell_size(map_type);
+    int cols = R__.rd_window.cols;
     char *null_buf;
     int i;
 
@@ -1047,19 +1286,45 @@ static void embed_nulls(int fd, void *buf, int row, RASTER_MAP_TYPE map_type,
         (R__.auto_mask <= 0 || !with_mask))
         return;
 
-    null_buf = G_malloc(R__.rd_window.cols);
+    null_buf = G_malloc(cols);
 
     get_null_value_row(fd, null_buf, row, with_mask);
 
-    for (i = 0; i < R__.rd_window.cols; i++) {
-        /* also check for nulls which might be already embedded by quant
-           rules in case of fp map. */
-        if (null_buf[i] || Rast_is_null_value(buf, map_type)) {
-            /* G__set_[f/d]_null_value() sets it to 0 is the embedded mode
-               is not set and calls G_set_[f/d]_null_value() otherwise */
-            Rast__set_null_value(buf, 1, null_is_zero, map_type);
-        }
-        buf = G_incr_void_ptr(buf, size);
+    /* also check for nulls which might be already embedded by quant
+       rules in case of fp map. Nulls are set to 0 if null_is_zero.
+       The loops are kept free of calls and branches so that they are
+       vectorized by the compiler. */
+    switch (map_type) {
+    case CELL_TYPE: {
+        CELL *c = buf;
+        CELL null_val;
+
+        Rast__set_null_value(&null_val, 1, null_is_zero, CELL_TYPE);
+        for (i = 0; i < cols; i++)
+            c[i] = (null_buf[i] | Rast_is_c_null_value(&c[i])) ? null_val
+                                                                : c[i];
+        break;
+    }
+    case FCELL_TYPE: {
+        FCELL *f = buf;
+        FCELL null_val;
+
+        Rast__set_null_value(&null_val, 1, null_is_zero, FCELL_TYPE);
+        for (i = 0; i < cols; i++)
+            f[i] = (null_buf[i] | Rast_is_f_null_value(&f[i])) ? null_val
+                                                                : f[i];
+        break;
+    }
+    case DCELL_TYPE: {
+        DCELL *d = buf;
+        DCELL null_val;
+
+        Rast__set_null_value(&null_val, 1, null_is_zero, DCELL_TYPE);
+        for (i = 0; i < cols; i++)
+            d[i] = (null_buf[i] | Rast_is_d_null_value(&d[i])) ? null_val
+                                                                : d[i];
+        break;
+    }
     }
 
     G_free(null_buf);
@@ -73,7 +73,7 @@ void Rast__error_handler(void *p G_UNUSED)
 
 static int init(void)
 {
-    char *nulls, *cname;
+    char *nulls, *cname, *rows, *mapped, *cache, *size;
 
     Rast__init_window();
 
@@ -86,6 +86,7 @@ static int init(void)
     /* Set masking flag unknown */
     R__.auto_mask = -1;
     R__.mask_fd = -1;
+    R__.mask_threads = 1;
 
     R__.nbytes = sizeof(CELL);
 
@@ -131,6 +132,27 @@ static int init(void)
     nulls = getenv("GRASS_COMPRESS_NULLS");
     R__.compress_nulls = (nulls && atoi(nulls) == 0) ? 0 : 1;
 
+    /* number of compressed rows to decompress in advance */
+    rows = getenv("GRASS_READ_AHEAD");
+    R__.read_ahead = (rows && atoi(rows) > 0) ? atoi(rows) : 0;
+
+    /* number of new rows to compress in the background */
+    rows = getenv("GRASS_WRITE_BEHIND");
+    R__.write_behind = (rows && atoi(rows) > 0) ? atoi(rows) : 0;
+
+    /* map the data files of raster maps opened for reading */
+    mapped = getenv("GRASS_RASTER_MMAP");
+    R__.use_mmap = (mapped && atoi(mapped) > 0) ? 1 : 0;
+
+    /* on-disk cache of decompressed rows, size limit in MB */
+    cache = getenv("GRASS_RASTER_CACHE");
+    size = getenv("GRASS_RASTER_CACHE_SIZE");
+    R__.row_cache_size = (size_t)((size && atoi(size) > 0) ? atoi(size) : 1024)
+                         << 20;
+    R__.row_cache_dir = (cache && *cache && strcmp(cache, "0") != 0)
+                            ? Rast__row_cache_dir(cache)
+                            : NULL;
+
     G_add_error_handler(Rast__error_handler, NULL);
 
     initialized = 1;
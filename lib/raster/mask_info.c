@@ -25,6 +25,8 @@
 #include <grass/raster.h>
 #include <grass/glocale.h>
 
+#include "R.h"
+
 /**
  * @brief Get a printable text with information about raster mask
  *
@@ -211,8 +213,8 @@ bool Rast_mask_is_present(void)
 /**
  * \brief Disable OpenMP if raster mask is present
  *
- * This helper function can be removed when raster reading is made
- * thread safe.
+ * \deprecated Raster maps can be read with the raster mask by several
+ * threads, use Rast_set_mask_threads() instead.
  *
  * \param nprocs number of threads to use
  * \return number of threads in use
@@ -235,3 +237,34 @@ int Rast_disable_omp_on_mask(int nprocs)
 
     return nprocs;
 }
+
+/**
+ * \brief Prepare reading with the raster mask by several threads
+ *
+ * Raster maps opened afterwards with Rast_open_old() by a module
+ * running <i>nprocs</i> threads read the raster mask through a mask
+ * reader of their own, so that they can be read by several threads at
+ * the same time. Descriptors from Rast_open_old_dup() always get one.
+ * Other maps share one mask descriptor, which threads read one at a
+ * time.
+ *
+ * Without OpenMP support, the number of threads is 1.
+ *
+ * \param nprocs number of threads to use
+ * \return number of threads in use
+ */
+int Rast_set_mask_threads(int nprocs)
+{
+#if !defined(_OPENMP)
+    nprocs = 1;
+#endif
+
+    Rast__init();
+    R__.mask_threads = nprocs;
+    if (nprocs > 1 && Rast_mask_is_present())
+        G_verbose_message(_("Raster mask is read by %d threads through "
+                            "a mask reader per raster map."),
+                          nprocs);
+
+    return nprocs;
+}
@@ -0,0 +1,259 @@
+/*!
+   \file lib/raster/mmap.c
+
+   \brief Raster library - Memory-mapped raster data files
+
+   The cell/fcell file and the null file of a raster map opened for
+   reading can be mapped into memory once. Rows of uncompressed maps
+   are then decoded directly from the mapping, rows of compressed maps
+   are expanded from the mapping, without any system call per row.
+   This speeds up modules reading rows in random order.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <grass/config.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+
+#include "R.h"
+
+/* map a whole file read-only, returns NULL on failure */
+static unsigned char *map_file(int fd, size_t *size, void **handle)
+{
+    struct stat st;
+    void *ptr;
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+        (unsigned long long)st.st_size > (size_t)-1)
+        return NULL;
+
+    *size = st.st_size;
+
+#ifdef _WIN32
+    *handle = CreateFileMapping((HANDLE)_get_osfhandle(fd), NULL,
+                                PAGE_READONLY, 0, 0, NULL);
+    if (!*handle)
+        return NULL;
+    ptr = MapViewOfFile(*handle, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        CloseHandle(*handle);
+        *handle = NULL;
+        return NULL;
+    }
+#else
+    *handle = NULL;
+    ptr = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, (off_t)0);
+    if (ptr == MAP_FAILED)
+        return NULL;
+#endif
+
+    return ptr;
+}
+
+static void unmap_file(unsigned char *ptr, size_t size, void *handle)
+{
+    if (!ptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(ptr);
+    CloseHandle(handle);
+#else
+    munmap(ptr, size);
+    (void)handle;
+#endif
+}
+
+/*!
+   \brief Get a row of a memory-mapped cell/fcell file
+
+   Called by read_data() for maps with memory mapping enabled. Rows of
+   uncompressed maps are not copied, the returned pointer points into
+   the mapping and is valid until the map is closed.
+
+   \param fd file descriptor for the opened raster map
+   \param row cell file row
+   \param data_buf buffer for a decompressed row
+   \param[out] nbytes number of bytes per cell of the row
+
+   \return pointer to the row data, either into the mapping or data_buf
+ */
+const unsigned char *Rast__get_mapped_row(int fd, int row,
+                                          unsigned char *data_buf, int *nbytes)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_mapped *mapped = fcb->mapped;
+    size_t bufsize = (size_t)fcb->cellhd.cols * fcb->nbytes;
+    off_t t1, t2;
+
+    if (!fcb->cellhd.compressed) {
+        if ((size_t)(row + 1) * bufsize > mapped->data_size)
+            G_fatal_error(_("Error reading raster data for row %d of <%s>"),
+                          row, fcb->name);
+
+        *nbytes = fcb->nbytes;
+
+        return mapped->data + (size_t)row * bufsize;
+    }
+
+    t1 = fcb->row_ptr[row];
+    t2 = fcb->row_ptr[row + 1];
+
+    if (t1 < 0 || t2 < t1 || (size_t)t2 > mapped->data_size)
+        G_fatal_error(_("Error reading raster data for row %d of <%s>"), row,
+                      fcb->name);
+
+    if (!Rast__expand_row(mapped->data + t1, t2 - t1, data_buf, nbytes,
+                          fcb->map_type, fcb->cellhd.compressed, fcb->nbytes,
+                          fcb->cellhd.cols))
+        G_fatal_error(_("Error uncompressing raster data for row %d of <%s>"),
+                      row, fcb->name);
+
+    return data_buf;
+}
+
+/*!
+   \brief Read a row of a memory-mapped null file
+
+   \param fd file descriptor for the opened raster map
+   \param row cell file row
+   \param[out] flags null bitstream of the row
+
+   \return 1
+ */
+int Rast__read_mapped_null_bits(int fd, int row, unsigned char *flags)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_mapped *mapped = fcb->mapped;
+    size_t size = Rast__null_bitstream_size(fcb->cellhd.cols);
+    off_t t1, t2;
+
+    if (!fcb->null_row_ptr) {
+        if ((size_t)(row + 1) * size > mapped->null_size)
+            G_fatal_error(_("Error reading null row %d for <%s>"), row,
+                          fcb->name);
+
+        memcpy(flags, mapped->null + (size_t)row * size, size);
+
+        return 1;
+    }
+
+    t1 = fcb->null_row_ptr[row];
+    t2 = fcb->null_row_ptr[row + 1];
+
+    if (t1 < 0 || t2 < t1 || (size_t)t2 > mapped->null_size)
+        G_fatal_error(
+            _("Error reading compressed null data for row %d of <%s>"), row,
+            fcb->name);
+
+    if ((size_t)(t2 - t1) == size)
+        memcpy(flags, mapped->null + t1, size);
+    /* null bits file compressed with LZ4, see lib/gis/compress.h */
+    else if (G_lz4_expand(mapped->null + t1, t2 - t1, flags, size) < 1)
+        G_fatal_error(_("Error uncompressing null data for row %d of <%s>"),
+                      row, fcb->name);
+
+    return 1;
+}
+
+/*!
+   \brief Unmap the data files of a raster map
+
+   Called when the map is closed.
+
+   \param fd file descriptor for the opened raster map
+ */
+void Rast__free_mmap(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_mapped *mapped = fcb->mapped;
+
+    if (!mapped)
+        return;
+
+    unmap_file(mapped->data, mapped->data_size, mapped->data_handle);
+    unmap_file(mapped->null, mapped->null_size, mapped->null_handle);
+
+    G_free(mapped);
+    fcb->mapped = NULL;
+    fcb->cur_row = -1;
+}
+
+/*!
+   \brief Enable memory mapping for a raster map
+
+   Maps the cell/fcell file and the null file of the raster map open
+   on <i>fd</i> into memory. Rows are then read without a system call
+   per row, and rows of uncompressed maps without an intermediate
+   copy. This mostly benefits modules reading rows in random order.
+   Compressed maps are supported too, which is most effective for
+   LZ4 compression.
+
+   The default for newly opened maps can be set with the environment
+   variable GRASS_RASTER_MMAP.
+
+   Maps linked with r.external or r.buildvrt are not affected. If a
+   file cannot be mapped, it is read with regular I/O.
+
+   \param fd file descriptor for the opened raster map
+   \param enable 1 to enable, 0 to disable memory mapping
+
+   \return 1 if memory mapping is enabled
+   \return 0 otherwise
+ */
+int Rast_set_mmap(int fd, int enable)
+{
+    struct fileinfo *fcb;
+    struct R_mapped *mapped;
+
+    if (fd < 0 || fd >= R__.fileinfo_count ||
+        R__.fileinfo[fd].open_mode != OPEN_OLD)
+        G_fatal_error(_("Invalid descriptor: %d"), fd);
+
+    fcb = &R__.fileinfo[fd];
+
+    Rast__free_mmap(fd);
+
+    if (!enable || fcb->gdal || fcb->vrt)
+        return 0;
+
+    mapped = G_calloc(1, sizeof(struct R_mapped));
+
+    mapped->data = map_file(fcb->data_fd, &mapped->data_size,
+                            &mapped->data_handle);
+    if (!mapped->data) {
+        G_debug(1, "Unable to map raster data file of <%s>", fcb->name);
+        G_free(mapped);
+        return 0;
+    }
+
+    if (fcb->null_fd >= 0) {
+        mapped->null = map_file(fcb->null_fd, &mapped->null_size,
+                                &mapped->null_handle);
+        if (!mapped->null)
+            G_debug(1, "Unable to map null file of <%s>", fcb->name);
+    }
+
+    G_debug(1, "Raster data files of <%s> mapped into memory", fcb->name);
+
+    fcb->mapped = mapped;
+    /* the row in memory may be in fcb->data or in the mapping */
+    fcb->cur_row = -1;
+
+    return 1;
+}
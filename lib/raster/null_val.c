@@ -419,29 +419,28 @@ int G__set_flags_from_01_random(const char *zero_ones, unsigned char *flags,
  */
 void Rast__convert_01_flags(const char *zero_ones, unsigned char *flags, int n)
 {
-    unsigned char *v;
-    int count;
-    int size;
+    int full = n / 8;
     int i, k;
 
-    /* pad the flags with 0's to make size multiple of 8 */
-    v = flags;
-    size = Rast__null_bitstream_size(n);
-    count = 0;
+    /* whole bytes, without per bit checks so that the loop is unrolled */
+    for (i = 0; i < full; i++) {
+        const char *z = &zero_ones[i * 8];
+        unsigned char v = 0;
 
-    for (i = 0; i < size; i++) {
-        *v = 0;
-        k = 8;
+        for (k = 0; k < 8; k++)
+            v |= (unsigned char)z[k] << (7 - k);
 
-        while (k-- > 0) {
-            if (count < n) {
-                *v = *v | ((unsigned char)zero_ones[count] << k);
-            }
+        flags[i] = v;
+    }
 
-            count++;
-        }
+    /* pad the flags with 0's to make size multiple of 8 */
+    if (n % 8) {
+        unsigned char v = 0;
+
+        for (k = 0; k < n % 8; k++)
+            v |= (unsigned char)zero_ones[full * 8 + k] << (7 - k);
 
-        v++;
+        flags[full] = v;
     }
 }
 
@@ -456,27 +455,10 @@ void Rast__convert_01_flags(const char *zero_ones, unsigned char *flags, int n)
  */
 void Rast__convert_flags_01(char *zero_ones, const unsigned char *flags, int n)
 {
-    const unsigned char *v;
-    int count;
-    int size;
-    int i, k;
-
-    count = 0;
-    v = flags;
-    size = Rast__null_bitstream_size(n);
-
-    for (i = 0; i < size; i++) {
-        k = 8;
-
-        while (k-- > 0) {
-            if (count < n) {
-                zero_ones[count] = ((*v & ((unsigned char)1 << k)) != 0);
-                count++;
-            }
-        }
+    int i;
 
-        v++;
-    }
+    for (i = 0; i < n; i++)
+        zero_ones[i] = (flags[i >> 3] >> (7 - (i & 7))) & 1;
 }
 
 /*!
@@ -489,22 +471,9 @@ void Rast__convert_flags_01(char *zero_ones, const unsigned char *flags, int n)
  */
 void Rast__init_null_bits(unsigned char *flags, int cols)
 {
-    unsigned char *v;
-    int size;
-    int i;
+    memset(flags, 255, cols / 8);
 
     /* pad the flags with 0's to make size multiple of 8 */
-    v = flags;
-    size = Rast__null_bitstream_size(cols);
-
-    for (i = 0; i < size; i++) {
-        if ((i + 1) * 8 <= cols) {
-            *v = (unsigned char)255;
-        }
-        else {
-            *v = (unsigned char)255 << ((i + 1) * 8 - cols);
-        }
-
-        v++;
-    }
+    if (cols % 8)
+        flags[cols / 8] = (unsigned char)255 << (8 - cols % 8);
 }
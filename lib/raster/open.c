@@ -40,6 +40,7 @@ static int new_fileinfo(void)
         if (R__.fileinfo[i].open_mode <= 0) {
             memset(&R__.fileinfo[i], 0, sizeof(struct fileinfo));
             R__.fileinfo[i].open_mode = -1;
+            R__.fileinfo[i].mask_fd = -1;
             return i;
         }
 
@@ -54,6 +55,7 @@ static int new_fileinfo(void)
     for (i = oldsize; i < newsize; i++) {
         memset(&R__.fileinfo[i], 0, sizeof(struct fileinfo));
         R__.fileinfo[i].open_mode = -1;
+        R__.fileinfo[i].mask_fd = -1;
     }
 
     R__.fileinfo_count = newsize;
@@ -111,6 +113,7 @@ static int open_raster_new(const char *name, int open_mode,
 int Rast_open_old(const char *name, const char *mapset)
 {
     int fd = Rast__open_old(name, mapset);
+    int mask_fd;
 
     /* turn on auto masking, if not already on */
     Rast__check_for_auto_masking();
@@ -122,6 +125,14 @@ int Rast_open_old(const char *name, const char *mapset)
     /* mask_buf is used for reading mask file when mask is set and
        for reading map rows when the null file doesn't exist */
 
+    /* own mask reader only if the map may be read by several threads,
+       see Rast_set_mask_threads(); R__.fileinfo may be moved by the
+       open */
+    if (R__.mask_threads > 1) {
+        mask_fd = Rast__open_mask_reader();
+        R__.fileinfo[fd].mask_fd = mask_fd;
+    }
+
     return fd;
 }
 
@@ -378,9 +389,182 @@ int Rast__open_old(const char *name, const char *mapset)
         fcb->null_file_exists = fcb->null_fd >= 0;
     }
 
+    if (R__.read_ahead > 0)
+        Rast_set_read_ahead(fd, R__.read_ahead);
+
+    if (R__.use_mmap)
+        Rast_set_mmap(fd, 1);
+
+    if (R__.row_cache_dir)
+        Rast_set_row_cache(fd, 1);
+
     return fd;
 }
 
+/*!
+   \brief Open another descriptor for a raster map open for reading
+
+   The new descriptor reads the same raster map as <i>fd</i>, but has
+   its own row buffers and its own file descriptors for the cell/fcell
+   file and the null file. The row addresses, the quantization rules
+   and the reclass table are shared with <i>fd</i> instead of being
+   read again. Rows can then be read through both descriptors by
+   different threads at the same time, e.g. through one descriptor per
+   OpenMP thread, without locking.
+
+   The new descriptor still costs one entry in the table of open maps,
+   a row buffer of the cell file width times the bytes per cell, a null
+   row of one bit per cell file column, and one or two open files. If
+   enabled on <i>fd</i>, it also gets its own read-ahead ring buffer,
+   memory mapping and row cache file descriptor. The column mapping of
+   the window is shared with other maps of the same grid, see
+   Rast__create_window_mapping().
+
+   The descriptors must be created before the threads start reading,
+   since opening and closing raster maps is not thread-safe. If a raster
+   mask is active, both descriptors read it through a mask reader of
+   their own as well, each costing the same as a new descriptor.
+
+   Maps linked with r.external or r.buildvrt are opened again by name.
+
+   All descriptors are closed with Rast_close(), in any order.
+
+   \param fd file descriptor of a raster map opened for reading
+
+   \return new file descriptor
+ */
+int Rast_open_old_dup(int fd)
+{
+    int dup_fd = Rast__open_old_dup(fd);
+    int mask_fd;
+
+    /* the mask itself is read without masking, see
+       Rast__open_mask_reader() */
+    if (fd == R__.mask_fd)
+        return dup_fd;
+
+    /* both descriptors are meant to be read by different threads, so
+       both read the mask through a reader of their own; R__.fileinfo
+       may be moved by the open */
+    if (R__.fileinfo[fd].mask_fd < 0) {
+        mask_fd = Rast__open_mask_reader();
+        R__.fileinfo[fd].mask_fd = mask_fd;
+    }
+    if (R__.fileinfo[dup_fd].mask_fd < 0) {
+        mask_fd = Rast__open_mask_reader();
+        R__.fileinfo[dup_fd].mask_fd = mask_fd;
+    }
+
+    return dup_fd;
+}
+
+/*!
+   \brief Lower level function, open another descriptor for a raster map
+
+   Same as Rast_open_old_dup(), but no mask reader is attached to
+   either descriptor. Used to open the mask readers themselves.
+
+   \param fd file descriptor of a raster map opened for reading
+
+   \return new file descriptor
+ */
+int Rast__open_old_dup(int fd)
+{
+    struct fileinfo *fcb, *src;
+    const char *r_name;
+    const char *r_mapset;
+    int dup_fd;
+
+    if (fd < 0 || fd >= R__.fileinfo_count ||
+        R__.fileinfo[fd].open_mode != OPEN_OLD)
+        G_fatal_error(_("Invalid descriptor: %d"), fd);
+
+    src = &R__.fileinfo[fd];
+    if (src->gdal || src->vrt)
+        return Rast__open_old(src->name, src->mapset);
+
+    /* the fp lookup table is otherwise organized on first use */
+    if (src->map_type != CELL_TYPE && !src->quant.truncate_only &&
+        !src->quant.round_only && !src->quant.fp_lookup.active)
+        Rast__quant_organize_fp_lookup(&src->quant);
+
+    if (!src->shared_refs) {
+        src->shared_refs = G_malloc(sizeof(int));
+        *src->shared_refs = 1;
+    }
+
+    dup_fd = new_fileinfo();
+    /* R__.fileinfo may have been moved */
+    src = &R__.fileinfo[fd];
+    fcb = &R__.fileinfo[dup_fd];
+
+    /* shared with fd */
+    fcb->cellhd = src->cellhd;
+    fcb->map_type = src->map_type;
+    fcb->nbytes = src->nbytes;
+    fcb->row_ptr = src->row_ptr;
+    fcb->null_row_ptr = src->null_row_ptr;
+    fcb->null_file_exists = src->null_file_exists;
+    fcb->quant = src->quant;
+    if ((fcb->reclass_flag = src->reclass_flag))
+        fcb->reclass = src->reclass;
+    fcb->shared_refs = src->shared_refs;
+    (*fcb->shared_refs)++;
+
+    /* private to the new descriptor */
+    fcb->name = G_store(src->name);
+    fcb->mapset = G_store(src->mapset);
+    fcb->cur_row = -1;
+    fcb->null_cur_row = -1;
+    fcb->data = (unsigned char *)G_calloc(fcb->cellhd.cols, fcb->nbytes);
+    fcb->null_bits = Rast__allocate_null_bits(fcb->cellhd.cols);
+
+    if (fcb->reclass_flag) {
+        r_name = fcb->reclass.name;
+        r_mapset = fcb->reclass.mapset;
+    }
+    else {
+        r_name = fcb->name;
+        r_mapset = fcb->mapset;
+    }
+
+    /* file offsets cannot be shared between threads */
+    fcb->data_fd = G_open_old(fcb->map_type == CELL_TYPE ? "cell" : "fcell",
+                              r_name, r_mapset);
+    if (fcb->data_fd < 0)
+        G_fatal_error(_("Unable to open %s file for raster map <%s@%s>"),
+                      fcb->map_type == CELL_TYPE ? "cell" : "fcell", r_name,
+                      r_mapset);
+
+    fcb->null_fd = -1;
+    if (src->null_fd >= 0) {
+        fcb->null_fd =
+            G_open_old_misc("cell_misc", fcb->null_row_ptr ? NULLC_FILE
+                                                           : NULL_FILE,
+                            r_name, r_mapset);
+        if (fcb->null_fd < 0)
+            G_fatal_error(_("Unable to open null file for raster map <%s@%s>"),
+                          r_name, r_mapset);
+    }
+
+    /* mark closed until the window mapping is created */
+    fcb->open_mode = -1;
+    Rast__create_window_mapping(dup_fd);
+    fcb->open_mode = OPEN_OLD;
+    fcb->io_error = 0;
+
+    if (src->read_ahead)
+        Rast_set_read_ahead(dup_fd, src->read_ahead->nslots);
+
+    if (src->mapped)
+        Rast_set_mmap(dup_fd, 1);
+
+    if (src->row_cache)
+        Rast_set_row_cache(dup_fd, 1);
+
+    return dup_fd;
+}
+
 /*!
    \brief Opens a new cell file in a database (compressed)
 
@@ -746,6 +930,9 @@ static int open_raster_new(const char *name, int open_mode,
     fcb->open_mode = open_mode;
     fcb->io_error = 0;
 
+    if (R__.write_behind > 0)
+        Rast_set_write_behind(fd, R__.write_behind);
+
     return fd;
 }
 
@@ -15,6 +15,7 @@
 
  **********************************************************************/
 
+#include <stdint.h>
 #include <string.h>
 
 #include <sys/types.h>
@@ -147,43 +148,60 @@ static void set_file_pointer(int fd, int row)
     }
 }
 
-static void convert_float(float *work_buf, char *null_buf, const FCELL *rast,
-                          int n)
+/* encode XDR (big endian IEEE) values; written without a test for the
+   host byte order so that the compiler turns them into byte swaps */
+static void xdr_put_float(unsigned char *p, FCELL f)
+{
+    uint32_t u;
+
+    memcpy(&u, &f, sizeof(u));
+    p[0] = u >> 24;
+    p[1] = u >> 16;
+    p[2] = u >> 8;
+    p[3] = u;
+}
+
+static void xdr_put_double(unsigned char *p, DCELL d)
+{
+    uint64_t u;
+
+    memcpy(&u, &d, sizeof(u));
+    p[0] = u >> 56;
+    p[1] = u >> 48;
+    p[2] = u >> 40;
+    p[3] = u >> 32;
+    p[4] = u >> 24;
+    p[5] = u >> 16;
+    p[6] = u >> 8;
+    p[7] = u;
+}
+
+static void convert_float(unsigned char *work_buf, char *null_buf,
+                          const FCELL *rast, int n)
 {
     int i;
 
     for (i = 0; i < n; i++) {
-        FCELL f;
+        int is_null = Rast_is_f_null_value(&rast[i]);
 
         /* substitute embedded null vals by 0's */
-        if (Rast_is_f_null_value(&rast[i])) {
-            f = 0.;
-            null_buf[i] = 1;
-        }
-        else
-            f = rast[i];
-
-        G_xdr_put_float(&work_buf[i], &f);
+        null_buf[i] |= is_null;
+        xdr_put_float(&work_buf[i * XDR_FLOAT_NBYTES], is_null ? 0 : rast[i]);
     }
 }
 
-static void convert_double(double *work_buf, char *null_buf, const DCELL *rast,
-                           int n)
+static void convert_double(unsigned char *work_buf, char *null_buf,
+                           const DCELL *rast, int n)
 {
     int i;
 
     for (i = 0; i < n; i++) {
-        DCELL d;
+        int is_null = Rast_is_d_null_value(&rast[i]);
 
         /* substitute embedded null vals by 0's */
-        if (Rast_is_d_null_value(&rast[i])) {
-            d = 0.;
-            null_buf[i] = 1;
-        }
-        else
-            d = rast[i];
-
-        G_xdr_put_double(&work_buf[i], &d);
+        null_buf[i] |= is_null;
+        xdr_put_double(&work_buf[i * XDR_DOUBLE_NBYTES],
+                       is_null ? 0 : rast[i]);
     }
 }
 
@@ -194,6 +212,7 @@ static void put_fp_data(int fd, char *null_buf, const void *rast, int row,
     struct fileinfo *fcb = &R__.fileinfo[fd];
     int compressed = (fcb->open_mode == OPEN_NEW_COMPRESSED);
     int size = fcb->nbytes * fcb->cellhd.cols;
+    struct R_write_behind_slot *slot = NULL;
     void *work_buf;
 
     if (row < 0 || row >= fcb->cellhd.rows)
@@ -202,9 +221,15 @@ static void put_fp_data(int fd, char *null_buf, const void *rast, int row,
     if (n <= 0)
         return;
 
-    work_buf = G_malloc(size + 1);
+    if (fcb->write_behind) {
+        slot = Rast__get_write_behind_slot(fd, fcb->write_behind);
+        Rast__write_behind_stats(slot, rast, n, data_type, 0, 0);
+        work_buf = slot->src;
+    }
+    else
+        work_buf = G_malloc(size + 1);
 
-    if (compressed)
+    if (compressed && !slot)
         set_file_pointer(fd, row);
 
     if (data_type == FCELL_TYPE)
@@ -212,6 +237,13 @@ static void put_fp_data(int fd, char *null_buf, const void *rast, int row,
     else
         convert_double(work_buf, null_buf, rast, n);
 
+    if (slot) {
+        /* compressed and written later */
+        Rast__queue_write_behind(fcb->write_behind, slot, row,
+                                 fcb->nbytes * n);
+        return;
+    }
+
     if (compressed)
         write_data_compressed(fd, row, work_buf, n, fcb->cellhd.compressed);
     else
@@ -333,12 +365,66 @@ static int rle_compress(unsigned char *dst, unsigned char *src, int n,
     return (nwrite >= total) ? 0 : nwrite;
 }
 
+/* compress a queued row of a CELL map, called by a worker thread */
+static void compress_cell_row(struct R_write_behind_slot *slot)
+{
+    int nbytes = slot->src[0];
+    int total = slot->src_size - 1;
+    int nwrite;
+
+    slot->dst[0] = nbytes;
+
+    if (slot->wb->compressor == 1)
+        nwrite = rle_compress(slot->dst + 1, slot->src + 1, total / nbytes,
+                              nbytes);
+    else
+        nwrite = G_compress(slot->src + 1, total, slot->dst + 1,
+                            slot->dst_size - 1, slot->wb->compressor);
+
+    if (nwrite > 0 && nwrite < total) {
+        slot->out = slot->dst;
+        slot->out_size = nwrite + 1;
+    }
+    else {
+        slot->out = slot->src;
+        slot->out_size = total + 1;
+    }
+}
+
+/* compress a queued row of a FCELL/DCELL map, called by a worker thread */
+static void compress_fp_row(struct R_write_behind_slot *slot)
+{
+    slot->out = slot->dst;
+    slot->out_size = G_compress_chunk(slot->src, slot->src_size, slot->dst,
+                                      slot->dst_size, slot->wb->compressor);
+}
+
+/* compress a queued row of a null file, called by a worker thread */
+static void compress_null_row(struct R_write_behind_slot *slot)
+{
+    int nwrite;
+
+    /* compress null bits file with LZ4, see lib/gis/compress.h */
+    nwrite = G_compress(slot->src, slot->src_size, slot->dst, slot->dst_size,
+                        3);
+
+    if (nwrite > 0 && nwrite < slot->src_size) {
+        slot->out = slot->dst;
+        slot->out_size = nwrite;
+    }
+    else {
+        slot->out = slot->src;
+        slot->out_size = slot->src_size;
+    }
+}
+
 static void put_data(int fd, char *null_buf, const CELL *cell, int row, int n,
                      int zeros_r_nulls)
 {
     struct fileinfo *fcb = &R__.fileinfo[fd];
     int compressed = (fcb->open_mode == OPEN_NEW_COMPRESSED);
     int len = compressed ? (int)sizeof(CELL) : fcb->nbytes;
+    struct R_write_behind_slot *slot = NULL;
     unsigned char *work_buf, *wk;
     ssize_t nwrite;
 
@@ -348,10 +434,17 @@ static void put_data(int fd, char *null_buf, const CELL *cell, int row, int n,
     if (n <= 0)
         return;
 
-    work_buf = G_malloc(fcb->cellhd.cols * sizeof(CELL) + 1);
+    if (fcb->write_behind) {
+        slot = Rast__get_write_behind_slot(fd, fcb->write_behind);
+        Rast__write_behind_stats(slot, cell, n, CELL_TYPE, zeros_r_nulls,
+                                 fcb->want_histogram);
+        work_buf = slot->src;
+    }
+    else
+        work_buf = G_malloc(fcb->cellhd.cols * sizeof(CELL) + 1);
     wk = work_buf;
 
-    if (compressed)
+    if (compressed && !slot)
         set_file_pointer(fd, row);
 
     if (compressed)
@@ -372,6 +465,14 @@ static void put_data(int fd, char *null_buf, const CELL *cell, int row, int n,
             trim_bytes(wk, n, len, len - nbytes);
 
         total = nbytes * n;
+
+        if (slot) {
+            /* compressed and written later */
+            work_buf[0] = nbytes;
+            Rast__queue_write_behind(fcb->write_behind, slot, row, total + 1);
+            return;
+        }
+
         /* get upper bound of compressed size */
         if (fcb->cellhd.compressed == 1)
             cmax = total;
@@ -568,6 +669,16 @@ void Rast__write_null_bits(int fd, const unsigned char *flags)
 
     size = Rast__null_bitstream_size(fcb->cellhd.cols);
 
+    if (fcb->null_write_behind) {
+        struct R_write_behind_slot *slot =
+            Rast__get_write_behind_slot(fd, fcb->null_write_behind);
+
+        /* compressed and written later */
+        memcpy(slot->src, flags, size);
+        Rast__queue_write_behind(fcb->null_write_behind, slot, row, size);
+        return;
+    }
+
     if (fcb->null_row_ptr) {
         write_null_bits_compressed(flags, row, size, fd);
         return;
@@ -729,16 +840,20 @@ static void put_raster_row(int fd, const void *buf, RASTER_MAP_TYPE data_type,
     put_raster_data(fd, null_buf, buf, fcb->cur_row, fcb->cellhd.cols,
                     zeros_r_nulls, data_type);
 
-    /* only for integer maps */
-    if (data_type == CELL_TYPE) {
-        if (fcb->want_histogram)
-            Rast_update_cell_stats(buf, fcb->cellhd.cols, &fcb->statf);
-        Rast__row_update_range(buf, fcb->cellhd.cols, &fcb->range,
-                               zeros_r_nulls);
+    /* with background compression, the statistics are collected when
+       the row is written, see Rast__write_behind_stats() */
+    if (!fcb->write_behind) {
+        /* only for integer maps */
+        if (data_type == CELL_TYPE) {
+            if (fcb->want_histogram)
+                Rast_update_cell_stats(buf, fcb->cellhd.cols, &fcb->statf);
+            Rast__row_update_range(buf, fcb->cellhd.cols, &fcb->range,
+                                   zeros_r_nulls);
+        }
+        else
+            Rast_row_update_fp_range(buf, fcb->cellhd.cols, &fcb->fp_range,
+                                     data_type);
     }
-    else
-        Rast_row_update_fp_range(buf, fcb->cellhd.cols, &fcb->fp_range,
-                                 data_type);
 
     fcb->cur_row++;
 
@@ -748,3 +863,79 @@ static void put_raster_row(int fd, const void *buf, RASTER_MAP_TYPE data_type,
 
     G_free(null_buf);
 }
+
+/*!
+   \brief Compress rows of a new raster map in the background
+
+   Rows written with the Rast_put_row() family of functions to the
+   compressed raster map open on <i>fd</i> are compressed by worker
+   threads, up to <i>nrows</i> rows behind the last row written. The
+   rows are written to the file in order by the calling thread, so
+   the resulting map is identical to a map written without
+   background compression. This applies to the compressed null file
+   too. The number of worker threads is set with the environment
+   variable WORKERS; without workers, background compression is not
+   enabled.
+
+   The default for newly opened maps can be set with the environment
+   variable GRASS_WRITE_BEHIND.
+
+   \param fd file descriptor for the raster map opened for writing
+   \param nrows number of rows to compress in the background, 0 to
+   disable background compression
+
+   \return 1 if background compression is enabled
+   \return 0 otherwise
+ */
+int Rast_set_write_behind(int fd, int nrows)
+{
+    struct fileinfo *fcb;
+    int cols;
+
+    if (fd < 0 || fd >= R__.fileinfo_count ||
+        (R__.fileinfo[fd].open_mode != OPEN_NEW_COMPRESSED &&
+         R__.fileinfo[fd].open_mode != OPEN_NEW_UNCOMPRESSED))
+        G_fatal_error(_("Invalid descriptor: %d"), fd);
+
+    fcb = &R__.fileinfo[fd];
+
+    /* rows already queued are written before the queue is changed */
+    Rast__flush_write_behind(fd);
+    Rast__free_write_behind(fd);
+
+    if (nrows <= 0 || fcb->gdal)
+        return 0;
+
+    if (fcb->open_mode != OPEN_NEW_COMPRESSED && !fcb->null_row_ptr)
+        return 0;
+
+    G_init_workers();
+    if (G_num_workers() < 1) {
+        G_debug(1, "No worker threads, background compression disabled for "
+                   "<%s>",
+                fcb->name);
+        return 0;
+    }
+
+    G_debug(1, "Compressing %d rows in the background for <%s>", nrows,
+            fcb->name);
+
+    cols = fcb->cellhd.cols;
+
+    if (fcb->open_mode == OPEN_NEW_COMPRESSED) {
+        if (fcb->map_type == CELL_TYPE)
+            fcb->write_behind = Rast__create_write_behind(
+                nrows, cols * sizeof(CELL) + 1, fcb->cellhd.compressed,
+                compress_cell_row, 0);
+        else
+            fcb->write_behind = Rast__create_write_behind(
+                nrows, cols * fcb->nbytes, fcb->cellhd.compressed,
+                compress_fp_row, 0);
+    }
+
+    if (fcb->null_row_ptr)
+        fcb->null_write_behind = Rast__create_write_behind(
+            nrows, Rast__null_bitstream_size(cols), 3, compress_null_row, 1);
+
+    return 1;
+}
@@ -12,6 +12,7 @@
  */
 
 #include <unistd.h>
+#include <limits.h>
 
 #include <grass/raster.h>
 #include <grass/glocale.h>
@@ -594,6 +595,12 @@ void Rast_row_update_range(const CELL *cell, int n, struct Range *range)
     Rast__row_update_range(cell, n, range, 0);
 }
 
+/* the sums of a row continue those of range in cell order, so that
+   they do not depend on how the values are split into rows; -0.0
+   keeps the first value as it is */
+#define FIRST_SUM(range, field) \
+    ((range)->first_time ? -0.0 : (range)->rstats.field)
+
 /*!
  * \brief Update range structure based on raster row
  *
@@ -607,34 +614,200 @@ void Rast_row_update_range(const CELL *cell, int n, struct Range *range)
 void Rast__row_update_range(const CELL *cell, int n, struct Range *range,
                             int ignore_zeros)
 {
-    CELL cat;
+    int zeros = ignore_zeros != 0;
+    CELL low = INT_MAX, high = INT_MIN;
+    DCELL sum, sumsq;
+    int count = 0;
+    int i;
+
+    /* the extremes are reduced in local variables, which the compiler
+       can keep in vector registers */
+#if defined(_OPENMP)
+#pragma omp simd reduction(min : low) reduction(max : high) \
+    reduction(+ : count)
+#endif
+    for (i = 0; i < n; i++) {
+        CELL cat = cell[i];
+        int skip = Rast_is_c_null_value(&cat) | (zeros & (cat == 0));
+        CELL lo = skip ? INT_MAX : cat;
+        CELL hi = skip ? INT_MIN : cat;
+
+        low = lo < low ? lo : low;
+        high = hi > high ? hi : high;
+        count += !skip;
+    }
+
+    if (count == 0)
+        return;
 
-    while (n-- > 0) {
-        cat = *cell++;
-        if (Rast_is_c_null_value(&cat) || (ignore_zeros && !cat))
+    sum = FIRST_SUM(range, sum);
+    sumsq = FIRST_SUM(range, sumsq);
+    for (i = 0; i < n; i++) {
+        if (Rast_is_c_null_value(&cell[i]) || (zeros && cell[i] == 0))
             continue;
-        if (range->first_time) {
-            range->first_time = 0;
-            range->min = cat;
-            range->max = cat;
+        sum += cell[i];
+        sumsq += (DCELL)cell[i] * cell[i];
+    }
+
+    if (range->first_time) {
+        range->first_time = 0;
+        range->min = low;
+        range->max = high;
+        range->rstats.count = 0;
+    }
+    else {
+        if (low < range->min)
+            range->min = low;
+        if (high > range->max)
+            range->max = high;
+    }
+
+    range->rstats.sum = sum;
+    range->rstats.sumsq = sumsq;
+    range->rstats.count += count;
+}
+
+/* extends range by the extremes and the sums of a row */
+static void update_fp_range(struct FPRange *range, DCELL low, DCELL high,
+                            DCELL sum, DCELL sumsq, int count)
+{
+    if (range->first_time) {
+        range->first_time = 0;
+        range->min = low;
+        range->max = high;
+        range->rstats.count = 0;
+    }
+    else {
+        if (low < range->min)
+            range->min = low;
+        if (high > range->max)
+            range->max = high;
+    }
+
+    range->rstats.sum = sum;
+    range->rstats.sumsq = sumsq;
+    range->rstats.count += count;
+}
+
+static void row_update_c_fp_range(const CELL *cell, int n,
+                                  struct FPRange *range)
+{
+    CELL low = INT_MAX, high = INT_MIN;
+    DCELL sum, sumsq;
+    int count = 0;
+    int i;
 
-            range->rstats.sum = cat;
-            range->rstats.sumsq = (DCELL)cat * cat;
+#if defined(_OPENMP)
+#pragma omp simd reduction(min : low) reduction(max : high) \
+    reduction(+ : count)
+#endif
+    for (i = 0; i < n; i++) {
+        CELL cat = cell[i];
+        int skip = Rast_is_c_null_value(&cat);
+        CELL lo = skip ? INT_MAX : cat;
 
-            range->rstats.count = 1;
+        /* NULL is the smallest CELL value */
+        low = lo < low ? lo : low;
+        high = cat > high ? cat : high;
+        count += !skip;
+    }
+
+    if (count == 0)
+        return;
 
+    sum = FIRST_SUM(range, sum);
+    sumsq = FIRST_SUM(range, sumsq);
+    for (i = 0; i < n; i++) {
+        DCELL val = cell[i];
+
+        if (Rast_is_c_null_value(&cell[i]))
             continue;
-        }
-        if (cat < range->min)
-            range->min = cat;
-        if (cat > range->max)
-            range->max = cat;
+        sum += val;
+        sumsq += val * val;
+    }
+
+    update_fp_range(range, low, high, sum, sumsq, count);
+}
+
+/* NULL (NaN) values never compare less or greater than low and high */
+static void row_update_f_fp_range(const FCELL *fcell, int n,
+                                  struct FPRange *range)
+{
+    FCELL low = fcell[0], high = fcell[0];
+    DCELL sum, sumsq;
+    int count = 0;
+    int i;
+
+    for (i = 1; i < n && Rast_is_f_null_value(&low); i++)
+        low = high = fcell[i];
+
+#if defined(_OPENMP)
+#pragma omp simd reduction(min : low) reduction(max : high) \
+    reduction(+ : count)
+#endif
+    for (i = 0; i < n; i++) {
+        FCELL v = fcell[i];
+
+        low = v < low ? v : low;
+        high = v > high ? v : high;
+        count += !Rast_is_f_null_value(&v);
+    }
+
+    if (count == 0)
+        return;
+
+    sum = FIRST_SUM(range, sum);
+    sumsq = FIRST_SUM(range, sumsq);
+    for (i = 0; i < n; i++) {
+        DCELL val = fcell[i];
 
-        range->rstats.sum += cat;
-        range->rstats.sumsq += (DCELL)cat * cat;
+        if (Rast_is_f_null_value(&fcell[i]))
+            continue;
+        sum += val;
+        sumsq += val * val;
+    }
+
+    update_fp_range(range, low, high, sum, sumsq, count);
+}
+
+static void row_update_d_fp_range(const DCELL *dcell, int n,
+                                  struct FPRange *range)
+{
+    DCELL low = dcell[0], high = dcell[0];
+    DCELL sum, sumsq;
+    int count = 0;
+    int i;
+
+    for (i = 1; i < n && Rast_is_d_null_value(&low); i++)
+        low = high = dcell[i];
+
+#if defined(_OPENMP)
+#pragma omp simd reduction(min : low) reduction(max : high) \
+    reduction(+ : count)
+#endif
+    for (i = 0; i < n; i++) {
+        DCELL v = dcell[i];
+
+        low = v < low ? v : low;
+        high = v > high ? v : high;
+        count += !Rast_is_d_null_value(&v);
+    }
+
+    if (count == 0)
+        return;
 
-        range->rstats.count += 1;
+    sum = FIRST_SUM(range, sum);
+    sumsq = FIRST_SUM(range, sumsq);
+    for (i = 0; i < n; i++) {
+        DCELL val = dcell[i];
+
+        if (Rast_is_d_null_value(&dcell[i]))
+            continue;
+        sum += val;
+        sumsq += val * val;
     }
+
+    update_fp_range(range, low, high, sum, sumsq, count);
 }
 
 /*!
@@ -652,48 +825,79 @@ void Rast__row_update_range(const CELL *cell, int n, struct Range *range,
 void Rast_row_update_fp_range(const void *rast, int n, struct FPRange *range,
                               RASTER_MAP_TYPE data_type)
 {
-    size_t size = Rast_cell_size(data_type);
-    DCELL val = 0.0;
-
-    while (n-- > 0) {
-        switch (data_type) {
-        case CELL_TYPE:
-            val = (DCELL) * ((CELL *)rast);
-            break;
-        case FCELL_TYPE:
-            val = (DCELL) * ((FCELL *)rast);
-            break;
-        case DCELL_TYPE:
-            val = *((DCELL *)rast);
-            break;
-        }
+    if (n <= 0)
+        return;
 
-        if (Rast_is_null_value(rast, data_type)) {
-            rast = G_incr_void_ptr(rast, size);
-            continue;
-        }
-        if (range->first_time) {
-            range->first_time = 0;
-            range->min = val;
-            range->max = val;
+    switch (data_type) {
+    case CELL_TYPE:
+        row_update_c_fp_range(rast, n, range);
+        break;
+    case FCELL_TYPE:
+        row_update_f_fp_range(rast, n, range);
+        break;
+    case DCELL_TYPE:
+        row_update_d_fp_range(rast, n, range);
+        break;
+    }
+}
 
-            range->rstats.sum = val;
-            range->rstats.sumsq = val * val;
-            range->rstats.count = 1;
-        }
-        else {
-            if (val < range->min)
-                range->min = val;
-            if (val > range->max)
-                range->max = val;
-
-            range->rstats.sum += val;
-            range->rstats.sumsq += val * val;
-            range->rstats.count += 1;
-        }
+/*!
+ * \brief Merge two range structures
+ *
+ * Extends <i>range</i> by the values accumulated in <i>src</i>, as if
+ * they had been added to <i>range</i> directly. This allows to collect
+ * the range of parts of a raster map separately, e.g. in different
+ * threads, and to combine the results afterwards.
+ *
+ * \param range pointer to Range structure to be updated
+ * \param src pointer to Range structure to be merged into range
+ */
+void Rast_merge_range(struct Range *range, const struct Range *src)
+{
+    if (src->first_time)
+        return;
+
+    if (range->first_time) {
+        *range = *src;
+        return;
+    }
+
+    if (src->min < range->min)
+        range->min = src->min;
+    if (src->max > range->max)
+        range->max = src->max;
 
-        rast = G_incr_void_ptr(rast, size);
+    range->rstats.sum += src->rstats.sum;
+    range->rstats.sumsq += src->rstats.sumsq;
+    range->rstats.count += src->rstats.count;
+}
+
+/*!
+ * \brief Merge two fp range structures
+ *
+ * Floating-point version of Rast_merge_range().
+ *
+ * \param range pointer to FPRange structure to be updated
+ * \param src pointer to FPRange structure to be merged into range
+ */
+void Rast_merge_fp_range(struct FPRange *range, const struct FPRange *src)
+{
+    if (src->first_time)
+        return;
+
+    if (range->first_time) {
+        *range = *src;
+        return;
     }
+
+    if (src->min < range->min)
+        range->min = src->min;
+    if (src->max > range->max)
+        range->max = src->max;
+
+    range->rstats.sum += src->rstats.sum;
+    range->rstats.sumsq += src->rstats.sumsq;
+    range->rstats.count += src->rstats.count;
 }
 
 /*!
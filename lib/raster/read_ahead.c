@@ -0,0 +1,219 @@
+/*!
+   \file lib/raster/read_ahead.c
+
+   \brief Raster library - Read-ahead of compressed raster rows
+
+   Rows of compressed raster maps are read from the cell/fcell file by
+   the calling thread and decompressed in advance by the worker threads
+   of the GIS library (see G_begin_execute()). Sequential readers then
+   get decompressed rows out of a ring buffer. Non-sequential access
+   discards the pending rows and restarts the read-ahead at the
+   requested row.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <errno.h>
+
+#include <grass/config.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+
+#include "R.h"
+
+static void expand_slot(void *closure)
+{
+    struct R_read_ahead_slot *slot = closure;
+    struct R_read_ahead *ra = slot->ra;
+
+    slot->status =
+        Rast__expand_row(slot->cmp, slot->cmp_size, slot->data, &slot->nbytes,
+                         ra->map_type, ra->compressed, ra->nbytes, ra->cols);
+}
+
+static void discard_rows(struct R_read_ahead *ra)
+{
+    int i;
+
+    for (i = 0; i < ra->nslots; i++) {
+        G_end_execute(&ra->slots[i].worker);
+        ra->slots[i].row = -1;
+    }
+}
+
+static void schedule_row(int fd, int row)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_read_ahead *ra = fcb->read_ahead;
+    struct R_read_ahead_slot *slot = &ra->slots[row % ra->nslots];
+    off_t t1 = fcb->row_ptr[row];
+    off_t t2 = fcb->row_ptr[row + 1];
+    ssize_t readamount = t2 - t1;
+
+    /* the previous occupant of this slot may still be in progress */
+    G_end_execute(&slot->worker);
+
+    if ((size_t)readamount > slot->cmp_alloc) {
+        slot->cmp_alloc = readamount;
+        slot->cmp = G_realloc(slot->cmp, slot->cmp_alloc);
+    }
+
+    if (lseek(fcb->data_fd, t1, SEEK_SET) == -1)
+        G_fatal_error(
+            _("Error seeking raster data file for row %d of <%s>: %s"), row,
+            fcb->name, strerror(errno));
+
+    if (read(fcb->data_fd, slot->cmp, readamount) != readamount)
+        G_fatal_error(_("Error reading raster data for row %d of <%s>: %s"),
+                      row, fcb->name, strerror(errno));
+
+    slot->cmp_size = readamount;
+    slot->row = row;
+    slot->status = 0;
+
+    G_begin_execute(expand_slot, slot, &slot->worker, 0);
+}
+
+/*!
+   \brief Get a row from the read-ahead ring buffer
+
+   Called by read_data() for maps with read-ahead enabled.
+
+   \param fd file descriptor for the opened raster map
+   \param row cell file row
+   \param[out] data_buf buffer for the decompressed row
+   \param[out] nbytes number of bytes per cell of the row
+ */
+void Rast__read_ahead_row(int fd, int row, unsigned char *data_buf,
+                          int *nbytes)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_read_ahead *ra = fcb->read_ahead;
+    struct R_read_ahead_slot *slot = &ra->slots[row % ra->nslots];
+
+    if (slot->row != row || row >= ra->next_row) {
+        /* not read sequentially, restart at the requested row */
+        discard_rows(ra);
+        ra->next_row = row;
+    }
+
+    /* keep the ring buffer filled */
+    while (ra->next_row < fcb->cellhd.rows &&
+           ra->next_row < row + ra->nslots)
+        schedule_row(fd, ra->next_row++);
+
+    G_end_execute(&slot->worker);
+
+    if (slot->status <= 0)
+        G_fatal_error(_("Error uncompressing raster data for row %d of <%s>"),
+                      row, fcb->name);
+
+    *nbytes = slot->nbytes;
+    memcpy(data_buf, slot->data, (size_t)slot->nbytes * fcb->cellhd.cols);
+}
+
+/*!
+   \brief Free read-ahead buffers of a raster map
+
+   Waits for rows still being decompressed. Called when the map is
+   closed.
+
+   \param fd file descriptor for the opened raster map
+ */
+void Rast__free_read_ahead(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_read_ahead *ra = fcb->read_ahead;
+    int i;
+
+    if (!ra)
+        return;
+
+    discard_rows(ra);
+
+    for (i = 0; i < ra->nslots; i++) {
+        G_free(ra->slots[i].cmp);
+        G_free(ra->slots[i].data);
+    }
+
+    G_free(ra->slots);
+    G_free(ra);
+    fcb->read_ahead = NULL;
+}
+
+/*!
+   \brief Enable read-ahead for a raster map
+
+   Rows of the compressed raster map open on <i>fd</i> are
+   decompressed in advance by worker threads, up to <i>nrows</i> rows
+   ahead of the last row read. This is transparent to the
+   Rast_get_row() family of functions and speeds up modules reading
+   compressed maps from top to bottom. The number of worker threads
+   is set with the environment variable WORKERS; without workers,
+   read-ahead is not enabled.
+
+   The default for newly opened maps can be set with the environment
+   variable GRASS_READ_AHEAD.
+
+   Uncompressed maps and maps linked with r.external or r.buildvrt are
+   not affected.
+
+   \param fd file descriptor for the opened raster map
+   \param nrows number of rows to read ahead, 0 to disable read-ahead
+
+   \return 1 if read-ahead is enabled
+   \return 0 otherwise
+ */
+int Rast_set_read_ahead(int fd, int nrows)
+{
+    struct fileinfo *fcb;
+    struct R_read_ahead *ra;
+    int i;
+
+    if (fd < 0 || fd >= R__.fileinfo_count ||
+        R__.fileinfo[fd].open_mode != OPEN_OLD)
+        G_fatal_error(_("Invalid descriptor: %d"), fd);
+
+    fcb = &R__.fileinfo[fd];
+
+    Rast__free_read_ahead(fd);
+
+    if (nrows <= 0 || fcb->gdal || fcb->vrt || !fcb->cellhd.compressed)
+        return 0;
+
+    G_init_workers();
+    if (G_num_workers() < 1) {
+        G_debug(1, "No worker threads, read-ahead disabled for <%s>",
+                fcb->name);
+        return 0;
+    }
+
+    G_debug(1, "Reading %d rows ahead for <%s>", nrows, fcb->name);
+
+    ra = G_calloc(1, sizeof(struct R_read_ahead));
+    ra->nslots = nrows;
+    ra->next_row = 0;
+    ra->map_type = fcb->map_type;
+    ra->compressed = fcb->cellhd.compressed;
+    ra->nbytes = fcb->nbytes;
+    ra->cols = fcb->cellhd.cols;
+    ra->slots = G_calloc(nrows, sizeof(struct R_read_ahead_slot));
+
+    for (i = 0; i < nrows; i++) {
+        struct R_read_ahead_slot *slot = &ra->slots[i];
+
+        slot->ra = ra;
+        slot->row = -1;
+        slot->data = G_malloc((size_t)fcb->cellhd.cols * fcb->nbytes);
+    }
+
+    fcb->read_ahead = ra;
+
+    return 1;
+}
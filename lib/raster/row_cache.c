@@ -0,0 +1,465 @@
+/*!
+   \file lib/raster/row_cache.c
+
+   \brief Raster library - On-disk cache of decompressed raster rows
+
+   Rows of compressed raster maps can be kept decompressed in a cache
+   file, one file per raster map. Every process reading the same map
+   uses the same cache file, so a row is decompressed only once for a
+   sequence of modules reading the same base layers.
+
+   A cache file is named after the raster map and the inode, the
+   modification time in nanoseconds and the size of its cell/fcell
+   file, and its header holds a checksum of the row index of the
+   cell/fcell file, so the cache of a map is no longer used once the
+   map is rewritten. Unused cache files are removed, least recently
+   used first, when the cache directory grows beyond its size limit,
+   and no more rows are added to the file in use once the files reach
+   the limit.
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <grass/config.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+
+#include "R.h"
+
+#define CACHE_MAGIC  "GRCACHE2"
+#define CACHE_SUFFIX ".rows"
+#define CACHE_ALIGN  4096
+
+struct cache_header {
+    char magic[8];
+    int rows;
+    int cols;
+    int nbytes;
+    int map_type;
+    unsigned long long index_hash; /* checksum of the row index */
+};
+
+struct cache_file {
+    char *name;
+    off_t size;
+    time_t mtime;
+};
+
+static int cmp_mtime(const void *a, const void *b)
+{
+    const struct cache_file *fa = a;
+    const struct cache_file *fb = b;
+
+    return (fa->mtime > fb->mtime) - (fa->mtime < fb->mtime);
+}
+
+/* disk space used by a cache file */
+static off_t file_size(const struct stat *st)
+{
+#ifdef _WIN32
+    return st->st_size;
+#else
+    /* cache files are sparse */
+    return (off_t)st->st_blocks * 512;
+#endif
+}
+
+/* modification time in nanoseconds of a file */
+static long long file_mtime_ns(const struct stat *st)
+{
+#if defined(__APPLE__)
+    return st->st_mtimespec.tv_sec * 1000000000LL + st->st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    return st->st_mtime * 1000000000LL;
+#else
+    return st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+#endif
+}
+
+/* FNV-1a hash of the row index of a compressed cell file, which
+   changes with the size of any row when the map is rewritten */
+static unsigned long long index_hash(const struct fileinfo *fcb)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    int row;
+    size_t i;
+
+    for (row = 0; row <= fcb->cellhd.rows; row++) {
+        unsigned long long offset = fcb->row_ptr[row];
+
+        for (i = 0; i < sizeof(offset); i++) {
+            hash ^= (offset >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+/* remove least recently used cache files until the cache fits into
+   its size limit, the file in use is kept; returns the disk space
+   used by the other cache files */
+static off_t evict_files(const char *keep)
+{
+    struct cache_file *files = NULL;
+    int nfiles = 0, nalloc = 0;
+    char path[GPATH_MAX];
+    off_t total = 0, others = 0;
+    struct dirent *entry;
+    DIR *dir;
+    int i;
+
+    dir = opendir(R__.row_cache_dir);
+    if (!dir)
+        return 0;
+
+    while ((entry = readdir(dir))) {
+        size_t len = strlen(entry->d_name);
+        struct stat st;
+
+        if (len <= strlen(CACHE_SUFFIX) ||
+            strcmp(entry->d_name + len - strlen(CACHE_SUFFIX), CACHE_SUFFIX))
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s", R__.row_cache_dir,
+                 entry->d_name);
+        if (stat(path, &st) != 0)
+            continue;
+
+        if (nfiles >= nalloc) {
+            nalloc += 32;
+            files = G_realloc(files, nalloc * sizeof(struct cache_file));
+        }
+        files[nfiles].name = G_store(entry->d_name);
+        files[nfiles].size = file_size(&st);
+        files[nfiles].mtime = st.st_mtime;
+        total += files[nfiles].size;
+        nfiles++;
+    }
+    closedir(dir);
+
+    qsort(files, nfiles, sizeof(struct cache_file), cmp_mtime);
+
+    for (i = 0; i < nfiles; i++) {
+        if (strcmp(files[i].name, keep) != 0) {
+            snprintf(path, sizeof(path), "%s/%s", R__.row_cache_dir,
+                     files[i].name);
+            /* processes still using the file keep it open */
+            if ((size_t)total > R__.row_cache_size && unlink(path) == 0) {
+                G_debug(1, "Row cache file <%s> removed", files[i].name);
+                total -= files[i].size;
+            }
+            else
+                others += files[i].size;
+        }
+        G_free(files[i].name);
+    }
+
+    G_free(files);
+
+    return others;
+}
+
+/* create a new cache file, it is renamed into place once complete */
+static int create_file(const char *path, const struct cache_header *hdr,
+                       off_t size)
+{
+    char tmp_path[GPATH_MAX];
+    int cache_fd;
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+
+    cache_fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (cache_fd < 0)
+        return -1;
+
+    if (write(cache_fd, hdr, sizeof(*hdr)) != sizeof(*hdr) ||
+        ftruncate(cache_fd, size) != 0 || rename(tmp_path, path) != 0) {
+        close(cache_fd);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    return cache_fd;
+}
+
+/*!
+   \brief Read a row from the row cache
+
+   Called by read_data() for maps with the row cache enabled.
+
+   \param fd file descriptor for the opened raster map
+   \param row cell file row
+   \param[out] data_buf buffer for the decompressed row
+   \param[out] nbytes number of bytes per cell of the row
+
+   \return 1 if the row was found in the cache
+   \return 0 otherwise
+ */
+int Rast__read_cached_row(int fd, int row, unsigned char *data_buf,
+                          int *nbytes)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_row_cache *cache = fcb->row_cache;
+    unsigned char row_nbytes;
+    ssize_t size;
+
+    /* the number of bytes per cell of a row, 0 if not cached */
+    if (lseek(cache->fd, sizeof(struct cache_header) + row, SEEK_SET) == -1 ||
+        read(cache->fd, &row_nbytes, 1) != 1 || row_nbytes == 0 ||
+        row_nbytes > fcb->nbytes)
+        return 0;
+
+    size = (ssize_t)fcb->cellhd.cols * row_nbytes;
+
+    if (lseek(cache->fd, cache->data_offset + (off_t)row * cache->row_size,
+              SEEK_SET) == -1 ||
+        read(cache->fd, data_buf, size) != size)
+        return 0;
+
+    *nbytes = row_nbytes;
+
+    return 1;
+}
+
+/*!
+   \brief Write a decompressed row to the row cache
+
+   The row data is written before the number of bytes per cell which
+   marks the row as cached, so other processes never see a row which
+   is cached only partly. Errors are not fatal, the row is not cached
+   then. Once the cache files reach the size limit of the cache, rows
+   are no longer written.
+
+   \param fd file descriptor for the opened raster map
+   \param row cell file row
+   \param data decompressed row
+   \param nbytes number of bytes per cell of the row
+ */
+void Rast__write_cached_row(int fd, int row, const unsigned char *data,
+                            int nbytes)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_row_cache *cache = fcb->row_cache;
+    unsigned char row_nbytes = nbytes;
+    ssize_t size = (ssize_t)fcb->cellhd.cols * nbytes;
+
+    if (nbytes <= 0 || nbytes > fcb->nbytes)
+        return;
+
+    if (cache->used + size > cache->limit)
+        return;
+
+    if (lseek(cache->fd, cache->data_offset + (off_t)row * cache->row_size,
+              SEEK_SET) == -1 ||
+        write(cache->fd, data, size) != size)
+        return;
+
+    if (lseek(cache->fd, sizeof(struct cache_header) + row, SEEK_SET) == -1 ||
+        write(cache->fd, &row_nbytes, 1) != 1) {
+        G_debug(1, "Unable to write row %d to the row cache of <%s>", row,
+                fcb->name);
+        return;
+    }
+
+    cache->used += size;
+}
+
+/*!
+   \brief Close the row cache of a raster map
+
+   Called when the map is closed.
+
+   \param fd file descriptor for the opened raster map
+ */
+void Rast__free_row_cache(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_row_cache *cache = fcb->row_cache;
+
+    if (!cache)
+        return;
+
+    close(cache->fd);
+    G_free(cache);
+    fcb->row_cache = NULL;
+}
+
+/*!
+   \brief Get the row cache directory
+
+   Called by the initialization of the raster library with the value
+   of GRASS_RASTER_CACHE, which is either 1 for a directory in the
+   temporary directory of the current mapset or the path of a
+   directory. The directory is created if needed.
+
+   \param value value of GRASS_RASTER_CACHE
+
+   \return path of the directory
+   \return NULL if the directory cannot be used
+ */
+char *Rast__row_cache_dir(const char *value)
+{
+    char element[GPATH_MAX];
+    char path[GPATH_MAX];
+    struct stat st;
+
+    if (strcmp(value, "1") == 0) {
+        G_temp_element(element);
+        strcat(element, "/rowcache");
+        G_make_mapset_object_group(element);
+        G_file_name(path, element, NULL, G_mapset());
+    }
+    else {
+        G_strlcpy(path, value, sizeof(path));
+        if (access(path, F_OK) != 0)
+            G_mkdir(path);
+    }
+
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode) ||
+        access(path, W_OK) != 0) {
+        G_warning(_("Unable to use <%s> for the raster row cache"), path);
+        return NULL;
+    }
+
+    G_debug(1, "Raster row cache directory: <%s>", path);
+
+    return G_store(path);
+}
+
+/*!
+   \brief Enable the on-disk row cache for a raster map
+
+   Decompressed rows of the compressed raster map open on <i>fd</i>
+   are stored in a cache file, and read from there instead of being
+   decompressed again, by this and by any later process reading the
+   same map. This speeds up sequences of modules reading the same
+   large raster maps, especially with the slower compression methods.
+   The cache is not used for the null file.
+
+   The cache is enabled for all maps opened for reading with the
+   environment variable GRASS_RASTER_CACHE, which also selects the
+   cache directory. The size limit of the cache directory is set in
+   MB with GRASS_RASTER_CACHE_SIZE. Without GRASS_RASTER_CACHE, the
+   cache cannot be enabled.
+
+   Uncompressed maps and maps linked with r.external or r.buildvrt are
+   not affected. If the cache file cannot be created, the map is read
+   without the cache.
+
+   \param fd file descriptor for the opened raster map
+   \param enable 1 to enable, 0 to disable the row cache
+
+   \return 1 if the row cache is enabled
+   \return 0 otherwise
+ */
+int Rast_set_row_cache(int fd, int enable)
+{
+    struct fileinfo *fcb;
+    struct R_row_cache *cache;
+    struct cache_header hdr, old_hdr;
+    const char *r_name, *r_mapset;
+    char name[GNAME_MAX + GMAPSET_MAX + 64];
+    char path[GPATH_MAX];
+    struct stat st;
+    off_t data_offset, size, others;
+    int cache_fd;
+
+    if (fd < 0 || fd >= R__.fileinfo_count ||
+        R__.fileinfo[fd].open_mode != OPEN_OLD)
+        G_fatal_error(_("Invalid descriptor: %d"), fd);
+
+    fcb = &R__.fileinfo[fd];
+
+    Rast__free_row_cache(fd);
+
+    if (!enable || !R__.row_cache_dir || fcb->gdal || fcb->vrt ||
+        !fcb->cellhd.compressed)
+        return 0;
+
+    if (fcb->reclass_flag) {
+        r_name = fcb->reclass.name;
+        r_mapset = fcb->reclass.mapset;
+    }
+    else {
+        r_name = fcb->name;
+        r_mapset = fcb->mapset;
+    }
+    r_mapset = G_find_raster2(r_name, r_mapset);
+    if (!r_mapset)
+        return 0;
+
+    /* the cache of a rewritten map is a different file */
+    if (fstat(fcb->data_fd, &st) != 0)
+        return 0;
+
+    snprintf(name, sizeof(name), "%s@%s_%llu_%lld_%lld%s", r_name, r_mapset,
+             (unsigned long long)st.st_ino, file_mtime_ns(&st),
+             (long long)st.st_size, CACHE_SUFFIX);
+    snprintf(path, sizeof(path), "%s/%s", R__.row_cache_dir, name);
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, CACHE_MAGIC, sizeof(hdr.magic));
+    hdr.rows = fcb->cellhd.rows;
+    hdr.cols = fcb->cellhd.cols;
+    hdr.nbytes = fcb->nbytes;
+    hdr.map_type = fcb->map_type;
+    hdr.index_hash = index_hash(fcb);
+
+    /* header and one byte per row, rows aligned to pages */
+    data_offset = sizeof(hdr) + hdr.rows;
+    data_offset = (data_offset + CACHE_ALIGN - 1) / CACHE_ALIGN * CACHE_ALIGN;
+    size = data_offset + (off_t)hdr.rows * hdr.cols * hdr.nbytes;
+
+    others = evict_files(name);
+
+    cache_fd = open(path, O_RDWR);
+    if (cache_fd >= 0) {
+        if (read(cache_fd, &old_hdr, sizeof(old_hdr)) != sizeof(old_hdr) ||
+            memcmp(&old_hdr, &hdr, sizeof(hdr)) != 0) {
+            G_debug(1, "Invalid row cache file for <%s>", fcb->name);
+            close(cache_fd);
+            return 0;
+        }
+        /* the modification time is the time of last use */
+        utime(path, NULL);
+        if (fstat(cache_fd, &st) != 0) {
+            close(cache_fd);
+            return 0;
+        }
+        size = file_size(&st);
+    }
+    else {
+        cache_fd = create_file(path, &hdr, size);
+        if (cache_fd < 0) {
+            G_debug(1, "Unable to create row cache file for <%s>", fcb->name);
+            return 0;
+        }
+        size = data_offset;
+    }
+
+    G_debug(1, "Row cache of <%s> is <%s>", fcb->name, path);
+
+    cache = G_calloc(1, sizeof(struct R_row_cache));
+    cache->fd = cache_fd;
+    cache->row_size = (size_t)hdr.cols * hdr.nbytes;
+    cache->data_offset = data_offset;
+    /* the other cache files are not removed while the map is read */
+    cache->limit = (off_t)R__.row_cache_size - others;
+    cache->used = size;
+    fcb->row_cache = cache;
+
+    return 1;
+}
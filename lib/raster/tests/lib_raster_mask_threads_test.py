@@ -0,0 +1,57 @@
+"""Test reading raster maps with a raster mask from several threads
+
+Modules open their input maps once per thread with Rast_open_old() or
+Rast_open_old_dup() and read them with the raster mask active, so their
+output with one and with several threads must be the same.
+"""
+
+import pytest
+
+from grass.script import MaskManager
+from grass.tools import Tools
+
+
+def read_map(tools, name):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17).text
+
+
+def run_slope_aspect(tools, nprocs):
+    output = f"slope_{nprocs}"
+    tools.r_slope_aspect(elevation="data", slope=output, nprocs=nprocs)
+    return read_map(tools, output)
+
+
+def run_patch(tools, nprocs):
+    output = f"patch_{nprocs}"
+    tools.r_patch(input=["data", "data"], output=output, nprocs=nprocs)
+    return read_map(tools, output)
+
+
+def run_mapcalc(tools, nprocs):
+    output = f"mapcalc_{nprocs}"
+    tools.r_mapcalc(expression=f"{output} = data * 2 + data[1, 1]", nprocs=nprocs)
+    return read_map(tools, output)
+
+
+def run_univar(tools, nprocs):
+    return tools.r_univar(map="data", flags="ge", nprocs=nprocs).text
+
+
+@pytest.mark.parametrize("run", [run_slope_aspect, run_patch, run_mapcalc, run_univar])
+@pytest.mark.parametrize(
+    "mask_options",
+    [{"raster": "raster_mask"}, {"raster": "data", "maskcats": "10 thru 25"}],
+)
+def test_threads_with_mask(session, run, mask_options):
+    """Outputs with a mask are the same with 1 and 4 threads"""
+    tools = Tools(session=session, overwrite=True)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    unmasked = run(tools, 1)
+    with MaskManager(env=session.env) as mask:
+        masked_tools = Tools(env=mask.env, overwrite=True)
+        masked_tools.r_mask(**mask_options)
+        single = run(masked_tools, 1)
+        threaded = run(masked_tools, 4)
+    assert threaded == single
+    assert single != unmasked
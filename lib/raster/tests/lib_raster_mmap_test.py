@@ -0,0 +1,43 @@
+"""Test reading raster maps through memory-mapped files"""
+
+import pytest
+
+from grass.tools import Tools
+
+
+def read_map(tools, name, env):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17, env=env).text
+
+
+@pytest.mark.parametrize("map_type", ["int", "float", "double"])
+@pytest.mark.parametrize("compressor", ["NONE", "RLE", "ZLIB", "LZ4"])
+@pytest.mark.parametrize("compress_nulls", ["0", "1"])
+def test_mmap_reads_same_values(session, map_type, compressor, compress_nulls):
+    """Values read with and without GRASS_RASTER_MMAP are the same"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    env = session.env.copy()
+    env["GRASS_COMPRESS_NULLS"] = compress_nulls
+    if compressor != "NONE":
+        env["GRASS_COMPRESSOR"] = compressor
+    tools.r_mapcalc(
+        expression=(
+            f"values = if((row() + col()) % 7, {map_type}(row() * 100 + col()) / 3,"
+            " null())"
+        ),
+        env=env,
+    )
+    if compressor == "NONE":
+        tools.r_compress(map="values", flags="u")
+
+    mmap_env = session.env.copy()
+    mmap_env["GRASS_RASTER_MMAP"] = "1"
+    expected = read_map(tools, "values", session.env)
+    assert "*" in expected
+    assert read_map(tools, "values", mmap_env) == expected
+
+    # rows read more than once and resampled columns
+    tools.g_region(n=20, s=0, e=20, w=0, rows=47, cols=13)
+    expected = read_map(tools, "values", session.env)
+    assert read_map(tools, "values", mmap_env) == expected
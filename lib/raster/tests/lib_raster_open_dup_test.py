@@ -0,0 +1,71 @@
+"""Test reading raster maps through descriptors from Rast_open_old_dup()
+
+r.stats and r.neighbors read their inputs with one duplicated descriptor
+per thread, so their output with one and with several threads must be
+the same.
+"""
+
+from io import StringIO
+
+import pytest
+
+from grass.script import MaskManager
+from grass.tools import Tools
+
+
+def read_map(tools, name):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17).text
+
+
+def threaded_outputs(tools, name):
+    """Return r.stats and r.neighbors results with 1 and 4 threads"""
+    results = []
+    for nprocs in (1, 4):
+        stats = tools.r_stats(
+            input=[name, "data"], flags="cn", separator="comma", nprocs=nprocs
+        ).text
+        output = f"neighbors_{nprocs}"
+        tools.r_neighbors(
+            input=name, output=output, method="average", size=5, nprocs=nprocs
+        )
+        results.append((stats, read_map(tools, output)))
+    return results
+
+
+@pytest.fixture
+def reclass_session(session):
+    """Session with a reclass map of the data map"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_reclass(
+        input="data",
+        output="data_reclass",
+        rules=StringIO("2 thru 10 = 1\n11 thru 25 = 2\n26 thru 40 = 3\n"),
+    )
+    return session
+
+
+def test_dup_of_reclass_map(reclass_session):
+    """Duplicated descriptors of a reclass map read the reclassed values"""
+    tools = Tools(session=reclass_session, overwrite=True)
+    single, threaded = threaded_outputs(tools, "data_reclass")
+    assert single[0].splitlines()[0].startswith("1,")
+    assert threaded == single
+
+
+@pytest.mark.parametrize("name", ["data", "data_reclass"])
+def test_dup_with_mask(reclass_session, name):
+    """Duplicated descriptors apply an active mask"""
+    tools = Tools(session=reclass_session, overwrite=True)
+    unmasked = threaded_outputs(tools, name)[0]
+    with MaskManager(env=reclass_session.env) as mask:
+        tools.r_mask(raster="raster_mask", env=mask.env)
+        masked_tools = Tools(env=mask.env, overwrite=True)
+        single, threaded = threaded_outputs(masked_tools, name)
+        assert threaded == single
+        assert single != unmasked
+        # rows outside of the mask are null
+        assert read_map(masked_tools, "neighbors_4").splitlines()[-1].startswith(
+            "*"
+        )
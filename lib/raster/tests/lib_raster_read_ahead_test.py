@@ -0,0 +1,59 @@
+"""Test reading compressed raster maps with rows decompressed ahead"""
+
+import pytest
+
+from grass.tools import Tools
+
+
+def read_map(tools, name, env):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17, env=env).text
+
+
+@pytest.mark.parametrize("map_type", ["int", "float", "double"])
+@pytest.mark.parametrize("compressor", ["RLE", "ZLIB", "LZ4"])
+def test_read_ahead_reads_same_values(session, map_type, compressor):
+    """Values read with and without GRASS_READ_AHEAD are the same"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    env = session.env.copy()
+    env["GRASS_COMPRESSOR"] = compressor
+    tools.r_mapcalc(
+        expression=(
+            f"values = if((row() + col()) % 7, {map_type}(row() * 100 + col()) / 3,"
+            " null())"
+        ),
+        env=env,
+    )
+
+    read_ahead_env = session.env.copy()
+    read_ahead_env["WORKERS"] = "4"
+    read_ahead_env["GRASS_READ_AHEAD"] = "3"
+    expected = read_map(tools, "values", session.env)
+    assert "*" in expected
+    assert read_map(tools, "values", read_ahead_env) == expected
+
+    # regions not aligned with the map: rows read more than once, rows
+    # skipped, and resampled columns
+    for rows, cols in ((47, 13), (7, 29)):
+        tools.g_region(n=19.5, s=0.25, e=20.5, w=-0.75, rows=rows, cols=cols)
+        expected = read_map(tools, "values", session.env)
+        assert read_map(tools, "values", read_ahead_env) == expected
+
+
+def test_read_ahead_out_of_order(session):
+    """Rows requested out of order restart the read-ahead"""
+    tools = Tools(session=session, overwrite=True)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    env = session.env.copy()
+    env["GRASS_COMPRESSOR"] = "ZLIB"
+    tools.r_mapcalc(expression="values = row() * 100 + col()", env=env)
+
+    read_ahead_env = session.env.copy()
+    read_ahead_env["WORKERS"] = "4"
+    read_ahead_env["GRASS_READ_AHEAD"] = "3"
+    expression = "shifted = values[-5, 1] + values[4, -2] * 1000"
+    tools.r_mapcalc(expression=expression.replace("shifted", "plain"))
+    tools.r_mapcalc(expression=expression, env=read_ahead_env)
+    expected = read_map(tools, "plain", session.env)
+    assert read_map(tools, "shifted", session.env) == expected
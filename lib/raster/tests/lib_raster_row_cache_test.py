@@ -0,0 +1,91 @@
+"""Test the on-disk cache of decompressed raster rows"""
+
+import pytest
+
+from grass.tools import Tools
+
+
+def read_map(tools, name, env):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17, env=env).text
+
+
+def cache_files(cache_dir):
+    """Return the cache files in a cache directory"""
+    return sorted(cache_dir.glob("*.rows"))
+
+
+def disk_usage(cache_dir):
+    """Return the disk space used by the sparse cache files"""
+    return sum(path.stat().st_blocks * 512 for path in cache_files(cache_dir))
+
+
+@pytest.fixture
+def cache_env(session, tmp_path):
+    """Environment with the row cache in a directory of its own"""
+    env = session.env.copy()
+    env["GRASS_RASTER_CACHE"] = str(tmp_path / "rowcache")
+    return env
+
+
+@pytest.mark.parametrize("map_type", ["int", "float", "double"])
+def test_cached_rows_same_values(session, cache_env, tmp_path, map_type):
+    """Rows read from the cache are the rows read from the map"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_mapcalc(
+        expression=(
+            f"values = if((row() + col()) % 7, {map_type}(row() * 100 + col()) / 3,"
+            " null())"
+        )
+    )
+    expected = read_map(tools, "values", session.env)
+    assert "*" in expected
+
+    # the first read fills the cache, the second one reads from it
+    assert read_map(tools, "values", cache_env) == expected
+    files = cache_files(tmp_path / "rowcache")
+    assert len(files) == 1
+    assert files[0].name.startswith("values@")
+    assert disk_usage(tmp_path / "rowcache") > 0
+    assert read_map(tools, "values", cache_env) == expected
+
+    # rows read more than once and resampled columns
+    tools.g_region(n=20, s=0, e=20, w=0, rows=47, cols=13)
+    expected = read_map(tools, "values", session.env)
+    assert read_map(tools, "values", cache_env) == expected
+    assert len(cache_files(tmp_path / "rowcache")) == 1
+
+
+def test_rewritten_map_not_read_from_cache(session, cache_env, tmp_path):
+    """The cache of a map is not used once the map is rewritten"""
+    tools = Tools(session=session, overwrite=True)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_mapcalc(expression="values = row() * 100 + col()")
+    expected = read_map(tools, "values", session.env)
+    assert read_map(tools, "values", cache_env) == expected
+
+    # same row sizes, different values
+    tools.r_mapcalc(expression="values = row() * 100 + col() + 1")
+    expected = read_map(tools, "values", session.env)
+    assert read_map(tools, "values", cache_env) == expected
+    assert read_map(tools, "values", cache_env) == expected
+    assert len(cache_files(tmp_path / "rowcache")) == 2
+
+
+def test_cache_size_limit(session, cache_env, tmp_path):
+    """The cache files stay within GRASS_RASTER_CACHE_SIZE"""
+    tools = Tools(session=session)
+    # 400 rows of 3200 bytes, more than the limit of 1 MB
+    tools.g_region(n=400, s=0, e=400, w=0, rows=400, cols=400)
+    tools.r_mapcalc(expression="first = double(row() * 1000 + col()) / 7")
+    tools.r_mapcalc(expression="second = double(row() * 1000 + col()) / 11")
+    cache_env["GRASS_RASTER_CACHE_SIZE"] = "1"
+    # header pages and partly filled file system blocks of each file
+    limit = (1 << 20) + 2 * 65536
+
+    for name in ("first", "second", "first"):
+        expected = read_map(tools, name, session.env)
+        assert read_map(tools, name, cache_env) == expected
+        assert read_map(tools, name, cache_env) == expected
+        assert 0 < disk_usage(tmp_path / "rowcache") <= limit
@@ -0,0 +1,212 @@
+"""Test the on-disk format of raster rows and null bitmaps
+
+Rows written with Rast_put_row() must be stored in the documented format,
+byte for byte: CELL values in the minimal number of bytes per row,
+compressed with RLE if that is shorter, FCELL and DCELL values as XDR, and
+null flags as bitmaps padded to whole bytes. Rows read back with
+Rast_get_row() must hold the values written.
+"""
+
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
+import numpy as np
+import pytest
+
+import grass.script as gs
+from grass.tools import Tools
+
+CELL_NULL = -(2**31)
+
+# Writes a map from values saved with numpy, then reads it back and
+# compares the rows. The C library is initialized per process, so it runs
+# in its own process.
+WRITE_AND_READ = """
+import sys
+
+import numpy as np
+
+from grass.lib.raster import (
+    Rast_close,
+    Rast_get_row,
+    Rast_open_new,
+    Rast_open_new_uncompressed,
+    Rast_open_old,
+    Rast_put_row,
+)
+from grass.pygrass.raster.buffer import Buffer
+from grass.pygrass.raster.raster_type import TYPE as RTYPE
+
+name, mtype, values = sys.argv[1], sys.argv[2], np.load(sys.argv[3])
+gtype = RTYPE[mtype]["grass type"]
+# CELL rows are compressed to test the row widths and RLE, FP rows are not
+if mtype == "CELL":
+    fd = Rast_open_new(name, gtype)
+else:
+    fd = Rast_open_new_uncompressed(name, gtype)
+buf = Buffer(values.shape[1:], mtype=mtype)
+for row in values:
+    buf[:] = row
+    Rast_put_row(fd, buf.p, gtype)
+Rast_close(fd)
+
+fd = Rast_open_old(name, "")
+for number, row in enumerate(values):
+    Rast_get_row(fd, buf.p, number, gtype)
+    if mtype == "CELL":
+        same = buf.tobytes() == row.tobytes()
+    else:
+        nulls = np.isnan(row)
+        same = np.array_equal(np.isnan(buf), nulls) and (
+            buf[~nulls].tobytes() == row[~nulls].tobytes()
+        )
+    if not same:
+        sys.exit(f"row {number} differs")
+Rast_close(fd)
+"""
+
+
+def cell_values(cols):
+    """Rows of CELL values 1, 2, 3 and 4 bytes wide, runs and nulls"""
+    col = np.arange(cols)
+    values = np.array(
+        [
+            col * 5 % 120 + 3,
+            col * 1500 % 30000 + 300,
+            col * 300000 % 8000000 + 70000,
+            col * 90000000 % 2000000000 + 20000000,
+            # a negative value takes 4 bytes, the sign is in the first one
+            col * 7 - 60,
+            np.where(col % 2, 2**31 - 1 - col, -(2**31) + 1 + col),
+            np.full(cols, 7),
+            np.zeros(cols),
+            np.full(cols, CELL_NULL),
+        ],
+        dtype=np.int32,
+    )
+    values[:4][(np.arange(4)[:, None] + col) % 6 == 0] = CELL_NULL
+    return values
+
+
+def fp_values(cols, dtype):
+    """Rows of FCELL or DCELL values with special values and nulls"""
+    col = np.arange(cols)
+    values = np.array(
+        [
+            col / 7 - 1,
+            (col - cols / 2) * 1e30,
+            np.where(col % 2, -0.0, np.finfo(dtype).tiny / 3),
+            np.where(col % 3, np.inf, -np.inf),
+            np.full(cols, np.nan),
+        ],
+        dtype=dtype,
+    )
+    values[:2][(np.arange(2)[:, None] + col) % 5 == 0] = np.nan
+    return values
+
+
+def encode_cell_row(row):
+    """Encode a row of a compressed CELL map, RLE compressed if shorter"""
+    cells = [
+        (abs(int(value)) | (2**31 if value < 0 else 0)).to_bytes(4, "big")
+        if value != CELL_NULL
+        else bytes(4)
+        for value in row
+    ]
+    # the bytes which are zero in all cells are not stored
+    nbytes = 4
+    while nbytes > 1 and not any(cell[4 - nbytes] for cell in cells):
+        nbytes -= 1
+    cells = [cell[4 - nbytes :] for cell in cells]
+    data = b"".join(cells)
+
+    rle = bytearray()
+    start = 0
+    while start < len(cells):
+        count = 1
+        while (
+            start + count < len(cells)
+            and count < 255
+            and cells[start + count] == cells[start]
+        ):
+            count += 1
+        rle += bytes([count]) + cells[start]
+        start += count
+    if len(rle) < len(data):
+        data = bytes(rle)
+    return nbytes, bytes([nbytes]) + data
+
+
+def encode_cell_file(values, ptr_nbytes):
+    """Encode a CELL map with the row offsets in front of the rows"""
+    rows = [encode_cell_row(row)[1] for row in values]
+    offset = 1 + (len(rows) + 1) * ptr_nbytes
+    offsets = []
+    for row in rows:
+        offsets.append(offset)
+        offset += len(row)
+    offsets.append(offset)
+    header = bytes([ptr_nbytes]) + b"".join(
+        value.to_bytes(ptr_nbytes, "big") for value in offsets
+    )
+    return header + b"".join(rows)
+
+
+def encode_fp_file(values):
+    """Encode an uncompressed FCELL or DCELL map, nulls stored as 0"""
+    code = ">f" if values.dtype == np.float32 else ">d"
+    return b"".join(
+        struct.pack(code, 0 if np.isnan(value) else value) for value in values.flat
+    )
+
+
+def encode_null_file(nulls):
+    """Encode an uncompressed null file, a bitmap padded per row"""
+    return np.packbits(nulls, axis=1).tobytes()
+
+
+def write_and_read(session, tmp_path, name, mtype, values):
+    """Write a map and compare the rows read back with the values"""
+    rows, cols = values.shape
+    Tools(session=session).g_region(n=rows, s=0, e=cols, w=0, res=1)
+    np.save(tmp_path / f"{name}.npy", values)
+    env = session.env.copy()
+    env["GRASS_COMPRESSOR"] = "RLE"
+    env["GRASS_COMPRESS_NULLS"] = "0"
+    subprocess.run(
+        [sys.executable, "-c", WRITE_AND_READ, name, mtype, tmp_path / f"{name}.npy"],
+        env=env,
+        check=True,
+    )
+    gisenv = gs.gisenv(env=session.env)
+    return Path(gisenv["GISDBASE"], gisenv["LOCATION_NAME"], gisenv["MAPSET"])
+
+
+@pytest.mark.parametrize("cols", [1, 8, 13, 21, 300])
+def test_cell_format(session, tmp_path, cols):
+    """CELL rows of all widths and their null flags, byte for byte"""
+    values = cell_values(cols)
+    assert [encode_cell_row(row)[0] for row in values[:4]] == [1, 2, 3, 4]
+    name = f"cell_{cols}"
+    mapset_path = write_and_read(session, tmp_path, name, "CELL", values)
+
+    data = (mapset_path / "cell" / name).read_bytes()
+    assert data == encode_cell_file(values, ptr_nbytes=data[0])
+    nulls = (mapset_path / "cell_misc" / name / "null").read_bytes()
+    assert nulls == encode_null_file(values == CELL_NULL)
+
+
+@pytest.mark.parametrize("mtype", ["FCELL", "DCELL"])
+@pytest.mark.parametrize("cols", [1, 8, 13, 21])
+def test_fp_format(session, tmp_path, mtype, cols):
+    """FCELL and DCELL rows and their null flags, byte for byte"""
+    values = fp_values(cols, np.float32 if mtype == "FCELL" else np.float64)
+    name = f"{mtype.lower()}_{cols}"
+    mapset_path = write_and_read(session, tmp_path, name, mtype, values)
+
+    data = (mapset_path / "fcell" / name).read_bytes()
+    assert data == encode_fp_file(values)
+    nulls = (mapset_path / "cell_misc" / name / "null").read_bytes()
+    assert nulls == encode_null_file(np.isnan(values))
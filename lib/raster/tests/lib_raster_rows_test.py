@@ -0,0 +1,92 @@
+"""Test reading blocks of consecutive rows with Rast_get_rows()
+
+Blocks must hold the same cells as the rows read with Rast_get_row(),
+with and without rows decompressed ahead.
+"""
+
+import subprocess
+import sys
+from io import StringIO
+
+import pytest
+
+from grass.script import MaskManager
+from grass.tools import Tools
+
+# Compares blocks of rows of a map read with Rast_get_rows() with the
+# rows read with Rast_get_row(). The C library is initialized per
+# process, so it runs in its own process.
+READ_ROWS = """
+import sys
+
+import numpy as np
+
+from grass.lib.raster import (
+    Rast_get_rows,
+    Rast_set_read_ahead,
+    Rast_window_cols,
+    Rast_window_rows,
+)
+from grass.pygrass.raster import RasterRow
+from grass.pygrass.raster.buffer import Buffer
+
+name, read_ahead = sys.argv[1], int(sys.argv[2])
+with RasterRow(name) as raster:
+    rows, cols = Rast_window_rows(), Rast_window_cols()
+    expected = np.array([raster.get_row(row).copy() for row in range(rows)])
+    if read_ahead:
+        Rast_set_read_ahead(raster._fd, read_ahead)
+    # top to bottom in blocks of 4 rows, then blocks out of order
+    blocks = [(row, min(4, rows - row)) for row in range(0, rows, 4)]
+    blocks += [(rows - 3, 3), (0, rows), (2, 1), (5, 0)]
+    for row, nrows in blocks:
+        block = Buffer((nrows, cols), raster.mtype)
+        Rast_get_rows(raster._fd, block.p, row, nrows, raster._gtype)
+        if block.tobytes() != expected[row : row + nrows].tobytes():
+            sys.exit(f"{nrows} rows from row {row} differ")
+"""
+
+
+def read_rows(name, env, read_ahead=0):
+    """Read blocks of rows of a map and compare them with its rows"""
+    env = env.copy()
+    env["WORKERS"] = "4"
+    subprocess.run(
+        [sys.executable, "-c", READ_ROWS, name, str(read_ahead)], env=env, check=True
+    )
+
+
+@pytest.mark.parametrize("map_type", ["int", "float", "double"])
+@pytest.mark.parametrize("read_ahead", [0, 4])
+def test_rows_same_as_row_reads(session, map_type, read_ahead):
+    """Blocks hold the cells of the rows, with nulls"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    env = session.env.copy()
+    env["GRASS_COMPRESSOR"] = "ZLIB"
+    tools.r_mapcalc(
+        expression=(
+            f"values = if((row() + col()) % 7, {map_type}(row() * 100 + col()) / 3,"
+            " null())"
+        ),
+        env=env,
+    )
+    read_rows("values", session.env, read_ahead)
+
+    # a region not aligned with the map, rows read more than once
+    tools.g_region(n=19.5, s=0.25, e=20.5, w=-0.75, rows=47, cols=13)
+    read_rows("values", session.env, read_ahead)
+
+
+def test_rows_reclass_and_mask(session):
+    """Blocks of rows of a reclassed map and read with a mask"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_reclass(
+        input="data", output="classes", rules=StringIO("1 thru 20 = 1\n* = 2\n")
+    )
+    read_rows("classes", session.env)
+    with MaskManager(env=session.env) as mask:
+        Tools(env=mask.env).r_mask(raster="raster_mask")
+        read_rows("data", mask.env, read_ahead=4)
+        read_rows("classes", mask.env)
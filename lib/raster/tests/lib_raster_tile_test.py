@@ -0,0 +1,84 @@
+"""Test reading rectangular blocks of cells with Rast_get_tile()
+
+Blocks must hold the same cells as the rows read with Rast_get_row().
+"""
+
+import subprocess
+import sys
+from io import StringIO
+
+import pytest
+
+from grass.script import MaskManager
+from grass.tools import Tools
+
+# Compares blocks of a map read with Rast_get_tile() with the rows read
+# with Rast_get_row(). The C library is initialized per process, so it
+# runs in its own process.
+READ_TILES = """
+import sys
+
+import numpy as np
+
+from grass.lib.raster import Rast_get_tile, Rast_window_cols, Rast_window_rows
+from grass.pygrass.raster import RasterRow
+from grass.pygrass.raster.buffer import Buffer
+
+with RasterRow(sys.argv[1]) as raster:
+    rows, cols = Rast_window_rows(), Rast_window_cols()
+    expected = np.array([raster.get_row(row).copy() for row in range(rows)])
+    blocks = [
+        (0, 0, rows, cols),
+        (3, 5, 7, 4),
+        (rows - 2, cols - 3, 2, 3),
+        (4, 0, 1, cols),
+        (0, cols - 1, rows, 1),
+        (5, 5, 0, 0),
+    ]
+    # blocks of a row of blocks, left to right
+    blocks += [(8, col, 4, min(3, cols - col)) for col in range(0, cols, 3)]
+    for row, col, nrows, ncols in blocks:
+        tile = Buffer((nrows, ncols), raster.mtype)
+        Rast_get_tile(raster._fd, tile.p, row, col, nrows, ncols, raster._gtype)
+        block = np.ascontiguousarray(expected[row : row + nrows, col : col + ncols])
+        if tile.tobytes() != block.tobytes():
+            sys.exit(f"block at row {row}, column {col} of {nrows} x {ncols} differs")
+"""
+
+
+def read_tiles(name, env):
+    """Read blocks of a map and compare them with its rows"""
+    subprocess.run([sys.executable, "-c", READ_TILES, name], env=env, check=True)
+
+
+@pytest.mark.parametrize("map_type", ["int", "float", "double"])
+def test_tiles_same_as_rows(session, map_type):
+    """Blocks hold the cells of the rows, with nulls"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_mapcalc(
+        expression=(
+            f"values = if((row() + col()) % 7, {map_type}(row() * 100 + col()) / 3,"
+            " null())"
+        )
+    )
+    read_tiles("values", session.env)
+
+    # regions not aligned with the map
+    for rows, cols in ((47, 13), (7, 29)):
+        tools.g_region(n=19.5, s=0.25, e=20.5, w=-0.75, rows=rows, cols=cols)
+        read_tiles("values", session.env)
+
+
+def test_tiles_reclass_and_mask(session):
+    """Blocks of a reclassed map and blocks read with a mask"""
+    tools = Tools(session=session)
+    tools.g_region(n=20, s=0, e=20, w=0, rows=20, cols=20)
+    tools.r_reclass(
+        input="data", output="classes", rules=StringIO("1 thru 20 = 1\n* = 2\n")
+    )
+    read_tiles("classes", session.env)
+    with MaskManager(env=session.env) as mask:
+        Tools(env=mask.env).r_mask(raster="raster_mask")
+        read_tiles("data", mask.env)
+        read_tiles("classes", mask.env)
@@ -0,0 +1,100 @@
+"""Test reading raster maps through window column mappings
+
+Maps with the same columns share one column mapping, and maps whose
+columns are the columns of the region are read without it. Values read
+in a region not aligned with the maps must be the values of the map
+cells containing the region cell centers.
+"""
+
+import pytest
+
+from grass.tools import Tools
+
+# name, extent and resolution of the maps; the value of a cell is
+# computed from its center, so that the value read at any point can
+# be computed from the coordinates of the point
+MAPS = {
+    # same columns as the module region
+    "cells": {"n": 20, "s": 0, "w": 0, "e": 20, "nsres": 1, "ewres": 1},
+    # same columns as cells, other rows
+    "cells_rows": {"n": 24, "s": 2, "w": 0, "e": 20, "nsres": 1, "ewres": 1},
+    # other columns and rows
+    "cells_other": {
+        "n": 21,
+        "s": -1,
+        "w": -1.5,
+        "e": 22.5,
+        "nsres": 0.5,
+        "ewres": 1.5,
+    },
+}
+
+
+def cell_value(name):
+    """Expression of the value of the map cell containing x(), y()"""
+    grid = MAPS[name]
+    offset = list(MAPS).index(name) * 1000000
+    return (
+        f"{offset} + floor(x() / {grid['ewres']}) * 1000"
+        f" + floor(y() / {grid['nsres']})"
+    )
+
+
+def read_map(tools, name):
+    """Return all cell values of a map as text"""
+    return tools.r_out_ascii(input=name, output="-", precision=17).text
+
+
+@pytest.fixture
+def maps_session(session):
+    """Session with the maps on their own grids"""
+    tools = Tools(session=session)
+    for name, grid in MAPS.items():
+        tools.g_region(**grid)
+        tools.r_mapcalc(expression=f"{name} = {cell_value(name)}")
+    return session
+
+
+@pytest.mark.parametrize(
+    "region",
+    [
+        # columns of cells and cells_rows, read without column mapping
+        {"n": 20, "s": 2, "w": 0, "e": 20, "rows": 18, "cols": 20},
+        # aligned with cells and cells_rows, fewer columns
+        {"n": 18, "s": 3, "w": 4, "e": 16, "rows": 15, "cols": 12},
+        # not aligned with any of the maps
+        {"n": 19.3, "s": 2.3, "w": 0.7, "e": 19.9, "rows": 13, "cols": 11},
+        # finer than the maps
+        {"n": 19.3, "s": 2.3, "w": 0.7, "e": 19.9, "rows": 41, "cols": 53},
+    ],
+)
+def test_values_at_region_cells(maps_session, region):
+    """Maps read together match the values at the region cell centers"""
+    tools = Tools(session=maps_session)
+    tools.g_region(**region)
+    # all maps are open at the same time
+    tools.r_mapcalc(
+        expression="\n".join(f"{name}_read = {name}" for name in MAPS),
+    )
+    for name in MAPS:
+        tools.r_mapcalc(expression=f"{name}_expected = {cell_value(name)}")
+        expected = read_map(tools, f"{name}_expected")
+        assert "*" not in expected
+        assert read_map(tools, f"{name}_read") == expected, name
+
+
+def test_region_outside_of_map(maps_session):
+    """Region cells outside of a map are null"""
+    tools = Tools(session=maps_session)
+    tools.g_region(n=23.25, s=-0.75, w=0.75, e=20.75, rows=24, cols=20)
+    tools.r_mapcalc(expression="cells_read = cells\ncells_rows_read = cells_rows")
+    rows = read_map(tools, "cells_read").splitlines()[-24:]
+    # first rows, last row and last column are outside of cells
+    assert set(rows[0].split()) == {"*"}
+    assert set(rows[-1].split()) == {"*"}
+    assert all(row.split()[-1] == "*" for row in rows)
+    assert rows[10].split()[0] != "*"
+    rows = read_map(tools, "cells_rows_read").splitlines()[-24:]
+    # last row is outside of cells_rows
+    assert set(rows[-1].split()) == {"*"}
+    assert rows[0].split()[0] != "*"
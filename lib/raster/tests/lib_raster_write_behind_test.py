@@ -0,0 +1,105 @@
+"""Test background compression of new raster maps
+
+Maps written with and without worker threads must be identical, data
+file, null file, range and histogram alike.
+"""
+
+import filecmp
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+import grass.script as gs
+from grass.tools import Tools
+
+ROWS = 97
+COLS = 53
+
+# Writes a map with zeros, nulls and many values through the C library,
+# which is initialized per process, so it runs in its own process.
+WRITE_MAP = """
+import sys
+
+import numpy as np
+
+from grass.lib.raster import Rast_init, Rast_set_write_behind, Rast_want_histogram
+from grass.pygrass.raster import RasterRow
+from grass.pygrass.raster.buffer import Buffer
+
+NULLS = {"CELL": -(2**31), "FCELL": np.nan, "DCELL": np.nan}
+
+name, mtype, write_behind = sys.argv[1], sys.argv[2], int(sys.argv[3])
+nrows, ncols = int(sys.argv[4]), int(sys.argv[5])
+rows, cols = np.mgrid[0:nrows, 0:ncols]
+values = (rows * 31 + cols * 17) % 23
+if mtype != "CELL":
+    values = values / 7.0
+# initializing the library resets the histogram flag
+Rast_init()
+Rast_want_histogram(1)
+with RasterRow(name, mode="w", mtype=mtype, overwrite=True) as raster:
+    if write_behind and Rast_set_write_behind(raster._fd, write_behind) != 1:
+        sys.exit("write-behind not enabled")
+    buf = Buffer((ncols,), mtype=mtype)
+    for row in range(nrows):
+        buf[:] = values[row]
+        buf[(row + np.arange(ncols)) % 11 == 0] = NULLS[mtype]
+        raster.put_row(buf)
+"""
+
+
+def write_map(session, name, mtype, write_behind):
+    """Write a map, with background compression if write_behind > 0"""
+    env = session.env.copy()
+    # the worker threads are started with the first map written in the
+    # background
+    env["WORKERS"] = "4"
+    subprocess.run(
+        [
+            sys.executable,
+            "-c",
+            WRITE_MAP,
+            name,
+            mtype,
+            str(write_behind),
+            str(ROWS),
+            str(COLS),
+        ],
+        env=env,
+        check=True,
+    )
+
+
+def assert_files_equal(first, second):
+    """Compare a file, or all files of a directory, of two maps"""
+    if first.is_dir():
+        names = sorted(path.name for path in first.iterdir())
+        assert names == sorted(path.name for path in second.iterdir())
+        for name in names:
+            assert filecmp.cmp(first / name, second / name, shallow=False), name
+    else:
+        assert filecmp.cmp(first, second, shallow=False)
+
+
+@pytest.mark.parametrize("mtype", ["CELL", "FCELL", "DCELL"])
+def test_write_behind_same_files(session, mtype):
+    """Data, null file, range and histogram do not depend on the workers"""
+    tools = Tools(session=session)
+    tools.g_region(n=ROWS, s=0, e=COLS, w=0, res=1)
+    env = gs.gisenv(env=session.env)
+    mapset_path = Path(env["GISDBASE"], env["LOCATION_NAME"], env["MAPSET"])
+
+    sequential = f"write_behind_{mtype.lower()}_0"
+    background = f"write_behind_{mtype.lower()}_8"
+    write_map(session, sequential, mtype, write_behind=0)
+    write_map(session, background, mtype, write_behind=8)
+
+    # data, then null file, range and histogram in cell_misc
+    for element in ("cell" if mtype == "CELL" else "fcell", "cell_misc"):
+        assert_files_equal(
+            mapset_path / element / sequential, mapset_path / element / background
+        )
+    if mtype == "CELL":
+        assert (mapset_path / "cell_misc" / background / "histogram").exists()
@@ -19,30 +19,19 @@
 
 #define alloc_index(n) (COLUMN_MAPPING *)G_malloc((n) * sizeof(COLUMN_MAPPING))
 
-/*!
- * \brief Create window mapping.
- *
- * Creates mapping from cell header into window. The boundaries and
- * resolution of the two spaces do not have to be the same or aligned in
- * any way.
- *
- * \param fd file descriptor
- */
-void Rast__create_window_mapping(int fd)
+/* column mappings in use, shared by maps with the same columns */
+static struct R_window_map *window_maps;
+
+static void compute_col_map(COLUMN_MAPPING *col_map,
+                            const struct Cell_head *cellhd)
 {
-    struct fileinfo *fcb = &R__.fileinfo[fd];
     COLUMN_MAPPING *col;
     int i;
     int x;
     double C1, C2;
     double west, east;
 
-    if (fcb->open_mode >= 0 && fcb->open_mode != OPEN_OLD) /* open for write? */
-        return;
-    if (fcb->open_mode == OPEN_OLD) /* already open ? */
-        G_free(fcb->col_map);
-
-    col = fcb->col_map = alloc_index(R__.rd_window.cols);
+    col = col_map;
 
     /*
      * for each column in the window, go to center of the cell,
@@ -55,24 +44,23 @@ void Rast__create_window_mapping(int fd)
     west = R__.rd_window.west;
     east = R__.rd_window.east;
     if (R__.rd_window.proj == PROJECTION_LL) {
-        while (west > fcb->cellhd.west + 360.0) {
+        while (west > cellhd->west + 360.0) {
             west -= 360.0;
             east -= 360.0;
         }
-        while (west < fcb->cellhd.west) {
+        while (west < cellhd->west) {
             west += 360.0;
             east += 360.0;
         }
     }
 
-    C1 = R__.rd_window.ew_res / fcb->cellhd.ew_res;
-    C2 = (west - fcb->cellhd.west + R__.rd_window.ew_res / 2.0) /
-         fcb->cellhd.ew_res;
+    C1 = R__.rd_window.ew_res / cellhd->ew_res;
+    C2 = (west - cellhd->west + R__.rd_window.ew_res / 2.0) / cellhd->ew_res;
     for (i = 0; i < R__.rd_window.cols; i++) {
         x = C2;
         if (C2 < x) /* adjust for rounding of negatives */
             x--;
-        if (x < 0 || x >= fcb->cellhd.cols) /* not in data file */
+        if (x < 0 || x >= cellhd->cols) /* not in data file */
             x = -1;
         *col++ = x + 1;
         C2 += C1;
@@ -81,18 +69,18 @@ void Rast__create_window_mapping(int fd)
     /* do wrap around for lat/lon */
     if (R__.rd_window.proj == PROJECTION_LL) {
 
-        while (east - 360.0 > fcb->cellhd.west) {
+        while (east - 360.0 > cellhd->west) {
             east -= 360.0;
             west -= 360.0;
 
-            col = fcb->col_map;
-            C2 = (west - fcb->cellhd.west + R__.rd_window.ew_res / 2.0) /
-                 fcb->cellhd.ew_res;
+            col = col_map;
+            C2 = (west - cellhd->west + R__.rd_window.ew_res / 2.0) /
+                 cellhd->ew_res;
             for (i = 0; i < R__.rd_window.cols; i++) {
                 x = C2;
                 if (C2 < x) /* adjust for rounding of negatives */
                     x--;
-                if (x < 0 || x >= fcb->cellhd.cols) /* not in data file */
+                if (x < 0 || x >= cellhd->cols) /* not in data file */
                     x = -1;
                 if (*col == 0) /* only change those not already set */
                     *col = x + 1;
@@ -104,9 +92,116 @@ void Rast__create_window_mapping(int fd)
 
     G_debug(3, "create window mapping (%d columns)", R__.rd_window.cols);
     /*  for (i = 0; i < R__.rd_window.cols; i++)
-       fprintf(stderr, "%s%ld", i % 15 ? " " : "\n", (long)fcb->col_map[i]);
+       fprintf(stderr, "%s%ld", i % 15 ? " " : "\n", (long)col_map[i]);
        fprintf(stderr, "\n");
      */
+}
+
+/* the column mapping depends only on these fields of the cell header
+   and the window */
+static int same_columns(const struct R_window_map *wm,
+                        const struct Cell_head *cellhd)
+{
+    return wm->cell_west == cellhd->west &&
+           wm->cell_ew_res == cellhd->ew_res &&
+           wm->cell_cols == cellhd->cols &&
+           wm->window_west == R__.rd_window.west &&
+           wm->window_east == R__.rd_window.east &&
+           wm->window_ew_res == R__.rd_window.ew_res &&
+           wm->window_cols == R__.rd_window.cols &&
+           wm->proj == R__.rd_window.proj;
+}
+
+static struct R_window_map *get_window_map(const struct Cell_head *cellhd)
+{
+    struct R_window_map *wm;
+    int i;
+
+    for (wm = window_maps; wm; wm = wm->next) {
+        if (same_columns(wm, cellhd)) {
+            wm->refs++;
+            return wm;
+        }
+    }
+
+    wm = G_malloc(sizeof(struct R_window_map));
+    wm->refs = 1;
+    wm->cell_west = cellhd->west;
+    wm->cell_ew_res = cellhd->ew_res;
+    wm->cell_cols = cellhd->cols;
+    wm->window_west = R__.rd_window.west;
+    wm->window_east = R__.rd_window.east;
+    wm->window_ew_res = R__.rd_window.ew_res;
+    wm->window_cols = R__.rd_window.cols;
+    wm->proj = R__.rd_window.proj;
+    wm->col_map = alloc_index(R__.rd_window.cols);
+    compute_col_map(wm->col_map, cellhd);
+
+    /* window column i is cell file column i */
+    wm->identity = R__.rd_window.cols == cellhd->cols;
+    for (i = 0; wm->identity && i < R__.rd_window.cols; i++)
+        wm->identity = wm->col_map[i] == i + 1;
+
+    wm->next = window_maps;
+    window_maps = wm;
+
+    return wm;
+}
+
+/*!
+ * \brief Free window mapping.
+ *
+ * Releases the column mapping of the raster map, which is freed when
+ * no other open map uses it.
+ *
+ * \param fd file descriptor
+ */
+void Rast__free_window_mapping(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_window_map *wm = fcb->window_map;
+    struct R_window_map **p;
+
+    fcb->window_map = NULL;
+    fcb->col_map = NULL;
+
+    if (!wm || --wm->refs > 0)
+        return;
+
+    for (p = &window_maps; *p; p = &(*p)->next) {
+        if (*p == wm) {
+            *p = wm->next;
+            break;
+        }
+    }
+
+    G_free(wm->col_map);
+    G_free(wm);
+}
+
+/*!
+ * \brief Create window mapping.
+ *
+ * Creates mapping from cell header into window. The boundaries and
+ * resolution of the two spaces do not have to be the same or aligned in
+ * any way.
+ *
+ * The column mapping is shared by all open raster maps with the same
+ * columns, e.g. the maps of a time series, so it is computed once.
+ *
+ * \param fd file descriptor
+ */
+void Rast__create_window_mapping(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+
+    if (fcb->open_mode >= 0 && fcb->open_mode != OPEN_OLD) /* open for write? */
+        return;
+    if (fcb->open_mode == OPEN_OLD) /* already open ? */
+        Rast__free_window_mapping(fd);
+
+    fcb->window_map = get_window_map(&fcb->cellhd);
+    fcb->col_map = fcb->window_map->col_map;
 
     /* compute C1,C2 for row window mapping */
     fcb->C1 = R__.rd_window.ns_res / fcb->cellhd.ns_res;
@@ -0,0 +1,303 @@
+/*!
+   \file lib/raster/write_behind.c
+
+   \brief Raster library - Background compression of new raster rows
+
+   Rows of new compressed raster maps and of compressed null files are
+   queued by Rast_put_row() and compressed by the worker threads of the
+   GIS library (see G_begin_execute()). A row is written to the file by
+   the calling thread once its slot in the queue is needed again, or
+   when the map is closed, so rows are always written in order and the
+   row addresses are known when the row pointers are written by
+   Rast_close().
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <errno.h>
+
+#include <grass/config.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+
+#include "R.h"
+
+/* collect the cell stats of a row, called by worker threads */
+static void row_stats(struct R_write_behind_slot *slot)
+{
+    if (slot->want_histogram) {
+        Rast_init_cell_stats(&slot->statf);
+        Rast_update_cell_stats(slot->rast, slot->rast_n, &slot->statf);
+    }
+}
+
+static void run_compress(void *closure)
+{
+    struct R_write_behind_slot *slot = closure;
+
+    if (slot->rast_n > 0)
+        row_stats(slot);
+
+    slot->wb->compress(slot);
+}
+
+/* add the statistics of a row to those of the map, the range is
+   updated here, in row order, so that its sums are added up in the
+   same order as without workers */
+static void merge_stats(int fd, struct R_write_behind_slot *slot)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+
+    if (slot->rast_n <= 0)
+        return;
+
+    if (slot->rast_type == CELL_TYPE) {
+        Rast__row_update_range(slot->rast, slot->rast_n, &fcb->range,
+                               slot->ignore_zeros);
+        if (slot->want_histogram) {
+            Rast_merge_cell_stats(&fcb->statf, &slot->statf);
+            Rast_free_cell_stats(&slot->statf);
+        }
+    }
+    else
+        Rast_row_update_fp_range(slot->rast, slot->rast_n, &fcb->fp_range,
+                                 slot->rast_type);
+
+    slot->rast_n = 0;
+}
+
+/* write a compressed row to the cell/fcell or null file */
+static void write_slot(int fd, struct R_write_behind_slot *slot)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+    struct R_write_behind *wb = slot->wb;
+    int file_fd = wb->null_file ? fcb->null_fd : fcb->data_fd;
+    off_t *row_ptr = wb->null_file ? fcb->null_row_ptr : fcb->row_ptr;
+
+    if (slot->row < 0)
+        return;
+
+    G_end_execute(&slot->worker);
+
+    merge_stats(fd, slot);
+
+    if (slot->out_size < 0)
+        G_fatal_error(_("Error compressing data for row %d of <%s>"),
+                      slot->row, fcb->name);
+
+    row_ptr[slot->row] = lseek(file_fd, 0L, SEEK_CUR);
+    if (row_ptr[slot->row] == -1) {
+        int err = errno;
+
+        G_fatal_error(_("File read/write operation failed: %s (%d)"),
+                      strerror(err), err);
+    }
+
+    if (write(file_fd, slot->out, slot->out_size) != slot->out_size) {
+        if (wb->null_file)
+            G_fatal_error(
+                _("Error writing compressed null data for row %d of <%s>: %s"),
+                slot->row, fcb->name, strerror(errno));
+        else
+            G_fatal_error(
+                _("Error writing compressed data for row %d of <%s>: %s"),
+                slot->row, fcb->name, strerror(errno));
+    }
+
+    slot->row = -1;
+}
+
+/*!
+   \brief Create a queue of rows to be compressed in the background
+
+   \param nslots number of rows in the queue
+   \param src_size maximum number of bytes of an uncompressed row
+   \param compressor compression type, used for the size of the buffers
+   \param compress function compressing a row, called by worker threads
+   \param null_file 1 for rows of the null file, 0 for the cell/fcell file
+
+   \return pointer to the new queue
+ */
+struct R_write_behind *
+Rast__create_write_behind(int nslots, int src_size, int compressor,
+                          void (*compress)(struct R_write_behind_slot *),
+                          int null_file)
+{
+    struct R_write_behind *wb = G_calloc(1, sizeof(struct R_write_behind));
+    int dst_size;
+    int i;
+
+    /* RLE of CELL rows is done by the raster library */
+    dst_size =
+        compressor == 1 ? src_size : G_compress_bound(src_size, compressor);
+    if (dst_size < src_size)
+        dst_size = src_size;
+    dst_size++;
+
+    wb->nslots = nslots;
+    wb->next_row = 0;
+    wb->null_file = null_file;
+    wb->compressor = compressor;
+    wb->compress = compress;
+    wb->slots = G_calloc(nslots, sizeof(struct R_write_behind_slot));
+
+    for (i = 0; i < nslots; i++) {
+        struct R_write_behind_slot *slot = &wb->slots[i];
+
+        slot->wb = wb;
+        slot->row = -1;
+        slot->src = G_malloc(src_size);
+        slot->dst = G_malloc(dst_size);
+        slot->dst_size = dst_size;
+    }
+
+    return wb;
+}
+
+/*!
+   \brief Get the queue slot for the next row
+
+   If the slot still holds an older row, that row is written first.
+   The caller converts the row into the <i>src</i> buffer of the slot
+   and then calls Rast__queue_write_behind().
+
+   \param fd file descriptor of the raster map
+   \param wb queue
+
+   \return slot for the next row
+ */
+struct R_write_behind_slot *
+Rast__get_write_behind_slot(int fd, struct R_write_behind *wb)
+{
+    struct R_write_behind_slot *slot = &wb->slots[wb->next_row % wb->nslots];
+
+    write_slot(fd, slot);
+
+    return slot;
+}
+
+/*!
+   \brief Collect the statistics of the next queued row
+
+   For CELL maps with a histogram, the cell stats of the row values are
+   collected by the worker thread compressing the row. They are merged
+   into those of the map, and the row values are added to the range of
+   the map, when the row is written. Must be called before
+   Rast__queue_write_behind().
+
+   \param slot slot returned by Rast__get_write_behind_slot()
+   \param rast row values
+   \param n number of values
+   \param data_type type of the values, the type of the map
+   \param ignore_zeros zeros are not part of the range
+   \param want_histogram 1 to collect cell stats too (CELL only)
+ */
+void Rast__write_behind_stats(struct R_write_behind_slot *slot,
+                              const void *rast, int n,
+                              RASTER_MAP_TYPE data_type, int ignore_zeros,
+                              int want_histogram)
+{
+    size_t size = (size_t)n * Rast_cell_size(data_type);
+
+    if (n <= 0)
+        return;
+
+    slot->rast = G_realloc(slot->rast, size);
+    memcpy(slot->rast, rast, size);
+
+    slot->rast_n = n;
+    slot->rast_type = data_type;
+    slot->ignore_zeros = ignore_zeros;
+    slot->want_histogram = want_histogram && data_type == CELL_TYPE;
+}
+
+/*!
+   \brief Queue the next row for compression
+
+   \param wb queue
+   \param slot slot returned by Rast__get_write_behind_slot()
+   \param row row number
+   \param src_size number of bytes of the uncompressed row in slot->src
+ */
+void Rast__queue_write_behind(struct R_write_behind *wb,
+                              struct R_write_behind_slot *slot, int row,
+                              int src_size)
+{
+    slot->row = row;
+    slot->src_size = src_size;
+    wb->next_row++;
+
+    G_begin_execute(run_compress, slot, &slot->worker, 0);
+}
+
+/* write all queued rows of a queue in order */
+static void flush_write_behind(int fd, struct R_write_behind *wb)
+{
+    int i;
+
+    if (!wb)
+        return;
+
+    for (i = 0; i < wb->nslots; i++)
+        write_slot(fd, &wb->slots[(wb->next_row + i) % wb->nslots]);
+}
+
+static void free_write_behind(struct R_write_behind *wb)
+{
+    int i;
+
+    if (!wb)
+        return;
+
+    for (i = 0; i < wb->nslots; i++) {
+        struct R_write_behind_slot *slot = &wb->slots[i];
+
+        G_end_execute(&slot->worker);
+        if (slot->rast_n > 0 && slot->want_histogram)
+            Rast_free_cell_stats(&slot->statf);
+        G_free(slot->rast);
+        G_free(slot->src);
+        G_free(slot->dst);
+    }
+
+    G_free(wb->slots);
+    G_free(wb);
+}
+
+/*!
+   \brief Write all rows queued for compression
+
+   Must be called before the row pointers of the map are written.
+
+   \param fd file descriptor of the raster map
+ */
+void Rast__flush_write_behind(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+
+    flush_write_behind(fd, fcb->write_behind);
+    flush_write_behind(fd, fcb->null_write_behind);
+}
+
+/*!
+   \brief Free the compression queues of a raster map
+
+   Rows which have not been written yet are discarded.
+
+   \param fd file descriptor of the raster map
+ */
+void Rast__free_write_behind(int fd)
+{
+    struct fileinfo *fcb = &R__.fileinfo[fd];
+
+    free_write_behind(fcb->write_behind);
+    fcb->write_behind = NULL;
+    free_write_behind(fcb->null_write_behind);
+    fcb->null_write_behind = NULL;
+}
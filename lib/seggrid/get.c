@@ -0,0 +1,60 @@
+/*!
+   \file lib/seggrid/get.c
+
+   \brief Segment grid library - read cells
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Markus Metz (from r.watershed and r.stream.extract)
+ */
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/seggrid.h>
+
+/*!
+   \brief Read a cell of a grid
+
+   \param grid grid
+   \param[out] value buffer for one cell
+   \param row,col row and column of the cell
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_get(SEGGRID *grid, void *value, off_t row, off_t col)
+{
+    if (Segment_get(&grid->seg, value, row, col) < 0) {
+        G_warning(_("Unable to read segment file"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Read a row of a grid
+
+   Rows are read directly from the segment file: Seggrid_flush() must
+   be called before reading rows after cells were written with
+   Seggrid_put().
+
+   \param grid grid
+   \param[out] value buffer for one row of cells
+   \param row row to read
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_get_row(SEGGRID *grid, void *value, off_t row)
+{
+    if (Segment_get_row(&grid->seg, value, row) < 0) {
+        G_warning(_("Unable to read segment file"));
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*!
+   \file lib/seggrid/open.c
+
+   \brief Segment grid library - open and close grids
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Markus Metz (from r.watershed and r.stream.extract)
+ */
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/seggrid.h>
+
+static int open_grid(SEGGRID *grid, int type, off_t nrows, off_t ncols,
+                     int srows, int scols, int len, int nseg)
+{
+    char *filename;
+
+    grid->type = type;
+    grid->block_rows = srows;
+    grid->filename = NULL;
+    grid->name = NULL;
+    grid->mapset = NULL;
+
+    /* Segment_open() keeps the grid in memory if all segments fit */
+    filename = G_tempfile();
+    if (Segment_open(&grid->seg, filename, nrows, ncols, srows, scols, len,
+                     nseg) != 1) {
+        G_warning(_("Unable to create temporary grid"));
+        G_free(filename);
+        return -1;
+    }
+    grid->filename = filename;
+
+    return 0;
+}
+
+/*!
+   \brief Open a grid of raster cells
+
+   The grid covers the current region. Cells are of type CELL_TYPE,
+   FCELL_TYPE, DCELL_TYPE or SEGGRID_BYTE. The grid is kept in memory
+   if <i>nseg</i> segments hold all cells, otherwise it is stored in
+   a temporary segment file with <i>nseg</i> segments in memory.
+
+   \param grid grid to open
+   \param type cell type
+   \param srows,scols rows and columns of a segment
+   \param nseg number of segments in memory
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_open(SEGGRID *grid, int type, int srows, int scols, int nseg)
+{
+    int len;
+
+    switch (type) {
+    case CELL_TYPE:
+    case FCELL_TYPE:
+    case DCELL_TYPE:
+        len = Rast_cell_size(type);
+        break;
+    case SEGGRID_BYTE:
+        len = 1;
+        break;
+    default:
+        G_warning(_("Invalid cell type %d for grid"), type);
+        return -1;
+    }
+
+    return open_grid(grid, type, Rast_window_rows(), Rast_window_cols(),
+                     srows, scols, len, nseg);
+}
+
+/*!
+   \brief Open a grid of records
+
+   Each cell of the grid holds a record of <i>len</i> bytes, as
+   defined by the module. Grids of records can not be read from or
+   written to raster maps.
+
+   \param grid grid to open
+   \param nrows,ncols number of rows and columns of the grid
+   \param srows,scols rows and columns of a segment
+   \param len size of a record in bytes
+   \param nseg number of segments in memory
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_open_records(SEGGRID *grid, off_t nrows, off_t ncols, int srows,
+                         int scols, int len, int nseg)
+{
+    return open_grid(grid, SEGGRID_RECORD, nrows, ncols, srows, scols, len,
+                     nseg);
+}
+
+/*!
+   \brief Allow concurrent access to a grid
+
+   After this call, cells and rows of the grid can be read and written
+   by up to <i>nthreads</i> threads at the same time, see
+   Segment_set_concurrent(). Threads must not write the same cell at
+   the same time.
+
+   \param grid grid opened with Seggrid_open() or Seggrid_open_records()
+   \param nthreads number of threads accessing the grid
+
+   \return 0 on success
+   \return -1 if concurrent access is not available
+ */
+int Seggrid_set_concurrent(SEGGRID *grid, int nthreads)
+{
+    if (Segment_set_concurrent(&grid->seg, nthreads) != 1)
+        return -1;
+
+    return 0;
+}
+
+/*!
+   \brief Close a grid
+
+   Frees the memory of the grid and removes its segment file.
+
+   \param grid grid to close
+
+   \return 0
+ */
+int Seggrid_close(SEGGRID *grid)
+{
+    Segment_close(&grid->seg);
+    if (grid->filename) {
+        G_free(grid->filename);
+        grid->filename = NULL;
+    }
+    if (grid->name) {
+        G_free(grid->name);
+        grid->name = NULL;
+    }
+    if (grid->mapset) {
+        G_free(grid->mapset);
+        grid->mapset = NULL;
+    }
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*!
+   \file lib/seggrid/put.c
+
+   \brief Segment grid library - write cells
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Markus Metz (from r.watershed and r.stream.extract)
+ */
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/seggrid.h>
+
+/*!
+   \brief Write a cell of a grid
+
+   \param grid grid
+   \param value cell value
+   \param row,col row and column of the cell
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_put(SEGGRID *grid, const void *value, off_t row, off_t col)
+{
+    if (Segment_put(&grid->seg, value, row, col) < 0) {
+        G_warning(_("Unable to write segment file"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Write a row of a grid
+
+   Rows are written directly to the segment file, bypassing segments
+   in memory. Rows are meant to be written before cells are accessed
+   with Seggrid_get() or Seggrid_put(), e.g. when the grid is filled.
+
+   \param grid grid
+   \param value row of cells
+   \param row row to write
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_put_row(SEGGRID *grid, const void *value, off_t row)
+{
+    if (Segment_put_row(&grid->seg, value, row) < 0) {
+        G_warning(_("Unable to write segment file"));
+        return -1;
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Write pending changes to the segment file
+
+   \param grid grid
+
+   \return 0
+ */
+int Seggrid_flush(SEGGRID *grid)
+{
+    Segment_flush(&grid->seg);
+
+    return 0;
+}
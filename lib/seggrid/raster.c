@@ -0,0 +1,152 @@
+/*!
+   \file lib/seggrid/raster.c
+
+   \brief Segment grid library - read and write raster maps
+
+   (C) 2026 by the GRASS Development Team
+
+   This program is free software under the GNU General Public License
+   (>=v2).  Read the file COPYING that comes with GRASS for details.
+
+   \author Markus Metz (from r.watershed and r.stream.extract)
+ */
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include <grass/seggrid.h>
+
+/*!
+   \brief Read a raster map into a grid
+
+   Rows of compressed maps are decompressed ahead in parallel if
+   worker threads are available (see Rast_set_read_ahead()). Values
+   are converted to the cell type of the grid, SEGGRID_BYTE grids get
+   the CELL values cast to char.
+
+   \param grid grid opened with Seggrid_open()
+   \param name name of the raster map
+   \param mapset mapset of the raster map
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_read_raster(SEGGRID *grid, const char *name, const char *mapset)
+{
+    int map_fd, map_type;
+    int row, rows, col, cols;
+    void *buffer;
+    char *bytes;
+
+    if (grid->type == SEGGRID_RECORD) {
+        G_warning(_("Unable to read raster map <%s> into a grid of records"),
+                  name);
+        return -1;
+    }
+
+    if (grid->name) {
+        G_free(grid->name);
+        grid->name = NULL;
+    }
+    if (grid->mapset) {
+        G_free(grid->mapset);
+        grid->mapset = NULL;
+    }
+
+    map_type = grid->type == SEGGRID_BYTE ? CELL_TYPE : grid->type;
+    map_fd = Rast_open_old(name, mapset);
+    rows = Rast_window_rows();
+    cols = Rast_window_cols();
+    buffer = Rast_allocate_buf(map_type);
+    bytes = grid->type == SEGGRID_BYTE ? G_malloc(cols) : NULL;
+
+    /* decompress the rows of a segment row in parallel */
+    Rast_set_read_ahead(map_fd, grid->block_rows);
+
+    for (row = 0; row < rows; row++) {
+        void *value = buffer;
+
+        Rast_get_row(map_fd, buffer, row, map_type);
+        if (bytes) {
+            for (col = 0; col < cols; col++)
+                bytes[col] = (char)((CELL *)buffer)[col];
+            value = bytes;
+        }
+        if (Segment_put_row(&grid->seg, value, row) < 0) {
+            G_warning(_("Unable to write row %d of raster map <%s> to "
+                        "segment file"),
+                      row, name);
+            G_free(buffer);
+            if (bytes)
+                G_free(bytes);
+            Rast_close(map_fd);
+            return -1;
+        }
+    }
+
+    Rast_close(map_fd);
+    G_free(buffer);
+    if (bytes)
+        G_free(bytes);
+
+    grid->name = G_store(name);
+    grid->mapset = G_store(mapset);
+
+    return 0;
+}
+
+/*!
+   \brief Write a grid to a new raster map
+
+   The raster map gets the cell type of the grid, SEGGRID_BYTE grids
+   are written as CELL maps. Rows are compressed in the background if
+   worker threads are available (see Rast_set_write_behind()).
+
+   \param grid grid opened with Seggrid_open()
+   \param name name of the new raster map
+
+   \return 0 on success
+   \return -1 on error
+ */
+int Seggrid_write_raster(SEGGRID *grid, const char *name)
+{
+    int map_fd, map_type;
+    int row, rows, col, cols;
+    void *buffer;
+    char *bytes;
+
+    if (grid->type == SEGGRID_RECORD) {
+        G_warning(_("Unable to write a grid of records to raster map <%s>"),
+                  name);
+        return -1;
+    }
+
+    map_type = grid->type == SEGGRID_BYTE ? CELL_TYPE : grid->type;
+    map_fd = Rast_open_new(name, map_type);
+    Rast_set_write_behind(map_fd, grid->block_rows);
+    rows = Rast_window_rows();
+    cols = Rast_window_cols();
+    buffer = Rast_allocate_buf(map_type);
+    bytes = grid->type == SEGGRID_BYTE ? G_malloc(cols) : NULL;
+
+    Segment_flush(&grid->seg);
+    for (row = 0; row < rows; row++) {
+        G_percent(row, rows, 1);
+        if (bytes) {
+            Segment_get_row(&grid->seg, bytes, row);
+            for (col = 0; col < cols; col++)
+                ((CELL *)buffer)[col] = bytes[col];
+        }
+        else
+            Segment_get_row(&grid->seg, buffer, row);
+        Rast_put_row(map_fd, buffer, map_type);
+    }
+    G_percent(row, rows, 1); /* finish it */
+
+    G_free(buffer);
+    if (bytes)
+        G_free(bytes);
+    Rast_close(map_fd);
+
+    return 0;
+}
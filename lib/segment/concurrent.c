@@ -0,0 +1,158 @@
+/**
+ * \file lib/segment/concurrent.c
+ *
+ * \brief Segment concurrent access routines.
+ *
+ * In concurrent mode, the segments in memory are split into shards by
+ * segment number. Each shard is a page table with its own lock, so that
+ * threads working on different segments rarely wait for each other.
+ * Dirty segments are written back to the segment file by the worker
+ * threads of the GIS library (see G_begin_execute()) while the caller
+ * goes on.
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2). Read the file COPYING that comes with GRASS for details.
+ *
+ * \author GRASS Development Team
+ *
+ * \date 2026
+ */
+
+#include <string.h>
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+
+#include "local_proto.h"
+
+/**
+ * \brief Internal use only
+ *
+ * Get a value from segment <b>n</b> in concurrent mode.
+ *
+ * \param[in] SEG segment
+ * \param[out] buf value return buffer
+ * \param[in] n segment number
+ * \param[in] index offset of the value in the segment
+ * \return 1 if successful
+ * \return -1 if unable to read segment file
+ */
+int seg_get_concurrent(SEGMENT *SEG, void *buf, int n, int index)
+{
+    struct seg_shard *sh = SEG_SHARD(SEG, n);
+    int i;
+
+    seg_lock(sh);
+    if ((i = seg_pagein(SEG, sh, n)) >= 0)
+        memcpy(buf, &SEG->scb[i].buf[index], SEG->len);
+    seg_unlock(sh);
+
+    return i < 0 ? -1 : 1;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Put a value into segment <b>n</b> in concurrent mode.
+ *
+ * \param[in,out] SEG segment
+ * \param[in] buf value
+ * \param[in] n segment number
+ * \param[in] index offset of the value in the segment
+ * \return 1 if successful
+ * \return -1 if unable to read or write segment file
+ */
+int seg_put_concurrent(SEGMENT *SEG, const void *buf, int n, int index)
+{
+    struct seg_shard *sh = SEG_SHARD(SEG, n);
+    int i;
+
+    seg_lock(sh);
+    if ((i = seg_pagein(SEG, sh, n)) >= 0) {
+        SEG->scb[i].dirty = 1;
+        memcpy(&SEG->scb[i].buf[index], buf, SEG->len);
+    }
+    seg_unlock(sh);
+
+    if (i < 0) {
+        G_warning("segment lib: put: pagein failed");
+        return -1;
+    }
+
+    return 1;
+}
+
+#ifdef SEG_THREADS
+
+/**
+ * \brief Allow concurrent access to a segment.
+ *
+ * After this call, Segment_get(), Segment_put(), Segment_get_row() and
+ * Segment_put_row() can be called from up to <b>nthreads</b> threads
+ * at the same time. The segments in memory are split into shards with
+ * separate locks, dirty segments are written back to the segment file
+ * in the background by the worker threads of the GIS library (see the
+ * WORKERS environment variable).
+ *
+ * Each shard keeps two more segments in memory for writing them back.
+ * Threads must not put values into the same cell at the same time.
+ * As in sequential mode, Segment_flush() must be called before rows
+ * are read with Segment_get_row().
+ *
+ * Segments that are kept in memory as a whole (see Segment_open())
+ * can always be accessed concurrently, nothing is changed for them.
+ *
+ * \param[in,out] SEG segment
+ * \param[in] nthreads number of threads accessing the segment
+ * \return 1 if successful
+ * \return -1 if the segment is not open or unable to write segment file
+ */
+int Segment_set_concurrent(SEGMENT *SEG, int nthreads)
+{
+    int nshards, policy;
+
+    if (SEG->open != 1)
+        return -1;
+
+    if (SEG->cache || SEG->concurrent)
+        return 1;
+
+    /* segments are loaded again by the shards */
+    if (seg_unload(SEG) < 0)
+        return -1;
+    policy = SEG->shards->policy;
+    seg_free_shards(SEG);
+
+    /* a few shards per thread, a few slots per shard */
+    nshards = 4 * (nthreads > 1 ? nthreads : 1);
+    if (nshards > SEG->nseg / 4)
+        nshards = SEG->nseg / 4;
+    if (nshards < 1)
+        nshards = 1;
+
+    G_init_workers();
+
+    seg_init_shards(SEG, nshards, 1, policy);
+    G_debug(1, "Segment_set_concurrent: %d shards of %d segments", nshards,
+            SEG->nseg / nshards);
+
+    return 1;
+}
+
+#else
+
+int Segment_set_concurrent(SEGMENT *SEG, int nthreads G_UNUSED)
+{
+    if (SEG->open != 1)
+        return -1;
+
+    if (SEG->cache)
+        return 1;
+
+    G_warning(_("Concurrent access to segment files is not supported on "
+                "this platform"));
+
+    return -1;
+}
+
+#endif
@@ -13,6 +13,43 @@
 
 #include "local_proto.h"
 
+/**
+ * \brief Internal use only
+ *
+ * Writes all dirty segments and waits for background reads and
+ * writes.
+ *
+ * \param[in] SEG segment
+ * \return 1 if successful
+ * \return -1 if unable to read or write segment file
+ */
+int seg_flush(SEGMENT *SEG)
+{
+    int s, i, ret = 1;
+
+    for (s = 0; s < SEG->nshards; s++) {
+        struct seg_shard *sh = &SEG->shards[s];
+
+        seg_lock(sh);
+        for (i = sh->first; sh->npending && i < sh->first + sh->nslots; i++) {
+            if (seg_finish_read(sh, i) < 0)
+                ret = -1;
+        }
+        for (i = 0; sh->wb && i < SEG_WRITEBACKS; i++) {
+            if (seg_io_finish(&sh->wb[i]) < 0)
+                ret = -1;
+        }
+        for (i = sh->first; i < sh->first + sh->nslots; i++) {
+            if (SEG->scb[i].n >= 0 && SEG->scb[i].dirty &&
+                seg_pageout(SEG, i) < 0)
+                ret = -1;
+        }
+        seg_unlock(sh);
+    }
+
+    return ret;
+}
+
 /**
  * \fn int Segment_flush (SEGMENT *SEG)
  *
@@ -23,18 +60,16 @@
  * final <i>Segment_put()</i> to force all pending updates to disk. Must
  * also be called before the first call to <i>Segment_get_row</i>.
  *
+ * Also waits for segments that are read or written in the background
+ * (see Segment_prefetch() and Segment_set_concurrent()).
+ *
  * \param[in] SEG segment
  * \return always returns 0
  */
 int Segment_flush(SEGMENT *SEG)
 {
-    int i;
-
-    if (SEG->scb) {
-        for (i = 0; i < SEG->nseg; i++)
-            if (SEG->scb[i].n >= 0 && SEG->scb[i].dirty)
-                seg_pageout(SEG, i);
-    }
+    if (SEG->scb)
+        seg_flush(SEG);
 
     return 0;
 }
@@ -45,7 +45,9 @@ int Segment_get(SEGMENT *SEG, void *buf, off_t row, off_t col)
     }
 
     SEG->address(SEG, row, col, &n, &index);
-    if ((i = seg_pagein(SEG, n)) < 0)
+    if (SEG->concurrent)
+        return seg_get_concurrent(SEG, buf, n, index);
+    if ((i = seg_pagein(SEG, SEG->shards, n)) < 0)
         return -1;
 
     memcpy(buf, &SEG->scb[i].buf[index], SEG->len);
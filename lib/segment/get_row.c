@@ -60,14 +60,7 @@ int Segment_get_row(const SEGMENT *SEG, void *buf, off_t row)
 
     for (col = 0; col < ncols; col += scols) {
         SEG->address(SEG, row, col, &n, &index);
-        if (SEG->seek(SEG, n, index) == -1) {
-            int err = errno;
-            G_warning(_("File read/write operation failed: %s (%d)"),
-                      strerror(err), err);
-            return -1;
-        }
-
-        if (read(SEG->fd, buf, size) != size) {
+        if (seg_read(SEG, n, index, buf, size) != size) {
             G_warning("Segment_get_row: %s", strerror(errno));
             return -1;
         }
@@ -81,14 +74,7 @@ int Segment_get_row(const SEGMENT *SEG, void *buf, off_t row)
     }
     if ((size = SEG->spill * SEG->len)) {
         SEG->address(SEG, row, col, &n, &index);
-        if (SEG->seek(SEG, n, index) == -1) {
-            int err = errno;
-            G_warning(_("File read/write operation failed: %s (%d)"),
-                      strerror(err), err);
-            return -1;
-        }
-
-        if (read(SEG->fd, buf, size) != size) {
+        if (seg_read(SEG, n, index, buf, size) != size) {
             G_warning("Segment_get_row: %s", strerror(errno));
             return -1;
         }
@@ -0,0 +1,169 @@
+/**
+ * \file lib/segment/io.c
+ *
+ * \brief Segment background read and write routines.
+ *
+ * Segments are read and written by the worker threads of the GIS
+ * library (see G_begin_execute()) while the caller goes on. Without
+ * threads, the read or write is done immediately.
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2). Read the file COPYING that comes with GRASS for details.
+ *
+ * \author GRASS Development Team
+ *
+ * \date 2026
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+
+#include "local_proto.h"
+
+static void run_io(void *closure)
+{
+    struct seg_io *io = closure;
+    const SEGMENT *SEG = io->SEG;
+    ssize_t result;
+    int err;
+
+    errno = 0;
+    if (io->write)
+        result = seg_write(SEG, io->n, 0, io->buf, SEG->size);
+    else {
+        result = seg_read(SEG, io->n, 0, io->buf, SEG->size);
+        /* not zero-filled, see seg_pagein() */
+        if (result == 0)
+            memset(io->buf, 0, SEG->size);
+    }
+    err = errno;
+
+#ifdef SEG_THREADS
+    pthread_mutex_lock(&io->mutex);
+#endif
+    io->result = result;
+    io->error = err;
+    io->busy = 0;
+#ifdef SEG_THREADS
+    pthread_cond_signal(&io->done);
+    pthread_mutex_unlock(&io->mutex);
+#endif
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Initialize a background read or write.
+ *
+ * \param[in] SEG segment
+ * \param[out] io read or write
+ */
+void seg_io_init(SEGMENT *SEG, struct seg_io *io)
+{
+    io->SEG = SEG;
+    io->buf = NULL;
+    io->n = -1;
+    io->write = 0;
+    io->result = 0;
+    io->error = 0;
+    io->busy = 0;
+    io->worker = NULL;
+#ifdef SEG_THREADS
+    pthread_mutex_init(&io->mutex, NULL);
+    pthread_cond_init(&io->done, NULL);
+#endif
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Start reading or writing segment <b>n</b> in the background. The
+ * buffer must not be touched until seg_io_finish() is called.
+ *
+ * \param[in,out] io read or write, finished
+ * \param[in] n segment number
+ * \param[in,out] buf data of the segment
+ * \param[in] write 1 to write, 0 to read the segment
+ */
+void seg_io_start(struct seg_io *io, int n, char *buf, int write)
+{
+    io->n = n;
+    io->buf = buf;
+    io->write = write;
+    io->busy = 1;
+#ifdef SEG_THREADS
+    G_begin_execute(run_io, io, &io->worker, 0);
+#else
+    run_io(io);
+#endif
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Wait for a background read or write and report errors.
+ *
+ * \param[in,out] io read or write
+ * \return 1 if successful or nothing was started
+ * \return -1 if unable to read or write segment file
+ */
+int seg_io_finish(struct seg_io *io)
+{
+    const SEGMENT *SEG = io->SEG;
+    ssize_t result;
+    int err;
+
+    if (io->n < 0)
+        return 1;
+
+#ifdef SEG_THREADS
+    pthread_mutex_lock(&io->mutex);
+    while (io->busy)
+        pthread_cond_wait(&io->done, &io->mutex);
+#endif
+    result = io->result;
+    err = io->error;
+#ifdef SEG_THREADS
+    pthread_mutex_unlock(&io->mutex);
+    G_end_execute(&io->worker);
+#endif
+    io->n = -1;
+
+    if (io->write && result != SEG->size) {
+        if (err)
+            G_warning("Segment pageout: %s", strerror(err));
+        else
+            G_warning("Segment pageout: insufficient disk space?");
+        return -1;
+    }
+    if (!io->write && result != 0 && result != SEG->size) {
+        if (result < 0)
+            G_warning("Segment pagein: %s", strerror(err));
+        else
+            G_warning("Segment pagein: short count during read(), got %d, "
+                      "expected %d",
+                      (int)result, SEG->size);
+        return -1;
+    }
+
+    return 1;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Wait for a background read or write and free it.
+ *
+ * \param[in,out] io read or write
+ */
+void seg_io_free(struct seg_io *io)
+{
+    seg_io_finish(io);
+#ifdef SEG_THREADS
+    pthread_mutex_destroy(&io->mutex);
+    pthread_cond_destroy(&io->done);
+#endif
+}
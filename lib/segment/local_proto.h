@@ -3,6 +3,74 @@
 
 #include <grass/segment.h>
 
+/* reads and writes on worker threads need pread() and pwrite() */
+#if defined(HAVE_PTHREAD_H) && !defined(_WIN32)
+#define SEG_THREADS
+#include <pthread.h>
+#endif
+
+/* segments of a shard being written back at the same time */
+#define SEG_WRITEBACKS 2
+
+/* read or write of a segment on a worker thread */
+struct seg_io {
+    const SEGMENT *SEG;
+    char *buf;      /* data of the segment */
+    int n;          /* segment number, -1 if none */
+    int write;      /* write instead of read */
+    ssize_t result; /* bytes read or written */
+    int error;      /* errno of a failed read or write */
+    int busy;       /* read or write is running */
+    void *worker;   /* worker doing the read or write */
+#ifdef SEG_THREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t done;
+#endif
+};
+
+/* page table of the segments in memory, or of a shard of them */
+struct seg_shard {
+#ifdef SEG_THREADS
+    pthread_mutex_t mutex;
+#endif
+    int concurrent;       /* lock the shard */
+    int policy;           /* eviction policy */
+    int first, nslots;    /* slots of the shard in SEG->scb */
+    struct aq *agequeue,  /* queue of age for order of access */
+        *youngest,        /* youngest in age queue */
+        *oldest;          /* oldest in age queue */
+    int *freeslot;        /* array of free slots */
+    int nfreeslots;       /* number of free slots */
+    int cur;              /* last accessed slot */
+    char *ref;            /* CLOCK: slot was accessed */
+    int hand;             /* CLOCK: next slot to look at */
+    int wave_row;         /* WAVEFRONT: segment row and column */
+    int wave_col;         /* of the last prefetch, -1 if none */
+    struct seg_io *reads; /* prefetch of each slot, or NULL */
+    int npending;         /* prefetched segments not yet accessed */
+    struct seg_io *wb;    /* write-back buffers, or NULL */
+    int next_wb;          /* next write-back buffer to use */
+};
+
+static inline void seg_lock(struct seg_shard *sh)
+{
+#ifdef SEG_THREADS
+    if (sh->concurrent)
+        pthread_mutex_lock(&sh->mutex);
+#endif
+}
+
+static inline void seg_unlock(struct seg_shard *sh)
+{
+#ifdef SEG_THREADS
+    if (sh->concurrent)
+        pthread_mutex_unlock(&sh->mutex);
+#endif
+}
+
+/* shard of segment n */
+#define SEG_SHARD(SEG, n) (&(SEG)->shards[(n) % (SEG)->nshards])
+
 /* internal functions */
 
 /* address.c */
@@ -10,18 +78,45 @@ int seg_address(const SEGMENT *, off_t, off_t, int *, int *);
 int seg_address_fast(const SEGMENT *, off_t, off_t, int *, int *);
 int seg_address_slow(const SEGMENT *, off_t, off_t, int *, int *);
 
+/* concurrent.c */
+int seg_get_concurrent(SEGMENT *, void *, int, int);
+int seg_put_concurrent(SEGMENT *, const void *, int, int);
+
+/* flush.c */
+int seg_flush(SEGMENT *);
+
+/* io.c */
+void seg_io_init(SEGMENT *, struct seg_io *);
+void seg_io_start(struct seg_io *, int, char *, int);
+int seg_io_finish(struct seg_io *);
+void seg_io_free(struct seg_io *);
+
 /* pagein.c */
-int seg_pagein(SEGMENT *, int);
+int seg_pagein(SEGMENT *, struct seg_shard *, int);
+int seg_getslot(SEGMENT *, struct seg_shard *, int, int);
+void seg_addslot(SEGMENT *, struct seg_shard *, int, int);
+int seg_wait_write_back(struct seg_shard *, int);
+int seg_finish_read(struct seg_shard *, int);
 
 /* pageout.c */
 int seg_pageout(SEGMENT *, int);
 
+/* policy.c */
+void seg_touch(SEGMENT *, struct seg_shard *, int);
+void seg_youngest(SEGMENT *, struct seg_shard *, int);
+int seg_victim(SEGMENT *, struct seg_shard *, int, int);
+
 /* seek.c */
 int seg_seek(const SEGMENT *, int, int);
 int seg_seek_fast(const SEGMENT *, int, int);
 int seg_seek_slow(const SEGMENT *, int, int);
+ssize_t seg_read(const SEGMENT *, int, int, void *, size_t);
+ssize_t seg_write(const SEGMENT *, int, int, const void *, size_t);
 
 /* setup.c */
 int seg_setup(SEGMENT *);
+void seg_init_shards(SEGMENT *, int, int, int);
+int seg_unload(SEGMENT *);
+void seg_free_shards(SEGMENT *);
 
 #endif /* Segment_LOCAL_H */
@@ -58,6 +58,9 @@ int Segment_open(SEGMENT *SEG, char *fname, off_t nrows, off_t ncols, int srows,
         SEG->nseg = nseg;
         SEG->cache = G_calloc(sizeof(char) * SEG->nrows * SEG->ncols, SEG->len);
         SEG->scb = NULL;
+        SEG->shards = NULL;
+        SEG->nshards = 0;
+        SEG->concurrent = 0;
         SEG->open = 1;
 
         return 1;
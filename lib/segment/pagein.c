@@ -21,83 +21,197 @@
 
 #include "local_proto.h"
 
+/**
+ * \brief Internal use only
+ *
+ * Waits until segment <b>n</b> is written back, if a write-back of it
+ * is pending in shard <b>sh</b>.
+ *
+ * \param[in,out] sh page table
+ * \param[in] n segment number
+ * \return 1 if successful
+ * \return -1 if unable to write segment file
+ */
+int seg_wait_write_back(struct seg_shard *sh, int n)
+{
+    int i;
+
+    if (!sh->wb)
+        return 1;
+
+    for (i = 0; i < SEG_WRITEBACKS; i++) {
+        if (sh->wb[i].n == n && seg_io_finish(&sh->wb[i]) < 0)
+            return -1;
+    }
+
+    return 1;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Waits until a prefetched segment is read into <b>slot</b>, if the
+ * read is pending.
+ *
+ * \param[in,out] sh page table
+ * \param[in] slot slot of the segment
+ * \return 1 if successful
+ * \return -1 if unable to read segment file
+ */
+int seg_finish_read(struct seg_shard *sh, int slot)
+{
+    struct seg_io *io;
+
+    if (!sh->npending)
+        return 1;
+
+    io = &sh->reads[slot - sh->first];
+    if (io->n < 0)
+        return 1;
+
+    sh->npending--;
+
+    return seg_io_finish(io);
+}
+
+/* hand a dirty slot to a worker, the slot gets a free buffer */
+static int write_back(SEGMENT *SEG, struct seg_shard *sh, int slot)
+{
+    struct seg_io *wb = &sh->wb[sh->next_wb];
+    char *buf;
+
+    sh->next_wb = (sh->next_wb + 1) % SEG_WRITEBACKS;
+    if (seg_io_finish(wb) < 0)
+        return -1;
+
+    buf = wb->buf;
+    seg_io_start(wb, SEG->scb[slot].n, SEG->scb[slot].buf, 1);
+    SEG->scb[slot].buf = buf;
+    SEG->scb[slot].dirty = 0;
+
+    return 1;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Finds a slot for segment <b>n</b>, a free slot or one chosen by the
+ * eviction policy. The segment in the slot is unloaded and written out
+ * if dirty.
+ *
+ * \param[in,out] SEG segment
+ * \param[in,out] sh page table
+ * \param[in] n segment number
+ * \param[in] keep_cur do not use the last accessed slot
+ * \return slot number
+ * \return -1 if unable to read or write segment file
+ * \return -2 if only the last accessed slot could be used
+ */
+int seg_getslot(SEGMENT *SEG, struct seg_shard *sh, int n, int keep_cur)
+{
+    int cur;
+
+    /* free slots left, the last accessed slot is among them only
+     * before the first access and given out last */
+    if (sh->nfreeslots) {
+        if (keep_cur && sh->freeslot[sh->nfreeslots - 1] == sh->cur)
+            return -2;
+        return sh->freeslot[--sh->nfreeslots];
+    }
+
+    if ((cur = seg_victim(SEG, sh, n, keep_cur)) < 0)
+        return cur;
+
+    /* a prefetched segment may still be read */
+    if (seg_finish_read(sh, cur) < 0)
+        return -1;
+
+    /* unload segment */
+    if (SEG->scb[cur].n >= 0) {
+        SEG->load_idx[SEG->scb[cur].n] = -1;
+
+        /* write it out if dirty */
+        if (SEG->scb[cur].dirty) {
+            if (sh->wb) {
+                if (write_back(SEG, sh, cur) < 0)
+                    return -1;
+            }
+            else if (seg_pageout(SEG, cur) < 0)
+                return -1;
+        }
+        SEG->scb[cur].n = -1;
+    }
+
+    return cur;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Adds segment <b>n</b> in <b>slot</b> to the index of loaded segments.
+ *
+ * \param[in,out] SEG segment
+ * \param[in,out] sh page table
+ * \param[in] slot slot of the segment
+ * \param[in] n segment number
+ */
+void seg_addslot(SEGMENT *SEG, struct seg_shard *sh, int slot, int n)
+{
+    SEG->scb[slot].n = n;
+    SEG->scb[slot].dirty = 0;
+    SEG->load_idx[n] = slot;
+    seg_youngest(SEG, sh, slot);
+}
+
 /**
  * \brief Internal use only
  *
  * Segment pagein.
  *
  * Finds <b>n</b> in the segment file, <b>seg</b>, and selects it as the
- * current segment.
+ * current segment of page table <b>sh</b>. In concurrent mode, the
+ * page table must be locked.
  *
  * \param[in] SEG segment
+ * \param[in,out] sh page table of segment n
  * \param[in] n segment number
- * \return 1 if successful
+ * \return slot of the segment if successful
  * \return -1 if unable to seek or read segment file
  */
-int seg_pagein(SEGMENT *SEG, int n)
+int seg_pagein(SEGMENT *SEG, struct seg_shard *sh, int n)
 {
     int cur;
     int read_result;
 
     /* is n the current segment? */
-    if (n == SEG->scb[SEG->cur].n)
-        return SEG->cur;
+    if (n == SEG->scb[sh->cur].n)
+        return sh->cur;
 
     /* segment n is in memory ? */
 
     if (SEG->load_idx[n] >= 0) {
         cur = SEG->load_idx[n];
 
-        if (SEG->scb[cur].age != SEG->youngest) {
-            /* splice out */
-            SEG->scb[cur].age->younger->older = SEG->scb[cur].age->older;
-            SEG->scb[cur].age->older->younger = SEG->scb[cur].age->younger;
-            /* splice in */
-            SEG->scb[cur].age->younger = SEG->youngest->younger;
-            SEG->scb[cur].age->older = SEG->youngest;
-            SEG->scb[cur].age->older->younger = SEG->scb[cur].age;
-            SEG->scb[cur].age->younger->older = SEG->scb[cur].age;
-            /* make it youngest */
-            SEG->youngest = SEG->scb[cur].age;
-        }
+        /* it may have been prefetched */
+        if (seg_finish_read(sh, cur) < 0)
+            return -1;
 
-        return SEG->cur = cur;
+        seg_touch(SEG, sh, cur);
+
+        return sh->cur = cur;
     }
 
     /* find a slot to use to hold segment */
-    if (!SEG->nfreeslots) {
-        /* use oldest segment */
-        SEG->oldest = SEG->oldest->younger;
-        cur = SEG->oldest->cur;
-        SEG->oldest->cur = -1;
-
-        /* unload segment */
-        if (SEG->scb[cur].n >= 0) {
-            SEG->load_idx[SEG->scb[cur].n] = -1;
-
-            /* write it out if dirty */
-            if (SEG->scb[cur].dirty) {
-                if (seg_pageout(SEG, cur) < 0)
-                    return -1;
-            }
-        }
-    }
-    else {
-        /* free slots left */
-        cur = SEG->freeslot[--SEG->nfreeslots];
-    }
+    if ((cur = seg_getslot(SEG, sh, n, 0)) < 0)
+        return -1;
 
-    /* read in the segment */
-    SEG->scb[cur].n = n;
-    SEG->scb[cur].dirty = 0;
-    if (SEG->seek(SEG, SEG->scb[cur].n, 0) == -1) {
-        int err = errno;
-        G_warning(_("File read/write operation failed: %s (%d)"), strerror(err),
-                  err);
+    /* segment n may still be written back */
+    if (seg_wait_write_back(sh, n) < 0)
         return -1;
-    }
 
-    read_result = read(SEG->fd, SEG->scb[cur].buf, SEG->size);
+    /* read in the segment */
+    errno = 0;
+    read_result = seg_read(SEG, n, 0, SEG->scb[cur].buf, SEG->size);
 
     if (read_result == 0) {
         /* this can happen if the file was not zero-filled,
@@ -120,13 +234,8 @@ int seg_pagein(SEGMENT *SEG, int n)
         return -1;
     }
 
-    /* add loaded segment to index */
-    SEG->load_idx[n] = cur;
-
-    /* make it youngest segment */
-    SEG->youngest = SEG->youngest->younger;
-    SEG->scb[cur].age = SEG->youngest;
-    SEG->youngest->cur = cur;
+    /* add loaded segment to index, make it youngest segment */
+    seg_addslot(SEG, sh, cur, n);
 
-    return SEG->cur = cur;
+    return sh->cur = cur;
 }
@@ -36,14 +36,9 @@
  */
 int seg_pageout(SEGMENT *SEG, int i)
 {
-    if (SEG->seek(SEG, SEG->scb[i].n, 0) == -1) {
-        int err = errno;
-        G_warning(_("File read/write operation failed: %s (%d)"), strerror(err),
-                  err);
-        return -1;
-    }
     errno = 0;
-    if (write(SEG->fd, SEG->scb[i].buf, SEG->size) != SEG->size) {
+    if (seg_write(SEG, SEG->scb[i].n, 0, SEG->scb[i].buf, SEG->size) !=
+        SEG->size) {
         int err = errno;
 
         if (err)
@@ -0,0 +1,216 @@
+/**
+ * \file lib/segment/policy.c
+ *
+ * \brief Segment eviction policies.
+ *
+ * When no slot is free, the eviction policy of a page table chooses
+ * the segment that makes room for a new one:
+ *
+ *  - SEGMENT_LRU: the least recently used segment
+ *  - SEGMENT_CLOCK: the next segment not used since the clock hand
+ *    passed it the last time
+ *  - SEGMENT_WAVEFRONT: the segment farthest from the position of the
+ *    last Segment_prefetch(), or from the segment to be loaded if
+ *    nothing was prefetched
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2). Read the file COPYING that comes with GRASS for details.
+ *
+ * \author GRASS Development Team
+ *
+ * \date 2026
+ */
+
+#include <stdlib.h>
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+
+#include "local_proto.h"
+
+/**
+ * \brief Internal use only
+ *
+ * Notes an access to the segment in <b>slot</b>.
+ *
+ * \param[in,out] SEG segment
+ * \param[in,out] sh page table
+ * \param[in] slot slot of the segment
+ */
+void seg_touch(SEGMENT *SEG, struct seg_shard *sh, int slot)
+{
+    struct aq *age;
+
+    switch (sh->policy) {
+    case SEGMENT_LRU:
+        age = SEG->scb[slot].age;
+        if (age != sh->youngest) {
+            /* splice out */
+            age->younger->older = age->older;
+            age->older->younger = age->younger;
+            /* splice in */
+            age->younger = sh->youngest->younger;
+            age->older = sh->youngest;
+            age->older->younger = age;
+            age->younger->older = age;
+            /* make it youngest */
+            sh->youngest = age;
+        }
+        break;
+    case SEGMENT_CLOCK:
+        sh->ref[slot - sh->first] = 1;
+        break;
+    }
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Makes the segment just loaded into <b>slot</b> the youngest one.
+ *
+ * \param[in,out] SEG segment
+ * \param[in,out] sh page table
+ * \param[in] slot slot of the segment
+ */
+void seg_youngest(SEGMENT *SEG, struct seg_shard *sh, int slot)
+{
+    switch (sh->policy) {
+    case SEGMENT_LRU:
+        sh->youngest = sh->youngest->younger;
+        SEG->scb[slot].age = sh->youngest;
+        sh->youngest->cur = slot;
+        break;
+    case SEGMENT_CLOCK:
+        sh->ref[slot - sh->first] = 1;
+        break;
+    }
+}
+
+/* segment farthest from the wavefront, in segment rows or columns */
+static int farthest(SEGMENT *SEG, struct seg_shard *sh, int n, int keep_cur)
+{
+    int wave_row, wave_col, slot, m, d, best, best_d;
+
+    if (sh->wave_row >= 0) {
+        wave_row = sh->wave_row;
+        wave_col = sh->wave_col;
+    }
+    else {
+        wave_row = n / SEG->spr;
+        wave_col = n % SEG->spr;
+    }
+
+    best = -2;
+    best_d = -1;
+    for (slot = sh->first; slot < sh->first + sh->nslots; slot++) {
+        if (keep_cur && slot == sh->cur)
+            continue;
+        if ((m = SEG->scb[slot].n) < 0)
+            return slot;
+        d = abs(m / SEG->spr - wave_row);
+        if (d < abs(m % SEG->spr - wave_col))
+            d = abs(m % SEG->spr - wave_col);
+        if (d > best_d) {
+            best = slot;
+            best_d = d;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Chooses the slot to be used for segment <b>n</b> if no slot is free.
+ *
+ * \param[in,out] SEG segment
+ * \param[in,out] sh page table
+ * \param[in] n segment number
+ * \param[in] keep_cur do not choose the last accessed slot
+ * \return slot number
+ * \return -2 if only the last accessed slot could be chosen
+ */
+int seg_victim(SEGMENT *SEG, struct seg_shard *sh, int n, int keep_cur)
+{
+    int slot;
+
+    switch (sh->policy) {
+    case SEGMENT_CLOCK:
+        if (keep_cur && sh->nslots == 1)
+            return -2;
+        for (;;) {
+            slot = sh->first + sh->hand;
+            if (++sh->hand == sh->nslots)
+                sh->hand = 0;
+            if (keep_cur && slot == sh->cur)
+                continue;
+            if (!sh->ref[slot - sh->first])
+                return slot;
+            /* second chance */
+            sh->ref[slot - sh->first] = 0;
+        }
+    case SEGMENT_WAVEFRONT:
+        return farthest(SEG, sh, n, keep_cur);
+    default:
+        /* use oldest segment */
+        if (keep_cur && sh->oldest->younger->cur == sh->cur)
+            return -2;
+        sh->oldest = sh->oldest->younger;
+        slot = sh->oldest->cur;
+        sh->oldest->cur = -1;
+        return slot;
+    }
+}
+
+/**
+ * \brief Set the eviction policy of a segment.
+ *
+ * Chooses which segment in memory is replaced when another one must
+ * be loaded:
+ *
+ *  - SEGMENT_LRU (default): the least recently used segment
+ *  - SEGMENT_CLOCK: an approximation of LRU with less bookkeeping for
+ *    each access
+ *  - SEGMENT_WAVEFRONT: the segment farthest from the position of the
+ *    last call to Segment_prefetch(). Meant for algorithms that sweep
+ *    along a straight front, not for fronts closing around a point
+ *    like the search for a cost surface. The search for the segment
+ *    takes longer with many segments in memory.
+ *
+ * All segments in memory are written out if dirty and unloaded.
+ * Nothing is changed for segments that are kept in memory as a whole
+ * (see Segment_open()).
+ *
+ * \param[in,out] SEG segment
+ * \param[in] policy eviction policy
+ * \return 1 if successful
+ * \return -1 if the segment is not open, the policy is unknown or
+ * unable to write segment file
+ */
+int Segment_set_policy(SEGMENT *SEG, int policy)
+{
+    int nshards, concurrent;
+
+    if (SEG->open != 1)
+        return -1;
+
+    if (policy != SEGMENT_LRU && policy != SEGMENT_CLOCK &&
+        policy != SEGMENT_WAVEFRONT) {
+        G_warning(_("Unknown segment eviction policy %d"), policy);
+        return -1;
+    }
+
+    if (SEG->cache)
+        return 1;
+
+    if (seg_unload(SEG) < 0)
+        return -1;
+
+    nshards = SEG->nshards;
+    concurrent = SEG->concurrent;
+    seg_free_shards(SEG);
+    seg_init_shards(SEG, nshards, concurrent, policy);
+
+    return 1;
+}
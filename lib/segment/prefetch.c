@@ -0,0 +1,145 @@
+/**
+ * \file lib/segment/prefetch.c
+ *
+ * \brief Segment prefetch routines.
+ *
+ * This program is free software under the GNU General Public License
+ * (>=v2). Read the file COPYING that comes with GRASS for details.
+ *
+ * \author GRASS Development Team
+ *
+ * \date 2026
+ */
+
+#include <grass/gis.h>
+
+#include "local_proto.h"
+
+/* start reading segment n into a slot of its page table */
+static int prefetch(SEGMENT *SEG, int n)
+{
+    struct seg_shard *sh = SEG_SHARD(SEG, n);
+    int i, cur, ret = 1;
+
+    seg_lock(sh);
+
+    /* keep half of the slots for segments in use */
+    if (SEG->load_idx[n] >= 0 || sh->npending >= sh->nslots / 2) {
+        seg_unlock(sh);
+        return 1;
+    }
+
+    if (!sh->reads) {
+        G_init_workers();
+        sh->reads = G_malloc(sh->nslots * sizeof(struct seg_io));
+        for (i = 0; i < sh->nslots; i++)
+            seg_io_init(SEG, &sh->reads[i]);
+    }
+
+    /* never the last accessed slot, the caller may still use it */
+    if ((cur = seg_getslot(SEG, sh, n, 1)) < 0)
+        ret = cur == -2 ? 1 : -1;
+    else if (seg_wait_write_back(sh, n) < 0)
+        ret = -1;
+    else {
+        seg_addslot(SEG, sh, cur, n);
+        seg_io_start(&sh->reads[cur - sh->first], n, SEG->scb[cur].buf, 0);
+        sh->npending++;
+    }
+
+    seg_unlock(sh);
+
+    return ret;
+}
+
+/**
+ * \brief Announce access to a part of a segment.
+ *
+ * Starts reading the segments within <b>radius</b> cells of
+ * <b>row</b> and <b>col</b> that are not in memory, nearest first.
+ * The segments are read by the worker threads of the GIS library (see
+ * the WORKERS environment variable) while the caller goes on, a later
+ * Segment_get() or Segment_put() waits only for the rest of the read.
+ * Without worker threads, the segments are read immediately.
+ *
+ * At most half of the segments in memory are read ahead and not yet
+ * accessed at any time, more hints are ignored. The position is also
+ * the wavefront of the SEGMENT_WAVEFRONT eviction policy (see
+ * Segment_set_policy()).
+ *
+ * Prefetched segments replace other segments in memory like any other
+ * access does, so the hints should cover only cells that are needed
+ * soon.
+ *
+ * \param[in,out] SEG segment
+ * \param[in] row
+ * \param[in] col
+ * \param[in] radius distance in cells
+ * \return 1 if successful
+ * \return -1 if the segment is not open or unable to read or write
+ * segment file
+ */
+int Segment_prefetch(SEGMENT *SEG, off_t row, off_t col, int radius)
+{
+    off_t row0, row1, col0, col1;
+    int srow, scol, srow0, srow1, scol0, scol1;
+    int d, dmax, r, c, s;
+
+    if (SEG->open != 1)
+        return -1;
+
+    if (SEG->cache)
+        return 1;
+
+    if (row < 0 || row >= SEG->nrows || col < 0 || col >= SEG->ncols)
+        return 1;
+    if (radius < 0)
+        radius = 0;
+
+    srow = row / SEG->srows;
+    scol = col / SEG->scols;
+
+    for (s = 0; s < SEG->nshards; s++) {
+        seg_lock(&SEG->shards[s]);
+        SEG->shards[s].wave_row = srow;
+        SEG->shards[s].wave_col = scol;
+        seg_unlock(&SEG->shards[s]);
+    }
+
+    /* segments of the window */
+    row0 = row - radius < 0 ? 0 : row - radius;
+    row1 = row + radius >= SEG->nrows ? SEG->nrows - 1 : row + radius;
+    col0 = col - radius < 0 ? 0 : col - radius;
+    col1 = col + radius >= SEG->ncols ? SEG->ncols - 1 : col + radius;
+    srow0 = row0 / SEG->srows;
+    srow1 = row1 / SEG->srows;
+    scol0 = col0 / SEG->scols;
+    scol1 = col1 / SEG->scols;
+
+    dmax = srow - srow0;
+    if (dmax < srow1 - srow)
+        dmax = srow1 - srow;
+    if (dmax < scol - scol0)
+        dmax = scol - scol0;
+    if (dmax < scol1 - scol)
+        dmax = scol1 - scol;
+
+    /* rings of segments around the segment of row, col */
+    for (d = 0; d <= dmax; d++) {
+        for (r = srow - d; r <= srow + d; r++) {
+            if (r < srow0 || r > srow1)
+                continue;
+            for (c = scol - d; c <= scol + d; c++) {
+                if (c < scol0 || c > scol1)
+                    continue;
+                if (r != srow - d && r != srow + d && c != scol - d &&
+                    c != scol + d)
+                    continue;
+                if (prefetch(SEG, r * SEG->spr + c) < 0)
+                    return -1;
+            }
+        }
+    }
+
+    return 1;
+}
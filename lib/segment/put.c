@@ -51,7 +51,9 @@ int Segment_put(SEGMENT *SEG, const void *buf, off_t row, off_t col)
     }
 
     SEG->address(SEG, row, col, &n, &index);
-    if ((i = seg_pagein(SEG, n)) < 0) {
+    if (SEG->concurrent)
+        return seg_put_concurrent(SEG, buf, n, index);
+    if ((i = seg_pagein(SEG, SEG->shards, n)) < 0) {
         G_warning("segment lib: put: pagein failed");
         return -1;
     }
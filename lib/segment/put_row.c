@@ -64,14 +64,7 @@ int Segment_put_row(const SEGMENT *SEG, const void *buf, off_t row)
 
     for (col = 0; col < ncols; col += scols) {
         SEG->address(SEG, row, col, &n, &index);
-        if (SEG->seek(SEG, n, index) == -1) {
-            int err = errno;
-            G_warning(_("File read/write operation failed: %s (%d)"),
-                      strerror(err), err);
-            return -1;
-        }
-
-        if ((result = write(SEG->fd, buf, size)) != size) {
+        if ((result = seg_write(SEG, n, index, buf, size)) != size) {
             G_warning("Segment_put_row write error %s", strerror(errno));
             /*      printf("Segment_put_row result = %d. ncols: %d, scols %d,
              * size: %d, col %d, row: %d,  SEG->fd:
@@ -89,14 +82,7 @@ int Segment_put_row(const SEGMENT *SEG, const void *buf, off_t row)
 
     if ((size = SEG->spill * SEG->len)) {
         SEG->address(SEG, row, col, &n, &index);
-        if (SEG->seek(SEG, n, index) == -1) {
-            int err = errno;
-            G_warning(_("File read/write operation failed: %s (%d)"),
-                      strerror(err), err);
-            return -1;
-        }
-
-        if (write(SEG->fd, buf, size) != size) {
+        if (seg_write(SEG, n, index, buf, size) != size) {
             G_warning("Segment_put_row final write error: %s", strerror(errno));
             return -1;
         }
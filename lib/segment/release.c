@@ -37,12 +37,12 @@ int Segment_release(SEGMENT *SEG)
     if (SEG->open != 1)
         return -1;
 
+    seg_free_shards(SEG);
+
     for (i = 0; i < SEG->nseg; i++)
         G_free(SEG->scb[i].buf);
     G_free(SEG->scb);
 
-    G_free(SEG->freeslot);
-    G_free(SEG->agequeue);
     G_free(SEG->load_idx);
 
     SEG->open = 0;
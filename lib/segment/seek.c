@@ -59,3 +59,68 @@ int seg_seek(const SEGMENT *SEG, int n, int index)
 {
     return SEG->seek(SEG, n, index);
 }
+
+static off_t seg_offset(const SEGMENT *SEG, int n, int index)
+{
+    if (SEG->fast_seek)
+        return SEG_SEEK_FAST(SEG, n, index);
+
+    return SEG_SEEK_SLOW(SEG, n, index);
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Read from a segment at a given position.
+ *
+ * Uses pread() where available, which does not move the file offset,
+ * so that several threads can read from the segment file at the same
+ * time.
+ *
+ * \param[in] SEG segment
+ * \param[in] n segment number
+ * \param[in] index offset into the segment in bytes
+ * \param[out] buf buffer
+ * \param[in] size number of bytes to read
+ * \return number of bytes read
+ * \return -1 on error
+ */
+ssize_t seg_read(const SEGMENT *SEG, int n, int index, void *buf, size_t size)
+{
+#ifndef _WIN32
+    return pread(SEG->fd, buf, size, seg_offset(SEG, n, index));
+#else
+    if (lseek(SEG->fd, seg_offset(SEG, n, index), SEEK_SET) == -1)
+        return -1;
+
+    return read(SEG->fd, buf, size);
+#endif
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Write to a segment at a given position.
+ *
+ * Uses pwrite() where available, see seg_read().
+ *
+ * \param[in] SEG segment
+ * \param[in] n segment number
+ * \param[in] index offset into the segment in bytes
+ * \param[in] buf buffer
+ * \param[in] size number of bytes to write
+ * \return number of bytes written
+ * \return -1 on error
+ */
+ssize_t seg_write(const SEGMENT *SEG, int n, int index, const void *buf,
+                  size_t size)
+{
+#ifndef _WIN32
+    return pwrite(SEG->fd, buf, size, seg_offset(SEG, n, index));
+#else
+    if (lseek(SEG->fd, seg_offset(SEG, n, index), SEEK_SET) == -1)
+        return -1;
+
+    return write(SEG->fd, buf, size);
+#endif
+}
@@ -42,6 +42,9 @@ int seg_setup(SEGMENT *SEG)
 
     SEG->open = 0;
     SEG->cache = NULL;
+    SEG->shards = NULL;
+    SEG->nshards = 0;
+    SEG->concurrent = 0;
 
     if (SEG->nrows <= 0 || SEG->ncols <= 0 || SEG->srows <= 0 ||
         SEG->scols <= 0 || SEG->len <= 0 || SEG->nseg <= 0) {
@@ -119,13 +122,6 @@ int seg_setup(SEGMENT *SEG)
         NULL)
         return -2;
 
-    if ((SEG->freeslot = (int *)G_malloc(SEG->nseg * sizeof(int))) == NULL)
-        return -2;
-
-    if ((SEG->agequeue = (struct aq *)G_malloc((SEG->nseg + 1) *
-                                               sizeof(struct aq))) == NULL)
-        return -2;
-
     SEG->srowscols = SEG->srows * SEG->scols;
     SEG->size = SEG->srowscols * SEG->len;
 
@@ -136,25 +132,11 @@ int seg_setup(SEGMENT *SEG)
         SEG->scb[i].n = -1; /* mark free */
         SEG->scb[i].dirty = 0;
         SEG->scb[i].age = NULL;
-        SEG->freeslot[i] = i;
-        SEG->agequeue[i].cur = -1;
-        if (i > 0) {
-            SEG->agequeue[i].younger = &(SEG->agequeue[i - 1]);
-            SEG->agequeue[i].older = &(SEG->agequeue[i + 1]);
-        }
-        else if (i == 0) {
-            SEG->agequeue[i].younger = &(SEG->agequeue[SEG->nseg]);
-            SEG->agequeue[i].older = &(SEG->agequeue[i + 1]);
-        }
     }
 
-    SEG->agequeue[SEG->nseg].cur = -1;
-    SEG->agequeue[SEG->nseg].younger = &(SEG->agequeue[SEG->nseg - 1]);
-    SEG->agequeue[SEG->nseg].older = &(SEG->agequeue[0]);
-    SEG->youngest = SEG->oldest = &(SEG->agequeue[SEG->nseg]);
+    /* a single page table without locks */
+    seg_init_shards(SEG, 1, 0, SEGMENT_LRU);
 
-    SEG->nfreeslots = SEG->nseg;
-    SEG->cur = 0;
     SEG->open = 1;
 
     /* index for each segment, same like cache of r.proj */
@@ -170,3 +152,151 @@ int seg_setup(SEGMENT *SEG)
 
     return 1;
 }
+
+static void init_shard(SEGMENT *SEG, struct seg_shard *sh, int first,
+                       int nslots, int concurrent, int policy)
+{
+    int i;
+
+#ifdef SEG_THREADS
+    pthread_mutex_init(&sh->mutex, NULL);
+#endif
+    sh->concurrent = concurrent;
+    sh->policy = policy;
+    sh->first = first;
+    sh->nslots = nslots;
+    sh->freeslot = G_malloc(nslots * sizeof(int));
+    sh->agequeue = G_malloc((nslots + 1) * sizeof(struct aq));
+
+    for (i = 0; i < nslots; i++) {
+        sh->freeslot[i] = first + i;
+        sh->agequeue[i].cur = -1;
+        if (i > 0) {
+            sh->agequeue[i].younger = &(sh->agequeue[i - 1]);
+            sh->agequeue[i].older = &(sh->agequeue[i + 1]);
+        }
+        else if (i == 0) {
+            sh->agequeue[i].younger = &(sh->agequeue[nslots]);
+            sh->agequeue[i].older = &(sh->agequeue[i + 1]);
+        }
+    }
+
+    sh->agequeue[nslots].cur = -1;
+    sh->agequeue[nslots].younger = &(sh->agequeue[nslots - 1]);
+    sh->agequeue[nslots].older = &(sh->agequeue[0]);
+    sh->youngest = sh->oldest = &(sh->agequeue[nslots]);
+
+    sh->nfreeslots = nslots;
+    sh->cur = first;
+
+    sh->ref = G_calloc(nslots, 1);
+    sh->hand = 0;
+    sh->wave_row = sh->wave_col = -1;
+    sh->reads = NULL;
+    sh->npending = 0;
+
+    /* dirty segments are written back in the background in
+     * concurrent mode */
+    sh->wb = NULL;
+    sh->next_wb = 0;
+    if (concurrent) {
+        sh->wb = G_malloc(SEG_WRITEBACKS * sizeof(struct seg_io));
+        for (i = 0; i < SEG_WRITEBACKS; i++) {
+            seg_io_init(SEG, &sh->wb[i]);
+            sh->wb[i].buf = G_malloc(SEG->size);
+        }
+    }
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Splits the slots of the segments in memory into page tables. All
+ * slots must be free.
+ *
+ * \param[in,out] SEG segment
+ * \param[in] nshards number of page tables
+ * \param[in] concurrent lock the page tables
+ * \param[in] policy eviction policy
+ */
+void seg_init_shards(SEGMENT *SEG, int nshards, int concurrent, int policy)
+{
+    int s, first, nslots;
+
+    SEG->shards = G_malloc(nshards * sizeof(struct seg_shard));
+    SEG->nshards = nshards;
+    SEG->concurrent = concurrent;
+
+    first = 0;
+    for (s = 0; s < nshards; s++) {
+        nslots = SEG->nseg / nshards + (s < SEG->nseg % nshards);
+        init_shard(SEG, &SEG->shards[s], first, nslots, concurrent, policy);
+        first += nslots;
+    }
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Writes out dirty segments and unloads all segments.
+ *
+ * \param[in,out] SEG segment
+ * \return 1 if successful
+ * \return -1 if unable to read or write segment file
+ */
+int seg_unload(SEGMENT *SEG)
+{
+    int i;
+
+    if (seg_flush(SEG) < 0)
+        return -1;
+
+    for (i = 0; i < SEG->nseg; i++) {
+        if (SEG->scb[i].n >= 0)
+            SEG->load_idx[SEG->scb[i].n] = -1;
+        SEG->scb[i].n = -1;
+        SEG->scb[i].dirty = 0;
+        SEG->scb[i].age = NULL;
+    }
+
+    return 1;
+}
+
+/**
+ * \brief Internal use only
+ *
+ * Waits for background reads and writes and frees the page tables.
+ *
+ * \param[in,out] SEG segment
+ */
+void seg_free_shards(SEGMENT *SEG)
+{
+    int s, i;
+
+    for (s = 0; s < SEG->nshards; s++) {
+        struct seg_shard *sh = &SEG->shards[s];
+
+        if (sh->reads) {
+            for (i = 0; i < sh->nslots; i++)
+                seg_io_free(&sh->reads[i]);
+            G_free(sh->reads);
+        }
+        if (sh->wb) {
+            for (i = 0; i < SEG_WRITEBACKS; i++) {
+                seg_io_free(&sh->wb[i]);
+                G_free(sh->wb[i].buf);
+            }
+            G_free(sh->wb);
+        }
+        G_free(sh->agequeue);
+        G_free(sh->freeslot);
+        G_free(sh->ref);
+#ifdef SEG_THREADS
+        pthread_mutex_destroy(&sh->mutex);
+#endif
+    }
+    G_free(SEG->shards);
+    SEG->shards = NULL;
+    SEG->nshards = 0;
+    SEG->concurrent = 0;
+}
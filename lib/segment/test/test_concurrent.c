@@ -0,0 +1,176 @@
+/*****************************************************************************
+ *
+ * MODULE:       Grass segment Library
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Unit tests
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test_segment_lib.h"
+
+/* values of a cell before and after it was changed */
+#define VALUE(row, col)   ((int)((row) * 100003 + (col) * 7))
+#define CHANGED(row, col) (-VALUE(row, col) - 1)
+
+static int test_concurrent_get_put(int rows, int cols, int nthreads);
+
+/* pseudo random numbers, one sequence per thread */
+static unsigned int next_random(unsigned int *state)
+{
+    *state = *state * 1103515245 + 12345;
+
+    return *state >> 8;
+}
+
+/* *************************************************************** */
+/* Perform the concurrent access tests *************************** */
+/* *************************************************************** */
+int unit_test_concurrent(int rows, int cols, int nthreads)
+{
+    int sum = 0;
+
+    G_message("\n++ Running segment concurrent access unit tests ++");
+
+    sum += test_concurrent_get_put(rows, cols, nthreads);
+
+    if (sum > 0)
+        G_warning("\n-- segment concurrent access unit tests failure --");
+    else
+        G_message("\n-- segment concurrent access unit tests finished "
+                  "successfully --");
+
+    return sum;
+}
+
+/* *************************************************************** */
+
+int test_concurrent_get_put(int rows, int cols, int nthreads)
+{
+    SEGMENT seg;
+    char *fname, *changed;
+    int sum = 0;
+    int row, t;
+
+    G_message("Testing Segment_put_row(), Segment_get(), Segment_put() and "
+              "Segment_get_row() with %d threads",
+              nthreads);
+
+    /* far fewer segments in memory than in the file, the last segment
+     * of a row is not full */
+    fname = G_tempfile();
+    if (Segment_open(&seg, fname, rows, cols, 16, 24, sizeof(int), 16) != 1) {
+        G_warning("Unable to open segment file");
+        G_free(fname);
+        return 1;
+    }
+    G_free(fname);
+    if (Segment_set_concurrent(&seg, nthreads) != 1) {
+        G_warning("Unable to set concurrent access");
+        Segment_close(&seg);
+        return 1;
+    }
+    changed = G_calloc((size_t)rows * cols, 1);
+
+    /* neighbouring rows are written by different threads */
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads) \
+    reduction(+ : sum)
+    for (row = 0; row < rows; row++) {
+        int *buf = G_malloc(cols * sizeof(int));
+        int col;
+
+        for (col = 0; col < cols; col++)
+            buf[col] = VALUE(row, col);
+        if (Segment_put_row(&seg, buf, row) != 1) {
+            G_warning("Error writing row %d", row);
+            sum++;
+        }
+        G_free(buf);
+    }
+
+    /* cells all over the segment file are read by all threads while
+     * each thread changes cells in the rows it owns */
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads) \
+    reduction(+ : sum)
+    for (t = 0; t < nthreads; t++) {
+        unsigned int state = t + 1;
+        long i, n = (long)rows * cols / 2;
+        int r, c, value, ok;
+
+        for (i = 0; i < n; i++) {
+            r = next_random(&state) % rows;
+            c = next_random(&state) % cols;
+
+            if (r % nthreads == t && i % 4 == 0) {
+                value = CHANGED(r, c);
+                if (Segment_put(&seg, &value, r, c) != 1) {
+                    G_warning("Error writing cell %d, %d", r, c);
+                    sum++;
+                }
+                changed[(size_t)r * cols + c] = 1;
+                continue;
+            }
+
+            if (Segment_get(&seg, &value, r, c) != 1) {
+                G_warning("Error reading cell %d, %d", r, c);
+                sum++;
+                continue;
+            }
+            /* cells of other threads may be changed at any time */
+            if (r % nthreads == t)
+                ok = value == (changed[(size_t)r * cols + c] ? CHANGED(r, c)
+                                                             : VALUE(r, c));
+            else
+                ok = value == VALUE(r, c) || value == CHANGED(r, c);
+            if (!ok) {
+                G_warning("Wrong value %d of cell %d, %d", value, r, c);
+                sum++;
+            }
+        }
+    }
+
+    /* changed cells are written out */
+    if (Segment_flush(&seg) != 0) {
+        G_warning("Error flushing the segment file");
+        sum++;
+    }
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads) \
+    reduction(+ : sum)
+    for (row = 0; row < rows; row++) {
+        int *buf = G_malloc(cols * sizeof(int));
+        int col, expected;
+
+        if (Segment_get_row(&seg, buf, row) != 1) {
+            G_warning("Error reading row %d", row);
+            sum++;
+        }
+        else {
+            for (col = 0; col < cols; col++) {
+                expected = changed[(size_t)row * cols + col]
+                               ? CHANGED(row, col)
+                               : VALUE(row, col);
+                if (buf[col] != expected) {
+                    G_warning("Wrong value %d of cell %d, %d in row", buf[col],
+                              row, col);
+                    sum++;
+                    break;
+                }
+            }
+        }
+        G_free(buf);
+    }
+
+    G_free(changed);
+    Segment_close(&seg);
+
+    return sum;
+}
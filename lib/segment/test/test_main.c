@@ -0,0 +1,122 @@
+/*****************************************************************************
+ *
+ * MODULE:       Grass segment Library
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Unit tests
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test_segment_lib.h"
+
+/*- Parameters and global variables -----------------------------------------*/
+typedef struct {
+    struct Option *unit, *rows, *cols, *nprocs;
+    struct Flag *testunit;
+} paramType;
+
+paramType param; /*Parameters */
+
+/*- prototypes --------------------------------------------------------------*/
+static void set_params(void); /*Fill the paramType structure */
+
+/* ************************************************************************* */
+/* Set up the arguments we are expecting ********************************** */
+
+/* ************************************************************************* */
+void set_params(void)
+{
+    param.unit = G_define_option();
+    param.unit->key = "unit";
+    param.unit->type = TYPE_STRING;
+    param.unit->required = NO;
+    param.unit->multiple = YES;
+    param.unit->options = "concurrent,policy";
+    param.unit->description = "Choose the unit tests to run";
+
+    param.rows = G_define_option();
+    param.rows->key = "rows";
+    param.rows->type = TYPE_INTEGER;
+    param.rows->required = NO;
+    param.rows->answer = "500";
+    param.rows->description = "The number of rows of the segment file";
+
+    param.cols = G_define_option();
+    param.cols->key = "cols";
+    param.cols->type = TYPE_INTEGER;
+    param.cols->required = NO;
+    param.cols->answer = "700";
+    param.cols->description = "The number of columns of the segment file";
+
+    param.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+    param.nprocs->description =
+        "Number of threads accessing the segment file at the same time";
+
+    param.testunit = G_define_flag();
+    param.testunit->key = 'u';
+    param.testunit->description = "Run all unit tests";
+}
+
+/* ************************************************************************* */
+/* ************************************************************************* */
+
+/* ************************************************************************* */
+int main(int argc, char *argv[])
+{
+    struct GModule *module;
+    int returnstat = 0, i;
+    int rows, cols, nprocs;
+
+    /* Initialize GRASS */
+    G_gisinit(argv[0]);
+
+    module = G_define_module();
+    G_add_keyword(_("segment"));
+    G_add_keyword(_("unit test"));
+    module->description = "Performs unit tests for the segment library";
+
+    /* Get parameters from user */
+    set_params();
+
+    if (G_parser(argc, argv))
+        exit(EXIT_FAILURE);
+
+    rows = atoi(param.rows->answer);
+    cols = atoi(param.cols->answer);
+    nprocs = G_set_omp_num_threads(param.nprocs);
+
+    /*Run the unit tests */
+    if (param.testunit->answer) {
+        returnstat += unit_test_concurrent(rows, cols, nprocs);
+        returnstat += unit_test_policy(rows, cols, nprocs);
+    }
+
+    /*Run single tests */
+    if (!param.testunit->answer) {
+        i = 0;
+        if (param.unit->answers)
+            while (param.unit->answers[i]) {
+                if (strcmp(param.unit->answers[i], "concurrent") == 0)
+                    returnstat += unit_test_concurrent(rows, cols, nprocs);
+                if (strcmp(param.unit->answers[i], "policy") == 0)
+                    returnstat += unit_test_policy(rows, cols, nprocs);
+
+                i++;
+            }
+    }
+
+    if (returnstat != 0)
+        G_warning("Errors detected while testing the segment lib");
+    else
+        G_message("\n-- segment lib tests finished successfully --");
+
+    return (returnstat);
+}
@@ -0,0 +1,183 @@
+/*****************************************************************************
+ *
+ * MODULE:       Grass segment Library
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Unit tests
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ *****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "test_segment_lib.h"
+
+static int test_policy_get_put(int rows, int cols, int nthreads, int policy,
+                               int prefetch);
+
+static const char *policy_names[] = {"SEGMENT_LRU", "SEGMENT_CLOCK",
+                                     "SEGMENT_WAVEFRONT"};
+
+/* pseudo random numbers, one sequence per thread */
+static unsigned int next_random(unsigned int *state)
+{
+    *state = *state * 1103515245 + 12345;
+
+    return *state >> 8;
+}
+
+/* *************************************************************** */
+/* Perform the eviction policy tests ***************************** */
+/* *************************************************************** */
+int unit_test_policy(int rows, int cols, int nthreads)
+{
+    int sum = 0;
+    int policy;
+
+    G_message("\n++ Running segment eviction policy unit tests ++");
+
+    for (policy = SEGMENT_LRU; policy <= SEGMENT_WAVEFRONT; policy++) {
+        sum += test_policy_get_put(rows, cols, 1, policy, 0);
+        sum += test_policy_get_put(rows, cols, 1, policy, 1);
+        if (nthreads > 1) {
+            sum += test_policy_get_put(rows, cols, nthreads, policy, 0);
+            sum += test_policy_get_put(rows, cols, nthreads, policy, 1);
+        }
+    }
+
+    if (sum > 0)
+        G_warning("\n-- segment eviction policy unit tests failure --");
+    else
+        G_message("\n-- segment eviction policy unit tests finished "
+                  "successfully --");
+
+    return sum;
+}
+
+/* *************************************************************** */
+
+int test_policy_get_put(int rows, int cols, int nthreads, int policy,
+                        int prefetch)
+{
+    SEGMENT seg;
+    char *fname;
+    int *ref, *buf;
+    int sum = 0;
+    int row, col, t;
+
+    G_message("Testing %s with %d threads%s", policy_names[policy], nthreads,
+              prefetch ? " and prefetch hints" : "");
+
+    /* far fewer segments in memory than in the file, the last segment
+     * of a row is not full */
+    fname = G_tempfile();
+    if (Segment_open(&seg, fname, rows, cols, 16, 24, sizeof(int), 12) != 1) {
+        G_warning("Unable to open segment file");
+        G_free(fname);
+        return 1;
+    }
+    G_free(fname);
+
+    /* the reference values, changed along with the segment file */
+    ref = G_malloc((size_t)rows * cols * sizeof(int));
+    for (row = 0; row < rows; row++) {
+        for (col = 0; col < cols; col++)
+            ref[(size_t)row * cols + col] = row * 1000 + col;
+        if (Segment_put_row(&seg, &ref[(size_t)row * cols], row) != 1) {
+            G_warning("Error writing row %d", row);
+            sum++;
+        }
+    }
+
+    if (Segment_set_policy(&seg, policy) != 1 ||
+        (nthreads > 1 && Segment_set_concurrent(&seg, nthreads) != 1)) {
+        G_warning("Unable to set up the segment file");
+        G_free(ref);
+        Segment_close(&seg);
+        return 1;
+    }
+
+    /* each thread walks through its own rows, mostly to neighbouring
+     * cells, sometimes far away */
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads) \
+    reduction(+ : sum)
+    for (t = 0; t < nthreads; t++) {
+        unsigned int state = t + 1;
+        long i, n = (long)rows * cols / nthreads;
+        int r = t, c = 0, value;
+        size_t idx;
+
+        for (i = 0; i < n; i++) {
+            /* the rows of a thread are t, t + nthreads, ... */
+            if (next_random(&state) % 64 == 0) {
+                r = next_random(&state) % rows;
+                r -= (r % nthreads + nthreads - t) % nthreads;
+                c = next_random(&state) % cols;
+            }
+            else {
+                r += ((int)(next_random(&state) % 3) - 1) * nthreads;
+                c += (int)(next_random(&state) % 5) - 2;
+            }
+            if (r < 0)
+                r += nthreads;
+            if (r >= rows)
+                r -= nthreads;
+            if (c < 0)
+                c = 0;
+            if (c >= cols)
+                c = cols - 1;
+            idx = (size_t)r * cols + c;
+
+            if (prefetch && i % 16 == 0 &&
+                Segment_prefetch(&seg, r, c, 40) != 1) {
+                G_warning("Error prefetching around cell %d, %d", r, c);
+                sum++;
+            }
+
+            if (next_random(&state) % 3 == 0) {
+                value = (int)next_random(&state);
+                if (Segment_put(&seg, &value, r, c) != 1) {
+                    G_warning("Error writing cell %d, %d", r, c);
+                    sum++;
+                }
+                ref[idx] = value;
+            }
+            else if (Segment_get(&seg, &value, r, c) != 1) {
+                G_warning("Error reading cell %d, %d", r, c);
+                sum++;
+            }
+            else if (value != ref[idx]) {
+                G_warning("Wrong value %d of cell %d, %d, expected %d", value,
+                          r, c, ref[idx]);
+                sum++;
+            }
+        }
+    }
+
+    /* all changes are in the segment file */
+    Segment_flush(&seg);
+
+    buf = G_malloc(cols * sizeof(int));
+    for (row = 0; row < rows; row++) {
+        if (Segment_get_row(&seg, buf, row) != 1) {
+            G_warning("Error reading row %d", row);
+            sum++;
+        }
+        else if (memcmp(buf, &ref[(size_t)row * cols], cols * sizeof(int)) !=
+                 0) {
+            G_warning("Wrong values in row %d", row);
+            sum++;
+        }
+    }
+
+    G_free(buf);
+    G_free(ref);
+    Segment_close(&seg);
+
+    return sum;
+}
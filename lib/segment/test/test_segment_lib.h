@@ -0,0 +1,26 @@
+/*****************************************************************************
+ *
+ * MODULE:       Grass segment Library
+ * AUTHOR(S):    GRASS Development Team
+ *
+ * PURPOSE:      Unit tests
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ *****************************************************************************/
+
+#ifndef _TEST_SEGMENT_LIB_H_
+#define _TEST_SEGMENT_LIB_H_
+
+#include <grass/gis.h>
+#include <grass/glocale.h>
+#include <grass/segment.h>
+
+int unit_test_concurrent(int, int, int);
+int unit_test_policy(int, int, int);
+
+#endif
@@ -0,0 +1,40 @@
+"""Test of segment library
+
+Threads read and write cells and rows of a segment file at the same
+time, with dirty segments written back by worker threads or not. Cells
+read with each eviction policy and prefetch hints are compared with a
+reference array.
+"""
+
+import os
+
+from grass.gunittest.case import TestCase
+
+
+class SegmentLibraryTest(TestCase):
+    def run_unit(self, unit, workers, **kwargs):
+        """Run a unit test with the given number of worker threads"""
+        env = os.environ.copy()
+        env["WORKERS"] = str(workers)
+        self.assertModule("test.segment.lib", unit=unit, env_=env, **kwargs)
+
+    def test_concurrent(self):
+        for nprocs in (1, 4, 8):
+            for workers in (0, 4):
+                self.run_unit("concurrent", workers, nprocs=nprocs)
+
+    def test_policy(self):
+        """Random access with each eviction policy, with prefetch hints"""
+        for nprocs in (1, 4):
+            for workers in (0, 4):
+                self.run_unit("policy", workers, nprocs=nprocs)
+
+    def test_concurrent_partial_segments(self):
+        """Rows and columns not filling the last segments"""
+        self.run_unit("concurrent", 2, rows=37, cols=1001, nprocs=4)
+
+
+if __name__ == "__main__":
+    from grass.gunittest.main import test
+
+    test()
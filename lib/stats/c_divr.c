@@ -1,16 +1,21 @@
 #include <grass/gis.h>
 #include <grass/stats.h>
 
-void c_divr(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+void c_divr(DCELL *result, DCELL *values, int n, const void *closure)
 {
-    int count;
-    DCELL prev;
-    int i;
-
     /* sort the array of values, then count differences */
 
     n = sort_cell(values, n);
 
+    s_divr(result, values, n, closure);
+}
+
+void s_divr(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+{
+    int count;
+    DCELL prev;
+    int i;
+
     if (n == 0) {
         *result = 0;
         return;
@@ -4,8 +4,33 @@
 
 void c_median(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
 {
-    n = sort_cell(values, n);
+    DCELL lo, hi;
+    int i;
+
+    n = compact_cell(values, n);
+
+    if (n < 1) {
+        Rast_set_d_null_value(result, 1);
+        return;
+    }
 
+    select_cell(values, n, n / 2);
+    hi = values[n / 2];
+
+    /* the lower middle value is the largest one before the upper */
+    lo = hi;
+    if (n % 2 == 0) {
+        lo = values[0];
+        for (i = 1; i < n / 2; i++)
+            if (values[i] > lo)
+                lo = values[i];
+    }
+
+    *result = (lo + hi) / 2;
+}
+
+void s_median(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+{
     if (n < 1)
         Rast_set_d_null_value(result, 1);
     else
@@ -2,7 +2,14 @@
 #include <grass/raster.h>
 #include <grass/stats.h>
 
-void c_mode(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+void c_mode(DCELL *result, DCELL *values, int n, const void *closure)
+{
+    n = sort_cell(values, n);
+
+    s_mode(result, values, n, closure);
+}
+
+void s_mode(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
 {
     DCELL mode;
     int max;
@@ -10,8 +17,6 @@ void c_mode(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
     int count;
     int i;
 
-    n = sort_cell(values, n);
-
     max = 0;
     count = 0;
 
@@ -8,9 +8,10 @@ void c_quant(DCELL *result, DCELL *values, int n, const void *closure)
 {
     double quant = *(const double *)closure;
     double k;
-    int i0, i1;
+    DCELL v0;
+    int i0, i1, i;
 
-    n = sort_cell(values, n);
+    n = compact_cell(values, n);
 
     if (n < 1) {
         Rast_set_d_null_value(result, 1);
@@ -22,8 +23,19 @@ void c_quant(DCELL *result, DCELL *values, int n, const void *closure)
     i0 = (int)floor(k);
     i1 = (int)ceil(k);
 
-    *result =
-        (i0 == i1) ? values[i0] : values[i0] * (i1 - k) + values[i1] * (k - i0);
+    select_cell(values, n, i1);
+    if (i0 == i1) {
+        *result = values[i1];
+        return;
+    }
+
+    /* values[i0] of the sorted array is the largest one before i1 */
+    v0 = values[0];
+    for (i = 1; i < i1; i++)
+        if (values[i] > v0)
+            v0 = values[i];
+
+    *result = v0 * (i1 - k) + values[i1] * (k - i0);
 }
 
 void c_quart1(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
@@ -47,6 +59,46 @@ void c_perc90(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
     c_quant(result, values, n, &q);
 }
 
+void s_quant(DCELL *result, DCELL *values, int n, const void *closure)
+{
+    double quant = *(const double *)closure;
+    double k;
+    int i0, i1;
+
+    if (n < 1) {
+        Rast_set_d_null_value(result, 1);
+        return;
+    }
+
+    k = quant * (n - 1);
+    i0 = (int)floor(k);
+    i1 = (int)ceil(k);
+
+    *result =
+        (i0 == i1) ? values[i0] : values[i0] * (i1 - k) + values[i1] * (k - i0);
+}
+
+void s_quart1(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+{
+    static const double q = 0.25;
+
+    s_quant(result, values, n, &q);
+}
+
+void s_quart3(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+{
+    static const double q = 0.75;
+
+    s_quant(result, values, n, &q);
+}
+
+void s_perc90(DCELL *result, DCELL *values, int n, const void *closure G_UNUSED)
+{
+    static const double q = 0.90;
+
+    s_quant(result, values, n, &q);
+}
+
 void w_quant(DCELL *result, DCELL (*values)[2], int n, const void *closure)
 {
     double quant = *(const double *)closure;
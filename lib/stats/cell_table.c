@@ -0,0 +1,305 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/stats.h>
+
+/* hash value and index of a combination, or -1 for an empty slot */
+struct cell_table_slot {
+    unsigned int hash;
+    int entry;
+};
+
+#define INITIAL_SLOTS   1024
+#define INITIAL_ENTRIES 256
+
+static unsigned int hash_key(const CELL *key, int nkeys)
+{
+    uint64_t h = 0;
+    int i;
+
+    for (i = 0; i < nkeys; i++)
+        h = (h ^ (uint32_t)key[i]) * 0x9E3779B97F4A7C15ULL;
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+
+    return (unsigned int)h;
+}
+
+static void allocate_slots(struct cell_table *t, unsigned int nslots)
+{
+    unsigned int i;
+
+    t->mask = nslots - 1;
+    t->slots = G_malloc((size_t)nslots * sizeof(struct cell_table_slot));
+    for (i = 0; i < nslots; i++)
+        t->slots[i].entry = -1;
+}
+
+/* slot of a combination, or the empty slot where it belongs */
+static unsigned int find_slot(const struct cell_table *t, const CELL *key,
+                              unsigned int hash)
+{
+    const struct cell_table_slot *s;
+    unsigned int i;
+
+    for (i = hash & t->mask;; i = (i + 1) & t->mask) {
+        s = &t->slots[i];
+        if (s->entry < 0)
+            return i;
+        if (s->hash == hash &&
+            memcmp(&t->keys[(size_t)s->entry * t->nkeys], key,
+                   t->nkeys * sizeof(CELL)) == 0)
+            return i;
+    }
+}
+
+/* doubles the number of slots, keeping the load factor below 1/2 */
+static void grow_slots(struct cell_table *t)
+{
+    struct cell_table_slot *old = t->slots;
+    unsigned int nold = t->mask + 1;
+    unsigned int i, j;
+
+    allocate_slots(t, 2 * nold);
+    for (i = 0; i < nold; i++) {
+        if (old[i].entry < 0)
+            continue;
+        for (j = old[i].hash & t->mask; t->slots[j].entry >= 0;
+             j = (j + 1) & t->mask)
+            ;
+        t->slots[j] = old[i];
+    }
+    G_free(old);
+}
+
+static void grow_entries(struct cell_table *t)
+{
+    t->max *= 2;
+    t->keys = G_realloc(t->keys, (size_t)t->max * t->nkeys * sizeof(CELL));
+    t->counts = G_realloc(t->counts, (size_t)t->max * sizeof(long));
+    t->areas = G_realloc(t->areas, (size_t)t->max * sizeof(DCELL));
+    if (t->nmoments)
+        t->sums = G_realloc(t->sums,
+                            (size_t)t->max * t->nmoments * sizeof(DCELL));
+}
+
+/* index of a combination, added with no cells if not yet present */
+static int lookup(struct cell_table *t, const CELL *key)
+{
+    unsigned int hash = hash_key(key, t->nkeys);
+    unsigned int slot = find_slot(t, key, hash);
+    int i, e;
+
+    if (t->slots[slot].entry >= 0)
+        return t->slots[slot].entry;
+
+    if (t->n == t->max)
+        grow_entries(t);
+
+    e = t->n++;
+    memcpy(&t->keys[(size_t)e * t->nkeys], key, t->nkeys * sizeof(CELL));
+    t->counts[e] = 0;
+    t->areas[e] = 0;
+    for (i = 0; i < t->nmoments; i++)
+        t->sums[(size_t)e * t->nmoments + i] = 0;
+
+    t->slots[slot].hash = hash;
+    t->slots[slot].entry = e;
+    if (2 * (unsigned int)t->n > t->mask + 1)
+        grow_slots(t);
+
+    return e;
+}
+
+/*!
+   \brief Initializes a table of combinations of CELL values
+
+   The table counts the cells (and sums their areas) of each combination
+   of <i>nkeys</i> CELL values, e.g. the categories of several maps at
+   the same cell. Optionally it also keeps the sums of the first
+   <i>nmoments</i> powers of a value per combination, from which the
+   mean, variance, skewness etc. of that value can be computed.
+
+   The combinations are stored in the order they were added, at index
+   0 to <i>t->n - 1</i> of <i>t->keys</i>, <i>t->counts</i>,
+   <i>t->areas</i> and <i>t->sums</i>, and are found through an
+   open-addressing hash table. To aggregate in parallel, each thread
+   can fill its own table, and the tables are merged with
+   cell_table_merge() at the end.
+
+   \param t table
+   \param nkeys number of values of a combination
+   \param nmoments number of sums of powers of a value (0 for none)
+ */
+void cell_table_init(struct cell_table *t, int nkeys, int nmoments)
+{
+    t->nkeys = nkeys;
+    t->nmoments = nmoments;
+    t->n = 0;
+    t->max = INITIAL_ENTRIES;
+    t->keys = G_malloc((size_t)t->max * nkeys * sizeof(CELL));
+    t->counts = G_malloc((size_t)t->max * sizeof(long));
+    t->areas = G_malloc((size_t)t->max * sizeof(DCELL));
+    t->sums = nmoments
+                  ? G_malloc((size_t)t->max * nmoments * sizeof(DCELL))
+                  : NULL;
+    allocate_slots(t, INITIAL_SLOTS);
+}
+
+/*!
+   \brief Adds a cell to a combination of values
+
+   \param t table
+   \param key <i>t->nkeys</i> values, NULL values are allowed
+   \param area area of the cell
+
+   \return index of the combination
+ */
+int cell_table_add(struct cell_table *t, const CELL *key, DCELL area)
+{
+    int e = lookup(t, key);
+
+    t->counts[e]++;
+    t->areas[e] += area;
+
+    return e;
+}
+
+/*!
+   \brief Adds the powers of a value to the sums of a combination
+
+   \param t table
+   \param e index of the combination, see cell_table_add()
+   \param value value, must not be NULL
+ */
+void cell_table_add_value(struct cell_table *t, int e, DCELL value)
+{
+    DCELL *sums = &t->sums[(size_t)e * t->nmoments];
+    DCELL power = 1;
+    int i;
+
+    for (i = 0; i < t->nmoments; i++) {
+        power *= value;
+        sums[i] += power;
+    }
+}
+
+/*!
+   \brief Adds all combinations of another table to a table
+
+   \param t table
+   \param src table with the same numbers of values and sums
+ */
+void cell_table_merge(struct cell_table *t, const struct cell_table *src)
+{
+    int i, j, e;
+
+    for (i = 0; i < src->n; i++) {
+        e = lookup(t, &src->keys[(size_t)i * src->nkeys]);
+        t->counts[e] += src->counts[i];
+        t->areas[e] += src->areas[i];
+        for (j = 0; j < t->nmoments; j++)
+            t->sums[(size_t)e * t->nmoments + j] +=
+                src->sums[(size_t)i * src->nmoments + j];
+    }
+}
+
+/*!
+   \brief Compares the values of two combinations
+
+   \param t table
+   \param a index of a combination
+   \param b index of a combination
+
+   \return -1, 0 or 1 if the values of <i>a</i> are less than, equal to
+   or greater than the values of <i>b</i>, in the order of the values
+ */
+int cell_table_compare_keys(const struct cell_table *t, int a, int b)
+{
+    const CELL *ka = &t->keys[(size_t)a * t->nkeys];
+    const CELL *kb = &t->keys[(size_t)b * t->nkeys];
+    int i;
+
+    for (i = 0; i < t->nkeys; i++) {
+        if (ka[i] < kb[i])
+            return -1;
+        if (ka[i] > kb[i])
+            return 1;
+    }
+
+    return 0;
+}
+
+/*!
+   \brief Sorts the combinations of a table
+
+   The sort is stable, combinations that compare equal keep the order
+   in which they were added.
+
+   \param t table
+   \param compare comparison of two combinations, e.g.
+   cell_table_compare_keys()
+
+   \return allocated array of the indices of all <i>t->n</i>
+   combinations in ascending order, to be freed with G_free()
+ */
+int *cell_table_sort(const struct cell_table *t,
+                     int (*compare)(const struct cell_table *, int, int))
+{
+    int n = t->n;
+    int *src = G_malloc((n > 0 ? n : 1) * sizeof(int));
+    int *dst = G_malloc((n > 0 ? n : 1) * sizeof(int));
+    int *tmp;
+    int width, lo, mid, hi, i, j, k;
+
+    for (i = 0; i < n; i++)
+        src[i] = i;
+
+    /* bottom-up merge sort */
+    for (width = 1; width < n; width *= 2) {
+        for (lo = 0; lo < n; lo += 2 * width) {
+            mid = lo + width < n ? lo + width : n;
+            hi = lo + 2 * width < n ? lo + 2 * width : n;
+            i = lo;
+            j = mid;
+            for (k = lo; k < hi; k++) {
+                if (i < mid && (j >= hi || (*compare)(t, src[i], src[j]) <= 0))
+                    dst[k] = src[i++];
+                else
+                    dst[k] = src[j++];
+            }
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    G_free(dst);
+
+    return src;
+}
+
+/*!
+   \brief Frees the memory of a table
+
+   \param t table
+ */
+void cell_table_free(struct cell_table *t)
+{
+    G_free(t->keys);
+    G_free(t->counts);
+    G_free(t->areas);
+    if (t->sums)
+        G_free(t->sums);
+    G_free(t->slots);
+    t->keys = NULL;
+    t->counts = NULL;
+    t->areas = NULL;
+    t->sums = NULL;
+    t->slots = NULL;
+    t->n = t->max = 0;
+}
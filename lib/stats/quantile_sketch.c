@@ -0,0 +1,269 @@
+#include <math.h>
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/stats.h>
+
+/*
+   The sketch is a stack of compactors (Karnin, Lang and Liberty 2016,
+   "Optimal quantile approximation in streams"): values enter level 0,
+   and a full level is sorted and every second value is moved to the
+   next level, where it stands for twice as many values. The top level
+   holds k values, each lower level 2/3 of the next one, but at least
+   MIN_CAPACITY values.
+ */
+
+#define MIN_CAPACITY 8
+#define MIN_SIZE     16
+
+/* k for a rank error: the largest rank error of 1000 quantiles of
+   millions of normal, uniform and integer values stayed below half the
+   requested error, also for merged sketches */
+#define ERROR_TO_K 3.0
+
+static int level_capacity(const struct quantile_sketch *s, int h)
+{
+    double cap = s->k * pow(2.0 / 3.0, s->nlevels - 1 - h);
+
+    return cap > MIN_CAPACITY ? (int)ceil(cap) : MIN_CAPACITY;
+}
+
+static void add_level(struct quantile_sketch *s)
+{
+    int h = s->nlevels++;
+
+    s->n = G_realloc(s->n, s->nlevels * sizeof(int));
+    s->size = G_realloc(s->size, s->nlevels * sizeof(int));
+    s->values = G_realloc(s->values, s->nlevels * sizeof(DCELL *));
+    s->n[h] = 0;
+    s->size[h] = 0;
+    s->values[h] = NULL;
+
+    s->capacity = 0;
+    for (h = 0; h < s->nlevels; h++)
+        s->capacity += level_capacity(s, h);
+}
+
+static void reserve(struct quantile_sketch *s, int h, int n)
+{
+    if (n <= s->size[h])
+        return;
+
+    if (s->size[h] < MIN_SIZE)
+        s->size[h] = MIN_SIZE;
+    while (s->size[h] < n)
+        s->size[h] *= 2;
+    s->values[h] = G_realloc(s->values[h], s->size[h] * sizeof(DCELL));
+}
+
+/* xorshift, so that a sketch of the same values is always the same */
+static int random_bit(struct quantile_sketch *s)
+{
+    s->seed ^= s->seed << 13;
+    s->seed ^= s->seed >> 17;
+    s->seed ^= s->seed << 5;
+
+    return s->seed & 1;
+}
+
+/* moves every second value of level h to level h + 1 */
+static void compact(struct quantile_sketch *s, int h)
+{
+    DCELL *v = s->values[h];
+    int n = s->n[h];
+    int first = n % 2;
+    int offset = random_bit(s);
+    int i, m;
+
+    if (h == s->nlevels - 1)
+        add_level(s);
+
+    sort_cell(v, n);
+
+    /* with an odd number of values, the smallest one stays */
+    m = (n - first) / 2;
+    reserve(s, h + 1, s->n[h + 1] + m);
+    for (i = 0; i < m; i++)
+        s->values[h + 1][s->n[h + 1] + i] = v[first + 2 * i + offset];
+    s->n[h + 1] += m;
+
+    s->n[h] = first;
+    s->retained -= m;
+}
+
+/* compacts the lowest full levels until the sketch fits its capacity */
+static void compress(struct quantile_sketch *s)
+{
+    int h;
+
+    while (s->retained >= s->capacity) {
+        for (h = 0; h < s->nlevels; h++)
+            if (s->n[h] >= level_capacity(s, h))
+                break;
+        if (h == s->nlevels)
+            break;
+        compact(s, h);
+    }
+}
+
+/*!
+   \brief Initializes a quantile sketch
+
+   The sketch summarizes a stream of values in a bounded amount of
+   memory (about 9 / <i>error</i> values), from which every quantile
+   can be estimated with a rank error of at most about <i>error</i>
+   times the number of values. Sketches of parts of the values can be
+   merged with quantile_sketch_merge(), e.g. to summarize the values
+   of a map in parallel or per zone.
+
+   \param s sketch
+   \param error rank error as a fraction of the number of values
+ */
+void quantile_sketch_init(struct quantile_sketch *s, double error)
+{
+    s->k = (int)ceil(ERROR_TO_K / error);
+    if (s->k < MIN_CAPACITY)
+        s->k = MIN_CAPACITY;
+    s->nlevels = 0;
+    s->n = NULL;
+    s->size = NULL;
+    s->values = NULL;
+    s->count = 0;
+    s->retained = 0;
+    s->seed = 2463534242U;
+    s->nsorted = -1;
+    s->sorted = NULL;
+    add_level(s);
+}
+
+/*!
+   \brief Adds a value to a sketch
+
+   \param s sketch
+   \param v value, ignored if NULL
+ */
+void quantile_sketch_add(struct quantile_sketch *s, DCELL v)
+{
+    if (Rast_is_d_null_value(&v))
+        return;
+
+    reserve(s, 0, s->n[0] + 1);
+    s->values[0][s->n[0]++] = v;
+    s->count++;
+    s->retained++;
+    s->nsorted = -1;
+
+    if (s->retained >= s->capacity)
+        compress(s);
+}
+
+/*!
+   \brief Adds the values of another sketch to a sketch
+
+   \param s sketch
+   \param src sketch, unchanged
+ */
+void quantile_sketch_merge(struct quantile_sketch *s,
+                           const struct quantile_sketch *src)
+{
+    int h, i;
+
+    while (s->nlevels < src->nlevels)
+        add_level(s);
+
+    for (h = 0; h < src->nlevels; h++) {
+        reserve(s, h, s->n[h] + src->n[h]);
+        for (i = 0; i < src->n[h]; i++)
+            s->values[h][s->n[h] + i] = src->values[h][i];
+        s->n[h] += src->n[h];
+        s->retained += src->n[h];
+    }
+    s->count += src->count;
+    s->nsorted = -1;
+
+    compress(s);
+}
+
+/*!
+   \brief Estimates the value of a rank
+
+   The value with rank <i>rank</i> is the value at index <i>rank</i> of
+   all values added to the sketch in ascending order.
+
+   \param s sketch
+   \param rank rank, from 0 to the number of values minus 1
+
+   \return value of the rank, NULL if the sketch is empty
+ */
+DCELL quantile_sketch_value(struct quantile_sketch *s, grass_int64 rank)
+{
+    grass_int64 weight;
+    int h, i, lo, hi, mid;
+    DCELL v;
+
+    if (s->count == 0) {
+        Rast_set_d_null_value(&v, 1);
+        return v;
+    }
+
+    /* values of all levels in ascending order, with their accumulated
+       weights in the second column */
+    if (s->nsorted < 0) {
+        s->sorted = G_realloc(s->sorted, s->retained * sizeof(*s->sorted));
+        s->nsorted = 0;
+        for (h = 0; h < s->nlevels; h++) {
+            for (i = 0; i < s->n[h]; i++) {
+                s->sorted[s->nsorted][0] = s->values[h][i];
+                s->sorted[s->nsorted][1] = (DCELL)((grass_int64)1 << h);
+                s->nsorted++;
+            }
+        }
+        s->nsorted = sort_cell_w(s->sorted, s->nsorted);
+        weight = 0;
+        for (i = 0; i < s->nsorted; i++) {
+            weight += (grass_int64)s->sorted[i][1];
+            s->sorted[i][1] = (DCELL)weight;
+        }
+    }
+
+    if (rank < 0)
+        rank = 0;
+    if (rank > s->count - 1)
+        rank = s->count - 1;
+
+    /* first value with more than rank values up to it */
+    lo = 0;
+    hi = s->nsorted - 1;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (s->sorted[mid][1] > (DCELL)rank)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+
+    return s->sorted[lo][0];
+}
+
+/*!
+   \brief Frees the memory of a sketch
+
+   \param s sketch
+ */
+void quantile_sketch_free(struct quantile_sketch *s)
+{
+    int h;
+
+    for (h = 0; h < s->nlevels; h++)
+        G_free(s->values[h]);
+    G_free(s->values);
+    G_free(s->n);
+    G_free(s->size);
+    G_free(s->sorted);
+    s->values = NULL;
+    s->n = s->size = NULL;
+    s->sorted = NULL;
+    s->nlevels = 0;
+    s->count = 0;
+    s->retained = 0;
+}
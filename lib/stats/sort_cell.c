@@ -4,6 +4,9 @@
 #include <grass/raster.h>
 #include <grass/stats.h>
 
+/* ranges up to this size are sorted by insertion */
+#define SMALL_RANGE 16
+
 static int ascending(const void *aa, const void *bb)
 {
     const DCELL *a = aa, *b = bb;
@@ -24,7 +27,139 @@ static int ascending(const void *aa, const void *bb)
     return (*a < *b) ? -1 : (*a > *b) ? 1 : 0;
 }
 
-int sort_cell(DCELL *array, int n)
+static void insertion_sort(DCELL *array, int lo, int hi)
+{
+    int i, j;
+    DCELL v;
+
+    for (i = lo + 1; i <= hi; i++) {
+        v = array[i];
+        for (j = i; j > lo && array[j - 1] > v; j--)
+            array[j] = array[j - 1];
+        array[j] = v;
+    }
+}
+
+static void sift_down(DCELL *array, int root, int n)
+{
+    int child;
+    DCELL v = array[root];
+
+    while ((child = 2 * root + 1) < n) {
+        if (child + 1 < n && array[child + 1] > array[child])
+            child++;
+        if (array[child] <= v)
+            break;
+        array[root] = array[child];
+        root = child;
+    }
+    array[root] = v;
+}
+
+static void heap_sort(DCELL *array, int n)
+{
+    int i;
+    DCELL v;
+
+    for (i = n / 2 - 1; i >= 0; i--)
+        sift_down(array, i, n);
+
+    for (i = n - 1; i > 0; i--) {
+        v = array[0];
+        array[0] = array[i];
+        array[i] = v;
+        sift_down(array, 0, i);
+    }
+}
+
+/* Hoare partition of array[lo..hi] around the median of three values.
+   On return, array[lo..*j] <= pivot <= array[*i..hi] and *j < *i. */
+static void partition(DCELL *array, int lo, int hi, int *i, int *j)
+{
+    int mid = lo + (hi - lo) / 2;
+    DCELL pivot, v;
+
+    if (array[mid] < array[lo]) {
+        v = array[mid];
+        array[mid] = array[lo];
+        array[lo] = v;
+    }
+    if (array[hi] < array[mid]) {
+        v = array[hi];
+        array[hi] = array[mid];
+        array[mid] = v;
+        if (array[mid] < array[lo]) {
+            v = array[mid];
+            array[mid] = array[lo];
+            array[lo] = v;
+        }
+    }
+    pivot = array[mid];
+
+    *i = lo;
+    *j = hi;
+    while (*i <= *j) {
+        while (array[*i] < pivot)
+            (*i)++;
+        while (array[*j] > pivot)
+            (*j)--;
+        if (*i <= *j) {
+            v = array[*i];
+            array[*i] = array[*j];
+            array[*j] = v;
+            (*i)++;
+            (*j)--;
+        }
+    }
+}
+
+/* introsort: quicksort falling back to heapsort when the recursion
+   gets too deep */
+static void sort_range(DCELL *array, int lo, int hi, int depth)
+{
+    int i, j;
+
+    while (hi - lo >= SMALL_RANGE) {
+        if (depth-- == 0) {
+            heap_sort(array + lo, hi - lo + 1);
+            return;
+        }
+        partition(array, lo, hi, &i, &j);
+        /* recurse into the smaller part */
+        if (j - lo < hi - i) {
+            sort_range(array, lo, j, depth);
+            lo = i;
+        }
+        else {
+            sort_range(array, i, hi, depth);
+            hi = j;
+        }
+    }
+
+    insertion_sort(array, lo, hi);
+}
+
+static int max_depth(int n)
+{
+    int depth = 0;
+
+    while (n > 1) {
+        n >>= 1;
+        depth += 2;
+    }
+
+    return depth;
+}
+
+/*!
+   \brief Removes NULL values from an array
+
+   \param array values
+   \param n number of values
+
+   \return number of non-NULL values, moved to the start of the array
+ */
+int compact_cell(DCELL *array, int n)
 {
     int i, j;
 
@@ -35,14 +170,64 @@ int sort_cell(DCELL *array, int n)
             j++;
         }
     }
-    n = j;
 
-    if (n > 0)
-        qsort(array, n, sizeof(DCELL), ascending);
+    return j;
+}
+
+/*!
+   \brief Removes NULL values from an array and sorts the rest
+
+   \param array values
+   \param n number of values
+
+   \return number of non-NULL values, sorted in ascending order at the
+   start of the array
+ */
+int sort_cell(DCELL *array, int n)
+{
+    n = compact_cell(array, n);
+
+    if (n > 1)
+        sort_range(array, 0, n - 1, max_depth(n));
 
     return n;
 }
 
+/*!
+   \brief Moves the k-th smallest value into place
+
+   Partially orders the array so that <i>array[k]</i> is the value a
+   full sort would put there, no value before it is greater and no
+   value after it is smaller. Takes linear time on average, unlike
+   sort_cell().
+
+   \param array values without NULL values (see compact_cell())
+   \param n number of values
+   \param k rank from 0 to n - 1
+ */
+void select_cell(DCELL *array, int n, int k)
+{
+    int lo = 0, hi = n - 1;
+    int depth = max_depth(n);
+    int i, j;
+
+    while (hi - lo >= SMALL_RANGE) {
+        if (depth-- == 0) {
+            sort_range(array, lo, hi, 0);
+            return;
+        }
+        partition(array, lo, hi, &i, &j);
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            return; /* array[k] is the pivot */
+    }
+
+    insertion_sort(array, lo, hi);
+}
+
 int sort_cell_w(DCELL (*array)[2], int n)
 {
     int i, j;
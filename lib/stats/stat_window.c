@@ -0,0 +1,137 @@
+#include <string.h>
+
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/stats.h>
+#include <grass/glocale.h>
+
+/* index of the first value not smaller than v */
+static int lower_bound(const struct stat_window *w, DCELL v)
+{
+    int lo = 0, hi = w->n, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (w->values[mid] < v)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static int find_value(const struct stat_window *w, DCELL v)
+{
+    int i = lower_bound(w, v);
+
+    if (i == w->n || w->values[i] != v)
+        G_fatal_error(_("Value %g is not in the window"), v);
+
+    return i;
+}
+
+/*!
+   \brief Initializes a moving window
+
+   The window keeps its non-NULL values sorted while values enter and
+   leave it, so that order statistics like the median can be taken
+   from the window without sorting all values of every position, e.g.
+   by passing <i>w->values</i> and <i>w->n</i> to s_median(). Moving
+   a window of n values by one cell costs a binary search and a move
+   of the values between the positions of the leaving and the entering
+   value, which is small when neighboring values are close.
+
+   \param w window
+   \param size maximum number of values
+ */
+void stat_window_init(struct stat_window *w, int size)
+{
+    w->values = G_malloc(size * sizeof(DCELL));
+    w->n = 0;
+    w->size = size;
+}
+
+/*!
+   \brief Removes all values from a window
+
+   \param w window
+ */
+void stat_window_clear(struct stat_window *w)
+{
+    w->n = 0;
+}
+
+/*!
+   \brief Adds a value to a window
+
+   \param w window
+   \param v value, ignored if NULL
+ */
+void stat_window_insert(struct stat_window *w, DCELL v)
+{
+    int i;
+
+    if (Rast_is_d_null_value(&v))
+        return;
+
+    if (w->n == w->size)
+        G_fatal_error(_("Too many values in the window"));
+
+    i = lower_bound(w, v);
+    memmove(&w->values[i + 1], &w->values[i], (w->n - i) * sizeof(DCELL));
+    w->values[i] = v;
+    w->n++;
+}
+
+/*!
+   \brief Replaces a value of a window by another one
+
+   \param w window
+   \param out leaving value, must be in the window unless NULL
+   \param in entering value, ignored if NULL
+ */
+void stat_window_update(struct stat_window *w, DCELL out, DCELL in)
+{
+    int i, j;
+
+    if (Rast_is_d_null_value(&out)) {
+        stat_window_insert(w, in);
+        return;
+    }
+
+    i = find_value(w, out);
+
+    if (Rast_is_d_null_value(&in)) {
+        memmove(&w->values[i], &w->values[i + 1],
+                (w->n - i - 1) * sizeof(DCELL));
+        w->n--;
+        return;
+    }
+
+    /* shift the values between the leaving and the entering one */
+    if (in > out) {
+        j = lower_bound(w, in) - 1;
+        memmove(&w->values[i], &w->values[i + 1], (j - i) * sizeof(DCELL));
+    }
+    else if (in < out) {
+        j = lower_bound(w, in);
+        memmove(&w->values[j + 1], &w->values[j], (i - j) * sizeof(DCELL));
+    }
+    else
+        return;
+
+    w->values[j] = in;
+}
+
+/*!
+   \brief Frees the memory of a window
+
+   \param w window
+ */
+void stat_window_free(struct stat_window *w)
+{
+    G_free(w->values);
+    w->values = NULL;
+    w->n = w->size = 0;
+}
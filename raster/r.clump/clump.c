@@ -16,6 +16,10 @@
  *
  ***************************************************************************/
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -185,314 +189,445 @@ static CELL do_renumber(int *in_fd, DCELL *rng, int nin, int diag, int minsize,
     return cat;
 }
 
-CELL clump(int *in_fd, int out_fd, int diag, int minsize)
+static double get_diff2(DCELL **a, int acol, DCELL **b, int bcol, DCELL *rng,
+                        int n)
 {
-    register int col;
-    register int n;
-    CELL NEW, OLD;
-    CELL *temp_cell, *temp_clump;
-    CELL *prev_in, *cur_in;
-    CELL *prev_clump, *cur_clump;
-    CELL X, LEFT;
-    CELL *index;
-    CELL label;
+    int i;
+    double diff, diff2;
+
+    diff2 = 0;
+    for (i = 0; i < n; i++) {
+        if (Rast_is_d_null_value(&b[i][bcol]))
+            return 2;
+        diff = a[i][acol] - b[i][bcol];
+        /* normalize with the band's range */
+        if (rng[i])
+            diff /= rng[i];
+        diff2 += diff * diff;
+    }
+    /* normalize difference to the range [0, 1] */
+    diff2 /= n;
+
+    return diff2;
+}
+
+/* input rows, two columns larger than the current window */
+struct inrow {
+    CELL *c;   /* single CELL map, threshold 0: cells must be identical */
+    DCELL **d; /* any maps: cells must be similar */
+};
+
+/* settings shared by all strips */
+struct clump_ctx {
+    int nin;
+    int cell; /* compare CELL values */
+    int diag;
+    double thresh2;
+    DCELL *rng;
     int nrows, ncols;
-    int row;
-    int len;
-    int nalloc;
-    time_t cur_time;
-    char *cname;
-    int cfd, csize;
+    char *cname; /* temp file for initial clump IDs */
+};
+
+/* rows labeled independently of the other strips */
+struct strip {
+    int row0, row1;                 /* first row, last row + 1 */
+    CELL nlabels;                   /* number of initial labels */
+    CELL *parent;                   /* union-find forest of initial labels */
+    CELL nclumps;                   /* number of clumps in the strip */
+    CELL offset;                    /* offset of the clump IDs of the strip */
+    CELL *first, *last;             /* clump IDs of the first and last row */
+    struct inrow first_in, last_in; /* input of the first and last row */
+};
+
+static void alloc_inrow(const struct clump_ctx *ctx, struct inrow *in)
+{
+    int i;
 
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
+    in->c = NULL;
+    in->d = NULL;
+    if (ctx->cell) {
+        in->c = G_malloc((ctx->ncols + 2) * sizeof(CELL));
+        /* set left and right edge to NULL */
+        Rast_set_c_null_value(in->c, ctx->ncols + 2);
+        return;
+    }
+    in->d = G_malloc(ctx->nin * sizeof(DCELL *));
+    for (i = 0; i < ctx->nin; i++) {
+        in->d[i] = G_malloc((ctx->ncols + 2) * sizeof(DCELL));
+        Rast_set_d_null_value(in->d[i], ctx->ncols + 2);
+    }
+}
 
-    /* allocate clump index */
-    nalloc = INCR;
-    index = (CELL *)G_malloc(nalloc * sizeof(CELL));
-    index[0] = 0;
+static void free_inrow(const struct clump_ctx *ctx, struct inrow *in)
+{
+    int i;
 
-    /* allocate CELL buffers two columns larger than current window */
-    len = (ncols + 2) * sizeof(CELL);
-    prev_in = (CELL *)G_malloc(len);
-    cur_in = (CELL *)G_malloc(len);
-    prev_clump = (CELL *)G_malloc(len);
-    cur_clump = (CELL *)G_malloc(len);
+    if (in->d) {
+        for (i = 0; i < ctx->nin; i++)
+            G_free(in->d[i]);
+    }
+    G_free(in->d);
+    G_free(in->c);
+}
 
-    /* temp file for initial clump IDs */
-    cname = G_tempfile();
-    if ((cfd = open(cname, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0)
-        G_fatal_error(_("Unable to open temp file"));
-    csize = ncols * sizeof(CELL);
+static void copy_inrow(const struct clump_ctx *ctx, struct inrow *dst,
+                       const struct inrow *src)
+{
+    int i;
 
-    time(&cur_time);
+    if (ctx->cell) {
+        memcpy(dst->c, src->c, (ctx->ncols + 2) * sizeof(CELL));
+        return;
+    }
+    for (i = 0; i < ctx->nin; i++)
+        memcpy(dst->d[i], src->d[i], (ctx->ncols + 2) * sizeof(DCELL));
+}
 
-    /* fake a previous row which is all NULL */
-    Rast_set_c_null_value(prev_in, ncols + 2);
+static inline int is_null(const struct clump_ctx *ctx, int cell,
+                          const struct inrow *in, int col)
+{
+    int i;
 
-    /* set left and right edge to NULL */
-    Rast_set_c_null_value(&cur_in[0], 1);
-    Rast_set_c_null_value(&cur_in[ncols + 1], 1);
+    if (cell)
+        return Rast_is_c_null_value(&in->c[col]);
+    for (i = 0; i < ctx->nin; i++) {
+        if (Rast_is_d_null_value(&in->d[i][col]))
+            return 1;
+    }
 
-    /* initialize clump labels */
-    G_zero(cur_clump, len);
-    G_zero(prev_clump, len);
-    label = 0;
+    return 0;
+}
 
-    /****************************************************
-     *                      PASS 1                      *
-     * pass thru the input, create initial clump labels *
-     ****************************************************/
+/* cell a at acol can be clumped with cell b at bcol, a must not be NULL */
+static inline int similar(const struct clump_ctx *ctx, int cell,
+                          const struct inrow *a, int acol,
+                          const struct inrow *b, int bcol)
+{
+    if (cell)
+        return a->c[acol] == b->c[bcol];
 
-    G_message(_("Pass 1 of 2..."));
-    for (row = 0; row < nrows; row++) {
-        Rast_get_c_row(*in_fd, cur_in + 1, row);
+    return get_diff2(a->d, acol, b->d, bcol, ctx->rng, ctx->nin) <=
+           ctx->thresh2;
+}
 
-        G_percent(row, nrows, 2);
-        Rast_set_c_null_value(&X, 1);
-        for (col = 1; col <= ncols; col++) {
-            LEFT = X;
-            X = cur_in[col];
-            if (Rast_is_c_null_value(&X)) { /* don't clump NULL data */
-                cur_clump[col] = 0;
-                continue;
-            }
+/* find the root of a label, the root is the smallest label of its tree */
+static inline CELL find_root(CELL *parent, CELL n)
+{
+    while (parent[n] != n) {
+        parent[n] = parent[parent[n]];
+        n = parent[n];
+    }
 
-            /*
-             * if the cell value is different to the left and above
-             * (diagonal: and above left and above right)
-             * then we must start a new clump
-             *
-             * this new clump may eventually collide with another
-             * clump and will have to be merged
-             */
-
-            /* try to connect the current cell to an existing clump */
-            OLD = NEW = 0;
-            /* same clump as to the left */
-            if (X == LEFT) {
-                OLD = cur_clump[col] = cur_clump[col - 1];
-            }
+    return n;
+}
 
-            if (diag) {
-                /* check above right, center, left, in that order */
-                n = 2;
-                temp_clump = prev_clump + col + 1;
-                temp_cell = prev_in + col + 1;
-                do {
-                    if (X == *temp_cell) {
-                        cur_clump[col] = *temp_clump;
-                        if (OLD == 0) {
-                            OLD = *temp_clump;
-                        }
-                        else {
-                            NEW = *temp_clump;
-                            break;
-                        }
-                    }
-                    temp_cell--;
-                    temp_clump--;
-                } while (n-- > 0);
-            }
-            else {
-                /* check above */
-                if (X == prev_in[col]) {
-                    temp_clump = prev_clump + col;
-                    cur_clump[col] = *temp_clump;
-                    if (OLD == 0) {
-                        OLD = *temp_clump;
-                    }
-                    else {
-                        NEW = *temp_clump;
-                    }
-                }
-            }
+/* merge the trees of two labels, returns the new root */
+static CELL unite(CELL *parent, CELL a, CELL b)
+{
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b) {
+        parent[b] = a;
+        return a;
+    }
+    parent[a] = b;
 
-            if (NEW == 0 || OLD == NEW) { /* ok */
-                if (OLD == 0) {
-                    /* start a new clump */
-                    label++;
-                    cur_clump[col] = label;
-                    if (label >= nalloc) {
-                        nalloc += INCR;
-                        index = (CELL *)G_realloc(index, nalloc * sizeof(CELL));
-                    }
-                    index[label] = label;
-                }
+    return b;
+}
+
+static void seek_row(int fd, int row, int csize)
+{
+    if (lseek(fd, (off_t)row * csize, SEEK_SET) == -1) {
+        int err = errno;
+        G_fatal_error(_("File read/write operation failed: %s (%d)"),
+                      strerror(err), err);
+    }
+}
+
+/* create initial clump labels for a row, cell and diag are constant in
+ * each call to have a loop for each kind of input */
+static inline void label_row(const struct clump_ctx *ctx, int cell, int diag,
+                             struct strip *s, int *nalloc,
+                             const struct inrow *cur_in,
+                             const struct inrow *prev_in, CELL *cur_clump,
+                             const CELL *prev_clump)
+{
+    int col, bcol, bcol1;
+    CELL X;
+
+    for (col = 1; col <= ctx->ncols; col++) {
+        if (is_null(ctx, cell, cur_in, col)) { /* don't clump NULL data */
+            cur_clump[col] = 0;
+            continue;
+        }
+
+        /* same clump as to the left */
+        X = 0;
+        if (similar(ctx, cell, cur_in, col, cur_in, col - 1))
+            X = cur_clump[col - 1];
+
+        /* above (diagonal: and above left and above right),
+         * different clumps of similar cells are merged */
+        bcol = diag ? col - 1 : col;
+        bcol1 = diag ? col + 1 : col;
+        for (; bcol <= bcol1; bcol++) {
+            if (prev_clump[bcol] == 0 ||
+                !similar(ctx, cell, cur_in, col, prev_in, bcol))
                 continue;
+            if (X == 0)
+                X = prev_clump[bcol];
+            else if (X != prev_clump[bcol])
+                X = unite(s->parent, X, prev_clump[bcol]);
+        }
+
+        if (X == 0) {
+            /* start a new clump */
+            X = ++s->nlabels;
+            if (X >= *nalloc) {
+                *nalloc += INCR;
+                s->parent =
+                    (CELL *)G_realloc(s->parent, *nalloc * sizeof(CELL));
             }
+            s->parent[X] = X;
+        }
+        cur_clump[col] = X;
+    }
+}
 
-            /* conflict! preserve NEW clump ID and change OLD clump ID.
-             * Must go back to the left in the current row and to the right
-             * in the previous row to change all the clump values as well.
-             */
+/* pass 1: create initial clump labels for the rows of a strip */
+static void label_strip(const struct clump_ctx *ctx, int *in_fd,
+                        struct strip *s, int *computed, int report)
+{
+    struct inrow prev_in, cur_in, temp_in;
+    CELL *prev_clump, *cur_clump, *temp_clump;
+    int nalloc;
+    int row, i, done;
+    int cfd, csize, len;
 
-            /* left of the current row from 1 to col - 1 */
-            temp_clump = cur_clump;
-            n = col - 1;
-            while (n-- > 0) {
-                temp_clump++; /* skip left edge */
-                if (*temp_clump == OLD)
-                    *temp_clump = NEW;
-            }
+    csize = ctx->ncols * sizeof(CELL);
+    if ((cfd = open(ctx->cname, O_RDWR)) < 0)
+        G_fatal_error(_("Unable to open temp file"));
 
-            /* right of previous row from col + 1 to ncols */
-            temp_clump = prev_clump + col;
-            n = ncols - col;
-            while (n-- > 0) {
-                temp_clump++; /* skip col */
-                if (*temp_clump == OLD)
-                    *temp_clump = NEW;
-            }
+    /* allocate clump index */
+    nalloc = INCR;
+    s->parent = (CELL *)G_malloc(nalloc * sizeof(CELL));
+    s->parent[0] = 0;
+    s->nlabels = 0;
+
+    /* fake a previous row which is all NULL */
+    alloc_inrow(ctx, &prev_in);
+    alloc_inrow(ctx, &cur_in);
+    alloc_inrow(ctx, &s->first_in);
+    alloc_inrow(ctx, &s->last_in);
 
-            /* modify the OLD index */
-            index[OLD] = NEW;
+    /* allocate CELL buffers two columns larger than current window */
+    len = (ctx->ncols + 2) * sizeof(CELL);
+    prev_clump = (CELL *)G_calloc(1, len);
+    cur_clump = (CELL *)G_calloc(1, len);
+    s->first = (CELL *)G_malloc(len);
+    s->last = (CELL *)G_malloc(len);
+
+    seek_row(cfd, s->row0, csize);
+    for (row = s->row0; row < s->row1; row++) {
+        if (ctx->cell)
+            Rast_get_c_row(in_fd[0], cur_in.c + 1, row);
+        else {
+            for (i = 0; i < ctx->nin; i++)
+                Rast_get_d_row(in_fd[i], cur_in.d[i] + 1, row);
         }
 
+        if (ctx->cell && ctx->diag)
+            label_row(ctx, 1, 1, s, &nalloc, &cur_in, &prev_in, cur_clump,
+                      prev_clump);
+        else if (ctx->cell)
+            label_row(ctx, 1, 0, s, &nalloc, &cur_in, &prev_in, cur_clump,
+                      prev_clump);
+        else
+            label_row(ctx, 0, ctx->diag, s, &nalloc, &cur_in, &prev_in,
+                      cur_clump, prev_clump);
+
         /* write initial clump IDs */
-        /* this works also with writing out cur_clump, but only
-         * prev_clump is complete and will not change any more */
-        if (row > 0) {
-            if (write(cfd, prev_clump + 1, csize) != csize)
-                G_fatal_error(_("Unable to write to temp file"));
+        if (write(cfd, cur_clump + 1, csize) != csize)
+            G_fatal_error(_("Unable to write to temp file"));
+
+        if (row == s->row0) {
+            memcpy(s->first, cur_clump, len);
+            copy_inrow(ctx, &s->first_in, &cur_in);
+        }
+        if (row == s->row1 - 1) {
+            memcpy(s->last, cur_clump, len);
+            copy_inrow(ctx, &s->last_in, &cur_in);
         }
 
         /* switch the buffers so that the current buffer becomes the previous */
-        temp_cell = cur_in;
+        temp_in = cur_in;
         cur_in = prev_in;
-        prev_in = temp_cell;
+        prev_in = temp_in;
 
         temp_clump = cur_clump;
         cur_clump = prev_clump;
         prev_clump = temp_clump;
-    }
-    /* write last row with initial clump IDs */
-    if (write(cfd, prev_clump + 1, csize) != csize)
-        G_fatal_error(_("Unable to write to temp file"));
-    G_percent(1, 1, 1);
 
-    /* free */
-    G_free(prev_clump);
-    G_free(cur_clump);
-
-    G_free(prev_in);
-    G_free(cur_in);
-
-    do_renumber(in_fd, NULL, 1, diag, minsize, cfd, label, index, out_fd);
+#pragma omp atomic capture
+        done = ++(*computed);
+        /* rows done by all strips, reported by one thread */
+        if (report)
+            G_percent(done, ctx->nrows, 2);
+    }
 
     close(cfd);
-    unlink(cname);
 
-    print_time(&cur_time);
-
-    return 0;
+    G_free(prev_clump);
+    G_free(cur_clump);
+    free_inrow(ctx, &prev_in);
+    free_inrow(ctx, &cur_in);
 }
 
-static double get_diff2(DCELL **a, int acol, DCELL **b, int bcol, DCELL *rng,
-                        int n)
+/* number the clumps of a strip in the order of their first cell */
+static void count_strip_clumps(struct strip *s)
 {
-    int i;
-    double diff, diff2;
-
-    diff2 = 0;
-    for (i = 0; i < n; i++) {
-        if (Rast_is_d_null_value(&b[i][bcol]))
-            return 2;
-        diff = a[i][acol] - b[i][bcol];
-        /* normalize with the band's range */
-        if (rng[i])
-            diff /= rng[i];
-        diff2 += diff * diff;
+    CELL n;
+
+    /* parents are smaller than their children, so the parent of a label
+     * is replaced with its clump ID before the label is */
+    s->nclumps = 0;
+    for (n = 1; n <= s->nlabels; n++) {
+        if (s->parent[n] == n)
+            s->parent[n] = ++s->nclumps;
+        else
+            s->parent[n] = s->parent[s->parent[n]];
     }
-    /* normalize difference to the range [0, 1] */
-    diff2 /= n;
-
-    return diff2;
 }
 
-CELL clump_n(int *in_fd, char **inname, int nin, double threshold, int out_fd,
-             int diag, int minsize)
+/* replace the initial labels of a strip with clump IDs */
+static void relabel_strip(const struct clump_ctx *ctx, struct strip *s)
 {
-    register int col;
-    register int i, n;
-    /* input */
-    DCELL **prev_in, **cur_in, **temp_in;
-    int bcol;
-    DCELL *rng, maxdiff;
-    double thresh2;
-    /* output */
-    CELL OLD, NEW;
-    CELL *temp_clump;
-    CELL *prev_clump, *cur_clump;
-    CELL *index;
-    CELL label;
-    int nrows, ncols;
-    int row;
-    int isnull;
-    int len;
-    int nalloc;
-    time_t cur_time;
-    char *cname;
+    CELL *cbuf, *id;
+    int row, col;
     int cfd, csize;
 
-    G_message(_("%d-band clumping with threshold %g"), nin, threshold);
-
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
-
-    thresh2 = threshold * threshold;
-
-    /* allocate clump index */
-    nalloc = INCR;
-    index = (CELL *)G_malloc(nalloc * sizeof(CELL));
-    index[0] = 0;
+    csize = ctx->ncols * sizeof(CELL);
+    if ((cfd = open(ctx->cname, O_RDWR)) < 0)
+        G_fatal_error(_("Unable to open temp file"));
 
-    /* allocate DCELL buffers two columns larger than current window */
-    len = (ncols + 2) * sizeof(DCELL);
-    prev_in = (DCELL **)G_malloc(sizeof(DCELL *) * nin);
-    cur_in = (DCELL **)G_malloc(sizeof(DCELL *) * nin);
-    rng = G_malloc(sizeof(DCELL) * nin);
+    /* parent[] maps labels to the clump ID within the strip now */
+    id = s->parent;
+    cbuf = (CELL *)G_malloc(csize);
+    for (row = s->row0; row < s->row1; row++) {
+        seek_row(cfd, row, csize);
+        if (read(cfd, cbuf, csize) != csize)
+            G_fatal_error(_("Unable to read from temp file"));
 
-    maxdiff = 0;
-    for (i = 0; i < nin; i++) {
-        struct FPRange fp_range; /* min/max values of each input raster */
-        DCELL min, max;
+        for (col = 0; col < ctx->ncols; col++) {
+            if (cbuf[col])
+                cbuf[col] = id[cbuf[col]] + s->offset;
+        }
 
-        if (Rast_read_fp_range(inname[i], "", &fp_range) != 1)
-            G_fatal_error(_("No min/max found in raster map <%s>"), inname[i]);
-        Rast_get_fp_range_min_max(&fp_range, &min, &max);
-        rng[i] = max - min;
-        maxdiff += rng[i] * rng[i];
+        seek_row(cfd, row, csize);
+        if (write(cfd, cbuf, csize) != csize)
+            G_fatal_error(_("Unable to write to temp file"));
+    }
 
-        prev_in[i] = (DCELL *)G_malloc(len);
-        cur_in[i] = (DCELL *)G_malloc(len);
+    for (col = 1; col <= ctx->ncols; col++) {
+        if (s->first[col])
+            s->first[col] = id[s->first[col]] + s->offset;
+        if (s->last[col])
+            s->last[col] = id[s->last[col]] + s->offset;
+    }
 
-        /* fake a previous row which is all NULL */
-        Rast_set_d_null_value(prev_in[i], ncols + 2);
+    close(cfd);
+    G_free(cbuf);
+    G_free(s->parent);
+    s->parent = NULL;
+}
 
-        /* set left and right edge to NULL */
-        Rast_set_d_null_value(&cur_in[i][0], 1);
-        Rast_set_d_null_value(&cur_in[i][ncols + 1], 1);
+/* merge clumps across the boundary between strip a and the next strip b */
+static void merge_strips(const struct clump_ctx *ctx, const struct strip *a,
+                         const struct strip *b, CELL *index)
+{
+    int col, bcol, bcol1;
+
+    for (col = 1; col <= ctx->ncols; col++) {
+        if (b->first[col] == 0)
+            continue;
+
+        bcol = ctx->diag ? col - 1 : col;
+        bcol1 = ctx->diag ? col + 1 : col;
+        for (; bcol <= bcol1; bcol++) {
+            if (a->last[bcol] != 0 &&
+                similar(ctx, ctx->cell, &b->first_in, col, &a->last_in, bcol))
+                unite(index, a->last[bcol], b->first[col]);
+        }
     }
-    G_debug(1, "maximum possible difference: %g", maxdiff);
+}
 
-    /* allocate CELL buffers two columns larger than current window */
-    len = (ncols + 2) * sizeof(CELL);
-    prev_clump = (CELL *)G_malloc(len);
-    cur_clump = (CELL *)G_malloc(len);
+/*
+ * Labels clumps in strips of rows, one per thread, each with its own
+ * union-find forest. The clumps of each strip are numbered in the order
+ * of their first cell, then clumps touching each other across strip
+ * boundaries are merged, keeping the smallest ID. Clumps thus get the
+ * same IDs regardless of the number of strips.
+ */
+CELL clump(int *in_fd, char **inname, int nin, int nthreads,
+           double threshold, int out_fd, int diag, int minsize)
+{
+    struct clump_ctx ctx;
+    struct strip *strips;
+    int nstrips, s, i, t;
+    int computed;
+    CELL *index;
+    CELL label;
+    time_t cur_time;
+    int cfd;
+
+    ctx.nin = nin;
+    ctx.diag = diag;
+    ctx.thresh2 = threshold * threshold;
+    ctx.nrows = Rast_window_rows();
+    ctx.ncols = Rast_window_cols();
+    /* a single CELL map without threshold is read as CELL and compared
+     * for equality, like the former separate clump() for this case did */
+    ctx.cell = (nin == 1 && threshold == 0 &&
+                Rast_get_map_type(in_fd[0]) == CELL_TYPE);
+    ctx.rng = NULL;
+
+    if (!ctx.cell) {
+        DCELL maxdiff;
+
+        G_message(_("%d-band clumping with threshold %g"), nin, threshold);
+
+        ctx.rng = G_malloc(sizeof(DCELL) * nin);
+        maxdiff = 0;
+        for (i = 0; i < nin; i++) {
+            struct FPRange fp_range; /* min/max values of each input raster */
+            DCELL min, max;
+
+            if (Rast_read_fp_range(inname[i], "", &fp_range) != 1)
+                G_fatal_error(_("No min/max found in raster map <%s>"),
+                              inname[i]);
+            Rast_get_fp_range_min_max(&fp_range, &min, &max);
+            ctx.rng[i] = max - min;
+            maxdiff += ctx.rng[i] * ctx.rng[i];
+        }
+        G_debug(1, "maximum possible difference: %g", maxdiff);
+    }
 
     /* temp file for initial clump IDs */
-    cname = G_tempfile();
-    if ((cfd = open(cname, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0)
+    ctx.cname = G_tempfile();
+    if ((cfd = open(ctx.cname, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0)
         G_fatal_error(_("Unable to open temp file"));
-    csize = ncols * sizeof(CELL);
 
     time(&cur_time);
 
-    /* initialize clump labels */
-    G_zero(cur_clump, len);
-    G_zero(prev_clump, len);
-    label = 0;
+    /* one strip of rows per thread */
+    nstrips = nthreads;
+    if (nstrips > ctx.nrows)
+        nstrips = ctx.nrows;
+    strips = G_calloc(nstrips, sizeof(struct strip));
+    for (s = 0; s < nstrips; s++) {
+        strips[s].row0 = (int)((double)ctx.nrows * s / nstrips);
+        strips[s].row1 = (int)((double)ctx.nrows * (s + 1) / nstrips);
+    }
 
     /****************************************************
      *                      PASS 1                      *
@@ -500,196 +635,56 @@ CELL clump_n(int *in_fd, char **inname, int nin, double threshold, int out_fd,
      ****************************************************/
 
     G_message(_("Pass 1 of 2..."));
-    for (row = 0; row < nrows; row++) {
-        G_percent(row, nrows, 2);
-        for (i = 0; i < nin; i++) {
-            Rast_get_d_row(in_fd[i], cur_in[i] + 1, row);
-        }
-
-        for (col = 1; col <= ncols; col++) {
-            isnull = 0;
-            for (i = 0; i < nin; i++) {
-                if (Rast_is_d_null_value(
-                        &cur_in[i][col])) { /* don't clump NULL data */
-                    cur_clump[col] = 0;
-                    isnull = 1;
-                    break;
-                }
-            }
-            if (isnull)
-                continue;
-
-            /*
-             * if the cell values are different to the left and above
-             * (diagonal: and above left and above right)
-             * then we must start a new clump
-             *
-             * this new clump may eventually collide with another
-             * clump and will have to be merged
-             */
-
-            /* try to connect the current cell to an existing clump */
-            OLD = NEW = 0;
-            /* same clump as to the left */
-            if (get_diff2(cur_in, col, cur_in, col - 1, rng, nin) <= thresh2) {
-                OLD = cur_clump[col] = cur_clump[col - 1];
-            }
-
-            if (diag) {
-                /* check above right, center, left, in that order */
-                temp_clump = prev_clump + col + 1;
-                bcol = col + 1;
-                do {
-                    if (get_diff2(cur_in, col, prev_in, bcol, rng, nin) <=
-                        thresh2) {
-                        cur_clump[col] = *temp_clump;
-                        if (OLD == 0) {
-                            OLD = *temp_clump;
-                        }
-                        else {
-                            NEW = *temp_clump;
-
-                            /* threshold > 0 and diagonal requires a bit of
-                             * extra work because of bridge cells: A similar to
-                             * B, B similar to C, but A not similar to C
-                             * -> B is bridge cell */
-                            if (NEW != OLD) {
-                                CELL *temp_clump2;
-
-                                /* conflict! preserve NEW clump ID and change
-                                 * OLD clump ID. Must go back to the left in the
-                                 * current row and to the right in the previous
-                                 * row to change all the clump values as well.
-                                 */
-
-                                /* left of the current row from 1 to col - 1 */
-                                temp_clump2 = cur_clump;
-                                n = col - 1;
-                                while (n-- > 0) {
-                                    temp_clump2++; /* skip left edge */
-                                    if (*temp_clump2 == OLD)
-                                        *temp_clump2 = NEW;
-                                }
-
-                                /* right of previous row from col - 1 to ncols
-                                 */
-                                temp_clump2 = prev_clump + col - 1;
-                                n = ncols - col + 2;
-                                while (n-- > 0) {
-                                    if (*temp_clump2 == OLD)
-                                        *temp_clump2 = NEW;
-                                    temp_clump2++;
-                                }
-
-                                /* modify the OLD index */
-                                index[OLD] = NEW;
-
-                                OLD = NEW;
-                                NEW = 0;
-                            }
-                        }
-                    }
-                    temp_clump--;
-                } while (bcol-- > col - 1);
-            }
-            else {
-                /* check above */
-                if (get_diff2(cur_in, col, prev_in, col, rng, nin) <= thresh2) {
-                    temp_clump = prev_clump + col;
-                    cur_clump[col] = *temp_clump;
-                    if (OLD == 0) {
-                        OLD = *temp_clump;
-                    }
-                    else {
-                        NEW = *temp_clump;
-                        if (NEW != OLD) {
-
-                            /* conflict! preserve NEW clump ID and change OLD
-                             * clump ID. Must go back to the left in the current
-                             * row and to the right in the previous row to
-                             * change all the clump values as well.
-                             */
-
-                            /* left of the current row from 1 to col - 1 */
-                            temp_clump = cur_clump;
-                            n = col - 1;
-                            while (n-- > 0) {
-                                temp_clump++; /* skip left edge */
-                                if (*temp_clump == OLD)
-                                    *temp_clump = NEW;
-                            }
-
-                            /* right of previous row from col + 1 to ncols */
-                            temp_clump = prev_clump + col;
-                            n = ncols - col;
-                            while (n-- > 0) {
-                                temp_clump++; /* skip col */
-                                if (*temp_clump == OLD)
-                                    *temp_clump = NEW;
-                            }
-
-                            /* modify the OLD index */
-                            index[OLD] = NEW;
-
-                            OLD = NEW;
-                            NEW = 0;
-                        }
-                    }
-                }
-            }
-
-            if (NEW == 0 || OLD == NEW) { /* ok */
-                if (OLD == 0) {
-                    /* start a new clump */
-                    label++;
-                    cur_clump[col] = label;
-                    if (label >= nalloc) {
-                        nalloc += INCR;
-                        index = (CELL *)G_realloc(index, nalloc * sizeof(CELL));
-                    }
-                    index[label] = label;
-                }
-            }
-            /* else the relabelling above failed */
-        }
+    computed = 0;
+    t = 0;
+#pragma omp parallel for schedule(static, 1) private(t) if (nstrips > 1)
+    for (s = 0; s < nstrips; s++) {
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        label_strip(&ctx, in_fd + t * nin, &strips[s], &computed, t == 0);
+        if (nstrips > 1)
+            count_strip_clumps(&strips[s]);
+    }
+    G_percent(1, 1, 1);
 
-        /* write initial clump IDs */
-        /* this works also with writing out cur_clump, but only
-         * prev_clump is complete and will not change any more */
-        if (row > 0) {
-            if (write(cfd, prev_clump + 1, csize) != csize)
-                G_fatal_error(_("Unable to write to temp file"));
+    if (nstrips == 1) {
+        /* the initial labels of a single strip need no merging */
+        index = strips[0].parent;
+        label = strips[0].nlabels;
+    }
+    else {
+        label = 0;
+        for (s = 0; s < nstrips; s++) {
+            strips[s].offset = label;
+            label += strips[s].nclumps;
         }
 
-        /* switch the buffers so that the current buffer becomes the previous */
-        temp_in = cur_in;
-        cur_in = prev_in;
-        prev_in = temp_in;
+#pragma omp parallel for schedule(static, 1)
+        for (s = 0; s < nstrips; s++)
+            relabel_strip(&ctx, &strips[s]);
 
-        temp_clump = cur_clump;
-        cur_clump = prev_clump;
-        prev_clump = temp_clump;
+        /* merge clumps across strip boundaries */
+        index = (CELL *)G_malloc((label + 1) * sizeof(CELL));
+        for (i = 0; i <= label; i++)
+            index[i] = i;
+        for (s = 1; s < nstrips; s++)
+            merge_strips(&ctx, &strips[s - 1], &strips[s], index);
     }
-    /* write last row with initial clump IDs */
-    if (write(cfd, prev_clump + 1, csize) != csize)
-        G_fatal_error(_("Unable to write to temp file"));
-    G_percent(1, 1, 1);
-
-    /* free */
-    G_free(prev_clump);
-    G_free(cur_clump);
 
-    for (i = 0; i < nin; i++) {
-        G_free(prev_in[i]);
-        G_free(cur_in[i]);
+    for (s = 0; s < nstrips; s++) {
+        G_free(strips[s].first);
+        G_free(strips[s].last);
+        free_inrow(&ctx, &strips[s].first_in);
+        free_inrow(&ctx, &strips[s].last_in);
     }
-    G_free(prev_in);
-    G_free(cur_in);
+    G_free(strips);
 
-    do_renumber(in_fd, rng, nin, diag, minsize, cfd, label, index, out_fd);
+    do_renumber(in_fd, ctx.rng, nin, diag, minsize, cfd, label, index, out_fd);
 
     close(cfd);
-    unlink(cname);
+    unlink(ctx.cname);
+    G_free(ctx.rng);
 
     print_time(&cur_time);
 
@@ -19,8 +19,7 @@
 #define __LOCAL_PROTO_H__
 
 /* clump.c */
-CELL clump(int *, int, int, int);
-CELL clump_n(int *, char **, int, double, int, int, int);
+CELL clump(int *, char **, int, int, double, int, int, int);
 
 /* minsize.c */
 int merge_small_clumps(int *in_fd, int nin, DCELL *rng, int diag, int min_size,
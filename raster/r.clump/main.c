@@ -33,20 +33,21 @@ int main(int argc, char *argv[])
     CELL min, max;
     int range_return, n_clumps;
     int *in_fd, out_fd;
-    int i, n;
+    int i, n, t;
+    int nprocs;
     double threshold;
     int minsize;
     char title[512];
     char name[GNAME_MAX];
     char *OUTPUT;
     char *INPUT;
-    RASTER_MAP_TYPE map_type;
     struct GModule *module;
     struct Option *opt_in;
     struct Option *opt_out;
     struct Option *opt_thresh;
     struct Option *opt_minsize;
     struct Option *opt_title;
+    struct Option *opt_nprocs;
     struct Flag *flag_diag;
     struct Flag *flag_print;
 
@@ -92,6 +93,8 @@ int main(int argc, char *argv[])
     opt_minsize->description =
         _("Clumps smaller than minsize will be merged to form larger clumps");
 
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     flag_diag = G_define_flag();
     flag_diag->key = 'd';
     flag_diag->label = _("Clump also diagonal cells");
@@ -117,17 +120,22 @@ int main(int argc, char *argv[])
 
     minsize = atoi(opt_minsize->answer);
 
+    nprocs = G_set_omp_num_threads(opt_nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
+    if (nprocs < 1)
+        G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
+
     n = 0;
     while (opt_in->answers[n])
         n++;
 
-    in_fd = G_malloc(sizeof(int) * n);
+    /* input maps for each thread */
+    in_fd = G_malloc(sizeof(int) * n * nprocs);
 
-    map_type = CELL_TYPE;
     for (i = 0; i < n; i++) {
         in_fd[i] = Rast_open_old(opt_in->answers[i], "");
-        if (Rast_get_map_type(in_fd[i]) != CELL_TYPE)
-            map_type = Rast_get_map_type(in_fd[i]);
+        for (t = 1; t < nprocs; t++)
+            in_fd[t * n + i] = Rast_open_old_dup(in_fd[i]);
     }
 
     INPUT = opt_in->answers[0];
@@ -142,13 +150,10 @@ int main(int argc, char *argv[])
         out_fd = Rast_open_c_new(OUTPUT);
     }
 
-    if (n == 1 && threshold == 0 && map_type == CELL_TYPE)
-        clump(in_fd, out_fd, flag_diag->answer, minsize);
-    else
-        clump_n(in_fd, opt_in->answers, n, threshold, out_fd, flag_diag->answer,
-                minsize);
+    clump(in_fd, opt_in->answers, n, nprocs, threshold, out_fd,
+          flag_diag->answer, minsize);
 
-    for (i = 0; i < n; i++)
+    for (i = 0; i < n * nprocs; i++)
         Rast_close(in_fd[i]);
 
     if (!flag_print->answer) {
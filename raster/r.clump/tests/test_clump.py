@@ -171,3 +171,29 @@ def test_clump_threshold(setup_maps):
     assert category_data == expected_categories, (
         "Category data does not match expected categories"
     )
+
+
+def test_clump_nprocs(setup_maps):
+    """Test that clumping in parallel gives the same clumps."""
+    session = setup_maps
+    for nprocs in (1, 3):
+        gs.run_command(
+            "r.clump",
+            input="custom_map",
+            output=f"clumped_map_{nprocs}",
+            flags="d",
+            nprocs=nprocs,
+            overwrite=True,
+            env=session.env,
+        )
+
+    gs.mapcalc(
+        "clump_diff = clumped_map_1 != clumped_map_3",
+        overwrite=True,
+        env=session.env,
+    )
+    stats = gs.parse_command(
+        "r.univar", map="clump_diff", format="json", env=session.env
+    )
+    assert stats["n"] == 5
+    assert stats["max"] == 0
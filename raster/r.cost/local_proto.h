@@ -0,0 +1,38 @@
+#ifndef __LOCAL_PROTO_H__
+#define __LOCAL_PROTO_H__
+
+#include <grass/raster.h>
+#include <grass/seggrid.h>
+#include <grass/cost.h>
+
+/* cell record, starts with the members of struct Cost_cell */
+struct cc {
+    double cost_out, nearest, cost_in;
+};
+
+/* separate cost surfaces for each start point */
+struct per_source {
+    SEGGRID *cost_segs;       /* loaded cost grid, one copy per thread */
+    int nthreads;             /* number of threads and of copies */
+    int knight;               /* use the knight's move */
+    double max_cost;          /* maximum cumulative cost, 0 for none */
+    int srows, scols;         /* segment size */
+    int segments_in_memory;   /* per segment file */
+    int count;                /* nearest start points per cell, 0 for none */
+    const char *output;       /* basename of cost maps */
+    const char *nearest;      /* basename of nearest start point maps */
+    const char *matrix;       /* file with start to stop point costs */
+    const char *fs;           /* field separator of the matrix */
+    int keep_nulls;           /* keep input nulls in the output */
+    int cost_fd;              /* input cost map, for keep_nulls */
+    RASTER_MAP_TYPE cost_type;
+};
+
+/* main.c */
+double move_cost(const struct Cost_search *, double, void **, int);
+
+/* sources.c */
+void run_per_source(struct per_source *, struct Cost_start_pt *,
+                    struct Cost_start_pt *);
+
+#endif /* __LOCAL_PROTO_H__ */
@@ -71,77 +71,56 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/vector.h>
-#include <grass/segment.h>
+#include <grass/seggrid.h>
+#include <grass/cost.h>
 #include <grass/glocale.h>
-#include "cost.h"
-#include "stash.h"
-#include "flag.h"
+#include "local_proto.h"
 
 #define SEGCOLSIZE 64
 
 struct Cell_head window;
 
-struct rc {
-    int r;
-    int c;
-};
-
-static struct rc *stop_pnts = NULL;
-static int n_stop_pnts = 0;
-static int stop_pnts_alloc = 0;
-
-int cmp_rc(struct rc *a, struct rc *b)
-{
-    if (a->r == b->r)
-        return (a->c - b->c);
-
-    return (a->r - b->r);
-}
-
-void add_stop_pnt(int r, int c);
+/* distance factors for moves to the neighbors */
+static double NS_fac, EW_fac, DIAG_fac, H_DIAG_fac, V_DIAG_fac;
 
 int main(int argc, char *argv[])
 {
     const char *cum_cost_layer, *move_dir_layer, *nearest_layer;
     const char *cost_layer;
     const char *cost_mapset, *search_mapset;
-    void *cell, *cell2, *dir_cell, *nearest_cell;
-    SEGMENT cost_seg, dir_seg, solve_seg;
+    void *cell, *cell2, *nearest_cell;
+    SEGGRID cost_seg, dir_seg, solve_seg;
+    SEGGRID *cost_segs;
+    int ncost_segs;
     int have_solver;
-    double *value;
     extern struct Cell_head window;
-    double NS_fac, EW_fac, DIAG_fac, H_DIAG_fac, V_DIAG_fac;
-    double fcost;
-    double min_cost, old_min_cost;
-    FCELL cur_dir;
+    double min_cost;
     double zero = 0.0;
-    int col, row, nrows, ncols;
+    int col, row, nrows, ncols, i;
     int maxcost;
     int nseg, nbytes;
     int maxmem;
     int segments_in_memory;
-    int cost_fd, cum_fd, dir_fd, nearest_fd;
+    int cost_fd, cum_fd, nearest_fd;
     int dir = 0;
-    double my_cost, nearest;
+    double nearest;
     double null_cost, dnullval;
     int srows, scols;
-    int total_reviewed;
     int keep_nulls = 1;
     int start_with_raster_vals = 1;
-    int neighbor;
-    long n_processed = 0;
     long total_cells;
     struct GModule *module;
     struct Flag *flag2, *flag3, *flag4, *flag5, *flag6;
     struct Option *opt1, *opt2, *opt3, *opt4, *opt5, *opt6, *opt7, *opt8;
     struct Option *opt9, *opt10, *opt11, *opt12, *opt_solve;
-    struct cost *pres_cell;
-    struct start_pt *head_start_pt = NULL;
-    struct start_pt *next_start_pt;
-    struct cc {
-        double cost_in, cost_out, nearest;
-    } costs;
-    FLAG *visited;
+    struct Option *opt_count, *opt_matrix, *opt_sep, *opt_nprocs;
+    struct Cost_search search;
+    struct Cost_start_pt *head_start_pt = NULL;
+    struct Cost_start_pt *head_stop_pt = NULL;
+    struct Cost_start_pt *next_start_pt;
+    struct per_source ps;
+    int per_source, count, nprocs;
+    struct cc costs;
 
     void *ptr2;
     RASTER_MAP_TYPE data_type,         /* input cost type */
@@ -154,7 +133,8 @@ int main(int argc, char *argv[])
     double disk_mb, mem_mb, pq_mb;
 
     int dir_bin;
-    DCELL mysolvedir[2], solvedir[2];
+    DCELL *solvedir;
+    struct cc *costrow;
 
     G_gisinit(argv[0]);
 
@@ -173,6 +153,7 @@ int main(int argc, char *argv[])
         _("Name of input raster map containing grid cell cost information");
 
     opt1 = G_define_standard_option(G_OPT_R_OUTPUT);
+    opt1->required = NO;
 
     opt_solve = G_define_standard_option(G_OPT_R_INPUT);
     opt_solve->key = "solver";
@@ -245,6 +226,37 @@ int main(int argc, char *argv[])
         _("Cost assigned to null cells. By default, null cells are excluded");
     opt6->guisection = _("NULL cells");
 
+    opt_count = G_define_option();
+    opt_count->key = "nearest_count";
+    opt_count->type = TYPE_INTEGER;
+    opt_count->required = NO;
+    opt_count->label =
+        _("Number of nearest start points to keep for each cell");
+    opt_count->description =
+        _("Computes a separate cost surface for each start point and writes "
+          "the costs of the nearest start points to <output>.1, <output>.2, "
+          "... and the start points to <nearest>.1, <nearest>.2, ...");
+    opt_count->options = "1-";
+    opt_count->guisection = _("Per start point");
+
+    opt_matrix = G_define_standard_option(G_OPT_F_OUTPUT);
+    opt_matrix->key = "matrix";
+    opt_matrix->required = NO;
+    opt_matrix->label =
+        _("Name for output file with costs from each start point to each "
+          "stop point");
+    opt_matrix->description =
+        _("Computes a separate cost surface for each start point. "
+          "'-' for standard output");
+    opt_matrix->guisection = _("Per start point");
+
+    opt_sep = G_define_standard_option(G_OPT_F_SEP);
+    opt_sep->guisection = _("Per start point");
+
+    opt_nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+    opt_nprocs->description =
+        _("Number of threads for separate cost surfaces per start point");
+
     opt10 = G_define_standard_option(G_OPT_MEMORYMB);
 
     flag2 = G_define_flag();
@@ -272,10 +284,27 @@ int main(int argc, char *argv[])
     flag6->description = _("Create bitmask encoded directions");
     flag6->guisection = _("Optional outputs");
 
+    G_option_required(opt1, opt_matrix, NULL);
+    G_option_requires(opt_count, opt1, NULL);
+    G_option_requires(opt_matrix, opt8, opt4, NULL);
+    G_option_excludes(opt9, opt_count, opt_matrix, NULL);
+    G_option_excludes(opt11, opt_count, opt_matrix, NULL);
+
     /* Parse options */
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    /* separate cost surfaces for each start point */
+    per_source = (opt_count->answer || opt_matrix->answer);
+    count = 0;
+    if (opt_count->answer)
+        count = atoi(opt_count->answer);
+    else if (per_source && opt1->answer)
+        count = 1;
+    nprocs = 1;
+    if (per_source)
+        nprocs = G_set_omp_num_threads(opt_nprocs);
+
     /* If no outdir is specified, set flag to skip all dir */
     if (opt11->answer != NULL)
         dir = 1;
@@ -298,10 +327,11 @@ int main(int argc, char *argv[])
 
     Rast_set_d_null_value(&null_cost, 1);
 
-    if (flag2->answer)
-        total_reviewed = 16;
-    else
-        total_reviewed = 8;
+    nrows = Rast_window_rows();
+    ncols = Rast_window_cols();
+
+    Cost_init_search(&search, nrows, ncols, flag2->answer);
+    search.move_cost = move_cost;
 
     keep_nulls = flag3->answer;
 
@@ -327,13 +357,15 @@ int main(int argc, char *argv[])
     }
 
     if (opt3->answers) {
-        head_start_pt = process_start_coords(opt3->answers, head_start_pt);
+        head_start_pt =
+            Cost_parse_start_coords(opt3->answers, head_start_pt, &window);
         if (!head_start_pt)
             G_fatal_error(_("No start points"));
     }
 
     if (opt4->answers) {
-        if (!process_stop_coords(opt4->answers))
+        head_stop_pt = Cost_parse_start_coords(opt4->answers, NULL, &window);
+        if (!head_stop_pt)
             G_fatal_error(_("No stop points"));
     }
 
@@ -381,10 +413,6 @@ int main(int argc, char *argv[])
     move_dir_layer = opt11->answer;
     nearest_layer = opt12->answer;
 
-    /* Find number of rows and columns in window */
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
-
     /* Open cost cell layer for reading */
     cost_mapset = G_find_raster2(cost_layer, "");
     if (cost_mapset == NULL)
@@ -434,6 +462,13 @@ int main(int argc, char *argv[])
         nbytes += 4;
     if (have_solver)
         nbytes += 16;
+    /* a copy of the cost records for each thread and the nearest
+     * start points */
+    ncost_segs = 1;
+    if (per_source) {
+        ncost_segs = nprocs;
+        nbytes = 24 * ncost_segs + 16 * count;
+    }
 
     disk_mb = (double)nrows * ncols * nbytes / 1048576.;
 
@@ -466,40 +501,48 @@ int main(int argc, char *argv[])
     /* Create segmented format files for cost layer and output layer */
     G_verbose_message(_("Creating some temporary files..."));
 
-    if (Segment_open(&cost_seg, G_tempfile(), nrows, ncols, srows, scols,
-                     sizeof(struct cc), segments_in_memory) != 1)
-        G_fatal_error(_("Can not create temporary file"));
+    cost_segs = &cost_seg;
+    if (ncost_segs > 1)
+        cost_segs = G_malloc(ncost_segs * sizeof(SEGGRID));
+    for (i = 0; i < ncost_segs; i++) {
+        if (Seggrid_open_records(&cost_segs[i], nrows, ncols, srows, scols,
+                                 sizeof(struct cc), segments_in_memory) < 0)
+            G_fatal_error(_("Can not create temporary file"));
+        /* the search goes around the start points, cells far from the
+         * current one are needed again soon */
+        Segment_set_policy(&cost_segs[i].seg, SEGMENT_CLOCK);
+    }
 
     if (dir == 1) {
-        if (Segment_open(&dir_seg, G_tempfile(), nrows, ncols, srows, scols,
-                         sizeof(FCELL), segments_in_memory) != 1)
+        if (Seggrid_open(&dir_seg, dir_data_type, srows, scols,
+                         segments_in_memory) < 0)
             G_fatal_error(_("Can not create temporary file"));
     }
 
     if (have_solver) {
         int sfd;
 
-        if (Segment_open(&solve_seg, G_tempfile(), nrows, ncols, srows, scols,
-                         sizeof(DCELL) * 2, segments_in_memory) != 1)
+        if (Seggrid_open_records(&solve_seg, nrows, ncols, srows, scols,
+                                 sizeof(DCELL) * 2, segments_in_memory) < 0)
             G_fatal_error(_("Can not create temporary file"));
 
+        /* the grids are new, they are filled by rows */
         sfd = Rast_open_old(opt_solve->answer, "");
         cell = Rast_allocate_buf(DCELL_TYPE);
-        Rast_set_d_null_value(&solvedir[1], 1);
-        dsize = Rast_cell_size(DCELL_TYPE);
+        solvedir = G_malloc(ncols * 2 * sizeof(DCELL));
+        for (col = 0; col < ncols; col++)
+            Rast_set_d_null_value(&solvedir[2 * col + 1], 1);
         for (row = 0; row < nrows; row++) {
             G_percent(row, nrows, 2);
             Rast_get_d_row(sfd, cell, row);
-            ptr2 = cell;
-            for (col = 0; col < ncols; col++) {
-                solvedir[0] = *(DCELL *)ptr2;
-                if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                ptr2 = G_incr_void_ptr(ptr2, dsize);
-            }
+            for (col = 0; col < ncols; col++)
+                solvedir[2 * col] = ((DCELL *)cell)[col];
+            if (Seggrid_put_row(&solve_seg, solvedir, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
         }
         Rast_close(sfd);
         G_free(cell);
+        G_free(solvedir);
     }
 
     /* Write the cost layer in the segmented file */
@@ -519,6 +562,7 @@ int main(int argc, char *argv[])
 
         dsize = Rast_cell_size(data_type);
         cell = Rast_allocate_buf(data_type);
+        costrow = G_malloc(ncols * sizeof(struct cc));
         p = 0.0;
 
         for (row = 0; row < nrows; row++) {
@@ -554,33 +598,42 @@ int main(int argc, char *argv[])
                     p = null_cost;
                 }
                 costs.cost_in = p;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
+                costrow[col] = costs;
                 ptr2 = G_incr_void_ptr(ptr2, dsize);
             }
+            for (i = 0; i < ncost_segs; i++) {
+                if (Seggrid_put_row(&cost_segs[i], costrow, row) < 0)
+                    G_fatal_error(_("Can not write to temporary file"));
+            }
         }
         G_free(cell);
+        G_free(costrow);
         G_percent(1, 1, 1);
     }
 
     if (dir == 1) {
-        FCELL fnullval;
-
         G_message(_("Initializing directional output..."));
-        Rast_set_f_null_value(&fnullval, 1);
+        cell = Rast_allocate_buf(dir_data_type);
+        Rast_set_null_value(cell, ncols, dir_data_type);
         for (row = 0; row < nrows; row++) {
             G_percent(row, nrows, 2);
-            for (col = 0; col < ncols; col++) {
-                if (Segment_put(&dir_seg, &fnullval, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-            }
+            if (Seggrid_put_row(&dir_seg, cell, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
         }
         G_percent(1, 1, 1);
+        G_free(cell);
     }
     /*   Scan the start_points layer searching for starting points.
      *   Create a heap of starting points ordered by increasing costs.
      */
-    init_heap();
+    search.cost_seg = &cost_seg.seg;
+    if (dir == 1)
+        search.dir_seg = &dir_seg.seg;
+    if (have_solver)
+        search.solve_seg = &solve_seg.seg;
+    search.dir_bin = dir_bin;
+    search.max_cost = maxcost;
+    search.total_cells = total_cells;
 
     /* read vector with start points */
     if (opt7->answer) {
@@ -625,8 +678,7 @@ int main(int argc, char *argv[])
             col = (int)Rast_easting_to_col(Points->x[0], &window);
             row = (int)Rast_northing_to_row(Points->y[0], &window);
 
-            next_start_pt =
-                (struct start_pt *)(G_malloc(sizeof(struct start_pt)));
+            next_start_pt = G_malloc(sizeof(struct Cost_start_pt));
 
             next_start_pt->row = row;
             next_start_pt->col = col;
@@ -652,7 +704,7 @@ int main(int argc, char *argv[])
         struct line_pnts *Points;
         struct line_cats *Cats;
         struct bound_box box;
-        int type;
+        int cat, type, nstop = 0;
 
         G_message(_("Reading vector map <%s> with stop points..."),
                   opt8->answer);
@@ -688,16 +740,54 @@ int main(int argc, char *argv[])
             col = (int)Rast_easting_to_col(Points->x[0], &window);
             row = (int)Rast_northing_to_row(Points->y[0], &window);
 
-            add_stop_pnt(row, col);
+            next_start_pt = G_malloc(sizeof(struct Cost_start_pt));
+
+            next_start_pt->row = row;
+            next_start_pt->col = col;
+            Vect_cat_get(Cats, 1, &cat);
+            next_start_pt->value = cat;
+            next_start_pt->next = head_stop_pt;
+            head_stop_pt = next_start_pt;
+            nstop++;
         }
 
         Vect_close(&In);
 
-        if (!stop_pnts)
+        if (!nstop)
             G_fatal_error(_("No stop points found in vector <%s>"),
                           opt8->answer);
     }
 
+    if (per_source) {
+        ps.cost_segs = cost_segs;
+        ps.nthreads = ncost_segs;
+        ps.knight = flag2->answer;
+        ps.max_cost = maxcost;
+        ps.srows = srows;
+        ps.scols = scols;
+        ps.segments_in_memory = segments_in_memory;
+        ps.count = count;
+        ps.output = cum_cost_layer;
+        ps.nearest = nearest_layer;
+        ps.matrix = opt_matrix->answer;
+        ps.fs = G_option_to_separator(opt_sep);
+        ps.keep_nulls = keep_nulls;
+        ps.cost_fd = cost_fd;
+        ps.cost_type = data_type;
+
+        run_per_source(&ps, head_start_pt, head_stop_pt);
+
+        for (i = 0; i < ncost_segs; i++)
+            Seggrid_close(&cost_segs[i]);
+        Rast_close(cost_fd);
+
+        exit(EXIT_SUCCESS);
+    }
+
+    for (next_start_pt = head_stop_pt; next_start_pt;
+         next_start_pt = next_start_pt->next)
+        Cost_add_stop_point(&search, next_start_pt->row, next_start_pt->col);
+
     /* read raster with start points */
     if (opt9->answer) {
         int dsize2;
@@ -730,25 +820,12 @@ int main(int argc, char *argv[])
                 if (!Rast_is_null_value(ptr2, data_type2)) {
                     double cellval;
 
-                    if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-
                     cellval = Rast_get_d_value(ptr2, data_type2);
-                    if (start_with_raster_vals == 1) {
-                        insert(cellval, row, col);
-                        costs.cost_out = cellval;
-                        costs.nearest = cellval;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
-                    else {
-                        value = &zero;
-                        insert(zero, row, col);
-                        costs.cost_out = *value;
-                        costs.nearest = cellval;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
+                    if (start_with_raster_vals == 1)
+                        Cost_add_start_point(&search, row, col, cellval,
+                                             cellval);
+                    else
+                        Cost_add_start_point(&search, row, col, zero, cellval);
                     got_one = 1;
                 }
                 ptr2 = G_incr_void_ptr(ptr2, dsize2);
@@ -768,45 +845,17 @@ int main(int argc, char *argv[])
 
         next_start_pt = head_start_pt;
         while (next_start_pt != NULL) {
-            value = &zero;
             if (next_start_pt->row < 0 || next_start_pt->row >= nrows ||
                 next_start_pt->col < 0 || next_start_pt->col >= ncols)
                 G_fatal_error(
                     _("Specified starting location outside database window"));
-            insert(zero, next_start_pt->row, next_start_pt->col);
-            if (Segment_get(&cost_seg, &costs, next_start_pt->row,
-                            next_start_pt->col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-            costs.cost_out = *value;
-            costs.nearest = next_start_pt->value;
-
-            if (Segment_put(&cost_seg, &costs, next_start_pt->row,
-                            next_start_pt->col) < 0)
-                G_fatal_error(_("Can not write to temporary file"));
+            Cost_add_start_point(&search, next_start_pt->row,
+                                 next_start_pt->col, zero,
+                                 next_start_pt->value);
             next_start_pt = next_start_pt->next;
         }
     }
 
-    if (n_stop_pnts > 1) {
-        int i, j;
-
-        /* prune stop points */
-        j = 1;
-        for (i = 1; i < n_stop_pnts; i++) {
-            if (stop_pnts[i].r != stop_pnts[j - 1].r ||
-                stop_pnts[i].c != stop_pnts[j - 1].c) {
-                stop_pnts[j].r = stop_pnts[i].r;
-                stop_pnts[j].c = stop_pnts[i].c;
-                j++;
-            }
-        }
-        if (n_stop_pnts > j) {
-            G_message(_("Number of duplicate stop points: %d"),
-                      n_stop_pnts - j);
-            n_stop_pnts = j;
-        }
-    }
-
     /*  Loop through the heap and perform at each cell the following:
      *   1) If an adjacent cell has not already been assigned a value compute
      *      the min cost and assign it.
@@ -817,430 +866,11 @@ int main(int argc, char *argv[])
     G_debug(1, "total cells: %ld", total_cells);
     G_debug(1, "nrows x ncols: %ld", (long)nrows * ncols);
     G_message(_("Finding cost path..."));
-    n_processed = 0;
-    visited = flag_create(nrows, ncols);
-
-    pres_cell = get_lowest();
-    while (pres_cell != NULL) {
-        struct cost *ct;
-        double N, NE, E, SE, S, SW, W, NW;
-        double NNE, ENE, ESE, SSE, SSW, WSW, WNW, NNW;
-
-        N = NE = E = SE = S = SW = W = NW = dnullval;
-        NNE = ENE = ESE = SSE = SSW = WSW = WNW = NNW = dnullval;
-
-        /* If we have surpassed the user specified maximum cost, then quit */
-        if (maxcost && ((double)maxcost < pres_cell->min_cost))
-            break;
-
-        /* If I've already been updated, delete me */
-        if (Segment_get(&cost_seg, &costs, pres_cell->row, pres_cell->col) < 0)
-            G_fatal_error(_("Can not read from temporary file"));
-        old_min_cost = costs.cost_out;
-        if (!Rast_is_d_null_value(&old_min_cost)) {
-            if (pres_cell->min_cost > old_min_cost) {
-                delete(pres_cell);
-                pres_cell = get_lowest();
-                continue;
-            }
-        }
-        if (FLAG_GET(visited, pres_cell->row, pres_cell->col)) {
-            delete(pres_cell);
-            pres_cell = get_lowest();
-            continue;
-        }
-        FLAG_SET(visited, pres_cell->row, pres_cell->col);
-
-        if (have_solver) {
-            if (Segment_get(&solve_seg, mysolvedir, pres_cell->row,
-                            pres_cell->col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-        }
-
-        my_cost = costs.cost_in;
-        nearest = costs.nearest;
-
-        row = pres_cell->row;
-        col = pres_cell->col;
-
-        G_percent(n_processed++, total_cells, 1);
-
-        /*          9    10       Order in which neighbors
-         *       13 5  3  6 14    are visited (Knight move).
-         *          1     2
-         *       16 8  4  7 15
-         *         12    11
-         */
-
-        /* drainage directions in degrees CCW from East
-         * drainage directions are set for each neighbor and must be
-         * read as from neighbor to current cell
-         *
-         * X = neighbor:
-         *
-         *       112.5       67.5
-         * 157.5 135    90   45   22.5
-         *       180     X  360
-         * 202.5 225   270  315   337.5
-         *       247.5      292.5
-         *
-         * X = current cell:
-         *
-         *       292.5      247.5
-         * 337.5 315   270  225    202.5
-         *       360     X  180
-         *  22.5  45    90  135    157.5
-         *        67.5      112.5
-         */
-
-        /* drainage directions bitmask encoded CW from North
-         * drainage directions are set for each neighbor and must be
-         * read as from neighbor to current cell
-         *
-         * bit positions, zero-based, from neighbor to current cell
-         *
-         *     X = neighbor                X = current cell
-         *
-         *      15       8                   11      12
-         *    14 6   7   0  9              10 2   3   4 13
-         *       5   X   1                    1   X   5
-         *    13 4   3   2 10               9 0   7   6 14
-         *      12      11                    8      15
-         */
-
-        for (neighbor = 1; neighbor <= total_reviewed; neighbor++) {
-            switch (neighbor) {
-            case 1:
-                row = pres_cell->row;
-                col = pres_cell->col - 1;
-                cur_dir = 360.0;
-                if (dir_bin)
-                    cur_dir = 1;
-                break;
-            case 2:
-                row = pres_cell->row;
-                col = pres_cell->col + 1;
-                cur_dir = 180.0;
-                if (dir_bin)
-                    cur_dir = 5;
-                break;
-            case 3:
-                row = pres_cell->row - 1;
-                col = pres_cell->col;
-                cur_dir = 270.0;
-                if (dir_bin)
-                    cur_dir = 3;
-                break;
-            case 4:
-                row = pres_cell->row + 1;
-                col = pres_cell->col;
-                cur_dir = 90.0;
-                if (dir_bin)
-                    cur_dir = 7;
-                break;
-            case 5:
-                row = pres_cell->row - 1;
-                col = pres_cell->col - 1;
-                cur_dir = 315.0;
-                if (dir_bin)
-                    cur_dir = 2;
-                break;
-            case 6:
-                row = pres_cell->row - 1;
-                col = pres_cell->col + 1;
-                cur_dir = 225.0;
-                if (dir_bin)
-                    cur_dir = 4;
-                break;
-            case 7:
-                row = pres_cell->row + 1;
-                col = pres_cell->col + 1;
-                cur_dir = 135.0;
-                if (dir_bin)
-                    cur_dir = 6;
-                break;
-            case 8:
-                row = pres_cell->row + 1;
-                col = pres_cell->col - 1;
-                cur_dir = 45.0;
-                if (dir_bin)
-                    cur_dir = 0;
-                break;
-            case 9:
-                row = pres_cell->row - 2;
-                col = pres_cell->col - 1;
-                cur_dir = 292.5;
-                if (dir_bin)
-                    cur_dir = 11;
-                break;
-            case 10:
-                row = pres_cell->row - 2;
-                col = pres_cell->col + 1;
-                cur_dir = 247.5;
-                if (dir_bin)
-                    cur_dir = 12;
-                break;
-            case 11:
-                row = pres_cell->row + 2;
-                col = pres_cell->col + 1;
-                cur_dir = 112.5;
-                if (dir_bin)
-                    cur_dir = 15;
-                break;
-            case 12:
-                row = pres_cell->row + 2;
-                col = pres_cell->col - 1;
-                cur_dir = 67.5;
-                if (dir_bin)
-                    cur_dir = 8;
-                break;
-            case 13:
-                row = pres_cell->row - 1;
-                col = pres_cell->col - 2;
-                cur_dir = 337.5;
-                if (dir_bin)
-                    cur_dir = 10;
-                break;
-            case 14:
-                row = pres_cell->row - 1;
-                col = pres_cell->col + 2;
-                cur_dir = 202.5;
-                if (dir_bin)
-                    cur_dir = 13;
-                break;
-            case 15:
-                row = pres_cell->row + 1;
-                col = pres_cell->col + 2;
-                cur_dir = 157.5;
-                if (dir_bin)
-                    cur_dir = 14;
-                break;
-            case 16:
-                row = pres_cell->row + 1;
-                col = pres_cell->col - 2;
-                cur_dir = 22.5;
-                if (dir_bin)
-                    cur_dir = 9;
-                break;
-            }
-
-            if (row < 0 || row >= nrows)
-                continue;
-            if (col < 0 || col >= ncols)
-                continue;
-
-            /* skip already processed neighbors here ? */
-
-            min_cost = dnullval;
-            if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-
-            switch (neighbor) {
-            case 1:
-                W = costs.cost_in;
-                fcost = (double)(W + my_cost);
-                min_cost = pres_cell->min_cost + fcost * EW_fac;
-                break;
-            case 2:
-                E = costs.cost_in;
-                fcost = (double)(E + my_cost);
-                min_cost = pres_cell->min_cost + fcost * EW_fac;
-                break;
-            case 3:
-                N = costs.cost_in;
-                fcost = (double)(N + my_cost);
-                min_cost = pres_cell->min_cost + fcost * NS_fac;
-                break;
-            case 4:
-                S = costs.cost_in;
-                fcost = (double)(S + my_cost);
-                min_cost = pres_cell->min_cost + fcost * NS_fac;
-                break;
-            case 5:
-                NW = costs.cost_in;
-                fcost = (double)(NW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * DIAG_fac;
-                break;
-            case 6:
-                NE = costs.cost_in;
-                fcost = (double)(NE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * DIAG_fac;
-                break;
-            case 7:
-                SE = costs.cost_in;
-                fcost = (double)(SE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * DIAG_fac;
-                break;
-            case 8:
-                SW = costs.cost_in;
-                fcost = (double)(SW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * DIAG_fac;
-                break;
-            case 9:
-                NNW = costs.cost_in;
-                fcost = (double)(N + NW + NNW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * V_DIAG_fac;
-                break;
-            case 10:
-                NNE = costs.cost_in;
-                fcost = (double)(N + NE + NNE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * V_DIAG_fac;
-                break;
-            case 11:
-                SSE = costs.cost_in;
-                fcost = (double)(S + SE + SSE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * V_DIAG_fac;
-                break;
-            case 12:
-                SSW = costs.cost_in;
-                fcost = (double)(S + SW + SSW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * V_DIAG_fac;
-                break;
-            case 13:
-                WNW = costs.cost_in;
-                fcost = (double)(W + NW + WNW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * H_DIAG_fac;
-                break;
-            case 14:
-                ENE = costs.cost_in;
-                fcost = (double)(E + NE + ENE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * H_DIAG_fac;
-                break;
-            case 15:
-                ESE = costs.cost_in;
-                fcost = (double)(E + SE + ESE + my_cost);
-                min_cost = pres_cell->min_cost + fcost * H_DIAG_fac;
-                break;
-            case 16:
-                WSW = costs.cost_in;
-                fcost = (double)(W + SW + WSW + my_cost);
-                min_cost = pres_cell->min_cost + fcost * H_DIAG_fac;
-                break;
-            }
-
-            /* skip if costs could not be calculated */
-            if (Rast_is_d_null_value(&min_cost))
-                continue;
-
-            if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-            old_min_cost = costs.cost_out;
-
-            /* add to list */
-            if (Rast_is_d_null_value(&old_min_cost)) {
-                costs.cost_out = min_cost;
-                costs.nearest = nearest;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                insert(min_cost, row, col);
-                if (dir == 1) {
-                    if (dir_bin)
-                        cur_dir = (1 << (int)cur_dir);
-                    if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    solvedir[1] = mysolvedir[0];
-                    if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-            }
-            /* update with lower costs */
-            else if (old_min_cost > min_cost) {
-                costs.cost_out = min_cost;
-                costs.nearest = nearest;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                insert(min_cost, row, col);
-                if (dir == 1) {
-                    if (dir_bin)
-                        cur_dir = (1 << (int)cur_dir);
-                    if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    solvedir[1] = mysolvedir[0];
-                    if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-            }
-            else if (old_min_cost == min_cost && (dir_bin || have_solver) &&
-                     !(FLAG_GET(visited, row, col))) {
-                FCELL old_dir;
-
-                int dir_inv[16] = {4,  5,  6,  7,  0, 1, 2,  3,
-                                   12, 13, 14, 15, 8, 9, 10, 11};
-                int dir_fwd;
-                int equal = 1;
-
-                /* only update neighbors that have not yet been processed,
-                 * otherwise we might get circular paths */
-
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    equal = (solvedir[1] == mysolvedir[0]);
-                    if (solvedir[1] > mysolvedir[0]) {
-                        solvedir[1] = mysolvedir[0];
-                        if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-
-                        costs.nearest = nearest;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-
-                        if (dir == 1) {
-                            if (dir_bin)
-                                cur_dir = (1 << (int)cur_dir);
-                            if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                                G_fatal_error(
-                                    _("Can not write to temporary file"));
-                        }
-                    }
-                }
-
-                if (dir_bin && equal) {
-                    /* this can create circular paths:
-                     * set only if current cell does not point to neighbor
-                     * does not avoid longer circular paths */
-                    if (Segment_get(&dir_seg, &old_dir, pres_cell->row,
-                                    pres_cell->col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    dir_fwd = (1 << dir_inv[(int)cur_dir]);
-                    if (!((int)old_dir & dir_fwd)) {
-                        if (Segment_get(&dir_seg, &old_dir, row, col) < 0)
-                            G_fatal_error(
-                                _("Can not read from temporary file"));
-                        cur_dir = ((1 << (int)cur_dir) | (int)old_dir);
-                        if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
-                }
-            }
-        }
-
-        if (stop_pnts && time_to_stop(pres_cell->row, pres_cell->col))
-            break;
-
-        ct = pres_cell;
-        delete(pres_cell);
-        pres_cell = get_lowest();
-
-        if (ct == pres_cell)
-            G_warning(_("Error, ct == pres_cell"));
-    }
-    G_percent(1, 1, 1);
-
-    /* free heap */
-    free_heap();
-    flag_destroy(visited);
+    Cost_run_search(&search);
+    Cost_free_search(&search);
 
     if (have_solver) {
-        Segment_close(&solve_seg);
+        Seggrid_close(&solve_seg);
     }
 
     /* Open cumulative cost layer for writing */
@@ -1296,7 +926,7 @@ int main(int argc, char *argv[])
                         continue;
                     }
                 }
-                if (Segment_get(&cost_seg, &costs, row, col) < 0)
+                if (Seggrid_get(&cost_seg, &costs, row, col) < 0)
                     G_fatal_error(_("Can not read from temporary file"));
                 min_cost = costs.cost_out;
                 nearest = costs.nearest;
@@ -1352,37 +982,18 @@ int main(int argc, char *argv[])
     }
 
     if (dir == 1) {
-        void *p;
-        size_t dir_size = Rast_cell_size(dir_data_type);
-
-        dir_fd = Rast_open_new(move_dir_layer, dir_data_type);
-        dir_cell = Rast_allocate_buf(dir_data_type);
-
         G_message(_("Writing output movement direction raster map <%s>..."),
                   move_dir_layer);
-        for (row = 0; row < nrows; row++) {
-            p = dir_cell;
-            for (col = 0; col < ncols; col++) {
-                if (Segment_get(&dir_seg, &cur_dir, row, col) < 0)
-                    G_fatal_error(_("Can not read from temporary file"));
-                *((FCELL *)p) = cur_dir;
-                p = G_incr_void_ptr(p, dir_size);
-            }
-            Rast_put_row(dir_fd, dir_cell, dir_data_type);
-            G_percent(row, nrows, 2);
-        }
-        G_percent(1, 1, 1);
-        G_free(dir_cell);
+        if (Seggrid_write_raster(&dir_seg, move_dir_layer) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
     }
 
-    Segment_close(&cost_seg); /* release memory  */
+    Seggrid_close(&cost_seg); /* release memory  */
     if (dir == 1)
-        Segment_close(&dir_seg);
+        Seggrid_close(&dir_seg);
 
     Rast_close(cost_fd);
     Rast_close(cum_fd);
-    if (dir == 1)
-        Rast_close(dir_fd);
     if (nearest_layer)
         Rast_close(nearest_fd);
 
@@ -1433,122 +1044,37 @@ int main(int argc, char *argv[])
     exit(EXIT_SUCCESS);
 }
 
-struct start_pt *process_start_coords(char **answers,
-                                      struct start_pt *top_start_pt)
-{
-    int col, row;
-    double east, north;
-    struct start_pt *new_start_pt;
-    int point_no = 0;
-
-    if (!answers)
-        return (0);
-
-    for (; *answers != NULL; answers += 2) {
-        if (!G_scan_easting(*answers, &east, G_projection()))
-            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
-        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
-            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
-
-        if (east < window.west || east > window.east || north < window.south ||
-            north > window.north) {
-            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
-                      north);
-            continue;
-        }
-
-        row = (window.north - north) / window.ns_res;
-        col = (east - window.west) / window.ew_res;
-
-        new_start_pt = (struct start_pt *)(G_malloc(sizeof(struct start_pt)));
-
-        new_start_pt->row = row;
-        new_start_pt->col = col;
-        new_start_pt->value = ++point_no;
-        new_start_pt->next = top_start_pt;
-        top_start_pt = new_start_pt;
-    }
-
-    return top_start_pt;
-}
-
-int process_stop_coords(char **answers)
+/* cumulative cost of moving from cell rec[0] to neighbor rec[neighbor],
+ * knight's moves include the costs of the two cells passed */
+double move_cost(const struct Cost_search *cs, double min_cost, void **rec,
+                 int neighbor)
 {
-    int col, row;
-    double east, north;
-
-    if (!answers)
-        return 0;
-
-    for (; *answers != NULL; answers += 2) {
-        if (!G_scan_easting(*answers, &east, G_projection()))
-            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
-        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
-            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
-
-        if (east < window.west || east > window.east || north < window.south ||
-            north > window.north) {
-            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
-                      north);
-            continue;
-        }
-
-        row = (window.north - north) / window.ns_res;
-        col = (east - window.west) / window.ew_res;
-
-        add_stop_pnt(row, col);
+    /* neighbors passed by the knight's moves 9 - 16 */
+    static const int pass1[17] = {0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  3, 3, 4, 4, 1, 2, 2, 1};
+    static const int pass2[17] = {0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  5, 6, 7, 8, 5, 6, 7, 8};
+    double my_cost, fcost, A, B, dnullval;
+
+    Rast_set_d_null_value(&dnullval, 1);
+    my_cost = ((struct cc *)rec[0])->cost_in;
+
+    if (neighbor > 8) {
+        A = rec[pass1[neighbor]] ? ((struct cc *)rec[pass1[neighbor]])->cost_in
+                                 : dnullval;
+        B = rec[pass2[neighbor]] ? ((struct cc *)rec[pass2[neighbor]])->cost_in
+                                 : dnullval;
+        fcost = (double)(A + B + ((struct cc *)rec[neighbor])->cost_in +
+                         my_cost);
+
+        return min_cost + fcost * (neighbor > 12 ? H_DIAG_fac : V_DIAG_fac);
     }
 
-    return (stop_pnts != NULL);
-}
-
-void add_stop_pnt(int r, int c)
-{
-    int i;
-    struct rc sp;
-
-    if (n_stop_pnts == stop_pnts_alloc) {
-        stop_pnts_alloc += 100;
-        stop_pnts = (struct rc *)G_realloc(stop_pnts,
-                                           stop_pnts_alloc * sizeof(struct rc));
-    }
-
-    sp.r = r;
-    sp.c = c;
-    i = n_stop_pnts;
-    while (i > 0 && cmp_rc(stop_pnts + i - 1, &sp) > 0) {
-        stop_pnts[i] = stop_pnts[i - 1];
-        i--;
-    }
-    stop_pnts[i] = sp;
-
-    n_stop_pnts++;
-}
-
-int time_to_stop(int row, int col)
-{
-    int lo, mid, hi;
-    struct rc sp;
-    static int hits = 0;
-
-    sp.r = row;
-    sp.c = col;
-
-    lo = 0;
-    hi = n_stop_pnts - 1;
-
-    /* bsearch with deferred test for equality
-     * slightly more efficient for worst case: no match */
-    while (lo < hi) {
-        mid = lo + ((hi - lo) >> 1);
-        if (cmp_rc(stop_pnts + mid, &sp) < 0)
-            lo = mid + 1;
-        else
-            hi = mid;
-    }
-    if (cmp_rc(stop_pnts + lo, &sp) == 0) {
-        return (++hits == n_stop_pnts);
-    }
+    fcost = (double)(((struct cc *)rec[neighbor])->cost_in + my_cost);
+    if (neighbor > 4)
+        return min_cost + fcost * DIAG_fac;
+    if (neighbor > 2)
+        return min_cost + fcost * NS_fac;
 
-    return 0;
+    return min_cost + fcost * EW_fac;
 }
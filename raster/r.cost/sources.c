@@ -0,0 +1,441 @@
+/****************************************************************************
+ *
+ * MODULE:       r.cost
+ *
+ * PURPOSE:      Separate cost surfaces for each start point: nearest
+ *               start points for each cell and costs from each start
+ *               point to each stop point.
+ *
+ * COPYRIGHT:    (C) 2026 by the GRASS Development Team
+ *
+ *               This program is free software under the GNU General Public
+ *               License (>=v2). Read the file COPYING that comes with GRASS
+ *               for details.
+ *
+ ***************************************************************************/
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include <grass/glocale.h>
+#include "local_proto.h"
+
+/* one of the nearest start points of a cell */
+struct near {
+    double cost; /* null for none */
+    int src;     /* index of the start point */
+};
+
+/* list of points in input order: the lists are built backwards */
+static struct Cost_start_pt *list_to_array(struct Cost_start_pt *head, int *n)
+{
+    struct Cost_start_pt *pt, *pts;
+    int i;
+
+    *n = 0;
+    for (pt = head; pt; pt = pt->next)
+        (*n)++;
+
+    pts = G_malloc((*n > 0 ? *n : 1) * sizeof(struct Cost_start_pt));
+    i = *n;
+    for (pt = head; pt; pt = pt->next)
+        pts[--i] = *pt;
+
+    return pts;
+}
+
+/* cumulative cost of a cell, null if not reached within the maximum cost */
+static double get_cost(struct Cost_search *cs, double max_cost, int row,
+                       int col)
+{
+    struct cc costs;
+
+    if (Segment_get(cs->cost_seg, &costs, row, col) < 0)
+        G_fatal_error(_("Can not read from temporary file"));
+    if (max_cost > 0 && costs.cost_out > max_cost)
+        Rast_set_d_null_value(&costs.cost_out, 1);
+
+    return costs.cost_out;
+}
+
+/* locks of the nearest start points, one for each band of segment rows
+ * modulo the number of locks */
+#if defined(_OPENMP)
+static omp_lock_t *near_locks;
+#endif
+static int n_near_locks, near_band_rows;
+
+static void lock_near(int row)
+{
+#if defined(_OPENMP)
+    omp_set_lock(&near_locks[row / near_band_rows % n_near_locks]);
+#endif
+}
+
+static void unlock_near(int row)
+{
+#if defined(_OPENMP)
+    omp_unset_lock(&near_locks[row / near_band_rows % n_near_locks]);
+#endif
+}
+
+/* add the cells reached from start point src to the nearest start points,
+ * which are sorted by cost, then by start point */
+static void add_nearest(struct Cost_search *cs, SEGGRID *near_seg, int count,
+                        double max_cost, int src)
+{
+    struct near *near;
+    long i;
+    int row, col, j;
+    double cost;
+
+    near = G_malloc(count * sizeof(struct near));
+
+    for (i = 0; i < cs->n_reached; i++) {
+        row = cs->reached[i].r;
+        col = cs->reached[i].c;
+        cost = get_cost(cs, max_cost, row, col);
+        if (Rast_is_d_null_value(&cost))
+            continue;
+
+        /* other threads may add to the same cell */
+        lock_near(row);
+        if (Seggrid_get(near_seg, near, row, col) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
+
+        j = count;
+        while (j > 0 && (Rast_is_d_null_value(&near[j - 1].cost) ||
+                         near[j - 1].cost > cost ||
+                         (near[j - 1].cost == cost && near[j - 1].src > src))) {
+            if (j < count)
+                near[j] = near[j - 1];
+            j--;
+        }
+        if (j < count) {
+            near[j].cost = cost;
+            near[j].src = src;
+
+            if (Seggrid_put(near_seg, near, row, col) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
+        }
+        unlock_near(row);
+    }
+
+    G_free(near);
+}
+
+static void write_history(const char *name)
+{
+    struct History history;
+
+    Rast_short_history(name, "raster", &history);
+    Rast_command_history(&history);
+    Rast_write_history(name, &history);
+}
+
+/* write the costs and start points of the count nearest start points */
+static void write_nearest(struct per_source *ps, SEGGRID *near_seg,
+                          struct near *near, struct Cost_start_pt *start)
+{
+    int nrows = Rast_window_rows();
+    int ncols = Rast_window_cols();
+    int count = ps->count;
+    int *cost_fds, *near_fds = NULL;
+    char **cost_names, **near_names = NULL;
+    DCELL **cost_bufs;
+    CELL **near_bufs = NULL;
+    void *in_buf = NULL, *in_ptr;
+    int in_size = Rast_cell_size(ps->cost_type);
+    int row, col, i;
+
+    cost_fds = G_malloc(count * sizeof(int));
+    cost_names = G_malloc(count * sizeof(char *));
+    cost_bufs = G_malloc(count * sizeof(DCELL *));
+    if (ps->nearest) {
+        near_fds = G_malloc(count * sizeof(int));
+        near_names = G_malloc(count * sizeof(char *));
+        near_bufs = G_malloc(count * sizeof(CELL *));
+    }
+    for (i = 0; i < count; i++) {
+        G_asprintf(&cost_names[i], "%s.%d", ps->output, i + 1);
+        cost_fds[i] = Rast_open_new(cost_names[i], DCELL_TYPE);
+        cost_bufs[i] = Rast_allocate_d_buf();
+        if (ps->nearest) {
+            G_asprintf(&near_names[i], "%s.%d", ps->nearest, i + 1);
+            near_fds[i] = Rast_open_new(near_names[i], CELL_TYPE);
+            near_bufs[i] = Rast_allocate_c_buf();
+        }
+    }
+    if (ps->keep_nulls)
+        in_buf = Rast_allocate_buf(ps->cost_type);
+
+    G_message(_("Writing output raster maps <%s.1> to <%s.%d>..."),
+              ps->output, ps->output, count);
+    for (row = 0; row < nrows; row++) {
+        G_percent(row, nrows, 2);
+        if (ps->keep_nulls)
+            Rast_get_row(ps->cost_fd, in_buf, row, ps->cost_type);
+        in_ptr = in_buf;
+
+        for (col = 0; col < ncols; col++) {
+            if (Seggrid_get(near_seg, near, row, col) < 0)
+                G_fatal_error(_("Can not read from temporary file"));
+            if (ps->keep_nulls) {
+                if (Rast_is_null_value(in_ptr, ps->cost_type)) {
+                    for (i = 0; i < count; i++)
+                        Rast_set_d_null_value(&near[i].cost, 1);
+                }
+                in_ptr = G_incr_void_ptr(in_ptr, in_size);
+            }
+
+            for (i = 0; i < count; i++) {
+                if (Rast_is_d_null_value(&near[i].cost)) {
+                    Rast_set_d_null_value(&cost_bufs[i][col], 1);
+                    if (ps->nearest)
+                        Rast_set_c_null_value(&near_bufs[i][col], 1);
+                    continue;
+                }
+                cost_bufs[i][col] = near[i].cost;
+                if (ps->nearest)
+                    near_bufs[i][col] = start[near[i].src].value;
+            }
+        }
+        for (i = 0; i < count; i++) {
+            Rast_put_d_row(cost_fds[i], cost_bufs[i]);
+            if (ps->nearest)
+                Rast_put_c_row(near_fds[i], near_bufs[i]);
+        }
+    }
+    G_percent(1, 1, 1);
+
+    for (i = 0; i < count; i++) {
+        Rast_close(cost_fds[i]);
+        write_history(cost_names[i]);
+        G_free(cost_bufs[i]);
+        G_free(cost_names[i]);
+
+        if (ps->nearest) {
+            struct Colors colors;
+            struct Range range;
+            CELL min, max;
+
+            Rast_close(near_fds[i]);
+            write_history(near_names[i]);
+
+            Rast_read_range(near_names[i], G_mapset(), &range);
+            Rast_get_range_min_max(&range, &min, &max);
+            Rast_make_random_colors(&colors, min, max);
+            Rast_write_colors(near_names[i], G_mapset(), &colors);
+
+            G_free(near_bufs[i]);
+            G_free(near_names[i]);
+        }
+    }
+    G_free(cost_fds);
+    G_free(cost_names);
+    G_free(cost_bufs);
+    if (ps->nearest) {
+        G_free(near_fds);
+        G_free(near_names);
+        G_free(near_bufs);
+    }
+    if (in_buf)
+        G_free(in_buf);
+}
+
+/* write costs from start points to stop points, one pair per line */
+static void write_matrix(struct per_source *ps, const double *matrix,
+                         struct Cost_start_pt *start, int n_start,
+                         struct Cost_start_pt *stop, int n_stop)
+{
+    FILE *fp;
+    int i, j;
+    double cost;
+
+    if (strcmp(ps->matrix, "-") == 0)
+        fp = stdout;
+    else if ((fp = fopen(ps->matrix, "w")) == NULL)
+        G_fatal_error(_("Unable to open file <%s> for writing"), ps->matrix);
+
+    fprintf(fp, "start%sstop%scost\n", ps->fs, ps->fs);
+    for (i = 0; i < n_start; i++) {
+        for (j = 0; j < n_stop; j++) {
+            cost = matrix[(size_t)i * n_stop + j];
+            if (Rast_is_d_null_value(&cost))
+                continue;
+            fprintf(fp, "%d%s%d%s%.15g\n", start[i].value, ps->fs,
+                    stop[j].value, ps->fs, cost);
+        }
+    }
+
+    if (fp != stdout)
+        fclose(fp);
+}
+
+/*!
+ * \brief Run one search for each start point
+ *
+ * The cost grid is loaded once into one segment file per thread and
+ * reused for all start points, a thread resets only the cells reached
+ * by its previous search. Nearest start points are merged in start
+ * point order for equal costs, so the results do not depend on the
+ * number of threads. Threads merge into the nearest start points at
+ * the same time unless they update cells in the same band of rows.
+ *
+ * \param ps settings and loaded cost grids
+ * \param start_pts list of start points
+ * \param stop_pts list of stop points, NULL for none
+ */
+void run_per_source(struct per_source *ps, struct Cost_start_pt *start_pts,
+                    struct Cost_start_pt *stop_pts)
+{
+    int nrows = Rast_window_rows();
+    int ncols = Rast_window_cols();
+    struct Cost_start_pt *start, *stop;
+    int n_start, n_stop;
+    struct Cost_search *searches;
+    SEGGRID near_seg;
+    struct near *near = NULL, *near_row;
+    double *matrix = NULL;
+    char *stop_dup;
+    int i, j, t, row, done;
+
+    start = list_to_array(start_pts, &n_start);
+    stop = list_to_array(stop_pts, &n_stop);
+
+    for (i = 0; i < n_start; i++) {
+        if (start[i].row < 0 || start[i].row >= nrows || start[i].col < 0 ||
+            start[i].col >= ncols)
+            G_fatal_error(
+                _("Specified starting location outside database window"));
+    }
+
+    /* duplicates would be reported by each search */
+    stop_dup = G_calloc(n_stop > 0 ? n_stop : 1, 1);
+    for (j = 1; j < n_stop; j++) {
+        for (i = 0; i < j; i++) {
+            if (stop[i].row == stop[j].row && stop[i].col == stop[j].col) {
+                stop_dup[j] = 1;
+                break;
+            }
+        }
+    }
+
+    searches = G_malloc(ps->nthreads * sizeof(struct Cost_search));
+    for (t = 0; t < ps->nthreads; t++) {
+        Cost_init_search(&searches[t], nrows, ncols, ps->knight);
+        searches[t].cost_seg = &ps->cost_segs[t].seg;
+        searches[t].move_cost = move_cost;
+        searches[t].max_cost = ps->max_cost;
+        searches[t].keep_reached = 1;
+        /* searches for nearest start points must not end early */
+        if (!ps->count) {
+            for (j = 0; j < n_stop; j++) {
+                if (!stop_dup[j])
+                    Cost_add_stop_point(&searches[t], stop[j].row,
+                                        stop[j].col);
+            }
+        }
+    }
+
+    if (ps->count) {
+        if (Seggrid_open_records(&near_seg, nrows, ncols, ps->srows,
+                                 ps->scols, ps->count * sizeof(struct near),
+                                 ps->segments_in_memory) < 0)
+            G_fatal_error(_("Can not create temporary file"));
+
+        near = G_malloc(ps->count * sizeof(struct near));
+        near_row = G_malloc((size_t)ncols * ps->count * sizeof(struct near));
+        for (j = 0; j < ncols * ps->count; j++) {
+            Rast_set_d_null_value(&near_row[j].cost, 1);
+            near_row[j].src = -1;
+        }
+        for (row = 0; row < nrows; row++) {
+            if (Seggrid_put_row(&near_seg, near_row, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
+        }
+        G_free(near_row);
+
+        /* one lock for all rows if the grid must be accessed by one
+         * thread at a time */
+        near_band_rows = ps->srows;
+        n_near_locks = 1;
+        if (ps->nthreads > 1 &&
+            Seggrid_set_concurrent(&near_seg, ps->nthreads) == 0)
+            n_near_locks = 4 * ps->nthreads;
+#if defined(_OPENMP)
+        near_locks = G_malloc(n_near_locks * sizeof(omp_lock_t));
+        for (j = 0; j < n_near_locks; j++)
+            omp_init_lock(&near_locks[j]);
+#endif
+    }
+
+    if (ps->matrix)
+        matrix = G_malloc((size_t)n_start * (n_stop > 0 ? n_stop : 1) *
+                          sizeof(double));
+
+    G_message(n_("Finding cost paths for %d start point...",
+                 "Finding cost paths for %d start points...", n_start),
+              n_start);
+    done = 0;
+
+#pragma omp parallel for schedule(dynamic) num_threads(ps->nthreads)
+    for (i = 0; i < n_start; i++) {
+        struct Cost_search *cs;
+        int id = 0, n;
+
+#if defined(_OPENMP)
+        id = omp_get_thread_num();
+#endif
+        cs = &searches[id];
+
+        Cost_add_start_point(cs, start[i].row, start[i].col, 0.0,
+                             start[i].value);
+        Cost_run_search(cs);
+
+        if (matrix) {
+            for (n = 0; n < n_stop; n++)
+                matrix[(size_t)i * n_stop + n] =
+                    get_cost(cs, ps->max_cost, stop[n].row, stop[n].col);
+        }
+
+        if (ps->count)
+            add_nearest(cs, &near_seg, ps->count, ps->max_cost, i);
+
+#pragma omp critical(progress)
+        G_percent(done++, n_start, 1);
+
+        Cost_reset_search(cs);
+    }
+    G_percent(1, 1, 1);
+
+    for (t = 0; t < ps->nthreads; t++)
+        Cost_free_search(&searches[t]);
+    G_free(searches);
+
+    if (ps->count) {
+#if defined(_OPENMP)
+        for (j = 0; j < n_near_locks; j++)
+            omp_destroy_lock(&near_locks[j]);
+        G_free(near_locks);
+#endif
+        write_nearest(ps, &near_seg, near, start);
+        Seggrid_close(&near_seg);
+        G_free(near);
+    }
+
+    if (matrix) {
+        write_matrix(ps, matrix, start, n_start, stop, n_stop);
+        G_free(matrix);
+    }
+
+    G_free(start);
+    G_free(stop);
+    G_free(stop_dup);
+}
@@ -0,0 +1,444 @@
+"""Test of r.cost
+
+Cumulative costs are compared with a Dijkstra search over the moves of
+r.cost computed in Python.
+
+@copyright 2026 by the GRASS Development Team
+
+@license This program is free software under the GNU General Public License (>=v2).
+Read the file COPYING that comes with GRASS
+for details
+"""
+
+import heapq
+import math
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.gmodules import SimpleModule
+from grass.gunittest.main import test
+import grass.script as gs
+
+# moves as row and column offsets, with the cells passed by knight's moves
+MOVES = [(0, -1), (0, 1), (-1, 0), (1, 0), (-1, -1), (-1, 1), (1, 1), (1, -1)]
+KNIGHT_MOVES = [
+    (-2, -1),
+    (-2, 1),
+    (2, 1),
+    (2, -1),
+    (-1, -2),
+    (-1, 2),
+    (1, 2),
+    (1, -2),
+]
+
+
+def read_grid(name):
+    """Return the cells of a map as rows of floats, None for null"""
+    text = gs.read_command(
+        "r.out.ascii", input=name, output="-", flags="h", null_value="*", precision=17
+    )
+    return [
+        [None if value == "*" else float(value) for value in line.split()]
+        for line in text.splitlines()
+    ]
+
+
+def cell_value(name, east, north):
+    """Return the value of a map at a point"""
+    output = gs.read_command("r.what", map=name, coordinates=(east, north))
+    return output.strip().split("|")[-1]
+
+
+def reference_costs(costs, starts, ns_res, ew_res, knight=False, null_cost=None):
+    """Cumulative costs from start cells (row, col) like r.cost
+
+    Moves average the costs of the cells involved and are weighted with
+    the distance in east-west cells. Moves are not possible through null
+    cells, unless null_cost is given.
+    """
+    nrows, ncols = len(costs), len(costs[0])
+    ns = ns_res / ew_res
+    moves = [(dr, dc, (), 0.5 if dr == 0 else ns / 2) for dr, dc in MOVES[:4]]
+    moves += [(dr, dc, (), math.sqrt(ns * ns + 1) / 2) for dr, dc in MOVES[4:]]
+    if knight:
+        for dr, dc in KNIGHT_MOVES:
+            if abs(dr) == 2:
+                passed = ((dr // 2, 0), (dr // 2, dc))
+                fac = math.sqrt(4 * ns * ns + 1) / 4
+            else:
+                passed = ((0, dc // 2), (dr, dc // 2))
+                fac = math.sqrt(ns * ns + 4) / 4
+            moves.append((dr, dc, passed, fac))
+
+    def cost_in(row, col):
+        if not (0 <= row < nrows and 0 <= col < ncols):
+            return None
+        value = costs[row][col]
+        return null_cost if value is None else value
+
+    result = {}
+    heap = [(0.0, row, col) for row, col in starts]
+    while heap:
+        cost, row, col = heapq.heappop(heap)
+        if (row, col) in result:
+            continue
+        result[row, col] = cost
+        for dr, dc, passed, fac in moves:
+            values = [cost_in(row + pr, col + pc) for pr, pc in passed]
+            values += [cost_in(row + dr, col + dc), cost_in(row, col)]
+            if None in values:
+                continue
+            total = 0.0
+            for value in values:
+                total += value
+            if (row + dr, col + dc) not in result:
+                heapq.heappush(heap, (cost + total * fac, row + dr, col + dc))
+    return result
+
+
+class TestCost(TestCase):
+    """Cumulative costs, nearest start points, stop points and limits"""
+
+    cost = "test_cost_friction"
+    output = "test_cost_output"
+    nearest = "test_cost_nearest"
+    # 12 rows of 2 m and 15 columns of 1 m
+    ns_res = 2
+    ew_res = 1
+    # start points in cells (row, col)
+    starts = [(2, 3), (9, 11)]
+    coordinates = [3.5, 19, 11.5, 5]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "g.region", n=24, s=0, e=15, w=0, nsres=cls.ns_res, ewres=cls.ew_res
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.cost} = if((row() * 3 + col()) % 11 == 0, null(),"
+                " double(1 + (row() * 7 + col() * 3) % 5))"
+            ),
+        )
+        cls.costs = read_grid(cls.cost)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.cost)
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove", flags="f", type="raster", name=[self.output, self.nearest]
+        )
+
+    def reference(self, starts=None, **kwargs):
+        return reference_costs(
+            self.costs, starts or self.starts, self.ns_res, self.ew_res, **kwargs
+        )
+
+    def assertCostsEqual(self, reference, keep=None):
+        """Compare the output map with reference costs"""
+        keep = keep or (lambda row, col: True)
+        for row, line in enumerate(read_grid(self.output)):
+            for col, value in enumerate(line):
+                expected = reference.get((row, col)) if keep(row, col) else None
+                if expected is None:
+                    self.assertIsNone(value, msg=f"cell {row}, {col}")
+                else:
+                    self.assertAlmostEqual(
+                        value, expected, delta=1e-9, msg=f"cell {row}, {col}"
+                    )
+
+    def run_cost(self, **kwargs):
+        kwargs.setdefault("start_coordinates", self.coordinates)
+        self.assertModule(
+            "r.cost", input=self.cost, output=self.output, overwrite=True, **kwargs
+        )
+
+    def test_costs(self):
+        """Costs match the reference, nulls are not crossed"""
+        self.run_cost(nearest=self.nearest)
+        reference = self.reference()
+        self.assertCostsEqual(reference)
+
+        values = list(reference.values())
+        self.assertRasterFitsUnivar(
+            self.output,
+            reference={
+                "n": len(values),
+                "min": 0,
+                "max": max(values),
+                "mean": sum(values) / len(values),
+            },
+            precision=1e-6,
+        )
+
+        # start points are numbered in the order given
+        first = self.reference(starts=self.starts[:1])
+        second = self.reference(starts=self.starts[1:])
+        nearest = read_grid(self.nearest)
+        for (row, col), cost in first.items():
+            if abs(cost - second.get((row, col), math.inf)) > 1e-6:
+                expected = 1 if cost < second.get((row, col), math.inf) else 2
+                self.assertEqual(nearest[row][col], expected)
+
+    def test_knight(self):
+        """Knight's moves with -k"""
+        self.run_cost(flags="k")
+        self.assertCostsEqual(self.reference(knight=True))
+
+    def test_null_cost(self):
+        """Null cells are crossed with null_cost, kept null with -n"""
+        self.run_cost(null_cost=3)
+        reference = self.reference(null_cost=3)
+        self.assertEqual(len(reference), 12 * 15)
+        self.assertCostsEqual(reference)
+
+        self.run_cost(null_cost=3, flags="n")
+        self.assertCostsEqual(
+            reference, keep=lambda row, col: self.costs[row][col] is not None
+        )
+
+    def test_max_cost(self):
+        """Cells within max_cost get their costs"""
+        self.run_cost(max_cost=10)
+        reference = self.reference()
+        for row, line in enumerate(read_grid(self.output)):
+            for col, value in enumerate(line):
+                expected = reference.get((row, col))
+                if expected is not None and expected <= 10:
+                    self.assertAlmostEqual(value, expected, delta=1e-9)
+                elif value is not None:
+                    # neighbors of the last cells searched
+                    self.assertGreater(value, 10)
+                    self.assertGreaterEqual(value, expected - 1e-9)
+        self.assertIsNone(read_grid(self.output)[11][0])
+
+    def test_stop_points(self):
+        """The search ends once the stop point is reached"""
+        self.run_cost(
+            start_coordinates=self.coordinates[:2], stop_coordinates=(5.5, 17)
+        )
+        reference = self.reference(starts=self.starts[:1])
+        stop = reference[3, 5]
+        # no move costs more than the highest cost times the diagonal
+        # distance in east-west cells
+        bound = stop + 5 * math.sqrt((self.ns_res / self.ew_res) ** 2 + 1) + 1e-9
+        output = read_grid(self.output)
+        self.assertAlmostEqual(output[3][5], stop, delta=1e-9)
+        for row, line in enumerate(output):
+            for col, value in enumerate(line):
+                expected = reference.get((row, col))
+                if expected is not None and expected < stop - 1e-9:
+                    self.assertAlmostEqual(value, expected, delta=1e-9)
+                elif expected is None or expected > bound:
+                    self.assertIsNone(value, msg=f"cell {row}, {col}")
+
+
+class TestCostDirections(TestCase):
+    """Directions of cells reached with equal costs from two cells
+
+    With equal costs of 1, the cell in row 1, column 2 is reached with a
+    cost of 1 + sqrt(2) both from the cell north-west of it and from the
+    cell west of it. The cell north-west of it is searched first.
+    """
+
+    cost = "test_cost_directions_friction"
+    solver = "test_cost_directions_solver"
+    output = "test_cost_directions_output"
+    outdir = "test_cost_directions_outdir"
+    start = (0.5, 2.5)
+    cell = (2.5, 1.5)
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=3, s=0, e=4, w=0, res=1)
+        cls.runModule("r.mapcalc", expression=f"{cls.cost} = 1")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule(
+            "g.remove",
+            flags="f",
+            type="raster",
+            name=[cls.cost, cls.solver, cls.output, cls.outdir],
+        )
+
+    def run_cost(self, **kwargs):
+        self.assertModule(
+            "r.cost",
+            input=self.cost,
+            output=self.output,
+            outdir=self.outdir,
+            start_coordinates=self.start,
+            overwrite=True,
+            **kwargs,
+        )
+        self.assertAlmostEqual(
+            float(cell_value(self.output, *self.cell)), 1 + math.sqrt(2), places=9
+        )
+        return float(cell_value(self.outdir, *self.cell))
+
+    def test_first_direction(self):
+        """Without solver, the direction of the first cell is kept"""
+        self.assertEqual(self.run_cost(), 135)
+
+    def test_solver(self):
+        """The solver picks the cell with the smaller value"""
+        # row() and col() count from 1
+        self.runModule(
+            "r.mapcalc",
+            expression=f"{self.solver} = if(row() == 2 && col() == 2, 0, 1)",
+            overwrite=True,
+        )
+        self.assertEqual(self.run_cost(solver=self.solver), 180)
+        self.runModule(
+            "r.mapcalc",
+            expression=f"{self.solver} = if(row() == 1 && col() == 2, 0, 1)",
+            overwrite=True,
+        )
+        self.assertEqual(self.run_cost(solver=self.solver), 135)
+
+    def test_bitmask(self):
+        """Bitmask encoded directions with -b hold both directions"""
+        # bits 6 (from the north-west) and 5 (from the west)
+        self.assertEqual(self.run_cost(flags="b"), 64 + 32)
+
+
+class TestCostPerSource(TestCase):
+    """Separate cost surfaces per start point with nearest_count and matrix
+
+    Friction and nulls are symmetric to the middle column, so the first
+    two start points reach the cells of that column with equal costs.
+    """
+
+    cost = "test_cost_sources_friction"
+    single = "test_cost_sources_single"
+    output = "test_cost_sources"
+    nearest = "test_cost_sources_nearest"
+    # start points in cells (row, col) and as coordinates
+    starts = [(1, 0), (1, 8), (8, 4)]
+    coordinates = [0.5, 7.5, 8.5, 7.5, 4.5, 0.5]
+    # the last stop point is a null cell
+    stops = [(4, 4), (0, 2), (0, 0)]
+    stop_coordinates = [4.5, 4.5, 2.5, 8.5, 0.5, 8.5]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=9, s=0, e=9, w=0, res=1)
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.cost} = if((row() * 3 + abs(col() - 5)) % 7 == 0, null(),"
+                " double(1 + (row() * 7 + abs(col() - 5) * 3) % 5))"
+            ),
+        )
+        # one run for each start point
+        cls.singles = []
+        for i in range(len(cls.starts)):
+            cls.runModule(
+                "r.cost",
+                input=cls.cost,
+                output=f"{cls.single}_{i + 1}",
+                start_coordinates=cls.coordinates[2 * i : 2 * i + 2],
+            )
+            cls.singles.append(read_grid(f"{cls.single}_{i + 1}"))
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        names = [cls.cost] + [f"{cls.single}_{i + 1}" for i in range(3)]
+        for nprocs in (1, 4):
+            for i in (1, 2):
+                names += [f"{cls.output}_{nprocs}.{i}", f"{cls.nearest}_{nprocs}.{i}"]
+        cls.runModule("g.remove", flags="f", type="raster", name=names)
+
+    def run_nearest(self, nprocs):
+        self.assertModule(
+            "r.cost",
+            input=self.cost,
+            output=f"{self.output}_{nprocs}",
+            nearest=f"{self.nearest}_{nprocs}",
+            nearest_count=2,
+            start_coordinates=self.coordinates,
+            nprocs=nprocs,
+            overwrite=True,
+        )
+
+    def run_matrix(self, nprocs):
+        module = SimpleModule(
+            "r.cost",
+            input=self.cost,
+            matrix="-",
+            start_coordinates=self.coordinates,
+            stop_coordinates=self.stop_coordinates,
+            nprocs=nprocs,
+        )
+        self.assertModule(module)
+        return module.outputs.stdout
+
+    def test_nearest_count(self):
+        """Costs of the two nearest start points match single runs"""
+        self.run_nearest(nprocs=1)
+        costs = [read_grid(f"{self.output}_1.{i}") for i in (1, 2)]
+        nearest = [read_grid(f"{self.nearest}_1.{i}") for i in (1, 2)]
+        ties = 0
+        for row in range(9):
+            for col in range(9):
+                # by cost, then by start point for equal costs
+                expected = sorted(
+                    (single[row][col], i + 1)
+                    for i, single in enumerate(self.singles)
+                    if single[row][col] is not None
+                )
+                if len(expected) > 1 and expected[0][0] == expected[1][0]:
+                    ties += 1
+                for k in range(2):
+                    if k < len(expected):
+                        self.assertAlmostEqual(
+                            costs[k][row][col], expected[k][0], delta=1e-9
+                        )
+                        self.assertEqual(nearest[k][row][col], expected[k][1])
+                    else:
+                        self.assertIsNone(costs[k][row][col])
+                        self.assertIsNone(nearest[k][row][col])
+        self.assertGreater(ties, 0)
+
+    def test_nearest_count_threads(self):
+        """Outputs with one and with four threads are the same"""
+        self.run_nearest(nprocs=1)
+        self.run_nearest(nprocs=4)
+        for i in (1, 2):
+            self.assertRastersNoDifference(
+                f"{self.output}_4.{i}", f"{self.output}_1.{i}", precision=0
+            )
+            self.assertRastersNoDifference(
+                f"{self.nearest}_4.{i}", f"{self.nearest}_1.{i}", precision=0
+            )
+
+    def test_matrix(self):
+        """Costs from each start point to each stop point match single runs"""
+        lines = self.run_matrix(nprocs=1).splitlines()
+        self.assertEqual(lines[0], "start|stop|cost")
+        expected = []
+        for i, single in enumerate(self.singles):
+            for j, (row, col) in enumerate(self.stops):
+                if single[row][col] is not None:
+                    expected.append((i + 1, j + 1, single[row][col]))
+        self.assertEqual(len(lines) - 1, len(expected))
+        for line, (start, stop, cost) in zip(lines[1:], expected):
+            values = line.split("|")
+            self.assertEqual((int(values[0]), int(values[1])), (start, stop))
+            self.assertAlmostEqual(float(values[2]), cost, delta=1e-9)
+
+        self.assertEqual(self.run_matrix(nprocs=4).splitlines(), lines)
+
+
+if __name__ == "__main__":
+    test()
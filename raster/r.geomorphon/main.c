@@ -307,7 +307,7 @@ int main(int argc, char **argv)
         /* Band height from the memory cap. */
         memory = atoi(par_memory->answer);
         nprocs = G_set_omp_num_threads(par_nprocs);
-        nprocs = Rast_disable_omp_on_mask(nprocs);
+        nprocs = Rast_set_mask_threads(nprocs);
         {
             size_t fixed = (size_t)2 * row_radius_size * ncols * sizeof(FCELL);
             size_t cap = (size_t)memory * (1 << 20);
@@ -336,7 +336,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
 
     int nprocs = G_set_omp_num_threads(parm.nprocs);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
 
     struct Cell_head cellhd;
     struct Cell_head new_cellhd;
@@ -35,9 +35,52 @@
 #define METHOD_SKEWNESS   12
 #define METHOD_TRIMMEAN   13
 
+/* lines read and parsed at a time */
+#define CHUNK_LINES       65536
+
+/* result of parsing a line */
+#define LINE_SKIP         0 /* comment, blank, outside region or filtered */
+#define LINE_POINT        1
+#define LINE_BROKEN       2 /* not enough data columns */
+#define LINE_BAD_X        3
+#define LINE_BAD_Y        4
+#define LINE_BAD_Z        5
+#define LINE_BAD_V        6
+
+/* a point binned into a cell of the region */
+struct point {
+    int row, col;
+    double z;
+};
+
+struct parse_params {
+    int xcol, ycol, zcol, vcol, max_col;
+    char *fs;
+    double zscale, vscale;
+    int zrange, vrange; /* filter by range */
+    double zrange_min, zrange_max, vrange_min, vrange_max;
+    struct Cell_head *region;
+};
+
+/* lines of the input file */
+struct chunk {
+    char *text;           /* lines, NUL terminated */
+    size_t text_size;     /* allocated size of text */
+    size_t *start;        /* start of each line in text */
+    int *status;          /* result of parsing each line */
+    struct point *points; /* point of each line */
+    int nlines;
+};
+
 /* main.c */
 int scan_bounds(FILE *, int, int, int, int, char *, int, int, double, double);
 
+/* parse.c */
+void init_chunk(struct chunk *);
+void free_chunk(struct chunk *);
+int read_chunk(FILE *, struct chunk *);
+void parse_chunk(struct chunk *, const struct parse_params *);
+
 /* support.c */
 int blank_array(void *, int, int, RASTER_MAP_TYPE, int);
 int update_n(void *, int, int, int);
@@ -89,62 +89,449 @@ int add_node(int head, double z)
     }
 }
 
+struct output {
+    const char *name;
+    const char *method_name;
+    int method;
+    RASTER_MAP_TYPE type;
+    int fd;
+    void *buf;
+};
+
+/* points of a later pass, spilled to a temporary file while reading the
+ * input once */
+struct spill {
+    char *name;
+    FILE *fp;
+};
+
+/* arrays of the current pass */
+int bin_n, bin_min, bin_max, bin_sum, bin_sumsq, bin_index;
+char *n_array, *min_array, *max_array, *sum_array, *sumsq_array, *index_array;
+
+/* add a point to the arrays, arr_row is the row in the current pass */
+static void bin_point(int arr_row, int arr_col, double z, int cols,
+                      RASTER_MAP_TYPE rtype)
+{
+    int head_id;
+    void *ptr;
+
+    if (bin_n)
+        update_n(n_array, cols, arr_row, arr_col);
+    if (bin_min)
+        update_min(min_array, cols, arr_row, arr_col, rtype, z);
+    if (bin_max)
+        update_max(max_array, cols, arr_row, arr_col, rtype, z);
+    if (bin_sum)
+        update_sum(sum_array, cols, arr_row, arr_col, rtype, z);
+    if (bin_sumsq)
+        update_sumsq(sumsq_array, cols, arr_row, arr_col, rtype, z);
+    if (bin_index) {
+        ptr = index_array;
+        ptr = G_incr_void_ptr(ptr, ((arr_row * cols) + arr_col) *
+                                       Rast_cell_size(CELL_TYPE));
+
+        if (Rast_is_null_value(ptr, CELL_TYPE)) { /* first node */
+            head_id = new_node();
+            nodes[head_id].next = -1;
+            nodes[head_id].z = z;
+            Rast_set_c_value(ptr, head_id, CELL_TYPE); /* store index to head */
+        }
+        else { /* head is already there */
+
+            head_id = Rast_get_c_value(ptr, CELL_TYPE); /* get index to head */
+            head_id = add_node(head_id, z);
+            if (head_id != -1)
+                Rast_set_c_value(ptr, head_id,
+                                 CELL_TYPE); /* store index to head */
+        }
+    }
+}
+
+/* calc stats of a row of the current pass, rtype is the type of the
+ * arrays and of raster_row */
+static void stats_row(int method, int row, int cols, void *raster_row,
+                      RASTER_MAP_TYPE rtype, int pth, double trim)
+{
+    int col, j, k;
+    int head_id, node_id;
+    int r_low, r_up;
+    int n;
+    double min, max, sum, sumsq, variance, mean, skew, sumdev, z;
+    size_t offset, n_offset;
+    void *ptr;
+
+    switch (method) {
+    case METHOD_N: /* n is a straight copy */
+        Rast_raster_cpy(raster_row,
+                        n_array + (row * cols * Rast_cell_size(CELL_TYPE)),
+                        cols, CELL_TYPE);
+        break;
+
+    case METHOD_MIN:
+        Rast_raster_cpy(raster_row,
+                        min_array + (row * cols * Rast_cell_size(rtype)), cols,
+                        rtype);
+        break;
+
+    case METHOD_MAX:
+        Rast_raster_cpy(raster_row,
+                        max_array + (row * cols * Rast_cell_size(rtype)), cols,
+                        rtype);
+        break;
+
+    case METHOD_SUM:
+        Rast_raster_cpy(raster_row,
+                        sum_array + (row * cols * Rast_cell_size(rtype)), cols,
+                        rtype);
+        break;
+
+    case METHOD_RANGE: /* (max-min) */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            offset = (row * cols + col) * Rast_cell_size(rtype);
+            min = Rast_get_d_value(min_array + offset, rtype);
+            max = Rast_get_d_value(max_array + offset, rtype);
+            Rast_set_d_value(ptr, max - min, rtype);
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+
+    case METHOD_MEAN: /* (sum / n) */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            offset = (row * cols + col) * Rast_cell_size(rtype);
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            n = Rast_get_c_value(n_array + n_offset, CELL_TYPE);
+            sum = Rast_get_d_value(sum_array + offset, rtype);
+
+            if (n == 0)
+                Rast_set_null_value(ptr, 1, rtype);
+            else
+                Rast_set_d_value(ptr, (sum / n), rtype);
+
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+
+    case METHOD_STDDEV:    /*  sqrt(variance)        */
+    case METHOD_VARIANCE:  /*  (sumsq - sum*sum/n)/n */
+    case METHOD_COEFF_VAR: /*  100 * stdev / mean    */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            offset = (row * cols + col) * Rast_cell_size(rtype);
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            n = Rast_get_c_value(n_array + n_offset, CELL_TYPE);
+            sum = Rast_get_d_value(sum_array + offset, rtype);
+            sumsq = Rast_get_d_value(sumsq_array + offset, rtype);
+
+            if (n == 0)
+                Rast_set_null_value(ptr, 1, rtype);
+            else {
+                variance = (sumsq - sum * sum / n) / n;
+                if (variance < GRASS_EPSILON)
+                    variance = 0.0;
+
+                if (method == METHOD_STDDEV)
+                    Rast_set_d_value(ptr, sqrt(variance), rtype);
+
+                else if (method == METHOD_VARIANCE)
+                    Rast_set_d_value(ptr, variance, rtype);
+
+                else if (method == METHOD_COEFF_VAR)
+                    Rast_set_d_value(ptr, 100 * sqrt(variance) / (sum / n),
+                                     rtype);
+            }
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+    case METHOD_MEDIAN: /* median, if only one point in cell we will use
+                           that */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            if (Rast_is_null_value(index_array + n_offset,
+                                   CELL_TYPE)) /* no points in cell */
+                Rast_set_null_value(ptr, 1, rtype);
+            else { /* one or more points in cell */
+
+                head_id = Rast_get_c_value(index_array + n_offset, CELL_TYPE);
+                node_id = head_id;
+
+                n = 0;
+
+                while (node_id != -1) { /* count number of points in cell */
+                    n++;
+                    node_id = nodes[node_id].next;
+                }
+
+                if (n == 1) /* only one point, use that */
+                    Rast_set_d_value(ptr, nodes[head_id].z, rtype);
+                else if (n % 2 != 0) { /* odd number of points: median_i
+                                          = (n + 1) / 2 */
+                    n = (n + 1) / 2;
+                    node_id = head_id;
+                    for (j = 1; j < n; j++) /* get "median element" */
+                        node_id = nodes[node_id].next;
+
+                    Rast_set_d_value(ptr, nodes[node_id].z, rtype);
+                }
+                else { /* even number of points: median = (val_below +
+                          val_above) / 2 */
+
+                    z = (n + 1) / 2.0;
+                    n = floor(z);
+                    node_id = head_id;
+                    for (j = 1; j < n; j++) /* get element "below" */
+                        node_id = nodes[node_id].next;
+
+                    z = (nodes[node_id].z + nodes[nodes[node_id].next].z) / 2;
+                    Rast_set_d_value(ptr, z, rtype);
+                }
+            }
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+    case METHOD_PERCENTILE: /* rank = (pth*(n+1))/100; interpolate
+                               linearly */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            if (Rast_is_null_value(index_array + n_offset,
+                                   CELL_TYPE)) /* no points in cell */
+                Rast_set_null_value(ptr, 1, rtype);
+            else {
+                head_id = Rast_get_c_value(index_array + n_offset, CELL_TYPE);
+                node_id = head_id;
+                n = 0;
+
+                while (node_id != -1) { /* count number of points in cell */
+                    n++;
+                    node_id = nodes[node_id].next;
+                }
+
+                z = (pth * (n + 1)) / 100.0;
+                r_low = floor(z); /* lower rank */
+                if (r_low < 1)
+                    r_low = 1;
+                else if (r_low > n)
+                    r_low = n;
+
+                r_up = ceil(z); /* upper rank */
+                if (r_up > n)
+                    r_up = n;
+
+                node_id = head_id;
+                for (j = 1; j < r_low; j++) /* search lower value */
+                    node_id = nodes[node_id].next;
+
+                z = nodes[node_id].z; /* save lower value */
+                node_id = head_id;
+                for (j = 1; j < r_up; j++) /* search upper value */
+                    node_id = nodes[node_id].next;
+
+                z = (z + nodes[node_id].z) / 2;
+                Rast_set_d_value(ptr, z, rtype);
+            }
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+    case METHOD_SKEWNESS: /* skewness = sum(xi-mean)^3/(N-1)*s^3 */
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            if (Rast_is_null_value(index_array + n_offset,
+                                   CELL_TYPE)) /* no points in cell */
+                Rast_set_null_value(ptr, 1, rtype);
+            else {
+                head_id = Rast_get_c_value(index_array + n_offset, CELL_TYPE);
+                node_id = head_id;
+
+                n = 0;        /* count */
+                sum = 0.0;    /* sum */
+                sumsq = 0.0;  /* sum of squares */
+                sumdev = 0.0; /* sum of (xi - mean)^3 */
+                skew = 0.0;   /* skewness */
+
+                while (node_id != -1) {
+                    z = nodes[node_id].z;
+                    n++;
+                    sum += z;
+                    sumsq += (z * z);
+                    node_id = nodes[node_id].next;
+                }
+
+                if (n > 1) { /* if n == 1, skew is "0.0" */
+                    mean = sum / n;
+                    node_id = head_id;
+                    while (node_id != -1) {
+                        z = nodes[node_id].z;
+                        sumdev += pow((z - mean), 3);
+                        node_id = nodes[node_id].next;
+                    }
+
+                    variance = (sumsq - sum * sum / n) / n;
+                    if (variance < GRASS_EPSILON)
+                        skew = 0.0;
+                    else
+                        skew = sumdev / ((n - 1) * pow(sqrt(variance), 3));
+                }
+                Rast_set_d_value(ptr, skew, rtype);
+            }
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+    case METHOD_TRIMMEAN:
+        ptr = raster_row;
+        for (col = 0; col < cols; col++) {
+            n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
+            if (Rast_is_null_value(index_array + n_offset,
+                                   CELL_TYPE)) /* no points in cell */
+                Rast_set_null_value(ptr, 1, rtype);
+            else {
+                head_id = Rast_get_c_value(index_array + n_offset, CELL_TYPE);
+
+                node_id = head_id;
+                n = 0;
+                while (node_id != -1) { /* count number of points in cell */
+                    n++;
+                    node_id = nodes[node_id].next;
+                }
+
+                if (1 == n)
+                    mean = nodes[head_id].z;
+                else {
+                    /* number of ranks to discard on each tail */
+                    k = floor(trim * n + 0.5);
+
+                    /* enough elements to discard */
+                    if (k > 0 && (n - 2 * k) > 0) {
+                        node_id = head_id;
+                        /* move to first rank to consider */
+                        for (j = 0; j < k; j++)
+                            node_id = nodes[node_id].next;
+
+                        j = k + 1;
+                        k = n - k;
+                        n = 0;
+                        sum = 0.0;
+
+                        while (j <= k) { /* get values in interval */
+                            n++;
+                            sum += nodes[node_id].z;
+                            node_id = nodes[node_id].next;
+                            j++;
+                        }
+                    }
+                    else {
+                        node_id = head_id;
+                        n = 0;
+                        sum = 0.0;
+                        while (node_id != -1) {
+                            n++;
+                            sum += nodes[node_id].z;
+                            node_id = nodes[node_id].next;
+                        }
+                    }
+                    mean = sum / n;
+                }
+                Rast_set_d_value(ptr, mean, rtype);
+            }
+            ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
+        }
+        break;
+
+    default:
+        G_fatal_error("?");
+    }
+}
+
+/* report a line that could not be parsed */
+static void bad_line(char *buff, unsigned long line, int status,
+                     const struct parse_params *p, int skipline)
+{
+    char **tokens;
+
+    if (status == LINE_BROKEN) {
+        if (skipline) {
+            G_warning(_("Not enough data columns. "
+                        "Incorrect delimiter or column number? "
+                        "Found the following character(s) in row %lu:\n[%s]"),
+                      line, buff);
+            G_warning(_("Line ignored as requested"));
+            return; /* line is garbage */
+        }
+        else {
+            G_fatal_error(
+                _("Not enough data columns. "
+                  "Incorrect delimiter or column number? "
+                  "Found the following character(s) in row %lu:\n[%s]"),
+                line, buff);
+        }
+    }
+
+    tokens = G_tokenize(buff, p->fs);
+    switch (status) {
+    case LINE_BAD_X:
+        G_fatal_error(_("Bad x-coordinate line %lu column %d. <%s>"), line,
+                      p->xcol, tokens[p->xcol - 1]);
+        break;
+    case LINE_BAD_Y:
+        G_fatal_error(_("Bad y-coordinate line %lu column %d. <%s>"), line,
+                      p->ycol, tokens[p->ycol - 1]);
+        break;
+    case LINE_BAD_Z:
+        G_fatal_error(_("Bad z-coordinate line %lu column %d. <%s>"), line,
+                      p->zcol, tokens[p->zcol - 1]);
+        break;
+    default:
+        G_fatal_error(_("Bad data value line %lu column %d. <%s>"), line,
+                      p->vcol, tokens[p->vcol - 1]);
+    }
+}
+
 int main(int argc, char *argv[])
 {
 
     FILE *in_fp;
-    int out_fd;
-    char *infile, *outmap;
-    int xcol, ycol, zcol, vcol, max_col, percent, skip_lines;
-    int method = -1;
-    int bin_n, bin_min, bin_max, bin_sum, bin_sumsq, bin_index;
-    double zrange_min, zrange_max, vrange_min, vrange_max, d_tmp;
-    char *fs; /* field delim */
+    char *infile;
+    int percent, skip_lines;
+    double d_tmp;
     off_t filesize;
     int linesize = 0;
     unsigned long estimated_lines, line;
     int from_stdin;
     int can_seek;
+    int nprocs;
 
     RASTER_MAP_TYPE rtype;
     struct History history;
     char title[64];
-    char *n_array, *min_array, *max_array, *sum_array, *sumsq_array,
-        *index_array;
-    void *raster_row, *ptr;
     struct Cell_head region = {0};
     int rows, last_rows, row0, cols; /* scan box size */
-    int row, col;                    /* counters */
+    int row;                         /* counters */
+
+    struct output *outputs;
+    int num_outputs;
+    struct parse_params params;
+    struct chunk chunk;
+    struct spill *spills;
+    struct point *pnt;
+    size_t npnts, total;
 
     int pass, npasses;
     char buff[BUFFSIZE];
-    double x, y, z;
-    char **tokens;
-    int ntokens; /* number of tokens */
-    int arr_row, arr_col;
+    int i;
     unsigned long count, count_total;
 
-    double min = NAN;
-    double max = NAN;
-    double zscale = 1.0;
-    double vscale = 1.0;
-    size_t offset, n_offset;
-    int n = 0;
-    double sum = 0.;
-    double sumsq = 0.;
-    double variance, mean, skew, sumdev;
     int pth = 0;
     double trim = 0.0;
 
-    int j, k;
-    int head_id, node_id;
-    int r_low, r_up;
-
     struct GModule *module;
     struct Option *input_opt, *output_opt, *delim_opt, *percent_opt, *type_opt;
     struct Option *method_opt, *xcol_opt, *ycol_opt, *zcol_opt, *zrange_opt,
         *zscale_opt, *vcol_opt, *vrange_opt, *vscale_opt, *skip_opt;
-    struct Option *trim_opt, *pth_opt;
+    struct Option *trim_opt, *pth_opt, *nprocs_opt;
     struct Flag *scan_flag, *shell_style, *skipline;
 
     G_gisinit(argv[0]);
@@ -165,13 +552,16 @@ int main(int argc, char *argv[])
     input_opt->description =
         _("ASCII file containing input data (or \"-\" to read from stdin)");
 
-    output_opt = G_define_standard_option(G_OPT_R_OUTPUT);
+    output_opt = G_define_standard_option(G_OPT_R_OUTPUTS);
+    output_opt->description =
+        _("Name for output raster map(s), one for each method");
 
     method_opt = G_define_option();
     method_opt->key = "method";
     method_opt->type = TYPE_STRING;
     method_opt->required = NO;
-    method_opt->description = _("Statistic to use for raster values");
+    method_opt->multiple = YES;
+    method_opt->description = _("Statistic(s) to use for raster values");
     method_opt->options = "n,min,max,range,sum,mean,stddev,variance,coeff_var,"
                           "median,percentile,skewness,trimmean";
     method_opt->answer = "mean";
@@ -334,6 +724,8 @@ int main(int argc, char *argv[])
     shell_style->guisection = _("Scan");
     shell_style->suppress_required = YES;
 
+    nprocs_opt = G_define_standard_option(G_OPT_M_NPROCS);
+
     skipline = G_define_flag();
     skipline->key = 'i';
     skipline->description = _("Ignore broken lines");
@@ -345,65 +737,80 @@ int main(int argc, char *argv[])
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
+    nprocs = G_set_omp_num_threads(nprocs_opt);
+    if (nprocs < 1)
+        G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
+
     /* parse input values */
     infile = input_opt->answer;
-    outmap = output_opt->answer;
 
     if (shell_style->answer && !scan_flag->answer) {
         scan_flag->answer =
             1; /* pointer not int, so set = shell_style->answer ? */
     }
 
-    fs = G_option_to_separator(delim_opt);
+    params.fs = G_option_to_separator(delim_opt);
 
-    xcol = atoi(xcol_opt->answer);
-    ycol = atoi(ycol_opt->answer);
-    zcol = atoi(zcol_opt->answer);
-    vcol = atoi(vcol_opt->answer);
-    if ((xcol < 0) || (ycol < 0) || (zcol < 0) || (vcol < 0))
+    params.xcol = atoi(xcol_opt->answer);
+    params.ycol = atoi(ycol_opt->answer);
+    params.zcol = atoi(zcol_opt->answer);
+    params.vcol = atoi(vcol_opt->answer);
+    if ((params.xcol < 0) || (params.ycol < 0) || (params.zcol < 0) ||
+        (params.vcol < 0))
         G_fatal_error(_("Please specify a reasonable column number."));
-    max_col = (xcol > ycol) ? xcol : ycol;
-    max_col = (zcol > max_col) ? zcol : max_col;
-    if (vcol)
-        max_col = (vcol > max_col) ? vcol : max_col;
+    params.max_col = (params.xcol > params.ycol) ? params.xcol : params.ycol;
+    params.max_col =
+        (params.zcol > params.max_col) ? params.zcol : params.max_col;
+    if (params.vcol)
+        params.max_col =
+            (params.vcol > params.max_col) ? params.vcol : params.max_col;
 
     percent = atoi(percent_opt->answer);
-    zscale = atof(zscale_opt->answer);
-    vscale = atof(vscale_opt->answer);
+    params.zscale = atof(zscale_opt->answer);
+    params.vscale = atof(vscale_opt->answer);
 
     skip_lines = atoi(skip_opt->answer);
     if (skip_lines < 0)
         G_fatal_error(_("Please specify reasonable number of lines to skip"));
 
     /* parse zrange and vrange */
-    if (zrange_opt->answer != NULL) {
+    params.zrange = zrange_opt->answer != NULL;
+    if (params.zrange) {
         if (zrange_opt->answers[0] == NULL)
             G_fatal_error(_("Invalid zrange"));
 
-        sscanf(zrange_opt->answers[0], "%lf", &zrange_min);
-        sscanf(zrange_opt->answers[1], "%lf", &zrange_max);
+        sscanf(zrange_opt->answers[0], "%lf", &params.zrange_min);
+        sscanf(zrange_opt->answers[1], "%lf", &params.zrange_max);
 
-        if (zrange_min > zrange_max) {
-            d_tmp = zrange_max;
-            zrange_max = zrange_min;
-            zrange_min = d_tmp;
+        if (params.zrange_min > params.zrange_max) {
+            d_tmp = params.zrange_max;
+            params.zrange_max = params.zrange_min;
+            params.zrange_min = d_tmp;
         }
     }
 
-    if (vrange_opt->answer != NULL) {
+    params.vrange = vrange_opt->answer != NULL;
+    if (params.vrange) {
         if (vrange_opt->answers[0] == NULL)
             G_fatal_error(_("Invalid vrange"));
 
-        sscanf(vrange_opt->answers[0], "%lf", &vrange_min);
-        sscanf(vrange_opt->answers[1], "%lf", &vrange_max);
+        sscanf(vrange_opt->answers[0], "%lf", &params.vrange_min);
+        sscanf(vrange_opt->answers[1], "%lf", &params.vrange_max);
 
-        if (vrange_min > vrange_max) {
-            d_tmp = vrange_max;
-            vrange_max = vrange_min;
-            vrange_min = d_tmp;
+        if (params.vrange_min > params.vrange_max) {
+            d_tmp = params.vrange_max;
+            params.vrange_max = params.vrange_min;
+            params.vrange_min = d_tmp;
         }
     }
 
+    if (strcmp("CELL", type_opt->answer) == 0)
+        rtype = CELL_TYPE;
+    else if (strcmp("DCELL", type_opt->answer) == 0)
+        rtype = DCELL_TYPE;
+    else
+        rtype = FCELL_TYPE;
+
     /* figure out what maps we need in memory */
     /*  n               n
        min              min
@@ -426,88 +833,105 @@ int main(int argc, char *argv[])
     bin_sumsq = FALSE;
     bin_index = FALSE;
 
-    if (strcmp(method_opt->answer, "n") == 0) {
-        method = METHOD_N;
-        bin_n = TRUE;
-    }
-    if (strcmp(method_opt->answer, "min") == 0) {
-        method = METHOD_MIN;
-        bin_min = TRUE;
-    }
-    if (strcmp(method_opt->answer, "max") == 0) {
-        method = METHOD_MAX;
-        bin_max = TRUE;
-    }
-    if (strcmp(method_opt->answer, "range") == 0) {
-        method = METHOD_RANGE;
-        bin_min = TRUE;
-        bin_max = TRUE;
-    }
-    if (strcmp(method_opt->answer, "sum") == 0) {
-        method = METHOD_SUM;
-        bin_sum = TRUE;
-    }
-    if (strcmp(method_opt->answer, "mean") == 0) {
-        method = METHOD_MEAN;
-        bin_sum = TRUE;
-        bin_n = TRUE;
-    }
-    if (strcmp(method_opt->answer, "stddev") == 0) {
-        method = METHOD_STDDEV;
-        bin_sum = TRUE;
-        bin_sumsq = TRUE;
-        bin_n = TRUE;
-    }
-    if (strcmp(method_opt->answer, "variance") == 0) {
-        method = METHOD_VARIANCE;
-        bin_sum = TRUE;
-        bin_sumsq = TRUE;
-        bin_n = TRUE;
-    }
-    if (strcmp(method_opt->answer, "coeff_var") == 0) {
-        method = METHOD_COEFF_VAR;
-        bin_sum = TRUE;
-        bin_sumsq = TRUE;
-        bin_n = TRUE;
-    }
-    if (strcmp(method_opt->answer, "median") == 0) {
-        method = METHOD_MEDIAN;
-        bin_index = TRUE;
-    }
-    if (strcmp(method_opt->answer, "percentile") == 0) {
-        if (pth_opt->answer != NULL)
-            pth = atoi(pth_opt->answer);
-        else
-            G_fatal_error(_("Unable to calculate percentile without the pth "
-                            "option specified!"));
-        method = METHOD_PERCENTILE;
-        bin_index = TRUE;
-    }
-    if (strcmp(method_opt->answer, "skewness") == 0) {
-        method = METHOD_SKEWNESS;
-        bin_index = TRUE;
-    }
-    if (strcmp(method_opt->answer, "trimmean") == 0) {
-        if (trim_opt->answer != NULL)
-            trim = atof(trim_opt->answer) / 100.0;
-        else
-            G_fatal_error(_("Unable to calculate trimmed mean without the trim "
-                            "option specified!"));
-        method = METHOD_TRIMMEAN;
-        bin_index = TRUE;
+    num_outputs = 0;
+    outputs = NULL;
+    if (!scan_flag->answer) {
+        for (i = 0; method_opt->answers[i]; i++)
+            ;
+        num_outputs = i;
+        for (i = 0; output_opt->answers[i]; i++)
+            ;
+        if (num_outputs != i)
+            G_fatal_error(
+                _("output= and method= must have the same number of values"));
+
+        outputs = G_calloc(num_outputs, sizeof(struct output));
     }
 
-    if (strcmp("CELL", type_opt->answer) == 0)
-        rtype = CELL_TYPE;
-    else if (strcmp("DCELL", type_opt->answer) == 0)
-        rtype = DCELL_TYPE;
-    else
-        rtype = FCELL_TYPE;
+    for (i = 0; i < num_outputs; i++) {
+        struct output *out = &outputs[i];
+        const char *method_name = method_opt->answers[i];
 
-    if (method == METHOD_N)
-        rtype = CELL_TYPE;
+        out->name = output_opt->answers[i];
+        out->method_name = method_name;
+        out->method = -1;
+        out->type = rtype;
+
+        if (strcmp(method_name, "n") == 0) {
+            out->method = METHOD_N;
+            out->type = CELL_TYPE;
+            bin_n = TRUE;
+        }
+        if (strcmp(method_name, "min") == 0) {
+            out->method = METHOD_MIN;
+            bin_min = TRUE;
+        }
+        if (strcmp(method_name, "max") == 0) {
+            out->method = METHOD_MAX;
+            bin_max = TRUE;
+        }
+        if (strcmp(method_name, "range") == 0) {
+            out->method = METHOD_RANGE;
+            bin_min = TRUE;
+            bin_max = TRUE;
+        }
+        if (strcmp(method_name, "sum") == 0) {
+            out->method = METHOD_SUM;
+            bin_sum = TRUE;
+        }
+        if (strcmp(method_name, "mean") == 0) {
+            out->method = METHOD_MEAN;
+            bin_sum = TRUE;
+            bin_n = TRUE;
+        }
+        if (strcmp(method_name, "stddev") == 0) {
+            out->method = METHOD_STDDEV;
+            bin_sum = TRUE;
+            bin_sumsq = TRUE;
+            bin_n = TRUE;
+        }
+        if (strcmp(method_name, "variance") == 0) {
+            out->method = METHOD_VARIANCE;
+            bin_sum = TRUE;
+            bin_sumsq = TRUE;
+            bin_n = TRUE;
+        }
+        if (strcmp(method_name, "coeff_var") == 0) {
+            out->method = METHOD_COEFF_VAR;
+            bin_sum = TRUE;
+            bin_sumsq = TRUE;
+            bin_n = TRUE;
+        }
+        if (strcmp(method_name, "median") == 0) {
+            out->method = METHOD_MEDIAN;
+            bin_index = TRUE;
+        }
+        if (strcmp(method_name, "percentile") == 0) {
+            if (pth_opt->answer != NULL)
+                pth = atoi(pth_opt->answer);
+            else
+                G_fatal_error(_("Unable to calculate percentile without the "
+                                "pth option specified!"));
+            out->method = METHOD_PERCENTILE;
+            bin_index = TRUE;
+        }
+        if (strcmp(method_name, "skewness") == 0) {
+            out->method = METHOD_SKEWNESS;
+            bin_index = TRUE;
+        }
+        if (strcmp(method_name, "trimmean") == 0) {
+            if (trim_opt->answer != NULL)
+                trim = atof(trim_opt->answer) / 100.0;
+            else
+                G_fatal_error(_("Unable to calculate trimmed mean without the "
+                                "trim option specified!"));
+            out->method = METHOD_TRIMMEAN;
+            bin_index = TRUE;
+        }
+    }
 
     G_get_window(&region);
+    params.region = &region;
     rows = last_rows = region.rows;
     npasses = 1;
     if (percent < 100) {
@@ -588,26 +1012,20 @@ int main(int argc, char *argv[])
 
     can_seek = fseek(in_fp, 0L, SEEK_SET) == 0;
 
-    /* can't rewind() non-files */
-    if (!can_seek && npasses != 1) {
-        G_warning(_("If input is not from a file it is only possible to "
-                    "perform a single pass."));
-        npasses = 1;
-    }
-
-    /* skip past header lines */
-    for (line = 0; line < (unsigned long)skip_lines; line++) {
-        if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
-            break;
-    }
-
     if (scan_flag->answer) {
+        /* skip past header lines */
+        for (line = 0; line < (unsigned long)skip_lines; line++) {
+            if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
+                break;
+        }
+
         if (zrange_opt->answer || vrange_opt->answer)
             G_warning(
                 _("Range filters will not be taken into account during scan"));
 
-        scan_bounds(in_fp, xcol, ycol, zcol, vcol, fs, shell_style->answer,
-                    skipline->answer, zscale, vscale);
+        scan_bounds(in_fp, params.xcol, params.ycol, params.zcol, params.vcol,
+                    params.fs, shell_style->answer, skipline->answer,
+                    params.zscale, params.vscale);
 
         /* close input file */
         if (!from_stdin)
@@ -616,8 +1034,12 @@ int main(int argc, char *argv[])
         exit(EXIT_SUCCESS);
     }
 
-    /* open output map */
-    out_fd = Rast_open_new(outmap, rtype);
+    /* open output maps */
+    for (i = 0; i < num_outputs; i++) {
+        outputs[i].fd = Rast_open_new(outputs[i].name, outputs[i].type);
+        /* allocate memory for a single row of output data */
+        outputs[i].buf = Rast_allocate_buf(outputs[i].type);
+    }
 
     if (can_seek) {
         /* guess at number of lines in the file without actually reading it all
@@ -639,28 +1061,26 @@ int main(int argc, char *argv[])
     else
         estimated_lines = -1;
 
-    /* allocate memory for a single row of output data */
-    raster_row = Rast_allocate_buf(rtype);
+    /* skip past header lines */
+    for (line = 0; line < (unsigned long)skip_lines; line++) {
+        if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
+            break;
+    }
 
     G_message(_("Reading input data..."));
 
+    /* the points of the passes after the first one go to temporary files,
+     * so that the input is read only once */
+    spills = G_calloc(npasses, sizeof(struct spill));
+    init_chunk(&chunk);
     count_total = 0;
+    line = 0;
 
     /* main binning loop(s) */
     for (pass = 1; pass <= npasses; pass++) {
         if (npasses > 1)
             G_message(_("Pass #%d (of %d) ..."), pass, npasses);
 
-        if (can_seek) {
-            rewind(in_fp);
-
-            /* skip past header lines again */
-            for (line = 0; line < (unsigned long)skip_lines; line++) {
-                if (0 == G_getl2(buff, BUFFSIZE - 1, in_fp))
-                    break;
-            }
-        }
-
         /* figure out segmentation */
         row0 = (pass - 1) * rows;
         if (pass == npasses) {
@@ -707,459 +1127,98 @@ int main(int argc, char *argv[])
                         -1); /* fill with NULLs */
         }
 
-        line = 0;
         count = 0;
         G_percent_reset();
 
-        while (0 != G_getl2(buff, BUFFSIZE - 1, in_fp)) {
-            line++;
+        if (pass == 1) {
+            /* parse the input in chunks, bin the points of this pass and
+             * keep the others for later passes */
+            while (read_chunk(in_fp, &chunk) > 0) {
+                parse_chunk(&chunk, &params);
 
-            if (line % 100000 == 0) { /* mod for speed */
-                if (!can_seek)
-                    G_clicker();
-                else if (line < estimated_lines)
-                    G_percent(line, estimated_lines, 3);
-            }
+                for (i = 0; i < chunk.nlines; i++) {
+                    line++;
 
-            if ((buff[0] == '#') || (buff[0] == '\0')) {
-                continue; /* line is a comment or blank */
-            }
-
-            G_chop(buff); /* remove leading and trailing whitespace from the
-                             string.  unneeded?? */
-            tokens = G_tokenize(buff, fs);
-            ntokens = G_number_of_tokens(tokens);
-
-            if ((ntokens < 3) || (max_col > ntokens)) {
-                if (skipline->answer) {
-                    G_warning(
-                        _("Not enough data columns. "
-                          "Incorrect delimiter or column number? "
-                          "Found the following character(s) in row %lu:\n[%s]"),
-                        line, buff);
-                    G_warning(_("Line ignored as requested"));
-                    continue; /* line is garbage */
-                }
-                else {
-                    G_fatal_error(
-                        _("Not enough data columns. "
-                          "Incorrect delimiter or column number? "
-                          "Found the following character(s) in row %lu:\n[%s]"),
-                        line, buff);
-                }
-            }
-
-            /* too slow?
-               if ( G_projection() == PROJECTION_LL ) {
-               G_scan_easting( tokens[xcol-1], &x, region.proj);
-               G_scan_northing( tokens[ycol-1], &y, region.proj);
-               }
-               else {
-             */
-            if (1 != sscanf(tokens[ycol - 1], "%lf", &y))
-                G_fatal_error(_("Bad y-coordinate line %lu column %d. <%s>"),
-                              line, ycol, tokens[ycol - 1]);
-            if (y <= region.south || y > region.north) {
-                G_free_tokens(tokens);
-                continue;
-            }
-            if (1 != sscanf(tokens[xcol - 1], "%lf", &x))
-                G_fatal_error(_("Bad x-coordinate line %lu column %d. <%s>"),
-                              line, xcol, tokens[xcol - 1]);
-            if (x < region.west || x >= region.east) {
-                G_free_tokens(tokens);
-                continue;
-            }
-
-            /* find the bin in the current array box */
-            arr_row = (int)((region.north - y) / region.ns_res) - row0;
-            if (arr_row < 0 || arr_row >= rows) {
-                G_free_tokens(tokens);
-                continue;
-            }
-            arr_col = (int)((x - region.west) / region.ew_res);
-
-            /* G_debug(5, "arr_row: %d   arr_col: %d", arr_row, arr_col); */
+                    if (line % 100000 == 0) { /* mod for speed */
+                        if (!can_seek)
+                            G_clicker();
+                        else if (line < estimated_lines)
+                            G_percent(line, estimated_lines, 3);
+                    }
 
-            if (1 != sscanf(tokens[zcol - 1], "%lf", &z))
-                G_fatal_error(_("Bad z-coordinate line %lu column %d. <%s>"),
-                              line, zcol, tokens[zcol - 1]);
-            z = z * zscale;
+                    if (chunk.status[i] == LINE_SKIP)
+                        continue;
+                    if (chunk.status[i] != LINE_POINT) {
+                        bad_line(chunk.text + chunk.start[i], line,
+                                 chunk.status[i], &params, skipline->answer);
+                        continue;
+                    }
 
-            if (zrange_opt->answer) {
-                if (z < zrange_min || z > zrange_max) {
-                    G_free_tokens(tokens);
-                    continue;
-                }
-            }
+                    pnt = &chunk.points[i];
+                    if (pnt->row >= rows) {
+                        struct spill *sp = &spills[pnt->row / rows];
 
-            if (vcol) {
-                if (1 != sscanf(tokens[vcol - 1], "%lf", &z))
-                    G_fatal_error(_("Bad data value line %lu column %d. <%s>"),
-                                  line, vcol, tokens[vcol - 1]);
-                /* we're past the zrange check, so pass over control of the
-                 * variable */
-                z = z * vscale;
-
-                if (vrange_opt->answer) {
-                    if (z < vrange_min || z > vrange_max) {
-                        G_free_tokens(tokens);
+                        if (!sp->fp) {
+                            sp->name = G_tempfile();
+                            if (!(sp->fp = fopen(sp->name, "w+b")))
+                                G_fatal_error(
+                                    _("Unable to open temporary file <%s>"),
+                                    sp->name);
+                        }
+                        if (fwrite(pnt, sizeof(struct point), 1, sp->fp) != 1)
+                            G_fatal_error(
+                                _("Unable to write temporary file <%s>"),
+                                sp->name);
                         continue;
                     }
-                }
-            }
 
-            count++;
-            /* G_debug(5, "x: %f, y: %f, z: %f", x, y, z); */
-            G_free_tokens(tokens);
-
-            if (bin_n)
-                update_n(n_array, cols, arr_row, arr_col);
-            if (bin_min)
-                update_min(min_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_max)
-                update_max(max_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_sum)
-                update_sum(sum_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_sumsq)
-                update_sumsq(sumsq_array, cols, arr_row, arr_col, rtype, z);
-            if (bin_index) {
-                ptr = index_array;
-                ptr = G_incr_void_ptr(ptr, ((arr_row * cols) + arr_col) *
-                                               Rast_cell_size(CELL_TYPE));
-
-                if (Rast_is_null_value(ptr, CELL_TYPE)) { /* first node */
-                    head_id = new_node();
-                    nodes[head_id].next = -1;
-                    nodes[head_id].z = z;
-                    Rast_set_c_value(ptr, head_id,
-                                     CELL_TYPE); /* store index to head */
+                    count++;
+                    bin_point(pnt->row, pnt->col, pnt->z, cols, rtype);
                 }
-                else { /* head is already there */
-
-                    head_id = Rast_get_c_value(
-                        ptr, CELL_TYPE); /* get index to head */
-                    head_id = add_node(head_id, z);
-                    if (head_id != -1)
-                        Rast_set_c_value(ptr, head_id,
-                                         CELL_TYPE); /* store index to head */
+            } /* while !EOF */
+
+            G_percent(1, 1, 1); /* flush */
+            G_message(_("%lu points found in input file"), line);
+        }
+        else if (spills[pass - 1].fp) {
+            /* bin the points kept for this pass */
+            struct spill *sp = &spills[pass - 1];
+
+            total = G_ftell(sp->fp) / sizeof(struct point);
+            rewind(sp->fp);
+            while ((npnts = fread(chunk.points, sizeof(struct point),
+                                  CHUNK_LINES, sp->fp)) > 0) {
+                for (i = 0; i < (int)npnts; i++) {
+                    pnt = &chunk.points[i];
+                    count++;
+                    bin_point(pnt->row - row0, pnt->col, pnt->z, cols, rtype);
                 }
+                G_percent(count, total, 3);
             }
-        } /* while !EOF */
+            if (ferror(sp->fp))
+                G_fatal_error(_("Unable to read temporary file <%s>"),
+                              sp->name);
+
+            fclose(sp->fp);
+            remove(sp->name);
+            G_free(sp->name);
+        }
 
-        G_percent(1, 1, 1); /* flush */
         G_debug(2, "pass %d finished, %lu coordinates in box", pass, count);
         count_total += count;
-        G_message(_("%lu points found in input file"), line);
 
         /* calc stats and output */
         G_message(_("Writing to output raster map..."));
         for (row = 0; row < rows; row++) {
+            for (i = 0; i < num_outputs; i++) {
+                stats_row(outputs[i].method, row, cols, outputs[i].buf,
+                          outputs[i].type, pth, trim);
 
-            switch (method) {
-            case METHOD_N: /* n is a straight copy */
-                Rast_raster_cpy(raster_row,
-                                n_array +
-                                    (row * cols * Rast_cell_size(CELL_TYPE)),
-                                cols, CELL_TYPE);
-                break;
-
-            case METHOD_MIN:
-                Rast_raster_cpy(raster_row,
-                                min_array +
-                                    (row * cols * Rast_cell_size(rtype)),
-                                cols, rtype);
-                break;
-
-            case METHOD_MAX:
-                Rast_raster_cpy(raster_row,
-                                max_array +
-                                    (row * cols * Rast_cell_size(rtype)),
-                                cols, rtype);
-                break;
-
-            case METHOD_SUM:
-                Rast_raster_cpy(raster_row,
-                                sum_array +
-                                    (row * cols * Rast_cell_size(rtype)),
-                                cols, rtype);
-                break;
-
-            case METHOD_RANGE: /* (max-min) */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    offset = (row * cols + col) * Rast_cell_size(rtype);
-                    min = Rast_get_d_value(min_array + offset, rtype);
-                    max = Rast_get_d_value(max_array + offset, rtype);
-                    Rast_set_d_value(ptr, max - min, rtype);
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-
-            case METHOD_MEAN: /* (sum / n) */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    offset = (row * cols + col) * Rast_cell_size(rtype);
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    n = Rast_get_c_value(n_array + n_offset, CELL_TYPE);
-                    sum = Rast_get_d_value(sum_array + offset, rtype);
-
-                    if (n == 0)
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else
-                        Rast_set_d_value(ptr, (sum / n), rtype);
-
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-
-            case METHOD_STDDEV:    /*  sqrt(variance)        */
-            case METHOD_VARIANCE:  /*  (sumsq - sum*sum/n)/n */
-            case METHOD_COEFF_VAR: /*  100 * stdev / mean    */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    offset = (row * cols + col) * Rast_cell_size(rtype);
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    n = Rast_get_c_value(n_array + n_offset, CELL_TYPE);
-                    sum = Rast_get_d_value(sum_array + offset, rtype);
-                    sumsq = Rast_get_d_value(sumsq_array + offset, rtype);
-
-                    if (n == 0)
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else {
-                        variance = (sumsq - sum * sum / n) / n;
-                        if (variance < GRASS_EPSILON)
-                            variance = 0.0;
-
-                        if (method == METHOD_STDDEV)
-                            Rast_set_d_value(ptr, sqrt(variance), rtype);
-
-                        else if (method == METHOD_VARIANCE)
-                            Rast_set_d_value(ptr, variance, rtype);
-
-                        else if (method == METHOD_COEFF_VAR)
-                            Rast_set_d_value(
-                                ptr, 100 * sqrt(variance) / (sum / n), rtype);
-                    }
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-            case METHOD_MEDIAN: /* median, if only one point in cell we will use
-                                   that */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    if (Rast_is_null_value(index_array + n_offset,
-                                           CELL_TYPE)) /* no points in cell */
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else { /* one or more points in cell */
-
-                        head_id =
-                            Rast_get_c_value(index_array + n_offset, CELL_TYPE);
-                        node_id = head_id;
-
-                        n = 0;
-
-                        while (node_id !=
-                               -1) { /* count number of points in cell */
-                            n++;
-                            node_id = nodes[node_id].next;
-                        }
-
-                        if (n == 1) /* only one point, use that */
-                            Rast_set_d_value(ptr, nodes[head_id].z, rtype);
-                        else if (n % 2 != 0) { /* odd number of points: median_i
-                                                  = (n + 1) / 2 */
-                            n = (n + 1) / 2;
-                            node_id = head_id;
-                            for (j = 1; j < n; j++) /* get "median element" */
-                                node_id = nodes[node_id].next;
-
-                            Rast_set_d_value(ptr, nodes[node_id].z, rtype);
-                        }
-                        else { /* even number of points: median = (val_below +
-                                  val_above) / 2 */
-
-                            z = (n + 1) / 2.0;
-                            n = floor(z);
-                            node_id = head_id;
-                            for (j = 1; j < n; j++) /* get element "below" */
-                                node_id = nodes[node_id].next;
-
-                            z = (nodes[node_id].z +
-                                 nodes[nodes[node_id].next].z) /
-                                2;
-                            Rast_set_d_value(ptr, z, rtype);
-                        }
-                    }
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-            case METHOD_PERCENTILE: /* rank = (pth*(n+1))/100; interpolate
-                                       linearly */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    if (Rast_is_null_value(index_array + n_offset,
-                                           CELL_TYPE)) /* no points in cell */
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else {
-                        head_id =
-                            Rast_get_c_value(index_array + n_offset, CELL_TYPE);
-                        node_id = head_id;
-                        n = 0;
-
-                        while (node_id !=
-                               -1) { /* count number of points in cell */
-                            n++;
-                            node_id = nodes[node_id].next;
-                        }
-
-                        z = (pth * (n + 1)) / 100.0;
-                        r_low = floor(z); /* lower rank */
-                        if (r_low < 1)
-                            r_low = 1;
-                        else if (r_low > n)
-                            r_low = n;
-
-                        r_up = ceil(z); /* upper rank */
-                        if (r_up > n)
-                            r_up = n;
-
-                        node_id = head_id;
-                        for (j = 1; j < r_low; j++) /* search lower value */
-                            node_id = nodes[node_id].next;
-
-                        z = nodes[node_id].z; /* save lower value */
-                        node_id = head_id;
-                        for (j = 1; j < r_up; j++) /* search upper value */
-                            node_id = nodes[node_id].next;
-
-                        z = (z + nodes[node_id].z) / 2;
-                        Rast_set_d_value(ptr, z, rtype);
-                    }
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-            case METHOD_SKEWNESS: /* skewness = sum(xi-mean)^3/(N-1)*s^3 */
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    if (Rast_is_null_value(index_array + n_offset,
-                                           CELL_TYPE)) /* no points in cell */
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else {
-                        head_id =
-                            Rast_get_c_value(index_array + n_offset, CELL_TYPE);
-                        node_id = head_id;
-
-                        n = 0;        /* count */
-                        sum = 0.0;    /* sum */
-                        sumsq = 0.0;  /* sum of squares */
-                        sumdev = 0.0; /* sum of (xi - mean)^3 */
-                        skew = 0.0;   /* skewness */
-
-                        while (node_id != -1) {
-                            z = nodes[node_id].z;
-                            n++;
-                            sum += z;
-                            sumsq += (z * z);
-                            node_id = nodes[node_id].next;
-                        }
-
-                        if (n > 1) { /* if n == 1, skew is "0.0" */
-                            mean = sum / n;
-                            node_id = head_id;
-                            while (node_id != -1) {
-                                z = nodes[node_id].z;
-                                sumdev += pow((z - mean), 3);
-                                node_id = nodes[node_id].next;
-                            }
-
-                            variance = (sumsq - sum * sum / n) / n;
-                            if (variance < GRASS_EPSILON)
-                                skew = 0.0;
-                            else
-                                skew =
-                                    sumdev / ((n - 1) * pow(sqrt(variance), 3));
-                        }
-                        Rast_set_d_value(ptr, skew, rtype);
-                    }
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-            case METHOD_TRIMMEAN:
-                ptr = raster_row;
-                for (col = 0; col < cols; col++) {
-                    n_offset = (row * cols + col) * Rast_cell_size(CELL_TYPE);
-                    if (Rast_is_null_value(index_array + n_offset,
-                                           CELL_TYPE)) /* no points in cell */
-                        Rast_set_null_value(ptr, 1, rtype);
-                    else {
-                        head_id =
-                            Rast_get_c_value(index_array + n_offset, CELL_TYPE);
-
-                        node_id = head_id;
-                        n = 0;
-                        while (node_id !=
-                               -1) { /* count number of points in cell */
-                            n++;
-                            node_id = nodes[node_id].next;
-                        }
-
-                        if (1 == n)
-                            mean = nodes[head_id].z;
-                        else {
-                            k = floor(trim * n +
-                                      0.5); /* number of ranks to discard on
-                                               each tail */
-
-                            if (k > 0 &&
-                                (n - 2 * k) >
-                                    0) { /* enough elements to discard */
-                                node_id = head_id;
-                                for (j = 0; j < k;
-                                     j++) /* move to first rank to consider */
-                                    node_id = nodes[node_id].next;
-
-                                j = k + 1;
-                                k = n - k;
-                                n = 0;
-                                sum = 0.0;
-
-                                while (j <= k) { /* get values in interval */
-                                    n++;
-                                    sum += nodes[node_id].z;
-                                    node_id = nodes[node_id].next;
-                                    j++;
-                                }
-                            }
-                            else {
-                                node_id = head_id;
-                                n = 0;
-                                sum = 0.0;
-                                while (node_id != -1) {
-                                    n++;
-                                    sum += nodes[node_id].z;
-                                    node_id = nodes[node_id].next;
-                                }
-                            }
-                            mean = sum / n;
-                        }
-                        Rast_set_d_value(ptr, mean, rtype);
-                    }
-                    ptr = G_incr_void_ptr(ptr, Rast_cell_size(rtype));
-                }
-                break;
-
-            default:
-                G_fatal_error("?");
+                /* write out line of raster data */
+                Rast_put_row(outputs[i].fd, outputs[i].buf, outputs[i].type);
             }
 
             G_percent(row, rows, 5);
-
-            /* write out line of raster data */
-            Rast_put_row(out_fd, raster_row, rtype);
         }
 
         /* free memory */
@@ -1184,24 +1243,28 @@ int main(int argc, char *argv[])
     } /* passes loop */
 
     G_percent(1, 1, 1); /* flush */
-    G_free(raster_row);
+    free_chunk(&chunk);
+    G_free(spills);
 
     /* close input file */
     if (!from_stdin)
         fclose(in_fp);
 
-    /* close raster file & write history */
-    Rast_close(out_fd);
+    /* close raster files & write history */
+    for (i = 0; i < num_outputs; i++) {
+        G_free(outputs[i].buf);
+        Rast_close(outputs[i].fd);
 
-    snprintf(title, sizeof(title),
-             "Raw x,y,z data binned into a raster grid by cell %s",
-             method_opt->answer);
-    Rast_put_cell_title(outmap, title);
+        snprintf(title, sizeof(title),
+                 "Raw x,y,z data binned into a raster grid by cell %s",
+                 outputs[i].method_name);
+        Rast_put_cell_title(outputs[i].name, title);
 
-    Rast_short_history(outmap, "raster", &history);
-    Rast_command_history(&history);
-    Rast_set_history(&history, HIST_DATSRC_1, infile);
-    Rast_write_history(outmap, &history);
+        Rast_short_history(outputs[i].name, "raster", &history);
+        Rast_command_history(&history);
+        Rast_set_history(&history, HIST_DATSRC_1, infile);
+        Rast_write_history(outputs[i].name, &history);
+    }
 
     G_done_msg(_("%lu points found in region."), count_total);
 
@@ -0,0 +1,149 @@
+/*
+ * r.in.xyz
+ *
+ *   Reading and parsing input lines in chunks
+ *
+ *   Copyright 2026 by the GRASS Development Team
+ *
+ *   This program is free software licensed under the GPL (>=v2).
+ *   Read the COPYING file that comes with GRASS for details.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include "local_proto.h"
+
+void init_chunk(struct chunk *chunk)
+{
+    chunk->text = NULL;
+    chunk->text_size = 0;
+    chunk->start = G_malloc(CHUNK_LINES * sizeof(size_t));
+    chunk->status = G_malloc(CHUNK_LINES * sizeof(int));
+    chunk->points = G_malloc(CHUNK_LINES * sizeof(struct point));
+    chunk->nlines = 0;
+}
+
+void free_chunk(struct chunk *chunk)
+{
+    G_free(chunk->text);
+    G_free(chunk->start);
+    G_free(chunk->status);
+    G_free(chunk->points);
+}
+
+/* read up to CHUNK_LINES lines, returns the number of lines read */
+int read_chunk(FILE *fp, struct chunk *chunk)
+{
+    char buff[BUFFSIZE];
+    size_t used = 0, len;
+
+    chunk->nlines = 0;
+    while (chunk->nlines < CHUNK_LINES &&
+           0 != G_getl2(buff, BUFFSIZE - 1, fp)) {
+        len = strlen(buff) + 1;
+        if (used + len > chunk->text_size) {
+            chunk->text_size = 2 * chunk->text_size + BUFFSIZE;
+            chunk->text = G_realloc(chunk->text, chunk->text_size);
+        }
+        memcpy(chunk->text + used, buff, len);
+        chunk->start[chunk->nlines++] = used;
+        used += len;
+    }
+
+    return chunk->nlines;
+}
+
+/* parse a line into a point binned into a cell of the region */
+static int parse_line(char *buff, const struct parse_params *p,
+                      struct point *pnt)
+{
+    char **tokens;
+    int ntokens; /* number of tokens */
+    double x, y, z;
+
+    if ((buff[0] == '#') || (buff[0] == '\0'))
+        return LINE_SKIP; /* line is a comment or blank */
+
+    G_chop(buff); /* remove leading and trailing whitespace from the
+                     string.  unneeded?? */
+    tokens = G_tokenize(buff, p->fs);
+    ntokens = G_number_of_tokens(tokens);
+
+    if ((ntokens < 3) || (p->max_col > ntokens)) {
+        G_free_tokens(tokens);
+        return LINE_BROKEN;
+    }
+
+    if (1 != sscanf(tokens[p->ycol - 1], "%lf", &y)) {
+        G_free_tokens(tokens);
+        return LINE_BAD_Y;
+    }
+    if (y <= p->region->south || y > p->region->north) {
+        G_free_tokens(tokens);
+        return LINE_SKIP;
+    }
+    if (1 != sscanf(tokens[p->xcol - 1], "%lf", &x)) {
+        G_free_tokens(tokens);
+        return LINE_BAD_X;
+    }
+    if (x < p->region->west || x >= p->region->east) {
+        G_free_tokens(tokens);
+        return LINE_SKIP;
+    }
+
+    /* find the bin in the region */
+    pnt->row = (int)((p->region->north - y) / p->region->ns_res);
+    if (pnt->row >= p->region->rows) {
+        G_free_tokens(tokens);
+        return LINE_SKIP;
+    }
+    pnt->col = (int)((x - p->region->west) / p->region->ew_res);
+
+    if (1 != sscanf(tokens[p->zcol - 1], "%lf", &z)) {
+        G_free_tokens(tokens);
+        return LINE_BAD_Z;
+    }
+    z = z * p->zscale;
+
+    if (p->zrange) {
+        if (z < p->zrange_min || z > p->zrange_max) {
+            G_free_tokens(tokens);
+            return LINE_SKIP;
+        }
+    }
+
+    if (p->vcol) {
+        if (1 != sscanf(tokens[p->vcol - 1], "%lf", &z)) {
+            G_free_tokens(tokens);
+            return LINE_BAD_V;
+        }
+        /* we're past the zrange check, so pass over control of the
+         * variable */
+        z = z * p->vscale;
+
+        if (p->vrange) {
+            if (z < p->vrange_min || z > p->vrange_max) {
+                G_free_tokens(tokens);
+                return LINE_SKIP;
+            }
+        }
+    }
+
+    G_free_tokens(tokens);
+    pnt->z = z;
+
+    return LINE_POINT;
+}
+
+/* parse the lines of a chunk, in parallel if threads are available */
+void parse_chunk(struct chunk *chunk, const struct parse_params *p)
+{
+    int i;
+
+#pragma omp parallel for schedule(static)
+    for (i = 0; i < chunk->nlines; i++)
+        chunk->status[i] = parse_line(chunk->text + chunk->start[i], p,
+                                      &chunk->points[i]);
+}
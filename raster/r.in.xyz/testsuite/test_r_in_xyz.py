@@ -0,0 +1,150 @@
+"""Test of r.in.xyz
+
+The same statistics must come out of one run with several methods,
+runs keeping only a part of the map in memory, runs with several
+threads parsing the input and runs reading from stdin.
+
+@copyright 2026 by the GRASS Development Team
+
+@license This program is free software under the GNU General Public License (>=v2).
+Read the file COPYING that comes with GRASS
+for details
+"""
+
+import os
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+import grass.script as gs
+
+METHODS = [
+    "n",
+    "min",
+    "max",
+    "range",
+    "sum",
+    "mean",
+    "stddev",
+    "variance",
+    "coeff_var",
+    "median",
+    "percentile",
+    "skewness",
+    "trimmean",
+]
+
+# more lines than are parsed at a time
+NPOINTS = 150000
+
+
+def make_points():
+    """Return the points as text and the number of points in the region
+
+    Coordinates are never on cell edges, some points are outside the
+    region.
+    """
+    lines = []
+    inside = 0
+    state = 12345
+    for i in range(NPOINTS):
+        values = []
+        for scale in (1300000, 1100000, 50000):
+            state = (state * 1103515245 + 12345) % 2**31
+            values.append(state % scale)
+        x = values[0] / 10000 - 5 + 0.00005
+        y = values[1] / 10000 - 5 + 0.00005
+        z = values[2] / 100 - 100 + (i % 7) * 0.25
+        lines.append(f"{x:.5f}|{y:.5f}|{z:.2f}")
+        if 0 < x < 120 and 0 < y < 100:
+            inside += 1
+    return "\n".join(lines) + "\n", inside
+
+
+class TestXyz(TestCase):
+    """Statistics of points in cells of 2 m"""
+
+    single = "test_xyz_single"
+    multi = "test_xyz_multi"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=100, s=0, e=120, w=0, res=2)
+        cls.text, cls.inside = make_points()
+        cls.points = gs.tempfile()
+        with open(cls.points, "w") as points:
+            points.write(cls.text)
+        # the reference: one method at a time, whole map in memory
+        for method in METHODS:
+            cls.runModule(
+                "r.in.xyz",
+                input=cls.points,
+                output=f"{cls.single}_{method}",
+                method=method,
+                pth=75,
+                trim=10,
+                nprocs=1,
+            )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        os.remove(cls.points)
+        cls.runModule("g.remove", flags="f", type="raster", pattern=f"{cls.single}_*")
+
+    def tearDown(self):
+        self.runModule("g.remove", flags="f", type="raster", pattern=f"{self.multi}_*")
+
+    def run_methods(self, **kwargs):
+        """Compute all statistics in one run"""
+        kwargs.setdefault("input", self.points)
+        self.assertModule(
+            "r.in.xyz",
+            output=[f"{self.multi}_{method}" for method in METHODS],
+            method=METHODS,
+            pth=75,
+            trim=10,
+            overwrite=True,
+            **kwargs,
+        )
+
+    def assertSameStatistics(self):
+        """Compare the statistics of one run with the reference"""
+        for method in METHODS:
+            self.assertRastersNoDifference(
+                f"{self.multi}_{method}", f"{self.single}_{method}", precision=0
+            )
+
+    def test_count(self):
+        """All points in the region are counted"""
+        self.assertRasterFitsUnivar(
+            f"{self.single}_n", reference={"sum": self.inside}, precision=0
+        )
+
+    def test_methods(self):
+        """Several methods in one run"""
+        self.run_methods(nprocs=1)
+        self.assertSameStatistics()
+
+    def test_percent(self):
+        """Parts of the map in memory, in passes of equal and unequal rows"""
+        for percent in (10, 33):
+            self.run_methods(percent=percent, nprocs=1)
+            self.assertSameStatistics()
+
+    def test_threads(self):
+        """Input parsed by several threads"""
+        self.run_methods(nprocs=4)
+        self.assertSameStatistics()
+        self.run_methods(percent=33, nprocs=4)
+        self.assertSameStatistics()
+
+    def test_stdin(self):
+        """Input from stdin, also in several passes"""
+        for percent in (100, 25):
+            self.run_methods(input="-", stdin_=self.text, percent=percent, nprocs=4)
+            self.assertSameStatistics()
+
+
+if __name__ == "__main__":
+    test()
@@ -191,23 +191,6 @@ static void initialize(expression *e)
 
 /****************************************************************************/
 
-static void do_evaluate(void *p)
-{
-    evaluate((struct expression *)p);
-}
-
-static void begin_evaluate(struct expression *e)
-{
-    G_begin_execute(do_evaluate, e, &e->worker, 0);
-}
-
-static void end_evaluate(struct expression *e)
-{
-    G_end_execute(&e->worker);
-}
-
-/****************************************************************************/
-
 static void evaluate_constant(expression *e)
 {
     int tid = 0;
@@ -266,16 +249,10 @@ static void evaluate_function(expression *e)
     tid = omp_get_thread_num();
 #endif
 
-    if (e->data.func.argc > 1 && e->data.func.func != f_eval) {
-        for (i = 1; i <= e->data.func.argc; i++)
-            begin_evaluate(e->data.func.args[i]);
-
-        for (i = 1; i <= e->data.func.argc; i++)
-            end_evaluate(e->data.func.args[i]);
-    }
-    else
-        for (i = 1; i <= e->data.func.argc; i++)
-            evaluate(e->data.func.args[i]);
+    /* arguments are evaluated by the calling OpenMP thread, the GIS
+       library worker threads are left to the raster library */
+    for (i = 1; i <= e->data.func.argc; i++)
+        evaluate(e->data.func.args[i]);
 
     /* copy the argv in the individual thread */
     void **thread_argv = G_malloc((e->data.func.argc + 1) * sizeof(void *));
@@ -491,8 +468,6 @@ void execute(expr_list *ee)
         }
     }
 
-    G_finish_workers();
-
     if (verbose)
         G_percent(n, count, 2);
 
@@ -526,6 +501,9 @@ void execute(expr_list *ee)
             create_history(var, val);
     }
 
+    /* closing the maps may still wait for the workers */
+    G_finish_workers();
+
     G_unset_error_routine();
 
     /* Free the memory and make it unreachable */
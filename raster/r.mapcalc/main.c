@@ -255,7 +255,7 @@ int main(int argc, char **argv)
     /* Ensure the proper number of threads is assigned */
     threads = G_set_omp_num_threads(nprocs);
     if (threads > 1)
-        threads = Rast_disable_omp_on_mask(threads);
+        threads = Rast_set_mask_threads(threads);
     if (threads < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), threads);
 
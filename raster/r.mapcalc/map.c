@@ -71,10 +71,6 @@ struct map {
 static struct map *maps;
 static int num_maps;
 static int max_maps;
-#ifdef HAVE_PTHREAD_H
-static int masking;
-#endif
-
 static int min_row = INT_MAX;
 static int max_row = -INT_MAX;
 static int min_col = INT_MAX;
@@ -84,24 +80,10 @@ static int max_rows_in_memory = 8;
 
 #ifdef HAVE_PTHREAD_H
 static pthread_mutex_t cats_mutex;
-static pthread_mutex_t mask_mutex;
 #endif
 
 /****************************************************************************/
 
-static void read_row(int fd, void *buf, int row, int res_type)
-{
-#ifdef HAVE_PTHREAD_H
-    if (masking)
-        pthread_mutex_lock(&mask_mutex);
-#endif
-    Rast_get_row(fd, buf, row, res_type);
-#ifdef HAVE_PTHREAD_H
-    if (masking)
-        pthread_mutex_unlock(&mask_mutex);
-#endif
-}
-
 static void cache_sub_init(struct row_cache *cache, int data_type)
 {
     struct sub_cache *sub = G_malloc(sizeof(struct sub_cache));
@@ -162,7 +144,7 @@ static void *cache_get_raw(struct row_cache *cache, int row, int data_type)
 
     if (i >= 0 && i < cache->nrows) {
         if (!sub->valid[i]) {
-            read_row(cache->fd, sub->buf[i], row, data_type);
+            Rast_get_row(cache->fd, sub->buf[i], row, data_type);
             sub->valid[i] = 1;
         }
         return sub->buf[i];
@@ -171,7 +153,7 @@ static void *cache_get_raw(struct row_cache *cache, int row, int data_type)
     if (i <= -cache->nrows || i >= cache->nrows * 2 - 1) {
         memset(sub->valid, 0, cache->nrows);
         sub->row = row;
-        read_row(cache->fd, sub->buf[0], row, data_type);
+        Rast_get_row(cache->fd, sub->buf[0], row, data_type);
         sub->valid[0] = 1;
         return sub->buf[0];
     }
@@ -197,7 +179,7 @@ static void *cache_get_raw(struct row_cache *cache, int row, int data_type)
     G_freea(tmp);
     G_freea(vtmp);
 
-    read_row(cache->fd, sub->buf[i], row, data_type);
+    Rast_get_row(cache->fd, sub->buf[i], row, data_type);
     sub->valid[i] = 1;
 
     return sub->buf[i];
@@ -428,7 +410,7 @@ static void read_map(struct map *m, void *buf, int res_type, int row, int col)
     if (m->use_rowio)
         cache_get(&m->cache, buf, row, res_type);
     else
-        read_row(m->fd, buf, row, res_type);
+        Rast_get_row(m->fd, buf, row, res_type);
     if (col)
         column_shift(buf, res_type, col);
 }
@@ -589,8 +571,6 @@ void setup_maps(void)
 
 #ifdef HAVE_PTHREAD_H
     pthread_mutex_init(&cats_mutex, NULL);
-    pthread_mutex_init(&mask_mutex, NULL);
-    masking = Rast_maskfd() >= 0;
 #endif
 
     for (i = 0; i < num_maps; i++)
@@ -650,7 +630,6 @@ void close_maps(void)
 
 #ifdef HAVE_PTHREAD_H
     pthread_mutex_destroy(&cats_mutex);
-    pthread_mutex_destroy(&mask_mutex);
 #endif
 }
 
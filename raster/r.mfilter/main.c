@@ -122,7 +122,7 @@ int main(int argc, char **argv)
     sscanf(opt4->answer, "%d", &repeat);
 
     nprocs = G_set_omp_num_threads(opt6);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
     if (nprocs < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
 
@@ -1,6 +1,8 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
+#include <grass/stats.h>
 #include "ncb.h"
+#include "local_proto.h"
 
 /*
    given the starting col of the neighborhood,
@@ -86,3 +88,55 @@ int gather_w(DCELL *values, DCELL (*values_w)[2], int offset, int thread_id)
 
     return n;
 }
+
+/*
+   find the columns of the neighborhood in each row,
+   return 0 if they are not a single range in some row
+ */
+int window_ranges(void)
+{
+    int row, col;
+
+    ncb.first = G_malloc(ncb.nsize * sizeof(int));
+    ncb.last = G_malloc(ncb.nsize * sizeof(int));
+
+    for (row = 0; row < ncb.nsize; row++) {
+        ncb.first[row] = 0;
+        ncb.last[row] = -1;
+        for (col = 0; col < ncb.nsize; col++) {
+            if (ncb.mask && !ncb.mask[row][col])
+                continue;
+            if (ncb.last[row] < 0)
+                ncb.first[row] = col;
+            else if (ncb.last[row] != col - 1)
+                return 0;
+            ncb.last[row] = col;
+        }
+    }
+
+    return 1;
+}
+
+/*
+   move the sorted window of the neighborhood values to the starting
+   col given by offset, columns must be visited in order from 0
+ */
+void gather_window(struct stat_window *w, int offset, int thread_id)
+{
+    DCELL **buf = ncb.buf[thread_id];
+    int row, col;
+
+    if (offset == 0) {
+        stat_window_clear(w);
+        for (row = 0; row < ncb.nsize; row++)
+            for (col = ncb.first[row]; col <= ncb.last[row]; col++)
+                stat_window_insert(w, buf[row][col]);
+        return;
+    }
+
+    /* one value leaves and one enters in each row */
+    for (row = 0; row < ncb.nsize; row++)
+        if (ncb.first[row] <= ncb.last[row])
+            stat_window_update(w, buf[row][offset - 1 + ncb.first[row]],
+                               buf[row][offset + ncb.last[row]]);
+}
@@ -1,4 +1,5 @@
 #include <grass/gis.h>
+#include <grass/stats.h>
 
 /* bufs.c */
 extern int allocate_bufs(void);
@@ -9,6 +10,14 @@ extern void circle_mask(void);
 extern void weights_mask(void);
 extern int gather(DCELL *, int, int);
 extern int gather_w(DCELL *, DCELL (*)[2], int, int);
+extern int window_ranges(void);
+extern void gather_window(struct stat_window *, int, int);
+
+/* sums.c */
+extern int use_sums(int);
+extern void allocate_sums(int);
+extern void window_sums(int, int);
+extern void sums_value(DCELL *, int, int, int);
 
 /* readcell.c */
 extern int readcell(int, int, int, int, int);
@@ -27,3 +36,4 @@ extern void read_weights(const char *);
 extern double gaussian(double, double);
 extern double exponential(double, double);
 extern void compute_weights(const char *, double);
+extern void separable_weights(const char *, double);
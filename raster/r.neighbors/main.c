@@ -41,6 +41,8 @@ typedef int (*ifunc)(void);
 struct menu {
     stat_func *method;     /* routine to compute new value */
     stat_func_w *method_w; /* routine to compute new value (weighted) */
+    stat_func *method_s;   /* routine for sorted values, or NULL */
+    int sums;              /* statistic from window sums, or SUMS_NONE */
     ifunc cat_names;       /* routine to make category names */
     int copycolr;          /* flag if color table can be copied */
     int half;              /* whether to add 0.5 to result (redundant) */
@@ -61,30 +63,39 @@ enum out_type { T_FLOAT = 1, T_INT = 2, T_COUNT = 3, T_COPY = 4, T_SUM = 5 };
 
 /* modify this table to add new methods */
 static struct menu menu[] = {
-    {c_ave, w_ave, NO_CATS, 1, 1, T_FLOAT, "average", "average value"},
-    {c_median, w_median, NO_CATS, 1, 0, T_FLOAT, "median", "median value"},
-    {c_mode, w_mode, NO_CATS, 1, 0, T_COPY, "mode",
+    {c_ave, w_ave, NULL, SUMS_AVE, NO_CATS, 1, 1, T_FLOAT, "average",
+     "average value"},
+    {c_median, w_median, s_median, SUMS_NONE, NO_CATS, 1, 0, T_FLOAT, "median",
+     "median value"},
+    {c_mode, w_mode, s_mode, SUMS_NONE, NO_CATS, 1, 0, T_COPY, "mode",
      "most frequently occurring value"},
-    {c_min, NULL, NO_CATS, 1, 0, T_COPY, "minimum", "lowest value"},
-    {c_max, NULL, NO_CATS, 1, 0, T_COPY, "maximum", "highest value"},
-    {c_range, NULL, NO_CATS, 1, 0, T_COPY, "range", "range value"},
-    {c_stddev, w_stddev, NO_CATS, 0, 1, T_FLOAT, "stddev",
+    {c_min, NULL, NULL, SUMS_NONE, NO_CATS, 1, 0, T_COPY, "minimum",
+     "lowest value"},
+    {c_max, NULL, NULL, SUMS_NONE, NO_CATS, 1, 0, T_COPY, "maximum",
+     "highest value"},
+    {c_range, NULL, NULL, SUMS_NONE, NO_CATS, 1, 0, T_COPY, "range",
+     "range value"},
+    {c_stddev, w_stddev, NULL, SUMS_STDDEV, NO_CATS, 0, 1, T_FLOAT, "stddev",
      "standard deviation"},
-    {c_sum, w_sum, NO_CATS, 1, 0, T_SUM, "sum", "sum of values"},
-    {c_count, w_count, NO_CATS, 0, 0, T_COUNT, "count",
+    {c_sum, w_sum, NULL, SUMS_SUM, NO_CATS, 1, 0, T_SUM, "sum",
+     "sum of values"},
+    {c_count, w_count, NULL, SUMS_COUNT, NO_CATS, 0, 0, T_COUNT, "count",
      "count of non-NULL values"},
-    {c_var, w_var, NO_CATS, 0, 1, T_FLOAT, "variance", "statistical variance"},
-    {c_divr, NULL, divr_cats, 0, 0, T_INT, "diversity",
+    {c_var, w_var, NULL, SUMS_VAR, NO_CATS, 0, 1, T_FLOAT, "variance",
+     "statistical variance"},
+    {c_divr, NULL, s_divr, SUMS_NONE, divr_cats, 0, 0, T_INT, "diversity",
      "number of different values"},
-    {c_intr, NULL, intr_cats, 0, 0, T_INT, "interspersion",
+    {c_intr, NULL, NULL, SUMS_NONE, intr_cats, 0, 0, T_INT, "interspersion",
      "number of values different than center value"},
-    {c_quart1, w_quart1, NO_CATS, 1, 0, T_FLOAT, "quart1", "first quartile"},
-    {c_quart3, w_quart3, NO_CATS, 1, 0, T_FLOAT, "quart3", "third quartile"},
-    {c_perc90, w_perc90, NO_CATS, 1, 0, T_FLOAT, "perc90",
+    {c_quart1, w_quart1, s_quart1, SUMS_NONE, NO_CATS, 1, 0, T_FLOAT, "quart1",
+     "first quartile"},
+    {c_quart3, w_quart3, s_quart3, SUMS_NONE, NO_CATS, 1, 0, T_FLOAT, "quart3",
+     "third quartile"},
+    {c_perc90, w_perc90, s_perc90, SUMS_NONE, NO_CATS, 1, 0, T_FLOAT, "perc90",
      "ninetieth percentile"},
-    {c_quant, w_quant, NO_CATS, 1, 0, T_FLOAT, "quantile",
+    {c_quant, w_quant, s_quant, SUMS_NONE, NO_CATS, 1, 0, T_FLOAT, "quantile",
      "arbitrary quantile"},
-    {0, 0, 0, 0, 0, 0, 0, 0}};
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
 
 struct ncb ncb;
 
@@ -95,6 +106,8 @@ struct output {
     DCELL *buf;
     stat_func *method_fn;
     stat_func_w *method_fn_w;
+    stat_func *method_fn_s;
+    int sums;
     int copycolr;
     ifunc cat_names;
     int map_type;
@@ -142,6 +155,7 @@ int main(int argc, char *argv[])
     int num_outputs;
     struct output *outputs = NULL;
     int copycolr, weights, have_weights_mask;
+    int sliding, sums, variance, need_gather;
     char **selection;
     RASTER_MAP_TYPE map_type;
     int row, col;
@@ -175,6 +189,8 @@ int main(int argc, char *argv[])
     DCELL(**values_w)[2];     /* list of neighborhood values and weights */
     DCELL(**values_w_tmp)[2]; /* list of neighborhood values and weights */
 
+    struct stat_window *windows; /* sorted neighborhood values */
+
     G_gisinit(argv[0]);
 
     module = G_define_module();
@@ -299,7 +315,7 @@ int main(int argc, char *argv[])
     ncb.dist = ncb.nsize / 2;
 
     ncb.threads = G_set_omp_num_threads(parm.nprocs);
-    ncb.threads = Rast_disable_omp_on_mask(ncb.threads);
+    ncb.threads = Rast_set_mask_threads(ncb.threads);
     if (ncb.threads < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), ncb.threads);
 
@@ -333,8 +349,9 @@ int main(int argc, char *argv[])
 
     /* open raster maps */
     in_fd = G_malloc(sizeof(int) * ncb.threads);
-    for (i = 0; i < ncb.threads; i++) {
-        in_fd[i] = Rast_open_old(ncb.oldcell, "");
+    in_fd[FIRST_THREAD] = Rast_open_old(ncb.oldcell, "");
+    for (i = 1; i < ncb.threads; i++) {
+        in_fd[i] = Rast_open_old_dup(in_fd[FIRST_THREAD]);
     }
     map_type = Rast_get_map_type(in_fd[FIRST_THREAD]);
 
@@ -376,6 +393,8 @@ int main(int argc, char *argv[])
     weights = 0;
     ncb.weights = NULL;
     ncb.mask = NULL;
+    ncb.kernel = NULL;
+    ncb.kernel_scale = 1;
     if (strcmp(parm.weighting_function->answer, "file") == 0) {
         read_weights(parm.weight->answer);
         weights = 1;
@@ -385,6 +404,8 @@ int main(int argc, char *argv[])
                           parm.weighting_function->answer);
         compute_weights(parm.weighting_function->answer,
                         atof(parm.weighting_factor->answer));
+        separable_weights(parm.weighting_function->answer,
+                          atof(parm.weighting_factor->answer));
         weights = 1;
     }
 
@@ -404,6 +425,7 @@ int main(int argc, char *argv[])
             if (menu[method].method_w) {
                 out->method_fn = NULL;
                 out->method_fn_w = menu[method].method_w;
+                out->sums = menu[method].sums;
             }
             else {
                 if (strcmp(parm.weighting_function->answer, "none")) {
@@ -422,6 +444,8 @@ int main(int argc, char *argv[])
         else {
             out->method_fn = menu[method].method;
             out->method_fn_w = NULL;
+            out->method_fn_s = menu[method].method_s;
+            out->sums = menu[method].sums;
         }
         out->copycolr = menu[method].copycolr;
         out->cat_names = menu[method].cat_names;
@@ -460,7 +484,10 @@ int main(int argc, char *argv[])
         selection_fd = G_malloc(sizeof(int) * ncb.threads);
         selection = G_malloc(sizeof(char *) * ncb.threads);
         for (t = 0; t < ncb.threads; t++) {
-            selection_fd[t] = Rast_open_old(parm.selection->answer, "");
+            selection_fd[t] =
+                t == FIRST_THREAD
+                    ? Rast_open_old(parm.selection->answer, "")
+                    : Rast_open_old_dup(selection_fd[FIRST_THREAD]);
             selection[t] = Rast_allocate_null_buf();
         }
     }
@@ -472,6 +499,46 @@ int main(int argc, char *argv[])
     if (flag.circle->answer)
         circle_mask();
 
+    /* order statistics are taken from sorted windows which are moved
+       along the row, if the neighborhood is a range of columns in
+       each row */
+    sliding = 0;
+    for (i = 0; i < num_outputs; i++)
+        if (outputs[i].method_fn_s)
+            sliding = 1;
+    if (sliding && !window_ranges()) {
+        for (i = 0; i < num_outputs; i++)
+            outputs[i].method_fn_s = NULL;
+        sliding = 0;
+    }
+
+    /* average, sum, count and variance are computed from sums of the
+       columns of square neighborhoods, for all cells of a row at once */
+    sums = 0;
+    variance = 0;
+    for (i = 0; i < num_outputs; i++) {
+        if (outputs[i].sums && !use_sums(weights))
+            outputs[i].sums = SUMS_NONE;
+        if (outputs[i].sums)
+            sums = 1;
+        if (outputs[i].sums == SUMS_VAR || outputs[i].sums == SUMS_STDDEV)
+            variance = 1;
+    }
+    if (sums)
+        allocate_sums(variance);
+
+    need_gather = 0;
+    for (i = 0; i < num_outputs; i++)
+        if (!outputs[i].method_fn_s && !outputs[i].sums)
+            need_gather = 1;
+
+    windows = NULL;
+    if (sliding) {
+        windows = G_malloc(sizeof(struct stat_window) * ncb.threads);
+        for (t = 0; t < ncb.threads; t++)
+            stat_window_init(&windows[t], ncb.nsize * ncb.nsize);
+    }
+
     values_w = NULL;
     values_w_tmp = NULL;
     if (weights) {
@@ -530,8 +597,14 @@ int main(int argc, char *argv[])
                 if (selection)
                     Rast_get_null_value_row(selection_fd[t], selection[t], row);
 
+                if (sums)
+                    window_sums(ncols, t);
+
                 for (col = 0; col < ncols; col++) {
 
+                    if (sliding)
+                        gather_window(&windows[t], col, t);
+
                     if (selection && selection[t][col]) {
                         /* ncb.buf length is region row length + 2 * ncb.dist
                          * (eq. floor(neighborhood/2)) Thus original data start
@@ -542,16 +615,26 @@ int main(int argc, char *argv[])
                         continue;
                     }
 
-                    if (weights)
-                        n = gather_w(values[t], values_w[t], col, t);
-                    else
-                        n = gather(values[t], col, t);
+                    n = 0;
+                    if (need_gather) {
+                        if (weights)
+                            n = gather_w(values[t], values_w[t], col, t);
+                        else
+                            n = gather(values[t], col, t);
+                    }
 
                     for (i = 0; i < num_outputs; i++) {
                         struct output *out = &outputs[i];
                         DCELL *rp = &out->buf[(size_t)brow_idx * ncols + col];
 
-                        if (n == 0) {
+                        if (out->sums) {
+                            sums_value(rp, out->sums, col, t);
+                        }
+                        else if (out->method_fn_s) {
+                            (*out->method_fn_s)(rp, windows[t].values,
+                                                windows[t].n, &out->quantile);
+                        }
+                        else if (n == 0) {
                             Rast_set_d_null_value(rp, 1);
                         }
                         else {
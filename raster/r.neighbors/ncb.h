@@ -1,5 +1,14 @@
 #include <grass/raster.h>
 
+/* statistics computed from window sums, see sums.c */
+enum { SUMS_NONE, SUMS_AVE, SUMS_SUM, SUMS_COUNT, SUMS_VAR, SUMS_STDDEV };
+
+struct window_sums {
+    DCELL *col[4];          /* sums of the columns of the neighborhood rows */
+    DCELL *win[4];          /* sums of the windows of the row */
+    DCELL *prefix, *suffix; /* partial sums of blocks */
+};
+
 struct ncb /* neighborhood control block */
 {
     DCELL ***buf; /* for reading raster map */
@@ -9,7 +18,11 @@ struct ncb /* neighborhood control block */
     int threads;
     struct Categories cats;
     char **mask;
+    int *first, *last; /* neighborhood columns of each row */
     DCELL **weights;
+    DCELL *kernel;      /* separable weights of rows and columns */
+    DCELL kernel_scale; /* scale of the product of the separable weights */
+    struct window_sums *sums;
     const char *oldcell;
 };
 
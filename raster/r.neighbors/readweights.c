@@ -64,3 +64,27 @@ void compute_weights(const char *function_type, double factor)
         }
     }
 }
+
+/*
+   factor the weights of the gaussian function into weights of rows and
+   columns, ncb.kernel stays NULL for other functions
+ */
+void separable_weights(const char *function_type, double factor)
+{
+    double sigma2 = factor * factor;
+    int i;
+
+    ncb.kernel = NULL;
+    ncb.kernel_scale = 1;
+
+    if (strcmp(function_type, "gaussian"))
+        return;
+
+    ncb.kernel = G_malloc(ncb.nsize * sizeof(DCELL));
+    for (i = 0; i < ncb.nsize; i++) {
+        double x = i - ncb.dist;
+
+        ncb.kernel[i] = exp(-x * x / (2 * sigma2));
+    }
+    ncb.kernel_scale = 1 / (2 * M_PI * sigma2);
+}
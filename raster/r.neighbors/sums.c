@@ -0,0 +1,189 @@
+#include <math.h>
+#include <grass/gis.h>
+#include <grass/raster.h>
+#include "ncb.h"
+#include "local_proto.h"
+
+/*
+   average, sum, count, variance and standard deviation of square
+   neighborhoods from sums of the columns of the neighborhood rows,
+   which are added up along the row in O(1) per cell, or O(size) per
+   cell with separable weights
+ */
+
+static int with_variance;
+
+/*
+   sums can be used if the neighborhood has no mask and its weights
+   (if any) are separable
+ */
+int use_sums(int weighted)
+{
+    return !ncb.mask && (!weighted || ncb.kernel);
+}
+
+void allocate_sums(int variance)
+{
+    int t, q, nq, len;
+
+    with_variance = variance;
+    nq = with_variance ? 4 : 2;
+    len = Rast_window_cols() + 2 * ncb.dist;
+
+    ncb.sums = G_malloc(ncb.threads * sizeof(struct window_sums));
+    for (t = 0; t < ncb.threads; t++) {
+        struct window_sums *s = &ncb.sums[t];
+
+        for (q = 0; q < 4; q++) {
+            s->col[q] = q < nq ? G_malloc(len * sizeof(DCELL)) : NULL;
+            s->win[q] = q < nq ? G_malloc(len * sizeof(DCELL)) : NULL;
+        }
+        s->prefix = G_malloc(len * sizeof(DCELL));
+        s->suffix = G_malloc(len * sizeof(DCELL));
+    }
+}
+
+/*
+   sums of all windows of k values in a, with n windows:
+   the sum of a window is split at a multiple of k into a suffix sum
+   of one block of k values and a prefix sum of the next block, so
+   that no rounding errors pile up along the row
+ */
+static void moving_sums(const DCELL *a, DCELL *out, int n, int k,
+                        DCELL *prefix, DCELL *suffix)
+{
+    int len = n + k - 1;
+    int b, j, end;
+
+    for (b = 0; b < len; b += k) {
+        end = b + k < len ? b + k : len;
+
+        prefix[b] = a[b];
+        for (j = b + 1; j < end; j++)
+            prefix[j] = prefix[j - 1] + a[j];
+
+        suffix[end - 1] = a[end - 1];
+        for (j = end - 2; j >= b; j--)
+            suffix[j] = suffix[j + 1] + a[j];
+    }
+
+    for (j = 0; j < n; j++)
+        out[j] = j % k == 0 ? prefix[j + k - 1]
+                            : suffix[j] + prefix[j + k - 1];
+}
+
+/* weighted sums of all windows of k values in a, with n windows */
+static void moving_weighted_sums(const DCELL *a, DCELL *out, int n, int k,
+                                 const DCELL *kernel)
+{
+    int i, j;
+    DCELL sum;
+
+    for (j = 0; j < n; j++) {
+        sum = 0;
+        for (i = 0; i < k; i++)
+            sum += kernel[i] * a[j + i];
+        out[j] = sum;
+    }
+}
+
+/* compute the window sums of all cells of the current row */
+void window_sums(int ncols, int thread_id)
+{
+    struct window_sums *s = &ncb.sums[thread_id];
+    DCELL **buf = ncb.buf[thread_id];
+    int len = ncols + 2 * ncb.dist;
+    int nq = with_variance ? 4 : 2;
+    int i, c, q, count;
+    DCELL w, v, d, mean, shift;
+
+    /* variances are computed from values shifted by the value of the
+       center row closest to its mean, which avoids the cancellation of
+       large sums and keeps the sums of integer maps exact */
+    shift = 0;
+    if (with_variance) {
+        mean = 0;
+        count = 0;
+        for (c = 0; c < len; c++)
+            if (!Rast_is_d_null_value(&buf[ncb.dist][c])) {
+                mean += buf[ncb.dist][c];
+                count++;
+            }
+        if (count) {
+            mean /= count;
+            shift = buf[ncb.dist][0];
+            for (c = 0; c < len; c++) {
+                v = buf[ncb.dist][c];
+                if (!Rast_is_d_null_value(&v) &&
+                    (Rast_is_d_null_value(&shift) ||
+                     fabs(v - mean) < fabs(shift - mean)))
+                    shift = v;
+            }
+        }
+    }
+
+    /* column sums: count, sum, shifted sum, shifted sum of squares */
+    for (q = 0; q < nq; q++)
+        for (c = 0; c < len; c++)
+            s->col[q][c] = 0;
+
+    for (i = 0; i < ncb.nsize; i++) {
+        w = ncb.kernel ? ncb.kernel[i] : 1;
+        for (c = 0; c < len; c++) {
+            v = buf[i][c];
+            if (Rast_is_d_null_value(&v))
+                continue;
+            s->col[0][c] += w;
+            s->col[1][c] += w * v;
+            if (with_variance) {
+                d = v - shift;
+                s->col[2][c] += w * d;
+                s->col[3][c] += w * d * d;
+            }
+        }
+    }
+
+    for (q = 0; q < nq; q++) {
+        if (ncb.kernel)
+            moving_weighted_sums(s->col[q], s->win[q], ncols, ncb.nsize,
+                                 ncb.kernel);
+        else
+            moving_sums(s->col[q], s->win[q], ncols, ncb.nsize, s->prefix,
+                        s->suffix);
+    }
+}
+
+/* value of a statistic of the window starting at col */
+void sums_value(DCELL *result, int stat, int col, int thread_id)
+{
+    struct window_sums *s = &ncb.sums[thread_id];
+    DCELL count = s->win[0][col];
+    DCELL sum, var;
+
+    if (stat == SUMS_COUNT) {
+        *result = count * ncb.kernel_scale;
+        return;
+    }
+
+    if (count == 0) {
+        Rast_set_d_null_value(result, 1);
+        return;
+    }
+
+    switch (stat) {
+    case SUMS_AVE:
+        *result = s->win[1][col] / count;
+        break;
+    case SUMS_SUM:
+        *result = s->win[1][col] * ncb.kernel_scale;
+        break;
+    case SUMS_VAR:
+    case SUMS_STDDEV:
+        sum = s->win[2][col];
+        var = (count * s->win[3][col] - sum * sum) / (count * count);
+        if (var < 0)
+            var = 0;
+        *result = stat == SUMS_VAR ? var : sqrt(var);
+        break;
+    }
+}
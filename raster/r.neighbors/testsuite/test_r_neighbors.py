@@ -1,8 +1,94 @@
+import math
 from pathlib import Path
 from grass.gunittest.case import TestCase
 from grass.gunittest.main import test
 from grass.script.raster import raster_info
-from grass.script import tempfile
+from grass.script import read_command, tempfile
+
+# order statistics with quantile option values, None for fixed ranks
+RANK_METHODS = [
+    ("median", None),
+    ("quart1", None),
+    ("quart3", None),
+    ("perc90", None),
+    ("quantile", 0.1),
+    ("quantile", 0.33),
+]
+
+
+def read_grid(name):
+    """Return the cells of a map as rows of floats, None for null"""
+    text = read_command(
+        "r.out.ascii", input=name, output="-", flags="h", null_value="*", precision=17
+    )
+    return [
+        [None if value == "*" else float(value) for value in line.split()]
+        for line in text.splitlines()
+    ]
+
+
+def rank_value(method, quant, values):
+    """Order statistic of sorted values like the unweighted methods"""
+    n = len(values)
+    if method == "median":
+        return (values[(n - 1) // 2] + values[n // 2]) / 2
+    quant = {"quart1": 0.25, "quart3": 0.75, "perc90": 0.90}.get(method, quant)
+    k = quant * (n - 1)
+    i0 = math.floor(k)
+    i1 = math.ceil(k)
+    if i0 == i1:
+        return values[i0]
+    return values[i0] * (i1 - k) + values[i1] * (k - i0)
+
+
+def weighted_rank_value(method, quant, values):
+    """Order statistic of sorted (value, weight) pairs like the weighted
+    methods, cells of weight 0 are kept as in the module"""
+    if method == "median":
+        quant = 0.5
+    quant = {"quart1": 0.25, "quart3": 0.75, "perc90": 0.90}.get(method, quant)
+    total = 0.0
+    for value, weight in values:
+        total += weight
+    k = 0.0
+    for value, weight in values:
+        k += weight
+        if k >= total * quant:
+            break
+    return value
+
+
+def reference_ranks(grid, size, method, quant, weights=None, circle=False):
+    """Order statistics gathered for every cell, cells outside the grid
+    are null"""
+    nrows, ncols = len(grid), len(grid[0])
+    dist = size // 2
+    result = []
+    for row in range(nrows):
+        line = []
+        for col in range(ncols):
+            values = []
+            for i in range(size):
+                for j in range(size):
+                    if circle and (i - dist) ** 2 + (j - dist) ** 2 > dist**2:
+                        continue
+                    r, c = row + i - dist, col + j - dist
+                    if not (0 <= r < nrows and 0 <= c < ncols):
+                        continue
+                    if grid[r][c] is None:
+                        continue
+                    values.append(
+                        grid[r][c] if weights is None else (grid[r][c], weights[i][j])
+                    )
+            if not values:
+                line.append(None)
+            elif weights is None:
+                line.append(rank_value(method, quant, sorted(values)))
+            else:
+                values.sort(key=lambda pair: pair[0])
+                line.append(weighted_rank_value(method, quant, values))
+        result.append(line)
+    return result
 
 
 class TestNeighbors(TestCase):
@@ -23,6 +109,11 @@ class TestNeighbors(TestCase):
         (standard options otherwise).
     test_weighting_file: Test results with file for weighting
         (standard options otherwise).
+    test_weighting_function_file: Test gaussian weighting against the
+        same weights given in a file.
+    test_sorted_window: Test order statistics of the sorted moving
+        window against the values gathered for every cell, with and
+        without nulls and -c, and of a weight mask with holes.
     """
 
     test_options = {
@@ -677,6 +768,219 @@ class TestNeighbors(TestCase):
             nprocs=4,
         )
 
+    def test_weighting_function_file(self):
+        """Test gaussian weighting, computed from separate row and column
+        weights, against the same weights given in a file."""
+        test_case = "test_weighting_function_file"
+        size = 7
+        factor = 2.0
+        methods = ["average", "sum", "count", "variance", "stddev"]
+        nulls_map = "{}_nulls".format(test_case)
+        self.to_remove.append(nulls_map)
+        self.runModule(
+            "r.mapcalc",
+            expression="{} = if((row() * 3 + col()) % 11 == 0, null(), "
+            "elevation)".format(nulls_map),
+        )
+
+        sigma2 = factor * factor
+        dist = size // 2
+        weights = tempfile()
+        Path(weights).write_text(
+            "\n".join(
+                " ".join(
+                    "{:.17g}".format(
+                        math.exp(-((i - dist) ** 2 + (j - dist) ** 2) / (2 * sigma2))
+                        / (2 * math.pi * sigma2)
+                    )
+                    for j in range(size)
+                )
+                for i in range(size)
+            )
+        )
+
+        for input_map in ("elevation", nulls_map):
+            function_maps = [
+                "{}_{}_function_{}".format(test_case, input_map, m) for m in methods
+            ]
+            file_maps = [
+                "{}_{}_file_{}".format(test_case, input_map, m) for m in methods
+            ]
+            self.to_remove.extend(function_maps + file_maps)
+            self.assertModule(
+                "r.neighbors",
+                input=input_map,
+                size=size,
+                weighting_function="gaussian",
+                weighting_factor=factor,
+                output=function_maps,
+                method=methods,
+                nprocs=4,
+            )
+            self.assertModule(
+                "r.neighbors",
+                input=input_map,
+                size=size,
+                weighting_function="file",
+                weight=weights,
+                output=file_maps,
+                method=methods,
+            )
+            for function_map, file_map in zip(function_maps, file_maps):
+                self.assertRastersNoDifference(function_map, file_map, precision=1e-6)
+
+    def test_sorted_window(self):
+        """Test order statistics of the sorted moving window against the
+        values gathered for every cell (weights not used by diversity) and
+        against values gathered in Python, also for a weight mask."""
+        test_case = "test_sorted_window"
+        size = 9
+        sorted_map = "{}_sorted".format(test_case)
+        gathered_map = "{}_gathered".format(test_case)
+        self.to_remove.extend([sorted_map, gathered_map])
+
+        weights = tempfile()
+        Path(weights).write_text(("1 " * size + "\n") * size)
+
+        self.assertModule(
+            "r.neighbors",
+            input="elevation",
+            size=size,
+            output=sorted_map,
+            method="diversity",
+            nprocs=4,
+        )
+        self.assertModule(
+            "r.neighbors",
+            input="elevation",
+            size=size,
+            weighting_function="file",
+            output=gathered_map,
+            method="diversity",
+            weight=weights,
+        )
+        self.assertRastersEqual(sorted_map, gathered_map)
+
+        # order statistics on a small region, gathered in Python
+        self.runModule("g.region", n=220300, s=220000, w=638000, e=638300, res=10)
+        self.addCleanup(self.runModule, "g.region", raster="elevation")
+        nulls_map = "{}_nulls".format(test_case)
+        self.to_remove.append(nulls_map)
+        self.runModule(
+            "r.mapcalc",
+            expression="{} = if((row() * 3 + col()) % 7 == 0 || "
+            "(row() > 10 && row() < 15 && col() > 5 && col() < 20), "
+            "null(), elevation)".format(nulls_map),
+        )
+        size = 7
+        methods = [method for method, quant in RANK_METHODS]
+        quantiles = [quant or 0 for method, quant in RANK_METHODS]
+        for input_map in ("elevation", nulls_map):
+            grid = read_grid(input_map)
+            for flags in ("", "c"):
+                outputs = [
+                    "{}_{}{}_{}_{}".format(test_case, flags, input_map, method, i)
+                    for i, method in enumerate(methods)
+                ]
+                self.to_remove.extend(outputs)
+                self.assertModule(
+                    "r.neighbors",
+                    input=input_map,
+                    size=size,
+                    flags=flags,
+                    output=outputs,
+                    method=methods,
+                    quantile=quantiles,
+                    nprocs=4,
+                )
+                for output, (method, quant) in zip(outputs, RANK_METHODS):
+                    self.assertGridsAlmostEqual(
+                        read_grid(output),
+                        reference_ranks(
+                            grid, size, method, quant, circle=flags == "c"
+                        ),
+                        output,
+                    )
+
+        # a ring of cells is not a range of columns in every row, so the
+        # values are gathered for every cell with their weights
+        size = 5
+        ring = [
+            [0 if 0 < i < size - 1 and 0 < j < size - 1 else 1 for j in range(size)]
+            for i in range(size)
+        ]
+        weights = tempfile()
+        Path(weights).write_text(
+            "\n".join(" ".join(str(w) for w in line) for line in ring)
+        )
+        grid = read_grid(nulls_map)
+        outputs = [
+            "{}_ring_{}_{}".format(test_case, method, i)
+            for i, method in enumerate(methods)
+        ]
+        self.to_remove.extend(outputs)
+        self.assertModule(
+            "r.neighbors",
+            input=nulls_map,
+            size=size,
+            weighting_function="file",
+            weight=weights,
+            output=outputs,
+            method=methods,
+            quantile=quantiles,
+            nprocs=4,
+        )
+        for output, (method, quant) in zip(outputs, RANK_METHODS):
+            self.assertGridsAlmostEqual(
+                read_grid(output),
+                reference_ranks(grid, size, method, quant, weights=ring),
+                output,
+            )
+
+    def assertGridsAlmostEqual(self, actual, expected, name):
+        """Compare cells of two grids, None for null"""
+        self.assertEqual(len(actual), len(expected))
+        for row, (line, expected_line) in enumerate(zip(actual, expected)):
+            for col, (value, expected_value) in enumerate(zip(line, expected_line)):
+                msg = "{} cell {}, {}".format(name, row, col)
+                if expected_value is None:
+                    self.assertIsNone(value, msg=msg)
+                else:
+                    self.assertAlmostEqual(value, expected_value, delta=1e-9, msg=msg)
+
+    def test_window_sums(self):
+        """Test statistics computed from sums of the columns of the window
+        against the values gathered for every cell (file weights)."""
+        test_case = "test_window_sums"
+        size = 9
+        methods = ["average", "count", "stddev"]
+        summed_maps = ["{}_summed_{}".format(test_case, m) for m in methods]
+        gathered_maps = ["{}_gathered_{}".format(test_case, m) for m in methods]
+        self.to_remove.extend(summed_maps + gathered_maps)
+
+        weights = tempfile()
+        Path(weights).write_text(("1 " * size + "\n") * size)
+
+        self.assertModule(
+            "r.neighbors",
+            input="elevation",
+            size=size,
+            output=summed_maps,
+            method=methods,
+            nprocs=4,
+        )
+        self.assertModule(
+            "r.neighbors",
+            input="elevation",
+            size=size,
+            weighting_function="file",
+            output=gathered_maps,
+            method=methods,
+            weight=weights,
+        )
+        for summed_map, gathered_map in zip(summed_maps, gathered_maps):
+            self.assertRastersEqual(summed_map, gathered_map, precision=1e-4)
+
     def test_standard_options_datatype(self):
         """Test if result is of integer or float data type depending on
         input datatype and method"""
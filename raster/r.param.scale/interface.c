@@ -136,7 +136,7 @@ void interface(int argc, char **argv)
     rast_out_name = rast_out->answer; /* can place the contents into strings  */
     wsize = atoi(win_size->answer);
     nprocs = G_set_omp_num_threads(nprocs_opt);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
     if (nprocs < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
     memory = atoi(mem_opt->answer);
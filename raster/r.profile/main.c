@@ -209,6 +209,8 @@ int main(int argc, char *argv[])
 
     /* Open Raster File */
     fd = Rast_open_old(name, "");
+    /* profile lines can cross the rows in any order */
+    Rast_set_mmap(fd, 1);
 
     /* initialize color structure */
     if (clr)
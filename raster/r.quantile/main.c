@@ -3,7 +3,8 @@
  * MODULE:       r.quantile
  * AUTHOR(S):    Glynn Clements <glynn gclements.plus.com>
  *                 (original contributor),
- * PURPOSE:      Compute quantiles using two passes
+ * PURPOSE:      Compute quantiles using two passes or approximately
+ *               in one pass
  *
  *               This program is free software under the GNU General Public
  *               License (>=v2). Read the file COPYING that comes with GRASS
@@ -11,12 +12,17 @@
  *
  *****************************************************************************/
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 #include <grass/gis.h>
 #include <grass/raster.h>
+#include <grass/stats.h>
 #include <grass/glocale.h>
 
 struct bin {
@@ -26,6 +32,7 @@ struct bin {
 };
 
 static int rows, cols;
+static int nprocs;
 
 static DCELL min, max;
 static int num_quants;
@@ -40,6 +47,7 @@ static int num_bins_alloc;
 static int num_bins_used;
 static struct bin *bins;
 static DCELL *values;
+static struct quantile_sketch sketch;
 
 static inline int get_slot(DCELL c)
 {
@@ -86,34 +94,54 @@ static inline double get_quantile(int n)
     return rnk;
 }
 
-static void get_slot_counts(int infile)
+static void get_slot_counts(int *infile)
 {
-    DCELL *inbuf = Rast_allocate_d_buf();
-    int row, col;
+    DCELL **inbuf = G_malloc(nprocs * sizeof(DCELL *));
+    size_t **counts = G_malloc(nprocs * sizeof(size_t *));
+    int row, col, computed;
+    int i, t;
 
     G_message(_("Computing histogram"));
 
+    /* each thread counts its rows in its own histogram */
+    for (t = 0; t < nprocs; t++) {
+        inbuf[t] = Rast_allocate_d_buf();
+        counts[t] = t ? G_calloc(num_slots, sizeof(size_t)) : slots;
+    }
+
     total = 0;
+    computed = 0;
+    t = 0;
 
+#pragma omp parallel for schedule(static) private(col, t) reduction(+ : total)
     for (row = 0; row < rows; row++) {
-        Rast_get_d_row(infile, inbuf, row);
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        Rast_get_d_row(infile[t], inbuf[t], row);
 
         for (col = 0; col < cols; col++) {
-            int i;
-
-            if (Rast_is_d_null_value(&inbuf[col]))
+            if (Rast_is_d_null_value(&inbuf[t][col]))
                 continue;
 
-            i = get_slot(inbuf[col]);
-
-            slots[i]++;
+            counts[t][get_slot(inbuf[t][col])]++;
             total++;
         }
 
-        G_percent(row, rows, 2);
+#pragma omp atomic update
+        computed++;
+        G_percent(computed, rows, 2);
     }
 
-    G_percent(rows, rows, 2);
+    for (t = 0; t < nprocs; t++) {
+        if (t) {
+            for (i = 0; i < num_slots; i++)
+                slots[i] += counts[t][i];
+            G_free(counts[t]);
+        }
+        G_free(inbuf[t]);
+    }
+    G_free(counts);
     G_free(inbuf);
 }
 
@@ -174,37 +202,104 @@ static void initialize_bins(void)
     G_debug(1, "Number of values: %lu", num_values);
 }
 
-static void fill_bins(int infile)
+static void fill_bins(int *infile)
 {
-    DCELL *inbuf = Rast_allocate_d_buf();
-    int row, col;
+    DCELL **inbuf = G_malloc(nprocs * sizeof(DCELL *));
+    int row, col, computed;
+    int t;
 
     G_message(_("Binning data"));
 
+    for (t = 0; t < nprocs; t++)
+        inbuf[t] = Rast_allocate_d_buf();
+
+    /* the order of the values within a bin does not matter, they are
+       sorted later */
+    computed = 0;
+    t = 0;
+
+#pragma omp parallel for schedule(static) private(col, t)
     for (row = 0; row < rows; row++) {
-        Rast_get_d_row(infile, inbuf, row);
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        Rast_get_d_row(infile[t], inbuf[t], row);
 
         for (col = 0; col < cols; col++) {
-            int i, bin;
+            int i;
+            size_t pos;
             struct bin *b;
 
-            if (Rast_is_d_null_value(&inbuf[col]))
+            if (Rast_is_d_null_value(&inbuf[t][col]))
                 continue;
 
-            i = get_slot(inbuf[col]);
+            i = get_slot(inbuf[t][col]);
             if (!slot_bins[i])
                 continue;
 
-            bin = slot_bins[i] - 1;
-            b = &bins[bin];
+            b = &bins[slot_bins[i] - 1];
 
-            values[b->base + b->count++] = inbuf[col];
+#pragma omp atomic capture
+            pos = b->count++;
+
+            values[b->base + pos] = inbuf[t][col];
         }
 
-        G_percent(row, rows, 2);
+#pragma omp atomic update
+        computed++;
+        G_percent(computed, rows, 2);
     }
 
-    G_percent(rows, rows, 2);
+    for (t = 0; t < nprocs; t++)
+        G_free(inbuf[t]);
+    G_free(inbuf);
+}
+
+/* one pass: each thread summarizes its rows in its own sketch */
+static void fill_sketch(int *infile, double error)
+{
+    DCELL **inbuf = G_malloc(nprocs * sizeof(DCELL *));
+    struct quantile_sketch *sketches;
+    int row, col, computed;
+    int t;
+
+    G_message(_("Computing approximate quantiles"));
+
+    sketches = G_malloc(nprocs * sizeof(struct quantile_sketch));
+    for (t = 0; t < nprocs; t++) {
+        inbuf[t] = Rast_allocate_d_buf();
+        quantile_sketch_init(&sketches[t], error);
+    }
+
+    computed = 0;
+    t = 0;
+
+#pragma omp parallel for schedule(static) private(col, t)
+    for (row = 0; row < rows; row++) {
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        Rast_get_d_row(infile[t], inbuf[t], row);
+
+        for (col = 0; col < cols; col++)
+            quantile_sketch_add(&sketches[t], inbuf[t][col]);
+
+#pragma omp atomic update
+        computed++;
+        G_percent(computed, rows, 2);
+    }
+
+    /* merged in the order of the threads to get the same result for the
+       same number of threads */
+    quantile_sketch_init(&sketch, error);
+    for (t = 0; t < nprocs; t++) {
+        quantile_sketch_merge(&sketch, &sketches[t]);
+        quantile_sketch_free(&sketches[t]);
+        G_free(inbuf[t]);
+    }
+    total = sketch.count;
+
+    G_free(sketches);
     G_free(inbuf);
 }
 
@@ -233,7 +328,20 @@ static void sort_bins(void)
     }
 }
 
-static void compute_quantiles(int recode)
+/* value of a rank, interpolated between the values of the sketch */
+static double sketch_value(double k)
+{
+    size_t i0 = (size_t)floor(k);
+    size_t i1 = (size_t)ceil(k);
+
+    if (i0 == i1)
+        return quantile_sketch_value(&sketch, i0);
+
+    return quantile_sketch_value(&sketch, i0) * (i1 - k) +
+           quantile_sketch_value(&sketch, i1) * (k - i0);
+}
+
+static void compute_quantiles(int recode, int approx)
 {
     int bin = 0;
     double prev_v = min;
@@ -247,23 +355,27 @@ static void compute_quantiles(int recode)
         double k, v;
         size_t i0, i1;
 
-        for (; bin < num_bins_used; bin++) {
-            b = &bins[bin];
-            if (b->origin + b->count >= next)
-                break;
-        }
+        if (approx)
+            v = total > 0 ? sketch_value(next) : max;
+        else {
+            for (; bin < num_bins_used; bin++) {
+                b = &bins[bin];
+                if (b->origin + b->count >= next)
+                    break;
+            }
 
-        if (bin < num_bins_used) {
-            k = next - b->origin;
-            i0 = (size_t)floor(k);
-            i1 = (size_t)ceil(k);
+            if (bin < num_bins_used) {
+                k = next - b->origin;
+                i0 = (size_t)floor(k);
+                i1 = (size_t)ceil(k);
 
-            v = (i0 == i1) ? values[b->base + i0]
-                           : values[b->base + i0] * (i1 - k) +
-                                 values[b->base + i1] * (k - i0);
+                v = (i0 == i1) ? values[b->base + i0]
+                               : values[b->base + i0] * (i1 - k) +
+                                     values[b->base + i1] * (k - i0);
+            }
+            else
+                v = max;
         }
-        else
-            v = max;
 
         if (recode)
             fprintf(stdout, "%f:%f:%i\n", prev_v, v, quant + 1);
@@ -281,13 +393,14 @@ int main(int argc, char *argv[])
 {
     struct GModule *module;
     struct {
-        struct Option *input, *quant, *perc, *slots, *file;
+        struct Option *input, *quant, *perc, *slots, *error, *file, *nprocs;
     } opt;
     struct {
-        struct Flag *r;
+        struct Flag *r, *a;
     } flag;
-    int recode;
-    int infile;
+    int recode, approx;
+    int *infile;
+    int t;
     struct FPRange range;
     int num_slots_max;
 
@@ -299,7 +412,8 @@ int main(int argc, char *argv[])
     G_add_keyword(_("statistics"));
     G_add_keyword(_("percentile"));
     G_add_keyword(_("quantile"));
-    module->description = _("Compute quantiles using two passes.");
+    module->description =
+        _("Compute quantiles using two passes or approximately in one pass.");
 
     opt.input = G_define_standard_option(G_OPT_R_INPUT);
 
@@ -324,6 +438,18 @@ int main(int argc, char *argv[])
     opt.slots->description = _("Number of bins to use");
     opt.slots->answer = "1000000";
 
+    opt.error = G_define_option();
+    opt.error->key = "error";
+    opt.error->type = TYPE_DOUBLE;
+    opt.error->required = NO;
+    opt.error->label = _("Rank error of approximate quantiles");
+    opt.error->description =
+        _("Fraction of the number of cells, requires the -a flag");
+    opt.error->options = "0.00001-0.1";
+    opt.error->answer = "0.001";
+
+    opt.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     opt.file = G_define_standard_option(G_OPT_F_OUTPUT);
     opt.file->key = "file";
     opt.file->required = NO;
@@ -335,11 +461,21 @@ int main(int argc, char *argv[])
     flag.r->description =
         _("Generate recode rules based on quantile-defined intervals");
 
+    flag.a = G_define_flag();
+    flag.a->key = 'a';
+    flag.a->description =
+        _("Compute approximate quantiles in one pass with bounded memory");
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
     num_slots = atoi(opt.slots->answer);
     recode = flag.r->answer;
+    approx = flag.a->answer;
+    nprocs = G_set_omp_num_threads(opt.nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
+    if (nprocs < 1)
+        G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
 
     if (opt.file->answer != NULL && strcmp(opt.file->answer, "-") != 0) {
         if (NULL == freopen(opt.file->answer, "w", stdout)) {
@@ -371,7 +507,10 @@ int main(int argc, char *argv[])
     if (num_quants > 65535)
         G_fatal_error(_("Too many quantiles"));
 
-    infile = Rast_open_old(opt.input->answer, "");
+    infile = G_malloc(nprocs * sizeof(int));
+    infile[0] = Rast_open_old(opt.input->answer, "");
+    for (t = 1; t < nprocs; t++)
+        infile[t] = Rast_open_old_dup(infile[0]);
 
     Rast_read_fp_range(opt.input->answer, "", &range);
     Rast_get_fp_range_min_max(&range, &min, &max);
@@ -379,6 +518,16 @@ int main(int argc, char *argv[])
     rows = Rast_window_rows();
     cols = Rast_window_cols();
 
+    if (approx) {
+        fill_sketch(infile, atof(opt.error->answer));
+        for (t = 0; t < nprocs; t++)
+            Rast_close(infile[t]);
+        compute_quantiles(recode, approx);
+        quantile_sketch_free(&sketch);
+
+        return (EXIT_SUCCESS);
+    }
+
     /* minimum 1000 values per slot to reduce memory consumption */
     num_slots_max = ((size_t)rows * cols) / 1000;
     if (num_slots_max < 1)
@@ -405,11 +554,12 @@ int main(int argc, char *argv[])
     values = G_calloc(num_values, sizeof(DCELL));
     fill_bins(infile);
 
-    Rast_close(infile);
+    for (t = 0; t < nprocs; t++)
+        Rast_close(infile[t]);
     G_free(slot_bins);
 
     sort_bins();
-    compute_quantiles(recode);
+    compute_quantiles(recode, approx);
 
     return (EXIT_SUCCESS);
 }
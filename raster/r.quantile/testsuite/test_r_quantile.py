@@ -0,0 +1,103 @@
+"""Test of r.quantile
+
+Exact quantiles must not depend on the number of threads. Approximate
+quantiles of -a must lie between the exact quantiles at the requested
+quantile minus and plus the rank error.
+
+@copyright 2026 by the GRASS Development Team
+
+@license This program is free software under the GNU General Public License (>=v2).
+Read the file COPYING that comes with GRASS
+for details
+"""
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.gmodules import SimpleModule
+from grass.gunittest.main import test
+
+PERCENTILES = [1, 5, 10, 25, 50, 75, 90, 95, 99]
+# values are printed with 6 decimals
+PRINT_PRECISION = 1e-6
+
+
+class TestQuantile(TestCase):
+    """Quantiles of a floating point map, a map with many equal values
+    and a map with nulls"""
+
+    maps = ["test_quantile_float", "test_quantile_ties", "test_quantile_nulls"]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=300, s=0, e=300, w=0, res=1)
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.maps[0]} = double((row() * 7919 + col() * 104729) % 10007)"
+                " / 100 + sin(row() * 3) * 20 + col() * 0.1"
+            ),
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=f"{cls.maps[1]} = (row() * 13 + col() * 17) % 23",
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.maps[2]} = if((row() + col() * 3) % 5 == 0 || row() < 40,"
+                f" null(), {cls.maps[0]})"
+            ),
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.maps)
+
+    def percentiles(self, name, percentiles, **kwargs):
+        """Return the percentile values computed by r.quantile"""
+        module = SimpleModule(
+            "r.quantile", input=name, percentiles=percentiles, **kwargs
+        )
+        self.assertModule(module)
+        lines = module.outputs.stdout.strip().splitlines()
+        self.assertEqual(len(lines), len(percentiles))
+        return [float(line.split(":")[2]) for line in lines]
+
+    def test_exact_threads(self):
+        """Exact quantiles are the same with 1 and 4 threads"""
+        for name in self.maps:
+            single = self.percentiles(name, PERCENTILES, nprocs=1)
+            threaded = self.percentiles(name, PERCENTILES, nprocs=4)
+            self.assertEqual(single, threaded, msg=name)
+            self.assertEqual(single, sorted(single), msg=name)
+
+    def test_approximate_within_error(self):
+        """Approximate quantiles are within the rank error of exact ones"""
+        for error in (0.01, 0.001):
+            # the exact quantiles interpolate between ranks, allow a
+            # tenth of the error for that
+            margin = 100 * error * 1.1
+            lower = [max(p - margin, 0) for p in PERCENTILES]
+            upper = [min(p + margin, 100) for p in PERCENTILES]
+            for name in self.maps:
+                low = self.percentiles(name, lower)
+                high = self.percentiles(name, upper)
+                for nprocs in (1, 4):
+                    values = self.percentiles(
+                        name, PERCENTILES, flags="a", error=error, nprocs=nprocs
+                    )
+                    for p, value, low_value, high_value in zip(
+                        PERCENTILES, values, low, high
+                    ):
+                        msg = f"{name} percentile {p} error {error} nprocs {nprocs}"
+                        self.assertGreaterEqual(
+                            value, low_value - PRINT_PRECISION, msg=msg
+                        )
+                        self.assertLessEqual(
+                            value, high_value + PRINT_PRECISION, msg=msg
+                        )
+
+
+if __name__ == "__main__":
+    test()
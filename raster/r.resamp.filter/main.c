@@ -483,7 +483,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
 
     nprocs = G_set_omp_num_threads(parm.nprocs);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
     if (nprocs < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
 
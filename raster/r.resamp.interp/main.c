@@ -121,7 +121,7 @@ int main(int argc, char *argv[])
     G_get_set_window(&dst_w);
 
     threads = G_set_omp_num_threads(nprocs);
-    threads = Rast_disable_omp_on_mask(threads);
+    threads = Rast_set_mask_threads(threads);
     if (threads < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), threads);
 
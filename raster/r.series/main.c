@@ -220,7 +220,7 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
 
     nprocs = G_set_omp_num_threads(parm.nprocs);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
     if (nprocs < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
 #if defined(_OPENMP)
@@ -302,7 +302,12 @@ int main(int argc, char *argv[])
                 G_verbose_message(
                     _("Reading raster map <%s> using weight %f..."), p->name,
                     p->weight);
-                p->fd = Rast_open_old(p->name, "");
+                /* other threads read through their own descriptor, sharing
+                   the row index and the quant/reclass tables */
+                if (t == 0 || flag.lazy->answer)
+                    p->fd = Rast_open_old(p->name, "");
+                else
+                    p->fd = Rast_open_old_dup(inputs[0][num_inputs].fd);
                 if (p->fd < 0)
                     G_fatal_error(_("Unable to open input raster <%s>"),
                                   p->name);
@@ -370,7 +375,10 @@ int main(int argc, char *argv[])
                 G_verbose_message(
                     _("Reading raster map <%s> using weight %f..."), p->name,
                     p->weight);
-                p->fd = Rast_open_old(p->name, "");
+                if (t == 0 || flag.lazy->answer)
+                    p->fd = Rast_open_old(p->name, "");
+                else
+                    p->fd = Rast_open_old_dup(inputs[0][i].fd);
                 if (p->fd < 0)
                     G_fatal_error(_("Unable to open input raster <%s>"),
                                   p->name);
@@ -1,23 +1,40 @@
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <stdlib.h>
 #include <grass/gjson.h>
 #include <grass/glocale.h>
 #include "global.h"
 
-int cell_stats(int fd[], int with_percents, int with_counts, int with_areas,
-               int do_sort, int with_labels, char *fmt,
+int cell_stats(int fd[], int nprocs, int with_percents, int with_counts,
+               int with_areas, int do_sort, int with_labels, char *fmt,
                enum OutputFormat format, G_JSON_Array *root_array)
 {
     CELL **cell;
-    int i;
-    int row;
+    CELL **key;
+    int *in_fd;
+    struct cell_table *tables;
+    int i, t;
+    int row, computed;
     double unit_area;
+    double *row_area;
     int planimetric = 0;
     int compute_areas;
 
-    /* allocate i/o buffers for each raster map */
-    cell = (CELL **)G_calloc(nfiles, sizeof(CELL *));
-    for (i = 0; i < nfiles; i++)
-        cell[i] = Rast_allocate_c_buf();
+    /* input maps and i/o buffers for each thread */
+    in_fd = (int *)G_malloc(nprocs * nfiles * sizeof(int));
+    cell = (CELL **)G_calloc(nprocs * nfiles, sizeof(CELL *));
+    key = (CELL **)G_calloc(nprocs, sizeof(CELL *));
+    tables = G_malloc(nprocs * sizeof(struct cell_table));
+    for (t = 0; t < nprocs; t++) {
+        for (i = 0; i < nfiles; i++) {
+            in_fd[t * nfiles + i] = t ? Rast_open_old_dup(fd[i]) : fd[i];
+            cell[t * nfiles + i] = Rast_allocate_c_buf();
+        }
+        key[t] = G_malloc(nfiles * sizeof(CELL));
+        cell_table_init(&tables[t], nfiles, 0);
+    }
 
     /* if we want area totals, set this up.
      * distinguish projections which are planimetric (all cells same size)
@@ -37,41 +54,66 @@ int cell_stats(int fd[], int with_percents, int with_counts, int with_areas,
         }
     }
     compute_areas = with_areas && !planimetric;
+    row_area = (double *)G_malloc(nrows * sizeof(double));
+    for (row = 0; row < nrows; row++)
+        row_area[row] = compute_areas ? G_area_of_cell_at_row(row) : unit_area;
 
     /* here we go */
     initialize_cell_stats(nfiles);
 
+    /* each thread counts its rows in its own table */
+    computed = 0;
+    t = 0;
+#pragma omp parallel for schedule(static) private(i, t)
     for (row = 0; row < nrows; row++) {
-        if (compute_areas)
-            unit_area = G_area_of_cell_at_row(row);
+        CELL **row_cell;
 
-        G_percent(row, nrows, 2);
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        row_cell = &cell[t * nfiles];
 
         for (i = 0; i < nfiles; i++) {
-            Rast_get_c_row(fd[i], cell[i], row);
+            Rast_get_c_row(in_fd[t * nfiles + i], row_cell[i], row);
 
             /* include max FP value in nsteps'th bin */
             if (is_fp[i])
-                fix_max_fp_val(cell[i], ncols);
+                fix_max_fp_val(row_cell[i], ncols);
 
             /* we can't compute hash on null values, so we change all
                nulls to max+1, set NULL_CELL to max+1, and later compare
                with NULL_CELL to check for nulls */
-            reset_null_vals(cell[i], ncols);
+            reset_null_vals(row_cell[i], ncols);
         }
 
-        update_cell_stats(cell, ncols, unit_area);
+        update_cell_stats(&tables[t], row_cell, key[t], ncols, row_area[row]);
+
+#pragma omp atomic update
+        computed++;
+        G_percent(computed, nrows, 2);
     }
 
-    G_percent(row, nrows, 2);
+    for (t = 0; t < nprocs; t++) {
+        merge_cell_stats(&tables[t]);
+        cell_table_free(&tables[t]);
+    }
 
     sort_cell_stats(do_sort);
     print_cell_stats(fmt, with_percents, with_counts, with_areas, with_labels,
                      fs, format, root_array);
-    for (i = 0; i < nfiles; i++) {
-        G_free(cell[i]);
+    for (t = 0; t < nprocs; t++) {
+        for (i = 0; i < nfiles; i++) {
+            if (t)
+                Rast_close(in_fd[t * nfiles + i]);
+            G_free(cell[t * nfiles + i]);
+        }
+        G_free(key[t]);
     }
     G_free(cell);
+    G_free(key);
+    G_free(tables);
+    G_free(row_area);
+    G_free(in_fd);
 
     return 0;
 }
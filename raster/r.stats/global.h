@@ -1,6 +1,7 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/gjson.h>
+#include <grass/stats.h>
 
 #define SORT_DEFAULT 0
 #define SORT_ASC     1
@@ -23,7 +24,7 @@ extern char *fs;
 extern struct Categories *labels;
 
 /* cell_stats.c */
-int cell_stats(int[], int, int, int, int, int, char *, enum OutputFormat,
+int cell_stats(int[], int, int, int, int, int, int, char *, enum OutputFormat,
                G_JSON_Array *);
 
 /* raw_stats.c */
@@ -31,11 +32,10 @@ int raw_stats(int[], int, int, int, enum OutputFormat, G_JSON_Array *);
 
 /* stats.c */
 int initialize_cell_stats(int);
-int allocate_values(void);
-struct Node *NewNode(double);
 void fix_max_fp_val(CELL *, int);
 void reset_null_vals(CELL *, int);
-int update_cell_stats(CELL **, int, double);
+int update_cell_stats(struct cell_table *, CELL **, CELL *, int, double);
+int merge_cell_stats(const struct cell_table *);
 int sort_cell_stats(int);
 int print_node_count(void);
 int print_cell_stats(char *, int, int, int, int, char *, enum OutputFormat,
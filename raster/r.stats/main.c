@@ -57,6 +57,7 @@ int main(int argc, char *argv[])
     int with_areas;
     int with_labels;
     int do_sort;
+    int nprocs;
 
     enum OutputFormat format;
     G_JSON_Array *root_array;
@@ -102,6 +103,7 @@ int main(int argc, char *argv[])
                                   is int, nsteps is ignored */
         struct Option *sort;   /* sort by cell counts */
         struct Option *format;
+        struct Option *nprocs;
     } option;
 
     G_gisinit(argv[0]);
@@ -159,6 +161,8 @@ int main(int argc, char *argv[])
                                    "json;JSON (JavaScript Object Notation);");
     option.format->guisection = _("Print");
 
+    option.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
+
     /* Define the different flags */
 
     flag.a = G_define_flag();
@@ -241,6 +245,10 @@ int main(int argc, char *argv[])
         }
     }
 
+    nprocs = G_set_omp_num_threads(option.nprocs);
+    if (nprocs < 1)
+        G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
+
     sscanf(option.nsteps->answer, "%d", &nsteps);
     if (nsteps <= 0) {
         G_warning(_("'%s' must be greater than zero; using %s=255"),
@@ -417,7 +425,7 @@ int main(int argc, char *argv[])
         raw_stats(fd, with_coordinates, with_xy, with_labels, format,
                   root_array);
     else
-        cell_stats(fd, with_percents, with_counts, with_areas, do_sort,
+        cell_stats(fd, nprocs, with_percents, with_counts, with_areas, do_sort,
                    with_labels, fmt, format, root_array);
 
     if (format == JSON) {
@@ -3,91 +3,20 @@
 
 #include <grass/gjson.h>
 
-/* hash definitions (these should be prime numbers) ************* */
-#define HASHSIZE 7307
-#define HASHMOD  89
-
-static CELL *values;
-static struct Node *node_pool;
-static int node_pool_count;
-static CELL *value_pool;
-static int value_pool_count;
-
-#define NODE_INCR  32
-#define VALUE_INCR 32
-
-static struct Node **sorted_list;
-
-struct Node {
-    CELL *values;
-    struct Node *left;
-    struct Node *right;
-    struct Node *list;
-    long count;
-    double area;
-};
-
-static struct Node **hashtable;
-static struct Node *node_list = NULL;
-static int node_count = 0;
+static struct cell_table table;
+static int *sorted_list;
 static long total_count = 0;
 
 int initialize_cell_stats(int n)
 {
-    int i;
-
-    /* record nilfes first */
+    /* record nfiles first */
     nfiles = n;
 
-    /* allocate a pool of value arrays */
-    value_pool_count = 0;
-    allocate_values();
-
-    /* set Node pool to empty */
-    node_pool_count = 0;
-
-    /* empty the has table */
-    hashtable = (struct Node **)G_malloc(HASHSIZE * sizeof(struct Node *));
-    for (i = 0; i < HASHSIZE; i++)
-        hashtable[i] = NULL;
+    cell_table_init(&table, nfiles, 0);
 
     return 0;
 }
 
-int allocate_values(void)
-{
-    value_pool_count = VALUE_INCR;
-    value_pool = (CELL *)G_calloc(nfiles * value_pool_count, sizeof(CELL));
-    values = value_pool;
-
-    return 0;
-}
-
-struct Node *NewNode(double area)
-{
-    struct Node *node;
-
-    if (node_pool_count <= 0)
-        node_pool = (struct Node *)G_calloc(node_pool_count = NODE_INCR,
-                                            sizeof(struct Node));
-    node = &node_pool[--node_pool_count];
-    node->count = 1;
-    node->area = area;
-    node->values = values;
-
-    if (--value_pool_count <= 0)
-        allocate_values();
-    else
-        values += nfiles;
-
-    node->left = node->right = NULL;
-    node->list = node_list;
-    node_list = node;
-    node_count++;
-
-    return node;
-}
-
 /* Essentially, Rast_quant_add_rule() treats the ranges as half-open,
  *  i.e. the values range from low (inclusive) to high (exclusive).
  *  While half-open ranges are a common concept (e.g. floor() behaves
@@ -117,139 +46,85 @@ void reset_null_vals(CELL *cell, int ncols)
     return;
 }
 
-int update_cell_stats(CELL **cell, int ncols, double area)
+/* add the cells of a row to the table of one thread,
+ * key is a buffer of nfiles values */
+int update_cell_stats(struct cell_table *t, CELL **cell, CELL *key, int ncols,
+                      double area)
 {
-    register int i;
-    register int hash;
-    register struct Node *q, *p = NULL;
-    register int dir = 0;
-
-    while (ncols-- > 0) {
-        /* copy this cell to an array, compute hash */
-
-        hash = values[0] = cell[0][ncols];
-
-        for (i = 1; i < nfiles; i++)
-            hash = hash * HASHMOD + (values[i] = cell[i][ncols]);
-
-        if (hash < 0)
-            hash = -hash;
-
-        hash %= HASHSIZE;
-
-        /* look it up and update/insert */
-        if ((q = hashtable[hash]) == NULL) {
-            hashtable[hash] = NewNode(area);
+    int i, col, same;
+    int e = -1;
+
+    for (col = 0; col < ncols; col++) {
+        /* neighboring cells often have the same values */
+        same = e >= 0;
+        for (i = 0; i < nfiles; i++) {
+            if (key[i] != cell[i][col]) {
+                key[i] = cell[i][col];
+                same = 0;
+            }
         }
-        else {
-            while (1) {
-                for (i = 0; i < nfiles; i++) {
-                    if (values[i] < q->values[i]) {
-                        dir = -1;
-                        p = q->left;
-                        break;
-                    }
-                    if (values[i] > q->values[i]) {
-                        dir = 1;
-                        p = q->right;
-                        break;
-                    }
-                }
 
-                if (i == nfiles) { /* match */
-                    q->count++;
-                    q->area += area;
-                    total_count++;
-                    break;
-                }
-                else if (p == NULL) {
-                    if (dir < 0)
-                        q->left = NewNode(area);
-                    else
-                        q->right = NewNode(area);
-                    break;
-                }
-                else
-                    q = p;
-            }
+        if (same) {
+            t->counts[e]++;
+            t->areas[e] += area;
         }
+        else
+            e = cell_table_add(t, key, area);
     }
 
     return 0;
 }
 
-static int node_compare(const void *pp, const void *qq)
+/* add the table of one thread to the totals */
+int merge_cell_stats(const struct cell_table *t)
 {
-    struct Node *const *p = pp, *const *q = qq;
-    register int i;
-    register const CELL *a, *b;
-
-    a = (*p)->values;
-    b = (*q)->values;
-    for (i = nfiles; --i >= 0;) {
-        if (*a < *b)
-            return -1;
-        else if (*a > *b)
-            return 1;
-        a++, b++;
-    }
+    cell_table_merge(&table, t);
 
     return 0;
 }
 
-static int node_compare_count_asc(const void *pp, const void *qq)
+static int compare_count_asc(const struct cell_table *t, int a, int b)
 {
-    struct Node *const *p = pp, *const *q = qq;
-    long a, b;
+    if (t->counts[a] != t->counts[b])
+        return t->counts[a] < t->counts[b] ? -1 : 1;
 
-    a = (*p)->count;
-    b = (*q)->count;
-
-    if (a < b)
-        return -1;
-    return (a > b);
+    return cell_table_compare_keys(t, a, b);
 }
 
-static int node_compare_count_desc(const void *pp, const void *qq)
+static int compare_count_desc(const struct cell_table *t, int a, int b)
 {
-    struct Node *const *p = pp, *const *q = qq;
-    long a, b;
-
-    a = (*p)->count;
-    b = (*q)->count;
+    if (t->counts[a] != t->counts[b])
+        return t->counts[a] > t->counts[b] ? -1 : 1;
 
-    if (a > b)
-        return -1;
-    return (a < b);
+    return cell_table_compare_keys(t, a, b);
 }
 
 int sort_cell_stats(int do_sort)
 {
-    struct Node **q, *p;
+    int i;
 
-    if (node_count <= 0)
+    if (table.n <= 0)
         return 0;
 
-    G_free(hashtable); /* make a bit more room */
-    sorted_list = (struct Node **)G_calloc(node_count, sizeof(struct Node *));
-    for (q = sorted_list, p = node_list; p; p = p->list)
-        *q++ = p;
+    /* the first cell of each combination has never been counted in the
+       total of the percentages */
+    total_count = -table.n;
+    for (i = 0; i < table.n; i++)
+        total_count += table.counts[i];
 
-    if (do_sort == SORT_DEFAULT)
-        qsort(sorted_list, node_count, sizeof(struct Node *), node_compare);
-    else if (do_sort == SORT_ASC)
-        qsort(sorted_list, node_count, sizeof(struct Node *),
-              node_compare_count_asc);
+    if (do_sort == SORT_ASC)
+        sorted_list = cell_table_sort(&table, compare_count_asc);
     else if (do_sort == SORT_DESC)
-        qsort(sorted_list, node_count, sizeof(struct Node *),
-              node_compare_count_desc);
+        sorted_list = cell_table_sort(&table, compare_count_desc);
+    else
+        sorted_list = cell_table_sort(&table, cell_table_compare_keys);
 
     return 0;
 }
 
 int print_node_count(void)
 {
-    fprintf(stdout, "%d nodes\n", node_count);
+    fprintf(stdout, "%d nodes\n", table.n);
 
     return 0;
 }
@@ -258,8 +133,8 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                      int with_areas, int with_labels, char *fs,
                      enum OutputFormat format, G_JSON_Array *array)
 {
-    int i, n, nulls_found;
-    struct Node *node;
+    int i, n, e, nulls_found;
+    CELL *values;
     CELL tmp_cell, null_cell;
     DCELL dLow, dHigh;
     char str1[50], str2[50];
@@ -268,11 +143,11 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
     G_JSON_Array *categories;
     G_JSON_Value *object_value, *category_value, *categories_value;
 
-    if (no_nulls)
-        total_count -= sorted_list[node_count - 1]->count;
+    if (no_nulls && table.n > 0)
+        total_count -= table.counts[sorted_list[table.n - 1]];
 
     Rast_set_c_null_value(&null_cell, 1);
-    if (node_count <= 0) {
+    if (table.n <= 0) {
         if (format == CSV) {
             /* CSV Header */
             for (i = 0; i < nfiles; i++) {
@@ -343,7 +218,7 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
             fprintf(stdout, "\n");
         }
 
-        for (n = 0; n < node_count; n++) {
+        for (n = 0; n < table.n; n++) {
             if (format == JSON) {
                 object_value = G_json_value_init_object();
                 object = G_json_object(object_value);
@@ -351,16 +226,17 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                 categories = G_json_array(categories_value);
             }
 
-            node = sorted_list[n];
+            e = sorted_list[n];
+            values = &table.keys[(size_t)e * nfiles];
 
             if (no_nulls || no_nulls_all) {
                 nulls_found = 0;
                 for (i = 0; i < nfiles; i++)
                     /*
-                       if (node->values[i] || (!raw_output && is_fp[i]))
+                       if (values[i] || (!raw_output && is_fp[i]))
                        break;
                      */
-                    if (node->values[i] == NULL_CELL)
+                    if (values[i] == NULL_CELL)
                         nulls_found++;
 
                 if (nulls_found == nfiles)
@@ -375,7 +251,7 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                     category_value = G_json_value_init_object();
                     category = G_json_object(category_value);
                 }
-                if (node->values[i] == NULL_CELL) {
+                if (values[i] == NULL_CELL) {
                     switch (format) {
                     case JSON:
                         if (raw_output || !is_fp[i] || as_int)
@@ -409,46 +285,40 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                     switch (format) {
                     case JSON:
                         G_json_object_set_number(category, "category",
-                                                 (long)node->values[i]);
+                                                 (long)values[i]);
                         if (with_labels && !is_fp[i]) {
                             G_json_object_set_string(
                                 category, "label",
-                                Rast_get_c_cat((CELL *)&(node->values[i]),
-                                               &labels[i]));
+                                Rast_get_c_cat(&values[i], &labels[i]));
                         }
                         break;
                     case CSV:
-                        fprintf(stdout, "%s%ld", i ? fs : "",
-                                (long)node->values[i]);
+                        fprintf(stdout, "%s%ld", i ? fs : "", (long)values[i]);
                         if (with_labels)
                             fprintf(stdout, "%s%s", fs,
-                                    !is_fp[i] ? Rast_get_c_cat(
-                                                    (CELL *)&(node->values[i]),
-                                                    &labels[i])
+                                    !is_fp[i] ? Rast_get_c_cat(&values[i],
+                                                               &labels[i])
                                               : no_data_str);
                         break;
                     case PLAIN:
-                        fprintf(stdout, "%s%ld", i ? fs : "",
-                                (long)node->values[i]);
+                        fprintf(stdout, "%s%ld", i ? fs : "", (long)values[i]);
                         if (with_labels && !is_fp[i])
                             fprintf(stdout, "%s%s", fs,
-                                    Rast_get_c_cat((CELL *)&(node->values[i]),
-                                                   &labels[i]));
+                                    Rast_get_c_cat(&values[i], &labels[i]));
                         break;
                     }
                 }
                 else { /* find out which floating point range to print */
 
                     if (cat_ranges)
-                        Rast_quant_get_ith_rule(&labels[i].q, node->values[i],
-                                                &dLow, &dHigh, &tmp_cell,
-                                                &tmp_cell);
+                        Rast_quant_get_ith_rule(&labels[i].q, values[i], &dLow,
+                                                &dHigh, &tmp_cell, &tmp_cell);
                     else {
                         dLow = (DMAX[i] - DMIN[i]) / nsteps *
-                                   (double)(node->values[i] - 1) +
+                                   (double)(values[i] - 1) +
                                DMIN[i];
                         dHigh = (DMAX[i] - DMIN[i]) / nsteps *
-                                    (double)node->values[i] +
+                                    (double)values[i] +
                                 DMIN[i];
                     }
                     if (averaged) {
@@ -495,7 +365,7 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                             if (cat_ranges) {
                                 G_json_object_set_string(
                                     category, "label",
-                                    labels[i].labels[node->values[i]]);
+                                    labels[i].labels[values[i]]);
                             }
                             else {
                                 G_json_object_dotset_string(
@@ -512,7 +382,7 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
                         if (with_labels) {
                             if (cat_ranges)
                                 fprintf(stdout, "%s%s", fs,
-                                        labels[i].labels[node->values[i]]);
+                                        labels[i].labels[values[i]]);
                             else
                                 fprintf(stdout, "%sfrom %s to %s", fs,
                                         Rast_get_d_cat(&dLow, &labels[i]),
@@ -534,28 +404,28 @@ int print_cell_stats(char *fmt, int with_percents, int with_counts,
             if (with_areas) {
                 switch (format) {
                 case JSON:
-                    G_json_object_set_number(object, "area", node->area);
+                    G_json_object_set_number(object, "area", table.areas[e]);
                     break;
                 case CSV:
                 case PLAIN:
                     fprintf(stdout, "%s", fs);
-                    fprintf(stdout, fmt, node->area);
+                    fprintf(stdout, fmt, table.areas[e]);
                     break;
                 }
             }
             if (with_counts) {
                 switch (format) {
                 case JSON:
-                    G_json_object_set_number(object, "count", node->count);
+                    G_json_object_set_number(object, "count", table.counts[e]);
                     break;
                 case CSV:
                 case PLAIN:
-                    fprintf(stdout, "%s%ld", fs, (long)node->count);
+                    fprintf(stdout, "%s%ld", fs, (long)table.counts[e]);
                     break;
                 }
             }
             if (with_percents) {
-                double percent = (double)100 * node->count / total_count;
+                double percent = (double)100 * table.counts[e] / total_count;
                 switch (format) {
                 case JSON:
                     G_json_object_set_number(object, "percent", percent);
@@ -118,6 +118,28 @@ class TestRStats(TestCase):
         actual_output = rstats_module.outputs.stdout.splitlines()
         self.assertEqual(actual_output, expected_output)
 
+    def test_cross_tabulation_threads_output(self):
+        """Verify that r.stats with several threads produces the same cross-tabulation."""
+        rstats_module = SimpleModule(
+            "r.stats",
+            input=[self.test_raster_1, self.test_raster_2],
+            flags="cp",
+            separator="comma",
+            nprocs=4,
+        )
+        self.assertModule(rstats_module)
+
+        expected_output = [
+            "1,1,5,25.00%",
+            "2,2,5,25.00%",
+            "2,3,5,25.00%",
+            "2,4,5,25.00%",
+            "2,*,5,25.00%",
+        ]
+
+        actual_output = rstats_module.outputs.stdout.splitlines()
+        self.assertEqual(actual_output, expected_output)
+
     def test_area_calculation_flag_output(self):
         """Verify that r.stats with the -a flag returns correct area calculations using pipe as a separator."""
         rstats_module = SimpleModule(
@@ -57,7 +57,7 @@ int close_streamvect(char *stream_vect)
         G_percent(i, n_outlets, 2);
         r = outlets[i].r;
         c = outlets[i].c;
-        cseg_get(&stream, &stream_id, r, c);
+        Seggrid_get(&stream, &stream_id, r, c);
 
         if (!stream_id)
             continue;
@@ -116,7 +116,7 @@ int close_streamvect(char *stream_vect)
                 r_nbr = stream_node[stream_id].r;
                 c_nbr = stream_node[stream_id].c;
 
-                cseg_get(&stream, &stream_nbr, r_nbr, c_nbr);
+                Seggrid_get(&stream, &stream_nbr, r_nbr, c_nbr);
                 if (stream_nbr <= 0)
                     G_fatal_error(
                         _("Stream id %d not set, top is %d, parent is %d"),
@@ -133,12 +133,12 @@ int close_streamvect(char *stream_vect)
 
                 Vect_write_line(&Out, GV_POINT, Points, Cats);
 
-                seg_get(&aspflag, (char *)&af, r_nbr, c_nbr);
+                Seggrid_get(&aspflag, &af, r_nbr, c_nbr);
                 while (af.asp > 0) {
                     r_nbr = r_nbr + asp_r[(int)af.asp];
                     c_nbr = c_nbr + asp_c[(int)af.asp];
 
-                    cseg_get(&stream, &stream_nbr, r_nbr, c_nbr);
+                    Seggrid_get(&stream, &stream_nbr, r_nbr, c_nbr);
                     if (stream_nbr <= 0)
                         G_fatal_error(_("Stream id not set while tracing"));
 
@@ -148,7 +148,7 @@ int close_streamvect(char *stream_vect)
                         /* first point of parent stream */
                         break;
                     }
-                    seg_get(&aspflag, (char *)&af, r_nbr, c_nbr);
+                    Seggrid_get(&aspflag, &af, r_nbr, c_nbr);
                 }
 
                 Vect_write_line(&Out, GV_LINE, Points, Cats);
@@ -272,12 +272,12 @@ int close_maps(char *stream_rast, char *stream_vect, char *dir_rast)
 
         for (c = 0; c < ncols; c++) {
             if (stream_rast) {
-                cseg_get(&stream, &stream_id, r, c);
+                Seggrid_get(&stream, &stream_id, r, c);
                 if (stream_id)
                     cell_buf1[c] = stream_id;
             }
             if (dir_rast) {
-                seg_get(&aspflag, (char *)&af, r, c);
+                Seggrid_get(&aspflag, &af, r, c);
                 if (!FLAG_GET(af.flag, NULLFLAG)) {
                     cell_buf2[c] = af.asp;
                 }
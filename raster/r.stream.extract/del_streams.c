@@ -20,7 +20,7 @@ int seg_length(CELL stream_id, CELL *next_stream_id)
         *next_stream_id = stream_id;
 
     /* get next downstream point */
-    seg_get(&aspflag, (char *)&af, r, c);
+    Seggrid_get(&aspflag, &af, r, c);
     while (af.asp > 0) {
         r_nbr = r + asp_r[(int)af.asp];
         c_nbr = c + asp_c[(int)af.asp];
@@ -32,7 +32,7 @@ int seg_length(CELL stream_id, CELL *next_stream_id)
         if (r_nbr < 0 || r_nbr >= nrows || c_nbr < 0 || c_nbr >= ncols)
             break;
         /* next stream */
-        cseg_get(&stream, &curr_stream, r_nbr, c_nbr);
+        Seggrid_get(&stream, &curr_stream, r_nbr, c_nbr);
         if (next_stream_id)
             *next_stream_id = curr_stream;
         if (curr_stream != stream_id)
@@ -40,7 +40,7 @@ int seg_length(CELL stream_id, CELL *next_stream_id)
         slength++;
         r = r_nbr;
         c = c_nbr;
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
     }
 
     return slength;
@@ -58,14 +58,14 @@ int update_stream_id(CELL stream_id, CELL new_stream_id)
 
     r = stream_node[stream_id].r;
     c = stream_node[stream_id].c;
-    cseg_get(&stream, &curr_stream, r, c);
+    Seggrid_get(&stream, &curr_stream, r, c);
     if (curr_stream != stream_id)
         G_fatal_error("Update downstream id: curr_stream != stream_id");
-    cseg_put(&stream, &new_stream, r, c);
+    Seggrid_put(&stream, &new_stream, r, c);
     curr_stream = stream_id;
 
     /* get next downstream point */
-    seg_get(&aspflag, (char *)&af, r, c);
+    Seggrid_get(&aspflag, &af, r, c);
     while (af.asp > 0) {
         r_nbr = r + asp_r[(int)af.asp];
         c_nbr = c + asp_c[(int)af.asp];
@@ -77,13 +77,13 @@ int update_stream_id(CELL stream_id, CELL new_stream_id)
         if (r_nbr < 0 || r_nbr >= nrows || c_nbr < 0 || c_nbr >= ncols)
             break;
         /* next stream */
-        cseg_get(&stream, &curr_stream, r_nbr, c_nbr);
+        Seggrid_get(&stream, &curr_stream, r_nbr, c_nbr);
         if (curr_stream != stream_id)
             break;
         r = r_nbr;
         c = c_nbr;
-        cseg_put(&stream, &new_stream, r, c);
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&stream, &new_stream, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
     }
 
     if (curr_stream <= 0)
@@ -148,7 +148,7 @@ int del_streams(int min_length)
             continue;
 
         /* already deleted */
-        cseg_get(&stream, &curr_stream, stream_node[i].r, stream_node[i].c);
+        Seggrid_get(&stream, &curr_stream, stream_node[i].r, stream_node[i].c);
         if (curr_stream == 0)
             continue;
 
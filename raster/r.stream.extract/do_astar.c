@@ -87,11 +87,11 @@ int do_astar(void)
             if (r_nbr < 0 || r_nbr >= nrows || c_nbr < 0 || c_nbr >= ncols)
                 continue;
 
-            seg_get(&aspflag, (char *)&af, r_nbr, c_nbr);
+            Seggrid_get(&aspflag, &af, r_nbr, c_nbr);
             is_in_list = FLAG_GET(af.flag, INLISTFLAG);
             is_worked = FLAG_GET(af.flag, WORKEDFLAG);
             if (!is_worked) {
-                seg_get(&watalt, (char *)&wa, r_nbr, c_nbr);
+                Seggrid_get(&watalt, &wa, r_nbr, c_nbr);
                 ele_nbr[ct_dir] = wa.ele;
                 slope[ct_dir] =
                     get_slope(ele_val, ele_nbr[ct_dir], dist_to_nbr[ct_dir]);
@@ -120,7 +120,7 @@ int do_astar(void)
                     af.asp = drain[r_nbr - r + 1][c_nbr - c + 1];
                     heap_add(r_nbr, c_nbr, ele_up);
                     FLAG_SET(af.flag, INLISTFLAG);
-                    seg_put(&aspflag, (char *)&af, r_nbr, c_nbr);
+                    Seggrid_put(&aspflag, &af, r_nbr, c_nbr);
                 }
                 else if (!is_worked) {
                     if (FLAG_GET(af.flag, EDGEFLAG)) {
@@ -128,7 +128,7 @@ int do_astar(void)
                         if (af.asp < 0 && slope[ct_dir] > 0) {
                             /* adjust flow direction for edge cell */
                             af.asp = drain[r_nbr - r + 1][c_nbr - c + 1];
-                            seg_put(&aspflag, (char *)&af, r_nbr, c_nbr);
+                            Seggrid_put(&aspflag, &af, r_nbr, c_nbr);
                         }
                     }
                     else if (FLAG_GET(af.flag, DEPRFLAG)) {
@@ -138,7 +138,7 @@ int do_astar(void)
                         if (af.asp == 0 && ele_val <= ele_nbr[ct_dir]) {
                             af.asp = drain[r_nbr - r + 1][c_nbr - c + 1];
                             FLAG_UNSET(af.flag, DEPRFLAG);
-                            seg_put(&aspflag, (char *)&af, r_nbr, c_nbr);
+                            Seggrid_put(&aspflag, &af, r_nbr, c_nbr);
                         }
                     }
                 }
@@ -147,10 +147,10 @@ int do_astar(void)
         /* add astar points to sorted list for flow accumulation and stream
          * extraction */
         first_cum--;
-        seg_put(&astar_pts, (char *)&heap_p.pnt, 0, first_cum);
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&astar_pts, &heap_p.pnt, 0, first_cum);
+        Seggrid_get(&aspflag, &af, r, c);
         FLAG_SET(af.flag, WORKEDFLAG);
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
     } /* end A* search */
 
     G_percent(n_points, n_points, 1); /* finish it */
@@ -182,11 +182,11 @@ static int sift_up(GW_LARGE_INT start, HEAP_PNT child_p)
 
     while (child > 1) {
         parent = GET_PARENT(child);
-        seg_get(&search_heap, (char *)&heap_p, 0, parent);
+        Seggrid_get(&search_heap, &heap_p, 0, parent);
 
         /* push parent point down if child is smaller */
         if (heap_cmp(&child_p, &heap_p)) {
-            seg_put(&search_heap, (char *)&heap_p, 0, child);
+            Seggrid_put(&search_heap, &heap_p, 0, child);
             child = parent;
         }
         else
@@ -195,7 +195,7 @@ static int sift_up(GW_LARGE_INT start, HEAP_PNT child_p)
     }
 
     /* add child to heap */
-    seg_put(&search_heap, (char *)&child_p, 0, child);
+    Seggrid_put(&search_heap, &child_p, 0, child);
 
     return 0;
 }
@@ -235,8 +235,8 @@ HEAP_PNT heap_drop(void)
     GW_LARGE_INT i;
     HEAP_PNT child_p, childr_p, last_p, root_p;
 
-    seg_get(&search_heap, (char *)&last_p, 0, heap_size);
-    seg_get(&search_heap, (char *)&root_p, 0, 1);
+    Seggrid_get(&search_heap, &last_p, 0, heap_size);
+    Seggrid_get(&search_heap, &root_p, 0, 1);
 
     if (heap_size == 1) {
         heap_size = 0;
@@ -246,13 +246,13 @@ HEAP_PNT heap_drop(void)
     parent = 1;
     while ((child = GET_CHILD(parent)) < heap_size) {
 
-        seg_get(&search_heap, (char *)&child_p, 0, child);
+        Seggrid_get(&search_heap, &child_p, 0, child);
 
         if (child < heap_size) {
             childr = child + 1;
             i = child + 8;
             while (childr < heap_size && childr < i) {
-                seg_get(&search_heap, (char *)&childr_p, 0, childr);
+                Seggrid_get(&search_heap, &childr_p, 0, childr);
                 if (heap_cmp(&childr_p, &child_p)) {
                     child = childr;
                     child_p = childr_p;
@@ -266,13 +266,13 @@ HEAP_PNT heap_drop(void)
         }
 
         /* move hole down */
-        seg_put(&search_heap, (char *)&child_p, 0, parent);
+        Seggrid_put(&search_heap, &child_p, 0, parent);
         parent = child;
     }
 
     /* fill hole */
     if (parent < heap_size) {
-        seg_put(&search_heap, (char *)&last_p, 0, parent);
+        Seggrid_put(&search_heap, &last_p, 0, parent);
     }
 
     /* the actual drop */
@@ -32,7 +32,7 @@ int init_search(int depr_fd)
 
         for (c = 0; c < ncols; c++) {
 
-            seg_get(&aspflag, (char *)&af, r, c);
+            Seggrid_get(&aspflag, &af, r, c);
             is_null = FLAG_GET(af.flag, NULLFLAG);
 
             if (is_null)
@@ -58,13 +58,13 @@ int init_search(int depr_fd)
                 else if (c == ncols - 1)
                     asp_value = -8;
 
-                seg_get(&watalt, (char *)&wa, r, c);
+                Seggrid_get(&watalt, &wa, r, c);
                 ele_value = wa.ele;
                 heap_add(r, c, ele_value);
                 FLAG_SET(af.flag, INLISTFLAG);
                 FLAG_SET(af.flag, EDGEFLAG);
                 af.asp = asp_value;
-                seg_put(&aspflag, (char *)&af, r, c);
+                Seggrid_put(&aspflag, &af, r, c);
                 continue;
             }
 
@@ -74,18 +74,18 @@ int init_search(int depr_fd)
                 r_nbr = r + nextdr[ct_dir];
                 c_nbr = c + nextdc[ct_dir];
 
-                seg_get(&aspflag, (char *)&af_nbr, r_nbr, c_nbr);
+                Seggrid_get(&aspflag, &af_nbr, r_nbr, c_nbr);
                 is_null = FLAG_GET(af_nbr.flag, NULLFLAG);
 
                 if (is_null) {
                     asp_value = -1 * drain[r - r_nbr + 1][c - c_nbr + 1];
-                    seg_get(&watalt, (char *)&wa, r, c);
+                    Seggrid_get(&watalt, &wa, r, c);
                     ele_value = wa.ele;
                     heap_add(r, c, ele_value);
                     FLAG_SET(af.flag, INLISTFLAG);
                     FLAG_SET(af.flag, EDGEFLAG);
                     af.asp = asp_value;
-                    seg_put(&aspflag, (char *)&af, r, c);
+                    Seggrid_put(&aspflag, &af, r, c);
 
                     break;
                 }
@@ -96,13 +96,13 @@ int init_search(int depr_fd)
             /* real depression ? */
             if (depr_fd >= 0) {
                 if (!Rast_is_c_null_value(&depr_buf[c]) && depr_buf[c] != 0) {
-                    seg_get(&watalt, (char *)&wa, r, c);
+                    Seggrid_get(&watalt, &wa, r, c);
                     ele_value = wa.ele;
                     heap_add(r, c, ele_value);
                     FLAG_SET(af.flag, INLISTFLAG);
                     FLAG_SET(af.flag, DEPRFLAG);
                     af.asp = asp_value;
-                    seg_put(&aspflag, (char *)&af, r, c);
+                    Seggrid_put(&aspflag, &af, r, c);
                     n_depr_cells++;
                 }
             }
@@ -152,9 +152,9 @@ int load_maps(int ele_fd, int acc_fd)
             if (acc_fd >= 0)
                 acc_ptr = G_incr_void_ptr(acc_ptr, acc_size);
         }
-        seg_put_row(&watalt, (char *)wabuf, r);
-        seg_put_row(&aspflag, (char *)afbuf, r);
-        cseg_put_row(&stream, stream_id, r);
+        Seggrid_put_row(&watalt, wabuf, r);
+        Seggrid_put_row(&aspflag, afbuf, r);
+        Seggrid_put_row(&stream, stream_id, r);
     }
     G_percent(nrows, nrows, 1); /* finish it */
 
@@ -2,8 +2,10 @@
 #define __LOCAL_PROTO_H__
 
 #include <grass/raster.h>
+#include <grass/seggrid.h>
 #include "flag.h"
-#include "seg.h"
+
+#define GW_LARGE_INT off_t
 
 #define INDEX(r, c) ((r) * ncols + (c))
 #define MAXDEPTH    1000 /* maximum supported tree depth of stream network */
@@ -60,12 +62,12 @@ extern int c_fac;
 extern int ele_scale;
 extern int have_depressions;
 
-extern SSEG search_heap;
-extern SSEG astar_pts;
-extern SSEG watalt, aspflag;
+extern SEGGRID search_heap;
+extern SEGGRID astar_pts;
+extern SEGGRID watalt, aspflag;
 
-/* extern BSEG bitflags, asp; */
-extern CSEG stream;
+/* extern SEGGRID bitflags, asp; */
+extern SEGGRID stream;
 
 /* load.c */
 int load_maps(int, int);
@@ -36,12 +36,12 @@ int c_fac;
 int ele_scale;
 int have_depressions;
 
-SSEG search_heap;
-SSEG astar_pts;
-SSEG watalt, aspflag;
+SEGGRID search_heap;
+SEGGRID astar_pts;
+SEGGRID watalt, aspflag;
 
-/* BSEG bitflags, asp; */
-CSEG stream;
+/* SEGGRID bitflags, asp; */
+SEGGRID stream;
 
 CELL *astar_order;
 
@@ -321,18 +321,19 @@ int main(int argc, char *argv[])
 
     /* open segment files */
     G_verbose_message(_("Creating temporary files..."));
-    seg_open(&watalt, nrows, ncols, seg_rows, seg_cols, num_open_segs * 2,
-             sizeof(WAT_ALT), 1);
+    Seggrid_open_records(&watalt, nrows, ncols, seg_rows, seg_cols,
+                         sizeof(WAT_ALT), num_open_segs * 2);
     if (num_open_segs * 2 > num_seg_total)
         heap_mem += (num_open_segs * 2 - num_seg_total) * seg2kb *
                     sizeof(WAT_ALT) / 1024.;
-    cseg_open(&stream, seg_rows, seg_cols, num_open_segs / 2.);
+    Seggrid_open(&stream, CELL_TYPE, seg_rows, seg_cols, num_open_segs / 2.);
 
-    seg_open(&aspflag, nrows, ncols, seg_rows, seg_cols, num_open_segs * 2,
-             sizeof(ASP_FLAG), 1);
+    Seggrid_open_records(&aspflag, nrows, ncols, seg_rows, seg_cols,
+                         sizeof(ASP_FLAG), num_open_segs * 2);
     /*
-       bseg_open(&asp, seg_rows, seg_cols, num_open_segs);
-       bseg_open(&bitflags, seg_rows, seg_cols, num_open_segs * 4);
+       Seggrid_open(&asp, SEGGRID_BYTE, seg_rows, seg_cols, num_open_segs);
+       Seggrid_open(&bitflags, SEGGRID_BYTE, seg_rows, seg_cols,
+                    num_open_segs * 4);
      */
 
     if (num_open_segs * 4 > num_seg_total)
@@ -358,8 +359,8 @@ int main(int argc, char *argv[])
         num_open_array_segs = 1;
 
     G_debug(1, "segment size for A* points: %d", seg_cols);
-    seg_open(&astar_pts, 1, n_points, 1, seg_cols, num_open_array_segs,
-             sizeof(POINT), 1);
+    Seggrid_open_records(&astar_pts, 1, n_points, 1, seg_cols, sizeof(POINT),
+                         num_open_array_segs);
 
     /* one-based d-ary search_heap with astar_pts */
     G_debug(1, "open segments for A* search heap");
@@ -385,8 +386,8 @@ int main(int argc, char *argv[])
     /* the search heap will not hold more than 5% of all points at any given
      * time ? */
     /* chances are good that the heap will fit into one large segment */
-    seg_open(&search_heap, 1, n_points + 1, 1, seg_cols, num_open_array_segs,
-             sizeof(HEAP_PNT), 0);
+    Seggrid_open_records(&search_heap, 1, n_points + 1, 1, seg_cols,
+                         sizeof(HEAP_PNT), num_open_array_segs);
 
     /********************/
     /*    processing    */
@@ -400,7 +401,7 @@ int main(int argc, char *argv[])
     /* sort elevation and get initial stream direction */
     if (do_astar() < 0)
         G_fatal_error(_("Unable to sort elevation raster map values"));
-    seg_close(&search_heap);
+    Seggrid_close(&search_heap);
 
     if (acc_fd < 0) {
         /* accumulate surface flow */
@@ -412,8 +413,8 @@ int main(int argc, char *argv[])
     if (extract_streams(threshold, mont_exp, acc_fd < 0) < 0)
         G_fatal_error(_("Unable to extract streams"));
 
-    seg_close(&astar_pts);
-    seg_close(&watalt);
+    Seggrid_close(&astar_pts);
+    Seggrid_close(&watalt);
 
     /* thin streams */
     if (thin_streams() < 0)
@@ -430,8 +431,8 @@ int main(int argc, char *argv[])
                    output.dir_rast->answer) < 0)
         G_fatal_error(_("Unable to write output raster maps"));
 
-    cseg_close(&stream);
-    seg_close(&aspflag);
+    Seggrid_close(&stream);
+    Seggrid_close(&aspflag);
 
     exit(EXIT_SUCCESS);
 }
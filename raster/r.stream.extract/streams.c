@@ -27,16 +27,16 @@ static int continue_stream(CELL stream_id, int r_max, int c_max, int *stream_no)
 
     G_debug(3, "continue stream");
 
-    cseg_get(&stream, &curr_stream, r_max, c_max);
+    Seggrid_get(&stream, &curr_stream, r_max, c_max);
 
     if (curr_stream <= 0) {
         /* no confluence, just continue */
         G_debug(3, "no confluence, just continue stream");
         curr_stream = stream_id;
-        cseg_put(&stream, &curr_stream, r_max, c_max);
-        seg_get(&aspflag, (char *)&af, r_max, c_max);
+        Seggrid_put(&stream, &curr_stream, r_max, c_max);
+        Seggrid_get(&aspflag, &af, r_max, c_max);
         FLAG_SET(af.flag, STREAMFLAG);
-        seg_put(&aspflag, (char *)&af, r_max, c_max);
+        Seggrid_put(&aspflag, &af, r_max, c_max);
         return 0;
     }
 
@@ -89,18 +89,18 @@ static int continue_stream(CELL stream_id, int r_max, int c_max, int *stream_no)
         c_nbr = c_max;
         old_stream = curr_stream;
         curr_stream = *stream_no;
-        cseg_put(&stream, &curr_stream, r_nbr, c_nbr);
-        seg_get(&aspflag, (char *)&af, r_nbr, c_nbr);
+        Seggrid_put(&stream, &curr_stream, r_nbr, c_nbr);
+        Seggrid_get(&aspflag, &af, r_nbr, c_nbr);
 
         while (af.asp > 0) {
             r_nbr = r_nbr + asp_r[(int)af.asp];
             c_nbr = c_nbr + asp_c[(int)af.asp];
-            cseg_get(&stream, &stream_nbr, r_nbr, c_nbr);
+            Seggrid_get(&stream, &stream_nbr, r_nbr, c_nbr);
             if (stream_nbr != old_stream)
                 af.asp = -1;
             else {
-                cseg_put(&stream, &curr_stream, r_nbr, c_nbr);
-                seg_get(&aspflag, (char *)&af, r_nbr, c_nbr);
+                Seggrid_put(&stream, &curr_stream, r_nbr, c_nbr);
+                Seggrid_get(&aspflag, &af, r_nbr, c_nbr);
             }
         }
     }
@@ -185,16 +185,16 @@ int do_accum(double d8cut)
 
         G_percent(killer, n_points, 1);
 
-        seg_get(&astar_pts, (char *)&astarpoint, 0, killer);
+        Seggrid_get(&astar_pts, &astarpoint, 0, killer);
         r = astarpoint.r;
         c = astarpoint.c;
 
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
 
         /* do not distribute flow along edges or out of real depressions */
         if (af.asp <= 0) {
             FLAG_UNSET(af.flag, WORKEDFLAG);
-            seg_put(&aspflag, (char *)&af, r, c);
+            Seggrid_put(&aspflag, &af, r, c);
             continue;
         }
 
@@ -203,13 +203,13 @@ int do_accum(double d8cut)
             dc = c + asp_c[abs((int)af.asp)];
         }
 
-        seg_get(&watalt, (char *)&wa, r, c);
+        Seggrid_get(&watalt, &wa, r, c);
         value = wa.wat;
 
         /* WORKEDFLAG has been set during A* Search
          * reversed meaning here: 0 = done, 1 = not yet done */
         FLAG_UNSET(af.flag, WORKEDFLAG);
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
 
         /***************************************/
         /*  get weights for flow distribution  */
@@ -235,11 +235,11 @@ int do_accum(double d8cut)
             /* check that neighbour is within region */
             if (r_nbr >= 0 && r_nbr < nrows && c_nbr >= 0 && c_nbr < ncols) {
 
-                seg_get(&aspflag, (char *)&af_nbr, r_nbr, c_nbr);
+                Seggrid_get(&aspflag, &af_nbr, r_nbr, c_nbr);
                 flag_nbr[ct_dir] = af_nbr.flag;
                 if ((edge = FLAG_GET(flag_nbr[ct_dir], NULLFLAG)))
                     break;
-                seg_get(&watalt, (char *)&wa, r_nbr, c_nbr);
+                Seggrid_get(&watalt, &wa, r_nbr, c_nbr);
                 wat_nbr[ct_dir] = wa.wat;
                 ele_nbr[ct_dir] = wa.ele;
 
@@ -325,7 +325,7 @@ int do_accum(double d8cut)
 
                         wa.wat = wat_nbr[ct_dir] + value * weight[ct_dir];
                         wa.ele = ele_nbr[ct_dir];
-                        seg_put(&watalt, (char *)&wa, r_nbr, c_nbr);
+                        Seggrid_put(&watalt, &wa, r_nbr, c_nbr);
                     }
                     else if (ct_dir == np_side) {
                         /* check for consistency with A * path */
@@ -342,7 +342,7 @@ int do_accum(double d8cut)
         else {
             wa.wat = wat_nbr[np_side] + value;
             wa.ele = ele_nbr[np_side];
-            seg_put(&watalt, (char *)&wa, dr, dc);
+            Seggrid_put(&watalt, &wa, dr, dc);
         }
     }
     G_percent(1, 1, 2);
@@ -432,17 +432,17 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
     for (killer = 0; killer < n_points; killer++) {
         G_percent(killer, n_points, 1);
 
-        seg_get(&astar_pts, (char *)&astarpoint, 0, killer);
+        Seggrid_get(&astar_pts, &astarpoint, 0, killer);
         r = astarpoint.r;
         c = astarpoint.c;
 
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
         /* internal acc: SET, external acc: UNSET */
         if (internal_acc)
             FLAG_SET(af.flag, WORKEDFLAG);
         else
             FLAG_UNSET(af.flag, WORKEDFLAG);
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
 
         /* do not distribute flow along edges */
         if (af.asp <= 0) {
@@ -484,7 +484,7 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
         r_nbr = r_max = dr;
         c_nbr = c_max = dc;
 
-        seg_get(&watalt, (char *)&wa, r, c);
+        Seggrid_get(&watalt, &wa, r, c);
         value = wa.wat;
 
         /**********************************/
@@ -516,11 +516,11 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
                 if (dr == r_nbr && dc == c_nbr)
                     np_side = ct_dir;
 
-                seg_get(&aspflag, (char *)&af_nbr, r_nbr, c_nbr);
+                Seggrid_get(&aspflag, &af_nbr, r_nbr, c_nbr);
                 flag_nbr[ct_dir] = af_nbr.flag;
                 if ((edge = FLAG_GET(flag_nbr[ct_dir], NULLFLAG)))
                     break;
-                seg_get(&watalt, (char *)&wa, r_nbr, c_nbr);
+                Seggrid_get(&watalt, &wa, r_nbr, c_nbr);
                 wat_nbr[ct_dir] = wa.wat;
                 ele_nbr[ct_dir] = wa.ele;
 
@@ -587,7 +587,7 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
                 n_outlets++;
                 if (af.asp > 0) {
                     af.asp = -1 * drain[r - r_nbr + 1][c - c_nbr + 1];
-                    seg_put(&aspflag, (char *)&af, r, c);
+                    Seggrid_put(&aspflag, &af, r, c);
                 }
             }
             continue;
@@ -616,7 +616,7 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
         /* r_max == r && c_max == c should not happen */
         if ((r_max != dr || c_max != dc) && (r_max != r || c_max != c)) {
             af.asp = drain[r - r_max + 1][c - c_max + 1];
-            seg_put(&aspflag, (char *)&af, r, c);
+            Seggrid_put(&aspflag, &af, r, c);
         }
 
         /**********************/
@@ -644,9 +644,9 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
             swale_cells < 1 && !flat) {
             G_debug(2, "start new stream");
             is_swale = ++stream_no;
-            cseg_put(&stream, &is_swale, r, c);
+            Seggrid_put(&stream, &is_swale, r, c);
             FLAG_SET(af.flag, STREAMFLAG);
-            seg_put(&aspflag, (char *)&af, r, c);
+            Seggrid_put(&aspflag, &af, r, c);
             /* add stream node */
             if (stream_no >= n_alloc_nodes - 1) {
                 n_alloc_nodes += stream_node_step;
@@ -675,7 +675,7 @@ int extract_streams(double threshold, double mont_exp, int internal_acc)
         /*********************/
 
         if (is_swale > 0) {
-            cseg_get(&stream, &is_swale, r, c);
+            Seggrid_get(&stream, &is_swale, r, c);
             if (r_max == r && c_max == c) {
                 /* can't continue stream, add outlet point
                  * r_max == r && c_max == c should not happen */
@@ -16,20 +16,20 @@ int thin_seg(int stream_id)
     r = stream_node[stream_id].r;
     c = stream_node[stream_id].c;
 
-    cseg_get(&stream, &curr_stream, r, c);
+    Seggrid_get(&stream, &curr_stream, r, c);
 
-    seg_get(&aspflag, (char *)&af, r, c);
+    Seggrid_get(&aspflag, &af, r, c);
     if (af.asp > 0) {
         /* get downstream point */
         last_r = r + asp_r[(int)af.asp];
         last_c = c + asp_c[(int)af.asp];
-        cseg_get(&stream, &curr_stream, last_r, last_c);
+        Seggrid_get(&stream, &curr_stream, last_r, last_c);
 
         if (curr_stream != stream_id)
             return thinned;
 
         /* get next downstream point */
-        seg_get(&aspflag, (char *)&af, last_r, last_c);
+        Seggrid_get(&aspflag, &af, last_r, last_c);
         while (af.asp > 0) {
             r_nbr = last_r + asp_r[(int)af.asp];
             c_nbr = last_c + asp_c[(int)af.asp];
@@ -38,18 +38,18 @@ int thin_seg(int stream_id)
                 return thinned;
             if (r_nbr < 0 || r_nbr >= nrows || c_nbr < 0 || c_nbr >= ncols)
                 return thinned;
-            cseg_get(&stream, &curr_stream, r_nbr, c_nbr);
+            Seggrid_get(&stream, &curr_stream, r_nbr, c_nbr);
             if (curr_stream != stream_id)
                 return thinned;
             if (abs(r_nbr - r) < 2 && abs(c_nbr - c) < 2) {
                 /* eliminate last point */
-                cseg_put(&stream, &no_stream, last_r, last_c);
+                Seggrid_put(&stream, &no_stream, last_r, last_c);
                 FLAG_UNSET(af.flag, STREAMFLAG);
-                seg_put(&aspflag, (char *)&af, last_r, last_c);
+                Seggrid_put(&aspflag, &af, last_r, last_c);
                 /* update start point */
-                seg_get(&aspflag, (char *)&af, r, c);
+                Seggrid_get(&aspflag, &af, r, c);
                 af.asp = drain[r - r_nbr + 1][c - c_nbr + 1];
-                seg_put(&aspflag, (char *)&af, r, c);
+                Seggrid_put(&aspflag, &af, r, c);
 
                 thinned = 1;
             }
@@ -60,7 +60,7 @@ int thin_seg(int stream_id)
             }
             last_r = r_nbr;
             last_c = c_nbr;
-            seg_get(&aspflag, (char *)&af, last_r, last_c);
+            Seggrid_get(&aspflag, &af, last_r, last_c);
         }
     }
 
@@ -88,7 +88,7 @@ int thin_streams(void)
         G_percent(i, n_outlets, 2);
         r = outlets[i].r;
         c = outlets[i].c;
-        cseg_get(&stream, &stream_id, r, c);
+        Seggrid_get(&stream, &stream_id, r, c);
 
         if (stream_id == 0)
             continue;
@@ -133,9 +133,13 @@ void joules2(struct SunGeometryConstDay *sunGeom,
 void calculate(double singleSlope, double singleAspect, double singleAlbedo,
                double singleLinke, struct GridGeometry gridGeom);
 double com_declin(int);
+static void compute_horizon(double zmax, struct GridGeometry *gridGeom);
 
 int n, m, ip, jp;
 int d, day;
+int first_day, end_day, day_step = 1; /* range of days */
+int aggregate;                        /* sum outputs over the days */
+int computeHorizon;                   /* compute horizon for all days */
 int saveMemory, numPartitions = 1;
 long int shadowoffset = 0;
 int varCount_global = 0;
@@ -226,13 +230,16 @@ int main(int argc, char *argv[])
             *lin, *albedo, *longin, *alb, *latin, *coefbh, *coefdh, *incidout,
             *beam_rad, *insol_time, *diff_rad, *refl_rad, *glob_rad, *day,
             *step, *declin, *solar_cnst, *ltime, *dist, *horizon, *horizonstep,
-            *numPartitions, *civilTime, *threads;
+            *numPartitions, *civilTime, *threads, *endDay, *dayStep;
     } parm;
 
     struct {
-        struct Flag *noshade, *saveMemory;
+        struct Flag *noshade, *saveMemory, *aggregate;
     } flag;
 
+    const char *beam_rad_base, *insol_time_base, *diff_rad_base,
+        *refl_rad_base, *glob_rad_base, *incidout_base;
+
     struct GridGeometry gridGeom = {0};
 
     G_gisinit(argv[0]);
@@ -455,6 +462,24 @@ int main(int argc, char *argv[])
     parm.day->options = "1-365";
     parm.day->guisection = _("Time");
 
+    parm.endDay = G_define_option();
+    parm.endDay->key = "end_day";
+    parm.endDay->type = TYPE_INTEGER;
+    parm.endDay->required = NO;
+    parm.endDay->description =
+        _("No. of the last day of a range of days starting at day (1-365)");
+    parm.endDay->options = "1-365";
+    parm.endDay->guisection = _("Time");
+
+    parm.dayStep = G_define_option();
+    parm.dayStep->key = "day_step";
+    parm.dayStep->type = TYPE_INTEGER;
+    parm.dayStep->required = NO;
+    parm.dayStep->description =
+        _("Step between the days of a range of days (default: 1)");
+    parm.dayStep->options = "1-365";
+    parm.dayStep->guisection = _("Time");
+
     parm.step = G_define_option();
     parm.step->key = "step";
     parm.step->type = TYPE_DOUBLE;
@@ -546,6 +571,13 @@ int main(int argc, char *argv[])
     flag.saveMemory->description =
         _("Use the low-memory version of the program");
 
+    flag.aggregate = G_define_flag();
+    flag.aggregate->key = 'a';
+    flag.aggregate->description =
+        _("Sum the outputs over the range of days instead of writing one "
+          "map per day (mode 2 only)");
+    flag.aggregate->guisection = _("Time");
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
@@ -634,7 +666,17 @@ int main(int argc, char *argv[])
     if ((insol_time != NULL) && (incidout != NULL))
         G_fatal_error(_("insol_time and incidout are incompatible options"));
 
-    sscanf(parm.day->answer, "%d", &day);
+    sscanf(parm.day->answer, "%d", &first_day);
+    end_day = first_day;
+    if (parm.endDay->answer != NULL) {
+        sscanf(parm.endDay->answer, "%d", &end_day);
+        if (end_day < first_day)
+            G_fatal_error(_("The last day of the range must not be before "
+                            "the first day"));
+    }
+    if (parm.dayStep->answer != NULL)
+        sscanf(parm.dayStep->answer, "%d", &day_step);
+    aggregate = flag.aggregate->answer;
 
     if (sscanf(parm.step->answer, "%lf", &step) != 1)
         G_fatal_error(_("Error reading time step size"));
@@ -659,6 +701,9 @@ int main(int argc, char *argv[])
     if (parm.ltime->answer != NULL) {
         if (insol_time != NULL)
             G_fatal_error(_("Time and insol_time are incompatible options"));
+        if (aggregate)
+            G_fatal_error(_("Time and the -%c flag are incompatible options"),
+                          flag.aggregate->key);
 
         G_message(_("Mode 1: instantaneous solar incidence angle & irradiance "
                     "using a set local time"));
@@ -754,13 +799,21 @@ int main(int argc, char *argv[])
         G_fatal_error(_("If you want to save memory and to use shadows, "
                         "you must use pre-calculated horizons."));
 
-    if (parm.declin->answer == NULL)
-        declination = com_declin(day);
-    else {
+    if (parm.declin->answer != NULL) {
+        if (end_day != first_day)
+            G_fatal_error(_("The declination cannot be given for a range of "
+                            "days"));
         sscanf(parm.declin->answer, "%lf", &declin);
         declination = -declin;
     }
 
+    /* Searching the terrain for shadows is repeated for every sun
+     * position. For a range of days, the horizon of each cell is
+     * computed once instead, if the angle step is given. */
+    computeHorizon = useShadow() && !useHorizonData() &&
+                     parm.horizonstep->answer != NULL &&
+                     end_day - first_day >= day_step;
+
     if (parm.solar_cnst->answer)
         sscanf(parm.solar_cnst->answer, "%lf", &solar_constant);
     else
@@ -781,6 +834,8 @@ int main(int argc, char *argv[])
             arrayNumInt = (int)(360. / horizonStep);
         }
     }
+    if (computeHorizon)
+        arrayNumInt = (int)(360. / horizonStep);
 
     if (ttime != NULL) {
 
@@ -834,10 +889,50 @@ int main(int argc, char *argv[])
     if ((G_projection() == PROJECTION_LL))
         ll_correction = TRUE;
 
-    G_debug(3, "calculate() starts...");
-    calculate(singleSlope, singleAspect, singleAlbedo, singleLinke, gridGeom);
-    G_debug(3, "OUTGR() starts...");
-    OUTGR();
+    beam_rad_base = beam_rad;
+    insol_time_base = insol_time;
+    diff_rad_base = diff_rad;
+    refl_rad_base = refl_rad;
+    glob_rad_base = glob_rad;
+    incidout_base = incidout;
+
+    /* the inputs are read once for all days of the range */
+    for (day = first_day; day <= end_day; day += day_step) {
+        if (end_day != first_day) {
+            G_message(_("Day %d"), day);
+            if (!aggregate) {
+                /* one map per day, named <basename>_<day> */
+                if (beam_rad_base)
+                    beam_rad = G_generate_basename(beam_rad_base, day, 3, 0);
+                if (insol_time_base)
+                    insol_time =
+                        G_generate_basename(insol_time_base, day, 3, 0);
+                if (diff_rad_base)
+                    diff_rad = G_generate_basename(diff_rad_base, day, 3, 0);
+                if (refl_rad_base)
+                    refl_rad = G_generate_basename(refl_rad_base, day, 3, 0);
+                if (glob_rad_base)
+                    glob_rad = G_generate_basename(glob_rad_base, day, 3, 0);
+                if (incidout_base)
+                    incidout = G_generate_basename(incidout_base, day, 3, 0);
+            }
+        }
+
+        if (parm.declin->answer == NULL)
+            declination = com_declin(day);
+
+        G_debug(3, "calculate() starts...");
+        calculate(singleSlope, singleAspect, singleAlbedo, singleLinke,
+                  gridGeom);
+        if (!aggregate) {
+            G_debug(3, "OUTGR() starts...");
+            OUTGR();
+        }
+    }
+    if (aggregate) {
+        G_debug(3, "OUTGR() starts...");
+        OUTGR();
+    }
 
     exit(EXIT_SUCCESS);
 }
@@ -1688,13 +1783,15 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
     double dayRad;
     double latid_l = 0.0, cos_u = 0.0, cos_v = 0.0, sin_u = 0.0, sin_v = 0.0;
     double sin_phi_l = 0.0, tan_lam_l = 0.0;
-    double zmax = 0;
+    static double zmax = 0; /* kept for the following days */
     double longitTime = 0.;
     double locTimeOffset;
     double latitude, longitude;
     double coslat = 0.0;
     bool shouldBeBestAM = false;
     bool isBestAM = false;
+    /* add to the outputs of the previous days */
+    bool sumDays = aggregate && day != first_day;
 
     struct SunGeometryConstDay sunGeom;
     struct SunGeometryVarDay sunVarGeom;
@@ -1715,74 +1812,113 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
                     (diff_rad != NULL) || (refl_rad != NULL) ||
                     (glob_rad != NULL);
 
+    if (!sumDays) {
+        /* statistics for the history of each day's maps */
+        sunrise_min = 24.;
+        sunrise_max = 0.;
+        sunset_min = 24.;
+        sunset_max = 0.;
+        linke_max = 0.;
+        linke_min = 100.;
+        albedo_max = 0.;
+        albedo_min = 1.0;
+        lat_max = -90.;
+        lat_min = 90.;
+    }
+
     if (incidout != NULL) {
-        lumcl = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            lumcl[l] = (float *)G_calloc((n), sizeof(float *));
+        if (lumcl == NULL) {
+            lumcl = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                lumcl[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                lumcl[j][i] = UNDEFZ;
+
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    lumcl[j][i] = UNDEFZ;
+            }
         }
     }
 
     if (beam_rad != NULL) {
-        beam = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            beam[l] = (float *)G_calloc((n), sizeof(float *));
+        if (beam == NULL) {
+            beam = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                beam[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
 
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                beam[j][i] = UNDEFZ;
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    beam[j][i] = UNDEFZ;
+            }
         }
     }
 
     if (insol_time != NULL) {
-        insol = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            insol[l] = (float *)G_calloc((n), sizeof(float *));
+        if (insol == NULL) {
+            insol = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                insol[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
 
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                insol[j][i] = UNDEFZ;
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    insol[j][i] = UNDEFZ;
+            }
         }
     }
 
     if (diff_rad != NULL) {
-        diff = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            diff[l] = (float *)G_calloc((n), sizeof(float *));
+        if (diff == NULL) {
+            diff = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                diff[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
 
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                diff[j][i] = UNDEFZ;
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    diff[j][i] = UNDEFZ;
+            }
         }
     }
 
     if (refl_rad != NULL) {
-        refl = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            refl[l] = (float *)G_calloc((n), sizeof(float *));
+        if (refl == NULL) {
+            refl = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                refl[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
 
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                refl[j][i] = UNDEFZ;
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    refl[j][i] = UNDEFZ;
+            }
         }
     }
 
     if (glob_rad != NULL) {
-        globrad = (float **)G_calloc((m), sizeof(float *));
-        for (l = 0; l < m; l++) {
-            globrad[l] = (float *)G_calloc((n), sizeof(float *));
+        if (globrad == NULL) {
+            globrad = (float **)G_calloc((m), sizeof(float *));
+            for (l = 0; l < m; l++) {
+                globrad[l] = (float *)G_calloc((n), sizeof(float *));
+            }
         }
 
-        for (j = 0; j < m; j++) {
-            for (i = 0; i < n; i++)
-                globrad[j][i] = UNDEFZ;
+        if (!sumDays) {
+            for (j = 0; j < m; j++) {
+                for (i = 0; i < n; i++)
+                    globrad[j][i] = UNDEFZ;
+            }
         }
     }
 
@@ -1811,7 +1947,13 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
         G_percent(j, m - 1, 2);
 
         if (j % (numRows) == 0) {
-            INPUT_part(j, &zmax);
+            /* unpartitioned inputs are read on the first day only */
+            if (numPartitions != 1 || day == first_day)
+                INPUT_part(j, &zmax);
+            if (computeHorizon && horizonarray == NULL) {
+                compute_horizon(zmax, &gridGeom);
+                setUseHorizonData(TRUE);
+            }
             arrayOffset = 0;
             shadowoffset = 0;
         }
@@ -1990,6 +2132,15 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
                             &sunGeom, &sunVarGeom, &sunSlopeGeom, &sunRadVar,
                             &gridGeom, horizonarray + shadowoffset, latitude,
                             longitude, &Pbeam_e, &Pdiff_e, &Prefl_e, &Pinsol_t);
+                        double Pglob_e = Pbeam_e + Pdiff_e + Prefl_e;
+
+                        if (sumDays) {
+                            Pbeam_e += beam_rad ? beam[j][i] : 0.;
+                            Pinsol_t += insol_time ? insol[j][i] : 0.;
+                            Pdiff_e += diff_rad ? diff[j][i] : 0.;
+                            Prefl_e += refl_rad ? refl[j][i] : 0.;
+                            Pglob_e += glob_rad ? globrad[j][i] : 0.;
+                        }
                         if (beam_rad != NULL)
                             beam[j][i] = (float)Pbeam_e;
                         if (insol_time != NULL)
@@ -2000,8 +2151,7 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
                         if (refl_rad != NULL)
                             refl[j][i] = (float)Prefl_e;
                         if (glob_rad != NULL)
-                            globrad[j][i] =
-                                (float)(Pbeam_e + Pdiff_e + Prefl_e);
+                            globrad[j][i] = (float)Pglob_e;
                     }
 
                 } /* undefs */
@@ -2036,8 +2186,14 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
     Rast_append_format_history(
         &hist,
         " ----------------------------------------------------------------");
-    Rast_append_format_history(
-        &hist, " Day [1-365]:                              %d", day);
+    if (aggregate && end_day != first_day)
+        Rast_append_format_history(
+            &hist,
+            " Days [1-365]:                             %d - %d, step %d",
+            first_day, end_day, day_step);
+    else
+        Rast_append_format_history(
+            &hist, " Day [1-365]:                              %d", day);
 
     if (ttime != NULL)
         Rast_append_format_history(
@@ -2045,11 +2201,14 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
 
     Rast_append_format_history(
         &hist, " Solar constant (W/m^2):                   %f", solar_constant);
-    Rast_append_format_history(&hist,
-                               " Extraterrestrial irradiance (W/m^2):      %f",
-                               sunRadVar.G_norm_extra);
-    Rast_append_format_history(
-        &hist, " Declination (rad):                        %f", -declination);
+    if (!aggregate || end_day == first_day) {
+        Rast_append_format_history(
+            &hist, " Extraterrestrial irradiance (W/m^2):      %f",
+            sunRadVar.G_norm_extra);
+        Rast_append_format_history(
+            &hist, " Declination (rad):                        %f",
+            -declination);
+    }
 
     Rast_append_format_history(
         &hist, " Latitude min-max(deg):                    %.4f - %.4f",
@@ -2114,6 +2273,93 @@ void calculate(double singleSlope, double singleAspect, double singleAlbedo,
 
 } /* End of ) function */
 
+/* Compute the horizon height of every cell in arrayNumInt directions,
+ * starting due east and counterclockwise like the horizon maps of
+ * r.horizon. The terrain is searched the same way as by searching() for
+ * the sun position, so a cell is in shadow if the sun is below the
+ * horizon in its direction. */
+static void compute_horizon(double zmax, struct GridGeometry *gridGeom)
+{
+    int j;
+
+    horizonarray =
+        (unsigned char *)G_calloc((size_t)arrayNumInt * m * n, sizeof(char));
+
+#pragma omp parallel for schedule(dynamic)
+    for (j = 0; j < m; j++) {
+        double coslat2 = 1.;
+        int i, k;
+
+        if (ll_correction) {
+            double coslat = cos(deg2rad * (ymin + j * gridGeom->stepy));
+
+            coslat2 = coslat * coslat;
+        }
+
+        for (i = 0; i < n; i++) {
+            unsigned char *horizonpointer =
+                horizonarray + ((size_t)j * n + i) * arrayNumInt;
+            double z0 = z[j][i];
+            double x0 = i * gridGeom->stepx;
+            double y0 = j * gridGeom->stepy;
+
+            if (z0 == UNDEFZ)
+                continue;
+
+            for (k = 0; k < arrayNumInt; k++) {
+                double angle = k * getHorizonInterval();
+                double stepx = gridGeom->stepxy * cos(angle);
+                double stepy = gridGeom->stepxy * sin(angle);
+                double xx0 = x0, yy0 = y0;
+                double maxTan = 0.;
+
+                while (TRUE) {
+                    double dx, dy, length, curvature_diff, zp;
+                    int ii, jj;
+
+                    xx0 += stepx;
+                    yy0 += stepy;
+                    if (((xx0 + (0.5 * gridGeom->stepx)) < 0) ||
+                        ((xx0 + (0.5 * gridGeom->stepx)) > gridGeom->deltx) ||
+                        ((yy0 + (0.5 * gridGeom->stepy)) < 0) ||
+                        ((yy0 + (0.5 * gridGeom->stepy)) > gridGeom->delty))
+                        break;
+
+                    ii = (int)(xx0 * invstepx + offsetx);
+                    jj = (int)(yy0 * invstepy + offsety);
+                    if (ii > n - 1 || jj > m - 1)
+                        break;
+
+                    zp = z[jj][ii];
+                    if (zp == UNDEFZ)
+                        break;
+
+                    dx = ii * gridGeom->stepx - x0;
+                    dy = jj * gridGeom->stepy - y0;
+                    if (ll_correction)
+                        length = DEGREEINMETERS *
+                                 sqrt(coslat2 * dx * dx + dy * dy);
+                    else
+                        length = sqrt(dx * dx + dy * dy);
+                    if (length == 0.)
+                        continue;
+
+                    curvature_diff =
+                        EARTHRADIUS * (1. - cos(length / EARTHRADIUS));
+                    maxTan = AMAX1(maxTan, (zp - z0 - curvature_diff) / length);
+
+                    /* nothing higher further on */
+                    if (z0 + curvature_diff + length * maxTan > zmax)
+                        break;
+                }
+
+                horizonpointer[k] = (unsigned char)rint(
+                    SCALING_FACTOR * AMIN1(atan(maxTan), 255 * invScale));
+            }
+        }
+    }
+}
+
 double com_declin(int no_of_day)
 {
     double d1, decl;
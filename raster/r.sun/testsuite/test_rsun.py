@@ -365,5 +365,102 @@ class TestRSunHighNorthernSlope(TestCase):
         )
 
 
+class TestRSunDayRange(TestCase):
+    elevation = "elevation"
+    slope = "rsun_slope"
+    aspect = "rsun_aspect"
+    beam_rad = "beam_rad_range"
+    beam_rad_day = "beam_rad_day"
+    beam_rad_sum = "beam_rad_sum"
+    beam_rad_ref = "beam_rad_ref"
+    beam_rad_horizon = "beam_rad_horizon"
+    beam_rad_horizon_next = "beam_rad_horizon_next"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=223500, s=220000, e=640000, w=635000, res=10)
+        cls.runModule(
+            "r.slope.aspect",
+            elevation=cls.elevation,
+            slope=cls.slope,
+            aspect=cls.aspect,
+        )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule(
+            "g.remove",
+            type=["raster"],
+            name=[
+                cls.slope,
+                cls.aspect,
+                cls.beam_rad + "_171",
+                cls.beam_rad + "_172",
+                cls.beam_rad_day + "_171",
+                cls.beam_rad_day + "_172",
+                cls.beam_rad_sum,
+                cls.beam_rad_ref,
+                cls.beam_rad_horizon + "_171",
+                cls.beam_rad_horizon + "_172",
+                cls.beam_rad_horizon_next + "_172",
+                cls.beam_rad_horizon_next + "_173",
+            ],
+            flags="f",
+        )
+
+    def run_rsun(self, output, **kwargs):
+        self.assertModule(
+            "r.sun",
+            elevation=self.elevation,
+            slope=self.slope,
+            aspect=self.aspect,
+            beam_rad=output,
+            overwrite=True,
+            **kwargs,
+        )
+
+    def test_maps_per_day(self):
+        """Each day of a range matches a run for that day"""
+        self.run_rsun(self.beam_rad, day=171, end_day=172)
+        for day in (171, 172):
+            self.run_rsun(f"{self.beam_rad_day}_{day}", day=day)
+            self.assertRastersNoDifference(
+                f"{self.beam_rad}_{day}",
+                f"{self.beam_rad_day}_{day}",
+                precision=1e-8,
+            )
+
+    def test_sum_over_days(self):
+        """The -a flag sums the days of a range"""
+        self.run_rsun(self.beam_rad_sum, day=171, end_day=172, flags="a")
+        for day in (171, 172):
+            self.run_rsun(f"{self.beam_rad_day}_{day}", day=day)
+        self.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{self.beam_rad_ref} = {self.beam_rad_day}_171 + "
+                f"{self.beam_rad_day}_172"
+            ),
+            overwrite=True,
+        )
+        self.assertRastersNoDifference(
+            self.beam_rad_sum, self.beam_rad_ref, precision=1e-2
+        )
+
+    def test_maps_per_day_horizon_step(self):
+        """Horizons computed once for a range do not depend on the days"""
+        self.run_rsun(self.beam_rad_horizon, day=171, end_day=172, horizon_step=30)
+        self.run_rsun(
+            self.beam_rad_horizon_next, day=172, end_day=173, horizon_step=30
+        )
+        self.assertRastersNoDifference(
+            f"{self.beam_rad_horizon}_172",
+            f"{self.beam_rad_horizon_next}_172",
+            precision=1e-8,
+        )
+
+
 if __name__ == "__main__":
     test()
@@ -313,7 +313,7 @@ int main(int argc, char *argv[])
     out_set.flag_ind = flag.ind;
 
     threads = G_set_omp_num_threads(parm.nproc);
-    threads = Rast_disable_omp_on_mask(threads);
+    threads = Rast_set_mask_threads(threads);
     if (threads < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), threads);
 
@@ -21,9 +21,16 @@
 #include <grass/gis.h>
 #include <grass/raster3d.h>
 #include <grass/raster.h>
+#include <grass/stats.h>
 #include <grass/glocale.h>
 
 /*- Parameters and global variables -----------------------------------------*/
+/* sorted values of a zone in the temporary file, see spill_values() */
+typedef struct {
+    off_t offset;
+    size_t n;
+} univar_run;
+
 typedef struct {
     double sum;
     double sumsq;
@@ -41,6 +48,10 @@ typedef struct {
     void *nextp;
     size_t n_alloc;
     int first;
+    univar_run *runs;
+    int n_runs;
+    size_t n_spilled;
+    struct quantile_sketch *sketch;
 } univar_stat;
 
 typedef struct {
@@ -52,8 +63,8 @@ typedef struct {
 /* command line options are the same for raster and raster3d maps */
 typedef struct {
     struct Option *inputfile, *zonefile, *percentile, *output_file, *separator,
-        *nprocs, *format;
-    struct Flag *shell_style, *extended, *table, *use_rast_region;
+        *nprocs, *format, *error, *memory;
+    struct Flag *shell_style, *extended, *table, *use_rast_region, *approximate;
 } param_type;
 
 extern param_type param;
@@ -70,5 +81,9 @@ int print_stats_table(univar_stat *stats);
 univar_stat *create_univar_stat_struct(int map_type, int n_perc);
 void free_univar_stat_struct(univar_stat *stats);
 univar_stat *univar_stat_with_percentiles(int map_type);
+void spill_values(univar_stat *stats, void *values, size_t n);
+void select_values(univar_stat *stats, const size_t *pos, double *values,
+                   int n_pos);
+void remove_spill_file(void);
 
 #endif
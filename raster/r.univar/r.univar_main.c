@@ -28,6 +28,9 @@
 param_type param;
 zone_type zone_info;
 
+/* number of values of the extended statistics in memory after reading */
+static size_t in_memory;
+
 /* Parallelization
  * Only raster statistics reduction in process_raster() is parallelized.
  * print_stats*() where sorting takes place for percentile computation are not.
@@ -89,6 +92,23 @@ void set_params(void)
         _("Percentile to calculate (requires extended statistics flag)");
     param.percentile->guisection = _("Extended");
 
+    param.error = G_define_option();
+    param.error->key = "error";
+    param.error->type = TYPE_DOUBLE;
+    param.error->required = NO;
+    param.error->options = "0.00001-0.1";
+    param.error->answer = "0.001";
+    param.error->label = _("Rank error of approximate extended statistics");
+    param.error->description =
+        _("Fraction of the number of cells, requires the -a flag");
+    param.error->guisection = _("Extended");
+
+    param.memory = G_define_standard_option(G_OPT_MEMORYMB);
+    param.memory->description =
+        _("Maximum memory for the values of exact extended statistics, "
+          "more values are sorted on disk");
+    param.memory->guisection = _("Extended");
+
     param.nprocs = G_define_standard_option(G_OPT_M_NPROCS);
 
     param.separator = G_define_standard_option(G_OPT_F_SEP);
@@ -109,6 +129,12 @@ void set_params(void)
     param.extended->description = _("Calculate extended statistics");
     param.extended->guisection = _("Extended");
 
+    param.approximate = G_define_flag();
+    param.approximate->key = 'a';
+    param.approximate->description =
+        _("Approximate extended statistics in bounded memory");
+    param.approximate->guisection = _("Extended");
+
     param.table = G_define_flag();
     param.table->key = 't';
     param.table->label =
@@ -140,6 +166,7 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                            const struct Cell_head *region, int nprocs,
                            enum OutputFormat format);
 static void kahan_sum(double *sum, double *c, double x);
+static void *bucket_values(zone_bucket *bucket, RASTER_MAP_TYPE map_type);
 
 /* *************************************************************** */
 /* **** the main functions for r.univar ************************** */
@@ -179,6 +206,8 @@ int main(int argc, char *argv[])
     /* Define the different options */
     set_params();
 
+    G_option_requires(param.approximate, param.extended, NULL);
+
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
 
@@ -242,7 +271,7 @@ int main(int argc, char *argv[])
     /* set nprocs parameter */
     int nprocs;
     nprocs = G_set_omp_num_threads(param.nprocs);
-    nprocs = Rast_disable_omp_on_mask(nprocs);
+    nprocs = Rast_set_mask_threads(nprocs);
     if (nprocs < 1)
         G_fatal_error(_("<%d> is not valid number of nprocs."), nprocs);
 
@@ -315,6 +344,18 @@ int main(int argc, char *argv[])
                 assert(stats == 0);
                 map_type = this_type;
                 stats = univar_stat_with_percentiles(map_type);
+
+                /* per-zone sketches instead of all values */
+                if (param.approximate->answer) {
+                    int n_zones = zone_info.n_zones ? zone_info.n_zones : 1;
+                    double error = atof(param.error->answer);
+
+                    for (int z = 0; z < n_zones; z++) {
+                        stats[z].sketch =
+                            G_malloc(sizeof(struct quantile_sketch));
+                        quantile_sketch_init(stats[z].sketch, error);
+                    }
+                }
             }
             else if (this_type != map_type) {
                 G_fatal_error(_("Raster <%s> type mismatch"), *infile);
@@ -342,6 +383,7 @@ int main(int argc, char *argv[])
 
     /* release memory */
     free_univar_stat_struct(stats);
+    remove_spill_file();
 
     exit(EXIT_SUCCESS);
 }
@@ -376,6 +418,20 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
     const int n_zones = zone_info.n_zones;
     const int n_alloc = n_zones ? n_zones : 1;
 
+    /* extended statistics from sketches or from all values, which are
+       written to sorted runs on disk beyond the memory limit */
+    const int approximate = param.extended->answer && param.approximate->answer;
+    const int exact = param.extended->answer && !approximate;
+    const size_t max_values =
+        (size_t)atoi(param.memory->answer) * 1024 * 1024 / value_sz;
+    struct quantile_sketch *sketches = NULL;
+
+    if (approximate) {
+        sketches = G_malloc((size_t)nprocs * n_alloc * sizeof *sketches);
+        for (int i = 0; i < nprocs * n_alloc; i++)
+            quantile_sketch_init(&sketches[i], atof(param.error->answer));
+    }
+
     /* initialize for KhanSum through rows */
     double c_sum = 0.0;
     double c_sumsq = 0.0;
@@ -402,6 +458,7 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
 #pragma omp parallel private(row, c_sum, c_sumsq, c_sum_abs)
     {
         int t_id = 0;
+        size_t held = 0;
         c_sum = 0;
         c_sumsq = 0;
         c_sum_abs = 0;
@@ -464,7 +521,10 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                     continue;
                 }
 
-                if (param.extended->answer) {
+                if (approximate)
+                    quantile_sketch_add(&sketches[t_id * n_alloc + zone],
+                                        Rast_get_d_value(ptr, map_type));
+                else if (exact) {
                     zone_bucket *bucket = &zd->bucket;
 
                     /* check allocated memory */
@@ -530,6 +590,24 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                 if (n_zones)
                     zptr++;
                 zd->bucket.n++;
+
+                /* write the values of all zones of this thread as sorted
+                   runs if they take more than their share of memory */
+                if (exact && ++held >= max_values / nprocs) {
+#pragma omp critical
+                    {
+                        for (int z = 0; z < n_alloc; z++) {
+                            zone_bucket *bucket = &zw[z].bucket;
+
+                            spill_values(&stats[z],
+                                         bucket_values(bucket, map_type),
+                                         bucket->n);
+                            bucket->n = 0;
+                            bucket->nextp = bucket_values(bucket, map_type);
+                        }
+                    }
+                    held = 0;
+                }
             } /* end column loop */
             if (format != SHELL) {
 #pragma omp atomic update
@@ -545,7 +623,7 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
 
         for (int z = 0; z < n_alloc; z++) {
             zone_workspace *zd = &zw[z];
-            if (param.extended->answer) {
+            if (exact) {
 #pragma omp critical
                 {
                     /*
@@ -556,9 +634,18 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                      */
                     zone_bucket *bucket = &zd->bucket;
                     univar_stat *g_bfr = &stats[z];
+                    size_t n_mem = g_bfr->n - g_bfr->n_spilled;
                     size_t old_size;
                     size_t add_size;
 
+                    /* beyond the memory limit, sort the values on disk */
+                    if (in_memory + bucket->n > max_values) {
+                        spill_values(g_bfr, bucket_values(bucket, map_type),
+                                     bucket->n);
+                        bucket->n = 0;
+                    }
+                    in_memory += bucket->n;
+
                     switch (map_type) {
                     case DCELL_TYPE:
                         if (NULL == g_bfr->dcell_array) {
@@ -566,14 +653,14 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                             bucket->dcells = NULL;
                         }
                         else if (bucket->n != 0) {
-                            old_size = g_bfr->n * sizeof(DCELL);
+                            old_size = n_mem * sizeof(DCELL);
                             add_size = bucket->n * sizeof(DCELL);
 
                             g_bfr->dcell_array =
                                 (DCELL *)G_realloc((void *)g_bfr->dcell_array,
                                                    old_size + add_size);
-                            memcpy(&g_bfr->dcell_array[g_bfr->n],
-                                   bucket->dcells, add_size);
+                            memcpy(&g_bfr->dcell_array[n_mem], bucket->dcells,
+                                   add_size);
                         }
                         break;
                     case FCELL_TYPE:
@@ -582,14 +669,14 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                             bucket->fcells = NULL;
                         }
                         else if (bucket->n != 0) {
-                            old_size = g_bfr->n * sizeof(FCELL);
+                            old_size = n_mem * sizeof(FCELL);
                             add_size = bucket->n * sizeof(FCELL);
 
                             g_bfr->fcell_array =
                                 (FCELL *)G_realloc((void *)g_bfr->fcell_array,
                                                    old_size + add_size);
-                            memcpy(&g_bfr->fcell_array[g_bfr->n],
-                                   bucket->fcells, add_size);
+                            memcpy(&g_bfr->fcell_array[n_mem], bucket->fcells,
+                                   add_size);
                         }
                         break;
                     case CELL_TYPE:
@@ -598,12 +685,12 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
                             bucket->cells = NULL;
                         }
                         else if (bucket->n != 0) {
-                            old_size = g_bfr->n * sizeof(CELL);
+                            old_size = n_mem * sizeof(CELL);
                             add_size = bucket->n * sizeof(CELL);
 
                             g_bfr->cell_array = (CELL *)G_realloc(
                                 (void *)g_bfr->cell_array, old_size + add_size);
-                            memcpy(&g_bfr->cell_array[g_bfr->n], bucket->cells,
+                            memcpy(&g_bfr->cell_array[n_mem], bucket->cells,
                                    add_size);
                         }
                         break;
@@ -664,6 +751,19 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
         }
     } /* end parallel region */
 
+    /* merged in the order of the threads to get the same result for the
+       same number of threads */
+    if (approximate) {
+        for (int t = 0; t < nprocs; t++) {
+            for (int z = 0; z < n_alloc; z++) {
+                quantile_sketch_merge(stats[z].sketch,
+                                      &sketches[t * n_alloc + z]);
+                quantile_sketch_free(&sketches[t * n_alloc + z]);
+            }
+        }
+        G_free(sketches);
+    }
+
 #if defined(_OPENMP)
     for (int z = 0; z < n_alloc; z++) {
         omp_destroy_lock(&minmax[z]);
@@ -684,6 +784,19 @@ static void process_raster(univar_stat *stats, thread_workspace *tw,
         G_percent(rows, rows, 2);
 }
 
+/* values of a bucket of the given type */
+static void *bucket_values(zone_bucket *bucket, RASTER_MAP_TYPE map_type)
+{
+    switch (map_type) {
+    case CELL_TYPE:
+        return bucket->cells;
+    case FCELL_TYPE:
+        return bucket->fcells;
+    default:
+        return bucket->dcells;
+    }
+}
+
 /* Use Kahan sum to avoid floating point error from lots of summations */
 static void kahan_sum(double *sum, double *c, double x)
 {
@@ -0,0 +1,243 @@
+/*
+ *  Sorted runs of values for exact extended statistics with bounded memory
+ *
+ *   Copyright (C) 2026 by the GRASS Development Team
+ *
+ *      This program is free software under the GNU General Public
+ *      License (>=v2). Read the file COPYING that comes with GRASS
+ *      for details.
+ *
+ */
+
+#include <string.h>
+#include "globals.h"
+
+/* values read at once from a run */
+#define RUN_BUFFER 4096
+
+/* all runs of all zones are written to one temporary file */
+static FILE *spill_fp;
+static char *spill_name;
+
+/* current value of a run while merging runs */
+typedef struct {
+    const char *values; /* buffered values of the run */
+    size_t pos;         /* index of the current value */
+    size_t len;         /* number of buffered values */
+    size_t left;        /* number of values still in the file */
+    off_t offset;       /* file position of the next values */
+    char *buf;          /* buffer, NULL for the values in memory */
+    double value;       /* current value */
+} run_reader;
+
+static double get_value(const void *p, int map_type)
+{
+    switch (map_type) {
+    case CELL_TYPE:
+        return *(const CELL *)p;
+    case FCELL_TYPE:
+        return *(const FCELL *)p;
+    default:
+        return *(const DCELL *)p;
+    }
+}
+
+static void sort_values(void *values, size_t n, int map_type)
+{
+    if (n < 2)
+        return;
+
+    switch (map_type) {
+    case CELL_TYPE:
+        heapsort_int(values, n);
+        break;
+    case FCELL_TYPE:
+        heapsort_float(values, n);
+        break;
+    case DCELL_TYPE:
+        heapsort_double(values, n);
+        break;
+    }
+}
+
+/* moves to the next value of a run, returns 0 at its end */
+static int next_value(run_reader *r, int map_type)
+{
+    size_t value_sz = Rast_cell_size(map_type);
+
+    if (++r->pos == r->len) {
+        if (r->left == 0)
+            return 0;
+        r->len = r->left < RUN_BUFFER ? r->left : RUN_BUFFER;
+        G_fseek(spill_fp, r->offset, SEEK_SET);
+        if (fread(r->buf, value_sz, r->len, spill_fp) != r->len)
+            G_fatal_error(_("Unable to read from temporary file <%s>"),
+                          spill_name);
+        r->offset += r->len * value_sz;
+        r->left -= r->len;
+        r->values = r->buf;
+        r->pos = 0;
+    }
+    r->value = get_value(r->values + r->pos * value_sz, map_type);
+
+    return 1;
+}
+
+/* restores the order of a heap of runs by their current values */
+static void sift_down(run_reader *readers, int *heap, int n, int i)
+{
+    int child, tmp;
+
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n &&
+            readers[heap[child + 1]].value < readers[heap[child]].value)
+            child++;
+        if (readers[heap[i]].value <= readers[heap[child]].value)
+            break;
+        tmp = heap[i];
+        heap[i] = heap[child];
+        heap[child] = tmp;
+        i = child;
+    }
+}
+
+/* *************************************************************** */
+/* **** write the values of a zone as a sorted run *************** */
+/* *************************************************************** */
+void spill_values(univar_stat *stats, void *values, size_t n)
+{
+    size_t value_sz = Rast_cell_size(stats->map_type);
+    univar_run *run;
+
+    if (n == 0)
+        return;
+
+    if (!spill_fp) {
+        spill_name = G_tempfile();
+        spill_fp = fopen(spill_name, "w+b");
+        if (!spill_fp)
+            G_fatal_error(_("Unable to open temporary file <%s>"),
+                          spill_name);
+        G_verbose_message(_("Writing sorted values to temporary file <%s>"),
+                          spill_name);
+    }
+
+    sort_values(values, n, stats->map_type);
+
+    stats->runs = (univar_run *)G_realloc(
+        (void *)stats->runs, (stats->n_runs + 1) * sizeof(univar_run));
+    run = &stats->runs[stats->n_runs++];
+
+    G_fseek(spill_fp, 0, SEEK_END);
+    run->offset = G_ftell(spill_fp);
+    run->n = n;
+    if (fwrite(values, value_sz, n, spill_fp) != n)
+        G_fatal_error(_("Unable to write to temporary file <%s>"), spill_name);
+
+    stats->n += n;
+    stats->n_spilled += n;
+}
+
+/* *************************************************************** */
+/* **** values at positions of the sorted values of a zone ******* */
+/* *************************************************************** */
+void select_values(univar_stat *stats, const size_t *pos, double *values,
+                   int n_pos)
+{
+    int map_type = stats->map_type;
+    size_t value_sz = Rast_cell_size(map_type);
+    size_t n_mem = stats->n - stats->n_spilled;
+    void *array;
+    run_reader *readers;
+    int *heap, *order;
+    int i, j, tmp, n_heap;
+    size_t idx;
+
+    switch (map_type) {
+    case CELL_TYPE:
+        array = stats->cell_array;
+        break;
+    case FCELL_TYPE:
+        array = stats->fcell_array;
+        break;
+    default:
+        array = stats->dcell_array;
+        break;
+    }
+
+    sort_values(array, n_mem, map_type);
+
+    if (stats->n_runs == 0) {
+        for (i = 0; i < n_pos; i++)
+            values[i] =
+                get_value((const char *)array + pos[i] * value_sz, map_type);
+        return;
+    }
+
+    /* positions in ascending order */
+    order = (int *)G_malloc(n_pos * sizeof(int));
+    for (i = 0; i < n_pos; i++) {
+        for (j = i; j > 0 && pos[order[j - 1]] > pos[i]; j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
+    /* merge the runs and the values in memory up to the last position */
+    readers = (run_reader *)G_calloc(stats->n_runs + 1, sizeof(run_reader));
+    heap = (int *)G_malloc((stats->n_runs + 1) * sizeof(int));
+    n_heap = 0;
+    for (i = 0; i <= stats->n_runs; i++) {
+        run_reader *r = &readers[i];
+
+        if (i < stats->n_runs) {
+            r->buf = (char *)G_malloc(RUN_BUFFER * value_sz);
+            r->offset = stats->runs[i].offset;
+            r->left = stats->runs[i].n;
+        }
+        else {
+            r->values = array;
+            r->len = n_mem;
+        }
+        r->pos = (size_t)-1;
+        if (next_value(r, map_type))
+            heap[n_heap++] = i;
+    }
+    for (i = n_heap / 2 - 1; i >= 0; i--)
+        sift_down(readers, heap, n_heap, i);
+
+    j = 0;
+    for (idx = 0; j < n_pos && n_heap > 0; idx++) {
+        run_reader *r = &readers[heap[0]];
+
+        while (j < n_pos && pos[order[j]] == idx)
+            values[order[j++]] = r->value;
+
+        if (!next_value(r, map_type)) {
+            tmp = heap[0];
+            heap[0] = heap[--n_heap];
+            heap[n_heap] = tmp;
+        }
+        sift_down(readers, heap, n_heap, 0);
+    }
+
+    for (i = 0; i < stats->n_runs; i++)
+        G_free(readers[i].buf);
+    G_free(readers);
+    G_free(heap);
+    G_free(order);
+}
+
+/* *************************************************************** */
+/* **** remove the temporary file of the runs ******************** */
+/* *************************************************************** */
+void remove_spill_file(void)
+{
+    if (!spill_fp)
+        return;
+
+    fclose(spill_fp);
+    remove(spill_name);
+    G_free(spill_name);
+    spill_fp = NULL;
+    spill_name = NULL;
+}
@@ -47,6 +47,10 @@ univar_stat *create_univar_stat_struct(int map_type, int n_perc)
         stats[i].map_type = map_type;
         stats[i].n_alloc = 0;
         stats[i].first = TRUE;
+        stats[i].runs = NULL;
+        stats[i].n_runs = 0;
+        stats[i].n_spilled = 0;
+        stats[i].sketch = NULL;
     }
 
     return stats;
@@ -72,6 +76,12 @@ void free_univar_stat_struct(univar_stat *stats)
             G_free(stats[i].fcell_array);
         if (stats[i].cell_array)
             G_free(stats[i].cell_array);
+        if (stats[i].runs)
+            G_free(stats[i].runs);
+        if (stats[i].sketch) {
+            quantile_sketch_free(stats[i].sketch);
+            G_free(stats[i].sketch);
+        }
     }
 
     G_free(stats);
@@ -79,6 +89,60 @@ void free_univar_stat_struct(univar_stat *stats)
     return;
 }
 
+/* *************************************************************** */
+/* **** quartiles, median and percentiles of a zone ************** */
+/* *************************************************************** */
+static void extended_stats(univar_stat *stats, double *quartile_25,
+                           double *median, double *quartile_75,
+                           double *quartile_perc)
+{
+    size_t n = stats->n;
+    size_t *pos;
+    double *values;
+    unsigned int i, n_pos;
+
+    if (n == 0) {
+        *quartile_25 = *median = *quartile_75 = NAN;
+        for (i = 0; i < stats->n_perc; i++)
+            quartile_perc[i] = NAN;
+        return;
+    }
+
+    /* positions of the first quartile, the lower and upper median, the
+       third quartile and the percentiles in the sorted values */
+    n_pos = 4 + stats->n_perc;
+    pos = (size_t *)G_malloc(n_pos * sizeof(size_t));
+    values = (double *)G_malloc(n_pos * sizeof(double));
+    pos[0] = (size_t)(n * 0.25 - 0.5);
+    pos[1] = n % 2 ? n / 2 : n / 2 - 1;
+    pos[2] = n / 2;
+    pos[3] = (size_t)(n * 0.75 - 0.5);
+    for (i = 0; i < stats->n_perc; i++)
+        pos[4 + i] = (size_t)(n * 1e-2 * stats->perc[i] - 0.5);
+
+    if (stats->sketch) {
+        for (i = 0; i < n_pos; i++)
+            values[i] = quantile_sketch_value(stats->sketch, pos[i]);
+    }
+    else
+        select_values(stats, pos, values, n_pos);
+
+    *quartile_25 = values[0];
+    if (n % 2)
+        *median = values[2];
+    else if (stats->map_type == FCELL_TYPE && !stats->sketch)
+        /* the two middle values are added in single precision */
+        *median = (double)((FCELL)values[1] + (FCELL)values[2]) / 2.0;
+    else
+        *median = (values[1] + values[2]) / 2.0;
+    *quartile_75 = values[3];
+    for (i = 0; i < stats->n_perc; i++)
+        quartile_perc[i] = values[4 + i];
+
+    G_free(pos);
+    G_free(values);
+}
+
 /* *************************************************************** */
 /* **** compute and print univar statistics to stdout ************ */
 /* *************************************************************** */
@@ -120,7 +184,6 @@ int print_stats(univar_stat *stats, enum OutputFormat format)
         double quartile_25 = 0.0, quartile_75 = 0.0, *quartile_perc;
         double median = 0.0;
         unsigned int i;
-        size_t qpos_25, qpos_75, *qpos_perc;
 
         /* stats collected for this zone? */
         if (stats[z].size == 0)
@@ -268,81 +331,9 @@ int print_stats(univar_stat *stats, enum OutputFormat format)
 
         /* TODO: mode, skewness, kurtosis */
         if (param.extended->answer) {
-            qpos_perc = (size_t *)G_calloc(stats[z].n_perc, sizeof(size_t));
             quartile_perc = (double *)G_calloc(stats[z].n_perc, sizeof(double));
-
-            if (stats[z].n == 0) {
-                quartile_25 = median = quartile_75 = NAN;
-                for (i = 0; i < stats[z].n_perc; i++)
-                    quartile_perc[i] = NAN;
-            }
-            else {
-                for (i = 0; i < stats[z].n_perc; i++) {
-                    qpos_perc[i] =
-                        (size_t)(stats[z].n * 1e-2 * stats[z].perc[i] - 0.5);
-                }
-                qpos_25 = (size_t)(stats[z].n * 0.25 - 0.5);
-                qpos_75 = (size_t)(stats[z].n * 0.75 - 0.5);
-
-                switch (stats[z].map_type) {
-                case CELL_TYPE:
-                    heapsort_int(stats[z].cell_array, stats[z].n);
-
-                    quartile_25 = (double)stats[z].cell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median =
-                            (double)stats[z].cell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median =
-                            (double)(stats[z].cell_array[stats[z].n / 2 - 1] +
-                                     stats[z].cell_array[stats[z].n / 2]) /
-                            2.0;
-                    quartile_75 = (double)stats[z].cell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] =
-                            (double)stats[z].cell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                case FCELL_TYPE:
-                    heapsort_float(stats[z].fcell_array, stats[z].n);
-
-                    quartile_25 = (double)stats[z].fcell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median =
-                            (double)stats[z].fcell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median =
-                            (double)(stats[z].fcell_array[stats[z].n / 2 - 1] +
-                                     stats[z].fcell_array[stats[z].n / 2]) /
-                            2.0;
-                    quartile_75 = (double)stats[z].fcell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] =
-                            (double)stats[z].fcell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                case DCELL_TYPE:
-                    heapsort_double(stats[z].dcell_array, stats[z].n);
-
-                    quartile_25 = stats[z].dcell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median = stats[z].dcell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median = (stats[z].dcell_array[stats[z].n / 2 - 1] +
-                                  stats[z].dcell_array[stats[z].n / 2]) /
-                                 2.0;
-                    quartile_75 = stats[z].dcell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] = stats[z].dcell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                default:
-                    break;
-                }
-            }
+            extended_stats(&stats[z], &quartile_25, &median, &quartile_75,
+                           quartile_perc);
 
             switch (format) {
             case PLAIN:
@@ -468,7 +459,6 @@ int print_stats(univar_stat *stats, enum OutputFormat format)
             }
 
             G_free((void *)quartile_perc);
-            G_free((void *)qpos_perc);
         }
 
         /* G_message() prints to stderr not stdout: disabled. this \n is printed
@@ -565,7 +555,6 @@ int print_stats_table(univar_stat *stats)
         /* for extended stats */
         double quartile_25 = 0.0, quartile_75 = 0.0, *quartile_perc;
         double median = 0.0;
-        int qpos_25, qpos_75, *qpos_perc;
 
         /* stats collected for this zone? */
         if (stats[z].size == 0)
@@ -628,81 +617,9 @@ int print_stats_table(univar_stat *stats)
 
         /* TODO: mode, skewness, kurtosis */
         if (param.extended->answer) {
-            qpos_perc = (int *)G_calloc(stats[z].n_perc, sizeof(int));
             quartile_perc = (double *)G_calloc(stats[z].n_perc, sizeof(double));
-
-            if (stats[z].n == 0) {
-                quartile_25 = median = quartile_75 = NAN;
-                for (i = 0; i < stats[z].n_perc; i++)
-                    quartile_perc[i] = NAN;
-            }
-            else {
-                for (i = 0; i < stats[z].n_perc; i++) {
-                    qpos_perc[i] =
-                        (int)(stats[z].n * 1e-2 * stats[z].perc[i] - 0.5);
-                }
-                qpos_25 = (int)(stats[z].n * 0.25 - 0.5);
-                qpos_75 = (int)(stats[z].n * 0.75 - 0.5);
-
-                switch (stats[z].map_type) {
-                case CELL_TYPE:
-                    heapsort_int(stats[z].cell_array, stats[z].n);
-
-                    quartile_25 = (double)stats[z].cell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median =
-                            (double)stats[z].cell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median =
-                            (double)(stats[z].cell_array[stats[z].n / 2 - 1] +
-                                     stats[z].cell_array[stats[z].n / 2]) /
-                            2.0;
-                    quartile_75 = (double)stats[z].cell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] =
-                            (double)stats[z].cell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                case FCELL_TYPE:
-                    heapsort_float(stats[z].fcell_array, stats[z].n);
-
-                    quartile_25 = (double)stats[z].fcell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median =
-                            (double)stats[z].fcell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median =
-                            (double)(stats[z].fcell_array[stats[z].n / 2 - 1] +
-                                     stats[z].fcell_array[stats[z].n / 2]) /
-                            2.0;
-                    quartile_75 = (double)stats[z].fcell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] =
-                            (double)stats[z].fcell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                case DCELL_TYPE:
-                    heapsort_double(stats[z].dcell_array, stats[z].n);
-
-                    quartile_25 = stats[z].dcell_array[qpos_25];
-                    if (stats[z].n % 2) /* odd */
-                        median = stats[z].dcell_array[(int)(stats[z].n / 2)];
-                    else /* even */
-                        median = (stats[z].dcell_array[stats[z].n / 2 - 1] +
-                                  stats[z].dcell_array[stats[z].n / 2]) /
-                                 2.0;
-                    quartile_75 = stats[z].dcell_array[qpos_75];
-                    for (i = 0; i < stats[z].n_perc; i++) {
-                        quartile_perc[i] = stats[z].dcell_array[qpos_perc[i]];
-                    }
-                    break;
-
-                default:
-                    break;
-                }
-            }
+            extended_stats(&stats[z], &quartile_25, &median, &quartile_75,
+                           quartile_perc);
 
             /* first quartile */
             fprintf(stdout, "%s%g", zone_info.sep, quartile_25);
@@ -716,7 +633,6 @@ int print_stats_table(univar_stat *stats)
             }
 
             G_free((void *)quartile_perc);
-            G_free((void *)qpos_perc);
         }
 
         fprintf(stdout, "\n");
@@ -731,6 +731,51 @@ class TestRasterUnivar(TestCase):
                 else:
                     self.assertEqual(expected[key], received[key])
 
+    def test_extended_sorted_runs(self):
+        """Extended statistics beyond the memory limit match those in memory"""
+        outputs = []
+        for memory in (300, 0):
+            module = SimpleModule(
+                "r.univar",
+                map=["map_a", "map_b"],
+                zones="zone_map",
+                flags="e",
+                percentile=[1, 33.3, 90],
+                memory=memory,
+                nprocs=2,
+                format="json",
+            )
+            self.runModule(module)
+            outputs.append(json.loads(module.outputs.stdout))
+        self.assertEqual(outputs[0], outputs[1])
+
+    def test_extended_approximate(self):
+        """Approximate extended statistics are within the rank error"""
+        reference = [
+            {"first_quartile": 155, "median": 205.5, "third_quartile": 255, "p90": 282},
+            {"first_quartile": 200, "median": 250.5, "third_quartile": 300, "p90": 330},
+        ]
+
+        module = SimpleModule(
+            "r.univar",
+            map=["map_a", "map_b"],
+            zones="zone_map",
+            flags="ea",
+            error=0.01,
+            nprocs=4,
+            format="json",
+        )
+        self.runModule(module)
+        output = json.loads(module.outputs.stdout)
+        self.assertEqual(len(reference), len(output))
+        for expected, received in zip(reference, output):
+            # 1% of the cells of a zone are about two values
+            for key in ("first_quartile", "median", "third_quartile"):
+                self.assertAlmostEqual(expected[key], received[key], delta=3)
+            self.assertAlmostEqual(
+                expected["p90"], received["percentiles"][0]["value"], delta=3
+            )
+
 
 if __name__ == "__main__":
     from grass.gunittest.main import test
@@ -565,6 +565,38 @@ int is_point_outside_max_dist(Viewpoint vp, GridHeader hd, dimensionType row,
     return 0;
 }
 
+/* ------------------------------------------------------------ */
+/*computes the rows and columns of the grid that can be within the
+   maximum distance limit. This is the whole grid if there is no limit
+   or in latitude-longitude. */
+void get_max_dist_extent(Viewpoint vp, GridHeader *hd, float maxDist,
+                         dimensionType *minRow, dimensionType *maxRow,
+                         dimensionType *minCol, dimensionType *maxCol)
+{
+    *minRow = 0;
+    *maxRow = hd->nrows - 1;
+    *minCol = 0;
+    *maxCol = hd->ncols - 1;
+
+    if ((int)maxDist == INFINITY_DISTANCE || G_projection() == PROJECTION_LL)
+        return;
+
+    /* meters per map unit, as used by G_distance(); one cell more,
+       because distances are measured between cell centers */
+    double factor = G_distance(0.0, 0.0, 1.0, 0.0);
+    double drows = maxDist / (hd->ns_res * factor) + 1;
+    double dcols = maxDist / (hd->ew_res * factor) + 1;
+
+    if (vp.row > drows)
+        *minRow = (dimensionType)(vp.row - drows);
+    if (vp.row + drows < *maxRow)
+        *maxRow = (dimensionType)(vp.row + drows);
+    if (vp.col > dcols)
+        *minCol = (dimensionType)(vp.col - dcols);
+    if (vp.col + dcols < *maxCol)
+        *maxCol = (dimensionType)(vp.col + dcols);
+}
+
 int is_point_inside_angle(Viewpoint vp, dimensionType row, dimensionType col,
                           float minAngle, float maxAngle)
 {
@@ -66,6 +66,12 @@ typedef struct event_ {
 int is_point_outside_max_dist(Viewpoint vp, GridHeader hd, dimensionType row,
                               dimensionType col, float maxDist);
 
+/*computes the rows and columns of the grid that can be within the
+   maximum distance limit wrt viewpoint */
+void get_max_dist_extent(Viewpoint vp, GridHeader *hd, float maxDist,
+                         dimensionType *minRow, dimensionType *maxRow,
+                         dimensionType *minCol, dimensionType *maxCol);
+
 /*determines if the point at row,col is within min and max angle (in 0-360, 0 is
  * east, CCW) */
 int is_point_inside_angle(Viewpoint vp, dimensionType row, dimensionType col,
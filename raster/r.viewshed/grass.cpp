@@ -54,7 +54,8 @@ extern "C" {
    the effect of atmospheric refraction too.
  */
 surface_type adjust_for_curvature(Viewpoint vp, double row, double col,
-                                  surface_type h, ViewOptions viewOptions,
+                                  surface_type h,
+                                  const ViewOptions &viewOptions,
                                   GridHeader *hd)
 {
 
@@ -160,23 +161,18 @@ surface_type calculate_event_elevation(AEvent e, int nrows, int ncols,
 }
 
 /*  ************************************************************ */
-/* input: an array capable to hold the max number of events, a raster
-   name, a viewpoint and the viewOptions; action: figure out all events
-   in the input file, and write them to the event list. data is
-   allocated and initialized with all the cells on the same row as the
-   viewpoint. it returns the number of events. initialize and fill
-   AEvent* with all the events for the map.  Used when solving in
-   memory, so the AEvent* should fit in memory.  */
-size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
-                                 Viewpoint *vp, GridHeader *hd,
-                                 ViewOptions viewOptions, surface_type ***data,
-                                 MemoryVisibilityGrid *visgrid)
+/* fill the event list with the events of all cells, reading the
+   elevations either row by row from the open raster infd or, if elev
+   is not NULL, from the elevation grid held in memory. verbose
+   controls progress output and the warning about a NODATA viewpoint;
+   it is off when several viewpoints are swept at the same time. */
+static size_t fill_event_list_in_memory(AEvent *eventList, int infd,
+                                        G_SURFACE_T **elev, Viewpoint *vp,
+                                        GridHeader *hd, ViewOptions viewOptions,
+                                        surface_type ***data,
+                                        MemoryVisibilityGrid *visgrid,
+                                        int verbose)
 {
-
-    G_message(_("Computing events..."));
-    assert(eventList && vp && visgrid);
-    // GRASS should be defined
-
     /*alloc data ; data is used to store all the cells on the same row
        as the viewpoint. */
     *data = (surface_type **)G_malloc(3 * sizeof(surface_type *));
@@ -187,19 +183,6 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
     (*data)[1] = (*data)[0] + Rast_window_cols();
     (*data)[2] = (*data)[1] + Rast_window_cols();
 
-    /*get the mapset name */
-    const char *mapset;
-
-    mapset = G_find_raster(rastName, "");
-    if (mapset == NULL)
-        G_fatal_error(_("Raster map [%s] not found"), rastName);
-
-    /*open map */
-    int infd;
-
-    if ((infd = Rast_open_old(rastName, mapset)) < 0)
-        G_fatal_error(_("Cannot open raster file [%s]"), rastName);
-
     /*get the data_type */
     RASTER_MAP_TYPE data_type;
 
@@ -207,24 +190,20 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
     data_type = G_SURFACE_TYPE;
 
     /*buffer to hold 3 rows */
-    G_SURFACE_T **inrast;
+    G_SURFACE_T *inrast[3], *buf[3] = {NULL, NULL, NULL};
     int nrows = Rast_window_rows();
     int ncols = Rast_window_cols();
     if (nrows > maxDimension || ncols > maxDimension)
         G_fatal_error(_("Grid size exceeds max dimension: %d"), maxDimension);
 
-    inrast = (G_SURFACE_T **)G_malloc(3 * sizeof(G_SURFACE_T *));
-    assert(inrast);
-    inrast[0] = (G_SURFACE_T *)Rast_allocate_buf(data_type);
-    assert(inrast[0]);
-    inrast[1] = (G_SURFACE_T *)Rast_allocate_buf(data_type);
-    assert(inrast[1]);
-    inrast[2] = (G_SURFACE_T *)Rast_allocate_buf(data_type);
-    assert(inrast[2]);
-
-    Rast_set_null_value(inrast[0], ncols, data_type);
-    Rast_set_null_value(inrast[1], ncols, data_type);
-    Rast_set_null_value(inrast[2], ncols, data_type);
+    /* the rows of the grid in memory are used directly, only a NODATA
+       row above the first and below the last row is needed */
+    for (int k = 0; k < (elev ? 1 : 3); k++) {
+        buf[k] = (G_SURFACE_T *)Rast_allocate_buf(data_type);
+        assert(buf[k]);
+        Rast_set_null_value(buf[k], ncols, data_type);
+        inrast[k] = buf[k];
+    }
 
     int isnull = 0;
 
@@ -236,27 +215,48 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
     double ax, ay;
     AEvent e;
 
+    /* with the grid in memory, only the cells that can be within the
+       maximum distance are scanned; the rest of the row of the
+       viewpoint is NODATA */
+    dimensionType minRow = 0, maxRow = nrows - 1, minCol = 0,
+                  maxCol = ncols - 1;
+
+    if (elev) {
+        get_max_dist_extent(*vp, hd, viewOptions.maxDist, &minRow, &maxRow,
+                            &minCol, &maxCol);
+        Rast_set_null_value((*data)[0], 3 * ncols, data_type);
+    }
+
     /* read first row */
-    Rast_get_row(infd, inrast[2], 0, data_type);
+    if (!elev)
+        Rast_get_row(infd, inrast[2], 0, data_type);
 
     e.angle = -1;
-    for (i = 0; i < (dimensionType)nrows; i++) {
+    for (i = minRow; i <= maxRow; i++) {
         /*read in the raster row */
 
-        G_SURFACE_T *tmprast = inrast[0];
-        inrast[0] = inrast[1];
-        inrast[1] = inrast[2];
-        inrast[2] = tmprast;
-
-        if (i < nrows - 1)
-            Rast_get_row(infd, inrast[2], i + 1, data_type);
-        else
-            Rast_set_null_value(inrast[2], ncols, data_type);
+        if (elev) {
+            inrast[0] = i > 0 ? elev[i - 1] : buf[0];
+            inrast[1] = elev[i];
+            inrast[2] = i < nrows - 1 ? elev[i + 1] : buf[0];
+        }
+        else {
+            G_SURFACE_T *tmprast = inrast[0];
+            inrast[0] = inrast[1];
+            inrast[1] = inrast[2];
+            inrast[2] = tmprast;
+
+            if (i < nrows - 1)
+                Rast_get_row(infd, inrast[2], i + 1, data_type);
+            else
+                Rast_set_null_value(inrast[2], ncols, data_type);
+        }
 
-        G_percent(i, nrows, 2);
+        if (verbose)
+            G_percent(i, nrows, 2);
 
         /*fill event list with events from this row */
-        for (j = 0; j < (dimensionType)ncols; j++) {
+        for (j = minCol; j <= maxCol; j++) {
             e.row = i;
             e.col = j;
 
@@ -282,7 +282,7 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
                     vp->target_offset = viewOptions.tgtElev;
                 else
                     vp->target_offset = 0.;
-                if (isnull) {
+                if (isnull && verbose) {
                     /*what to do when viewpoint is NODATA ? */
                     G_warning(_("Viewpoint is NODATA."));
                     G_message(_("Will assume its elevation is = %f"), vp->elev);
@@ -367,18 +367,73 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
             nevents++;
         }
     }
-    G_percent(nrows, nrows, 2);
+    if (verbose)
+        G_percent(nrows, nrows, 2);
 
-    Rast_close(infd);
+    G_free(buf[0]);
+    G_free(buf[1]);
+    G_free(buf[2]);
 
-    G_free(inrast[0]);
-    G_free(inrast[1]);
-    G_free(inrast[2]);
-    G_free(inrast);
+    return nevents;
+}
+
+/*  ************************************************************ */
+/* input: an array capable to hold the max number of events, a raster
+   name, a viewpoint and the viewOptions; action: figure out all events
+   in the input file, and write them to the event list. data is
+   allocated and initialized with all the cells on the same row as the
+   viewpoint. it returns the number of events. initialize and fill
+   AEvent* with all the events for the map.  Used when solving in
+   memory, so the AEvent* should fit in memory.  */
+size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
+                                 Viewpoint *vp, GridHeader *hd,
+                                 ViewOptions viewOptions, surface_type ***data,
+                                 MemoryVisibilityGrid *visgrid)
+{
+
+    G_message(_("Computing events..."));
+    assert(eventList && vp && visgrid);
+    // GRASS should be defined
+
+    /*get the mapset name */
+    const char *mapset;
+
+    mapset = G_find_raster(rastName, "");
+    if (mapset == NULL)
+        G_fatal_error(_("Raster map [%s] not found"), rastName);
+
+    /*open map */
+    int infd;
+    size_t nevents;
+
+    if ((infd = Rast_open_old(rastName, mapset)) < 0)
+        G_fatal_error(_("Cannot open raster file [%s]"), rastName);
+
+    nevents = fill_event_list_in_memory(eventList, infd, NULL, vp, hd,
+                                        viewOptions, data, visgrid, 1);
+
+    Rast_close(infd);
 
     return nevents;
 }
 
+/*  ************************************************************ */
+/* same as init_event_list_in_memory(), but the elevations are taken
+   from the grid elev held in memory; nothing is printed, so that
+   several viewpoints can be processed at the same time. */
+size_t init_event_list_in_memory_from_grid(AEvent *eventList,
+                                           G_SURFACE_T **elev, Viewpoint *vp,
+                                           GridHeader *hd,
+                                           ViewOptions viewOptions,
+                                           surface_type ***data,
+                                           MemoryVisibilityGrid *visgrid)
+{
+    assert(eventList && elev && vp && visgrid);
+
+    return fill_event_list_in_memory(eventList, -1, elev, vp, hd, viewOptions,
+                                     data, visgrid, 0);
+}
+
 /* ************************************************************ */
 /* input: an arcascii file, a grid header and a viewpoint; action:
    figure out all events in the input file, and write them to the
@@ -611,6 +666,44 @@ AMI_STREAM<AEvent> *init_event_list(char *rastName, Viewpoint *vp,
     return eventList;
 }
 
+/* ************************************************************ */
+/* read the elevation raster into a grid held in memory, so that the
+   events of many viewpoints can be computed without reading the
+   raster again */
+Grid *read_elevation_grid(char *rastName, GridHeader *hd)
+{
+
+    G_message(_("Reading elevation raster map..."));
+    assert(rastName && hd);
+
+    const char *mapset;
+
+    mapset = G_find_raster(rastName, "");
+    if (mapset == NULL)
+        G_fatal_error(_("Raster map [%s] not found"), rastName);
+
+    int infd;
+
+    if ((infd = Rast_open_old(rastName, mapset)) < 0)
+        G_fatal_error(_("Cannot open raster file [%s]"), rastName);
+
+    Grid *elev = create_empty_grid();
+
+    elev->hd = (GridHeader *)G_malloc(sizeof(GridHeader));
+    *elev->hd = *hd;
+    alloc_grid_data(elev);
+
+    for (dimensionType i = 0; i < hd->nrows; i++) {
+        G_percent(i, hd->nrows, 2);
+        Rast_get_row(infd, elev->grid_data[i], i, G_SURFACE_TYPE);
+    }
+    G_percent(1, 1, 1);
+
+    Rast_close(infd);
+
+    return elev;
+}
+
 /* ************************************************************ */
 /*  saves the grid into a GRASS raster.  Loops through all elements x
    in row-column order and writes fun(x) to file. */
@@ -668,6 +761,65 @@ void save_grid_to_GRASS(Grid *grid, char *filename, RASTER_MAP_TYPE type,
     return;
 }
 
+/* ************************************************************ */
+/*  saves the result of a cumulative viewshed. countfname gets the
+   number of viewpoints each cell is visible from; anglefname, if not
+   NULL, gets the largest vertical angle under which a cell is seen
+   from another viewpoint, NODATA where it is not seen at all. Cells
+   that are NODATA in the elevation grid are NODATA in both. */
+void save_cumulative_grids_to_GRASS(Grid *elev, Grid *count, Grid *angle,
+                                    char *countfname, char *anglefname)
+{
+
+    G_important_message(_("Writing output raster map..."));
+    assert(elev && count && countfname);
+
+    int countfd, anglefd = -1;
+    CELL *countrast;
+    FCELL *anglerast = NULL;
+
+    countfd = Rast_open_new(countfname, CELL_TYPE);
+    countrast = Rast_allocate_c_buf();
+    if (angle) {
+        assert(anglefname);
+        anglefd = Rast_open_new(anglefname, FCELL_TYPE);
+        anglerast = Rast_allocate_f_buf();
+    }
+
+    dimensionType i, j;
+
+    for (i = 0; i < elev->hd->nrows; i++) {
+        G_percent(i, elev->hd->nrows, 5);
+        for (j = 0; j < elev->hd->ncols; j++) {
+            if (is_nodata(elev, elev->grid_data[i][j])) {
+                Rast_set_c_null_value(&countrast[j], 1);
+                if (angle)
+                    Rast_set_f_null_value(&anglerast[j], 1);
+                continue;
+            }
+            countrast[j] = (CELL)count->grid_data[i][j];
+            if (!angle)
+                continue;
+            if (is_visible(angle->grid_data[i][j]))
+                anglerast[j] = angle->grid_data[i][j];
+            else
+                Rast_set_f_null_value(&anglerast[j], 1);
+        }
+        Rast_put_c_row(countfd, countrast);
+        if (angle)
+            Rast_put_f_row(anglefd, anglerast);
+    }
+    G_percent(1, 1, 1);
+
+    G_free(countrast);
+    Rast_close(countfd);
+    if (angle) {
+        G_free(anglerast);
+        Rast_close(anglefd);
+    }
+    return;
+}
+
 /* ************************************************************ */
 /*  using the visibility information recorded in visgrid, it creates an
    output viewshed raster with name outfname; for every point p that
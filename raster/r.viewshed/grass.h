@@ -53,8 +53,10 @@ extern "C" {
    curvature of the earth; otherwise return the passed height
    unchanged.
  */
-float adjust_for_curvature(Viewpoint vp, double row, double col, float h,
-                           ViewOptions viewOptions);
+surface_type adjust_for_curvature(Viewpoint vp, double row, double col,
+                                  surface_type h,
+                                  const ViewOptions &viewOptions,
+                                  GridHeader *hd);
 
 /* helper function to deal with GRASS writing to a row buffer */
 void writeValue(void *ptr, int j, double x, RASTER_MAP_TYPE data_type);
@@ -82,6 +84,17 @@ size_t init_event_list_in_memory(AEvent *eventList, char *rastName,
                                  ViewOptions viewOptions, surface_type ***data,
                                  MemoryVisibilityGrid *visgrid);
 
+/*  ************************************************************ */
+/* same as init_event_list_in_memory(), but the elevations are taken
+   from the grid elev held in memory; nothing is printed, so that
+   several viewpoints can be processed at the same time. */
+size_t init_event_list_in_memory_from_grid(AEvent *eventList,
+                                           G_SURFACE_T **elev, Viewpoint *vp,
+                                           GridHeader *hd,
+                                           ViewOptions viewOptions,
+                                           surface_type ***data,
+                                           MemoryVisibilityGrid *visgrid);
+
 /* ************************************************************ */
 /* input: an arcascii file, a grid header and a viewpoint; action:
    figure out all events in the input file, and write them to the
@@ -96,12 +109,24 @@ AMI_STREAM<AEvent> *init_event_list(char *rastName, Viewpoint *vp,
                                     surface_type ***data,
                                     IOVisibilityGrid *visgrid);
 
+/* ************************************************************ */
+/* read the elevation raster into a grid held in memory */
+Grid *read_elevation_grid(char *rastName, GridHeader *hd);
+
 /* ************************************************************ */
 /*  saves the grid into a GRASS raster.  Loops through all elements x
    in row-column order and writes fun(x) to file. */
 void save_grid_to_GRASS(Grid *grid, char *filename, RASTER_MAP_TYPE type,
                         OutputMode mode);
 
+/* ************************************************************ */
+/*  saves the result of a cumulative viewshed: the number of viewpoints
+   each cell is visible from into countfname and, if angle is not
+   NULL, the largest vertical angle a cell is seen under into
+   anglefname */
+void save_cumulative_grids_to_GRASS(Grid *elev, Grid *count, Grid *angle,
+                                    char *countfname, char *anglefname);
+
 /* ************************************************************ */
 /*  using the visibility information recorded in visgrid, it creates an
    output viewshed raster with name outfname; for every point p that
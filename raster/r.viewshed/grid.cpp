@@ -141,7 +141,7 @@ void destroy_grid(Grid *grid)
         dimensionType i;
 
         for (i = 0; i < grid->hd->nrows; i++) {
-            if (!grid->grid_data[i])
+            if (grid->grid_data[i])
                 G_free((float *)grid->grid_data[i]);
         }
 
@@ -43,6 +43,7 @@
 extern "C" {
 #include <grass/config.h>
 #include <grass/gis.h>
+#include <grass/vector.h>
 #include <grass/glocale.h>
 }
 #include "grass.h"
@@ -84,9 +85,13 @@ void print_timings_internal(Rtimer sweepTime, Rtimer outputTime,
 void print_timings_external_memory(Rtimer totalTime, Rtimer viewshedTime,
                                    Rtimer outputTime, Rtimer sortOutputTime);
 
-void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
+void parse_args(int argc, char *argv[], int **vpRow, int **vpCol, int *nvp,
                 ViewOptions *viewOptions, long long *memSizeBytes,
-                Cell_head *window);
+                int *nprocs, Cell_head *window);
+
+void cumulative_viewshed(GridHeader *hd, int *vpRow, int *vpCol, int nvp,
+                         ViewOptions viewOptions, long long memSizeBytes,
+                         int nprocs);
 
 /* ------------------------------------------------------------ */
 int main(int argc, char *argv[])
@@ -122,13 +127,15 @@ int main(int argc, char *argv[])
        used.  The program uses this value to decide in which mode to
        run --- in internal memory, or external memory.  */
 
-    int vpRow, vpCol;
+    int *vpRow, *vpCol, nvp;
 
-    /* the coordinates of the viewpoint in the raster; right now the
+    /* the coordinates of the viewpoints in the raster; right now the
        algorithm assumes that the viewpoint is inside the grid, though
        this is not necessary; some changes will be needed to make it
        work with a viewpoint outside the terrain */
 
+    int nprocs;
+
     ViewOptions viewOptions;
 
     // viewOptions.inputfname = (char*)malloc(500);
@@ -143,15 +150,15 @@ int main(int argc, char *argv[])
     viewOptions.horizontal_angle_min = 0;
     viewOptions.horizontal_angle_max = 360;
 
-    parse_args(argc, argv, &vpRow, &vpCol, &viewOptions, &memSizeBytes,
-               &region);
+    parse_args(argc, argv, &vpRow, &vpCol, &nvp, &viewOptions, &memSizeBytes,
+               &nprocs, &region);
 
     /* set viewpoint with the coordinates specified by user. The
        height of the viewpoint is not known at this point---it will be
        set during the execution of the algorithm */
     Viewpoint vp;
 
-    set_viewpoint_coord(&vp, vpRow, vpCol);
+    set_viewpoint_coord(&vp, vpRow[0], vpCol[0]);
 
     /* ************************************************************ */
     /* set up the header of the raster with all raster info and make
@@ -165,7 +172,8 @@ int main(int argc, char *argv[])
     /* LT: there is no need to exit if viewpoint is outside grid,
        the algorithm will work correctly in theory. But this
        requires some changes. To do. */
-    if (!(vp.row < hd->nrows && vp.col < hd->ncols)) {
+    if (!viewOptions.doCumulative &&
+        !(vp.row < hd->nrows && vp.col < hd->ncols)) {
         /* unfortunately, we don't know the point coordinates now */
         G_warning(_("Region extent: north=%f, south=%f, east=%f, west=%f"),
                   hd->window.north, hd->window.south, hd->window.east,
@@ -190,6 +198,15 @@ int main(int argc, char *argv[])
 
     G_begin_distance_calculations();
 
+    /* ************************************************************ */
+    /* count for every cell the viewpoints it is visible from */
+    if (viewOptions.doCumulative) {
+        cumulative_viewshed(hd, vpRow, vpCol, nvp, viewOptions, memSizeBytes,
+                            nprocs);
+        G_free(hd);
+        exit(EXIT_SUCCESS);
+    }
+
     /* ************************************************************ */
     /* decide whether the computation of the viewshed will take place
        in-memory or in external memory */
@@ -396,14 +413,45 @@ int main(int argc, char *argv[])
     exit(EXIT_SUCCESS);
 }
 
+/* ------------------------------------------------------------ */
+/* convert the coordinates of a viewpoint to row and column and append
+   them to the viewpoint arrays. In cumulative mode viewpoints outside
+   of the region are skipped; returns 0 if the viewpoint was skipped */
+static int add_viewpoint(double east, double north, Cell_head *window,
+                         int doCumulative, int **vpRow, int **vpCol, int *nvp,
+                         int *nalloc)
+{
+    if (doCumulative && (east < window->west || east >= window->east ||
+                         north <= window->south || north > window->north))
+        return 0;
+
+    if (*nvp == *nalloc) {
+        *nalloc = *nalloc ? 2 * *nalloc : 16;
+        *vpRow = (int *)G_realloc(*vpRow, *nalloc * sizeof(int));
+        *vpCol = (int *)G_realloc(*vpCol, *nalloc * sizeof(int));
+    }
+
+    /*The algorithm runs with the viewpoint row and col, so we need to
+        convert the lat-lon coordinates to row and column format */
+    (*vpRow)[*nvp] = (int)Rast_northing_to_row(north, window);
+    (*vpCol)[*nvp] = (int)Rast_easting_to_col(east, window);
+    G_debug(3,
+            "viewpoint converted from current projection: (%.3f, %.3f)  to "
+            "col, row (%d, %d)",
+            east, north, (*vpCol)[*nvp], (*vpRow)[*nvp]);
+    (*nvp)++;
+
+    return 1;
+}
+
 /* ------------------------------------------------------------ */
 /* parse arguments */
-void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
+void parse_args(int argc, char *argv[], int **vpRow, int **vpCol, int *nvp,
                 ViewOptions *viewOptions, long long *memSizeBytes,
-                Cell_head *window)
+                int *nprocs, Cell_head *window)
 {
 
-    assert(vpRow && vpCol && memSizeBytes && window);
+    assert(vpRow && vpCol && nvp && memSizeBytes && nprocs && window);
 
     /* the input */
     struct Option *inputOpt;
@@ -415,6 +463,20 @@ void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
     struct Option *outputOpt;
 
     outputOpt = G_define_standard_option(G_OPT_R_OUTPUT);
+    outputOpt->description =
+        _("Name for output raster map (number of viewpoints a cell is "
+          "visible from if there are several viewpoints)");
+
+    /* the maximum vertical angle, cumulative mode */
+    struct Option *angleOpt;
+
+    angleOpt = G_define_standard_option(G_OPT_R_OUTPUT);
+    angleOpt->key = "max_angle";
+    angleOpt->required = NO;
+    angleOpt->description =
+        _("Name for output raster map with the largest vertical angle under "
+          "which a cell is seen from the viewpoints");
+    angleOpt->guisection = _("Output format");
 
     /* curvature flag */
     struct Flag *curvature;
@@ -455,8 +517,18 @@ void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
     struct Option *viewLocOpt;
 
     viewLocOpt = G_define_standard_option(G_OPT_M_COORDS);
-    viewLocOpt->required = YES;
-    viewLocOpt->description = _("Coordinates of viewing position");
+    viewLocOpt->multiple = YES;
+    viewLocOpt->description = _("Coordinates of viewing position(s)");
+
+    /* viewpoints from a vector map */
+    struct Option *observersOpt;
+
+    observersOpt = G_define_standard_option(G_OPT_V_INPUT);
+    observersOpt->key = "observers";
+    observersOpt->required = NO;
+    observersOpt->label = _("Name of input vector map with viewing positions");
+    observersOpt->description =
+        _("Cells are counted by the number of points they are visible from");
 
     /* observer elevation */
     struct Option *obsElevOpt;
@@ -561,6 +633,13 @@ void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
     streamdirOpt->description =
         _("Directory to hold temporary files (they can be large)");
 
+    /* number of threads for several viewpoints */
+    struct Option *nprocsOpt;
+
+    nprocsOpt = G_define_standard_option(G_OPT_M_NPROCS);
+
+    G_option_required(viewLocOpt, observersOpt, NULL);
+
     /*fill the options and flags with G_parser */
     if (G_parser(argc, argv))
         exit(EXIT_FAILURE);
@@ -621,19 +700,172 @@ void parse_args(int argc, char *argv[], int *vpRow, int *vpCol,
 
     G_get_set_window(window);
 
-    /*The algorithm runs with the viewpoint row and col, so we need to
-        convert the lat-lon coordinates to row and column format */
-    *vpRow = (int)Rast_northing_to_row(atof(viewLocOpt->answers[1]), window);
-    *vpCol = (int)Rast_easting_to_col(atof(viewLocOpt->answers[0]), window);
-    G_debug(3,
-            "viewpoint converted from current projection: (%.3f, %.3f)  to "
-            "col, row (%d, %d)",
-            atof(viewLocOpt->answers[0]), atof(viewLocOpt->answers[1]), *vpCol,
-            *vpRow);
+    /* several viewpoints are counted instead of giving a viewshed */
+    int ncoords = 0;
+
+    if (viewLocOpt->answers)
+        while (viewLocOpt->answers[ncoords])
+            ncoords++;
+    viewOptions->doCumulative =
+        ncoords > 2 || observersOpt->answer || angleOpt->answer;
+    viewOptions->anglefname[0] = '\0';
+    if (angleOpt->answer)
+        strcpy(viewOptions->anglefname, angleOpt->answer);
+    if (viewOptions->doCumulative &&
+        (booleanOutput->answer || elevationFlag->answer))
+        G_fatal_error(_("Flags -%c and -%c are not available for several "
+                        "viewpoints"),
+                      booleanOutput->key, elevationFlag->key);
+
+    *nprocs = G_set_omp_num_threads(nprocsOpt);
+
+    int nalloc = 0, nskipped = 0;
+
+    *vpRow = *vpCol = NULL;
+    *nvp = 0;
+    for (int i = 0; i + 1 < ncoords; i += 2) {
+        if (!add_viewpoint(atof(viewLocOpt->answers[i]),
+                           atof(viewLocOpt->answers[i + 1]), window,
+                           viewOptions->doCumulative, vpRow, vpCol, nvp,
+                           &nalloc))
+            nskipped++;
+    }
+
+    if (observersOpt->answer) {
+        struct Map_info Map;
+        struct line_pnts *Points;
+        int type;
+
+        Vect_set_open_level(1); /* topology not required */
+
+        if (1 > Vect_open_old(&Map, observersOpt->answer, ""))
+            G_fatal_error(_("Unable to open vector map <%s>"),
+                          observersOpt->answer);
+
+        Points = Vect_new_line_struct();
+
+        while ((type = Vect_read_next_line(&Map, Points, NULL)) != -2) {
+            if (type == -1) {
+                G_warning(_("Unable to read vector map"));
+                continue;
+            }
+            if (!(type & GV_POINTS))
+                continue;
+            if (!add_viewpoint(Points->x[0], Points->y[0], window,
+                               viewOptions->doCumulative, vpRow, vpCol, nvp,
+                               &nalloc))
+                nskipped++;
+        }
+
+        Vect_destroy_line_struct(Points);
+        Vect_close(&Map);
+    }
+
+    if (nskipped > 0)
+        G_warning(n_("%d viewpoint outside of the computational region "
+                     "skipped",
+                     "%d viewpoints outside of the computational region "
+                     "skipped",
+                     nskipped),
+                  nskipped);
+    if (*nvp == 0)
+        G_fatal_error(_("No viewpoints in the computational region"));
 
     return;
 }
 
+/* ------------------------------------------------------------ */
+/* compute the viewsheds of all viewpoints on the elevation raster held
+   in memory, and write the number of viewpoints every cell is visible
+   from (and optionally the largest vertical angle) */
+void cumulative_viewshed(GridHeader *hd, int *vpRow, int *vpCol, int nvp,
+                         ViewOptions viewOptions, long long memSizeBytes,
+                         int nprocs)
+{
+    Rtimer totalTime, sweepTime, outputTime;
+    int doAngle = viewOptions.anglefname[0] != '\0';
+
+    rt_start(totalTime);
+
+    /* the elevation grid and the results are shared, every thread
+       needs its own event list and visibility grid */
+    long long totalcells = (long long)hd->nrows * (long long)hd->ncols;
+    long long sharedBytes = totalcells * sizeof(float) * (doAngle ? 3 : 2);
+    long long threadBytes = get_cumulative_viewshed_memory_usage(hd, doAngle);
+    int nthreads = (int)((memSizeBytes - sharedBytes) / threadBytes);
+
+    if (nthreads < 1)
+        G_fatal_error(_("Several viewpoints require %lld MB of memory, "
+                        "increase the memory option"),
+                      (sharedBytes + threadBytes) >> 20);
+    if (nthreads < nprocs)
+        G_verbose_message(_("Memory limit allows only %d threads"), nthreads);
+    else
+        nthreads = nprocs;
+
+    Grid *elev = read_elevation_grid(viewOptions.inputfname, hd);
+
+    /* viewpoints on NODATA are skipped */
+    Viewpoint *vps = (Viewpoint *)G_malloc(nvp * sizeof(Viewpoint));
+    int n = 0;
+
+    for (int i = 0; i < nvp; i++) {
+        if (is_nodata(elev, elev->grid_data[vpRow[i]][vpCol[i]])) {
+            G_warning(_("Viewpoint at row %d, col %d is NODATA, skipped"),
+                      vpRow[i], vpCol[i]);
+            continue;
+        }
+        set_viewpoint_coord(&vps[n++], vpRow[i], vpCol[i]);
+    }
+    if (n == 0)
+        G_fatal_error(_("No viewpoints with elevation data"));
+
+    /* the results */
+    Grid *count, *angle = NULL;
+
+    count = create_empty_grid();
+    count->hd = (GridHeader *)G_malloc(sizeof(GridHeader));
+    *count->hd = *hd;
+    alloc_grid_data(count);
+    if (doAngle) {
+        angle = create_empty_grid();
+        angle->hd = (GridHeader *)G_malloc(sizeof(GridHeader));
+        *angle->hd = *hd;
+        alloc_grid_data(angle);
+    }
+
+    rt_start(sweepTime);
+    cumulative_viewshed_in_memory(elev, hd, vps, n, viewOptions, nthreads,
+                                  count, angle);
+    rt_stop(sweepTime);
+
+    rt_start(outputTime);
+    save_cumulative_grids_to_GRASS(elev, count, angle, viewOptions.outputfname,
+                                   viewOptions.anglefname);
+    rt_stop(outputTime);
+
+    rt_stop(totalTime);
+
+    print_timings_internal(sweepTime, outputTime, totalTime);
+
+    destroy_grid(elev);
+    destroy_grid(count);
+    if (angle)
+        destroy_grid(angle);
+    G_free(vps);
+
+    struct History history;
+
+    Rast_short_history(viewOptions.outputfname, "raster", &history);
+    Rast_command_history(&history);
+    Rast_write_history(viewOptions.outputfname, &history);
+    if (doAngle) {
+        Rast_short_history(viewOptions.anglefname, "raster", &history);
+        Rast_command_history(&history);
+        Rast_write_history(viewOptions.anglefname, &history);
+    }
+}
+
 /* ------------------------------------------------------------ */
 /*print the timings for the internal memory method of computing the
    viewshed */
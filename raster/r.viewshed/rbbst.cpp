@@ -76,7 +76,9 @@ extern "C" {
 #include <grass/glocale.h>
 }
 
-TreeNode *NIL;
+/* the sentinel is written to during deletion, so every thread sweeping
+   its own tree needs its own sentinel */
+static thread_local TreeNode *NIL;
 
 #define EPSILON 0.0000001
 
@@ -107,6 +109,7 @@ int is_empty(RBTree *t)
 void delete_tree(RBTree *t)
 {
     destroy_sub_tree(t->root);
+    G_free(t);
     return;
 }
 
@@ -149,7 +152,8 @@ double find_max_gradient_within_key(RBTree *rbt, double key, double angle,
    //Private below this line */
 void init_nil_node()
 {
-    NIL = (TreeNode *)G_malloc(sizeof(TreeNode));
+    if (!NIL)
+        NIL = (TreeNode *)G_malloc(sizeof(TreeNode));
     NIL->color = RB_BLACK;
     NIL->value.angle[0] = 0;
     NIL->value.angle[1] = 0;
@@ -106,6 +106,86 @@ class TestViewshed(TestCase):
         )
 
 
+class TestCumulativeViewshed(TestCase):
+    """Test viewsheds of several viewpoints against single viewsheds"""
+
+    points = [(634720, 216180), (635200, 216500), (634000, 215800)]
+    single = ["test_viewshed_single_%d" % i for i in range(len(points))]
+    count = "test_viewshed_count"
+    angle = "test_viewshed_max_angle"
+    reference = "test_viewshed_reference"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=216990, s=215520, e=635950, w=633730, res=10)
+        for point, name in zip(cls.points, cls.single):
+            cls.runModule(
+                "r.viewshed",
+                input="elevation",
+                coordinates=point,
+                output=name,
+                flags="b",
+                max_distance=1000,
+            )
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule("g.remove", flags="f", type="raster", name=cls.single)
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove",
+            flags="f",
+            type="raster",
+            name=[self.count, self.angle, self.reference],
+        )
+
+    def test_count(self):
+        """Count equals the sum of boolean viewsheds"""
+        coordinates = [c for point in self.points for c in point]
+        self.assertModule(
+            "r.viewshed",
+            input="elevation",
+            coordinates=coordinates,
+            output=self.count,
+            max_distance=1000,
+            nprocs=2,
+        )
+        self.assertRasterFitsInfo(raster=self.count, reference="datatype=CELL")
+        self.runModule(
+            "r.mapcalc",
+            expression="%s = %s" % (self.reference, " + ".join(self.single)),
+        )
+        self.assertRastersNoDifference(
+            actual=self.count, reference=self.reference, precision=0
+        )
+
+    def test_max_angle(self):
+        """Largest vertical angle is a valid angle"""
+        coordinates = [c for point in self.points for c in point]
+        self.assertModule(
+            "r.viewshed",
+            input="elevation",
+            coordinates=coordinates,
+            output=self.count,
+            max_angle=self.angle,
+        )
+        self.assertRasterMinMax(map=self.angle, refmin=0, refmax=180)
+
+    def test_flags(self):
+        """Boolean and elevation output are not available"""
+        coordinates = [c for point in self.points for c in point]
+        self.assertModuleFail(
+            "r.viewshed",
+            input="elevation",
+            coordinates=coordinates,
+            output=self.count,
+            flags="b",
+        )
+
+
 class TestViewshedAgainstReference(TestCase):
     """
 
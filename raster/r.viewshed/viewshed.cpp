@@ -37,6 +37,9 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 extern "C" {
 #include "grass/gis.h"
@@ -164,92 +167,23 @@ AEvent *allocate_eventlist(GridHeader *hd)
     return eventList;
 }
 
-/*///////////////////////////////////////////////////////////
-   ------------------------------------------------------------ run
-   Viewshed's sweep algorithm on the grid stored in the given file, and
-   with the given viewpoint.  Create a visibility grid and return
-   it. The computation runs in memory, which means the input grid, the
-   status structure and the output grid are stored in arrays in
-   memory.
-
-
-   The output: A cell x in the visibility grid is recorded as follows:
-
-   if it is NODATA, then x  is set to NODATA
-   if it is invisible, then x is set to INVISIBLE
-   if it is visible,  then x is set to the vertical angle wrt to viewpoint
-
- */
-MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
-                                         Viewpoint *vp, ViewOptions viewOptions)
+/* ------------------------------------------------------------ */
+/* sweep the event list, which must be sorted radially around the
+   viewpoint, and record the vertical angle of every visible cell in
+   visgrid; data holds the cells on the same row as the viewpoint.
+   Returns the number of visible cells. */
+static long sweep_event_list_in_memory(AEvent *eventList, size_t nevents,
+                                       surface_type **data, Viewpoint *vp,
+                                       GridHeader *hd, ViewOptions viewOptions,
+                                       MemoryVisibilityGrid *visgrid,
+                                       int verbose)
 {
-
-    assert(inputfname && hd && vp);
-    G_verbose_message(_("Start sweeping."));
-
-    /* ------------------------------ */
-    /* create the visibility grid  */
-    MemoryVisibilityGrid *visgrid;
-
-    visgrid = create_inmem_visibilitygrid(*hd, *vp);
-    /* set everything initially invisible */
-    set_inmem_visibilitygrid(visgrid, INVISIBLE);
-    assert(visgrid);
-    G_debug(1, "visibility grid size:  %d x %d x %d B (%d MB)", hd->nrows,
-            hd->ncols, (int)sizeof(float),
-            (int)(((long long)(hd->nrows * hd->ncols * sizeof(float))) >> 20));
-
-    /* ------------------------------ */
-    /* construct the event list corresponding to the given input file
-       and viewpoint; this creates an array of all the cells on the
-       same row as the viewpoint */
-    surface_type **data;
-    size_t nevents;
-
-    Rtimer initEventTime;
-
-    rt_start(initEventTime);
-
-    AEvent *eventList = allocate_eventlist(hd);
-
-    nevents = init_event_list_in_memory(eventList, inputfname, vp, hd,
-                                        viewOptions, &data, visgrid);
-
-    assert(data);
-    rt_stop(initEventTime);
-    G_debug(1, "actual nb events is %lu", (long unsigned int)nevents);
-
-    /* ------------------------------ */
-    /*sort the events radially by angle */
-    Rtimer sortEventTime;
-
-    rt_start(sortEventTime);
-    G_verbose_message(_("Sorting events..."));
-    fflush(stdout);
-
-    /*this is recursive and seg faults for large arrays
-       //qsort(eventList, nevents, sizeof(AEvent), radial_compare_events);
-
-       //this is too slow...
-       //heapsort(eventList, nevents, sizeof(AEvent), radial_compare_events);
-
-       //iostream quicksort */
-    RadialCompare cmpObj;
-
-    quicksort(eventList, nevents, cmpObj);
-    G_verbose_message(_("Done."));
-    fflush(stdout);
-    rt_stop(sortEventTime);
-
-    /* ------------------------------ */
     /*create the status structure */
     StatusList *status_struct = create_status_struct();
 
     /*Put cells that are initially on the sweepline into status structure */
-    Rtimer sweepTime;
     StatusNode sn;
 
-    rt_start(sweepTime);
     for (dimensionType i = vp->col + 1; i < hd->ncols; i++) {
         AEvent e;
         double ax, ay;
@@ -301,21 +235,19 @@ MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
             insert_into_status_struct(sn, status_struct);
         }
     }
-    G_free(data[0]);
-    G_free(data);
 
     /* ------------------------------ */
     /*sweep the event list */
     long nvis = 0; /*number of visible cells */
     AEvent *e;
 
-    G_important_message(_("Computing visibility..."));
-    G_percent(0, 100, 2);
+    if (verbose)
+        G_percent(0, 100, 2);
 
     for (size_t i = 0; i < nevents; i++) {
 
         int perc = (int)(1000000 * i / nevents);
-        if (perc > 0 && perc < 1000000)
+        if (verbose && perc > 0 && perc < 1000000)
             G_percent(perc, 1000000, 1);
 
         /*get out one event at a time and process it according to its type */
@@ -408,8 +340,103 @@ MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
             break;
         }
     }
+    if (verbose)
+        G_percent(1, 1, 1);
+
+    delete_status_structure(status_struct);
+
+    return nvis;
+}
+
+/*///////////////////////////////////////////////////////////
+   ------------------------------------------------------------ run
+   Viewshed's sweep algorithm on the grid stored in the given file, and
+   with the given viewpoint.  Create a visibility grid and return
+   it. The computation runs in memory, which means the input grid, the
+   status structure and the output grid are stored in arrays in
+   memory.
+
+
+   The output: A cell x in the visibility grid is recorded as follows:
+
+   if it is NODATA, then x  is set to NODATA
+   if it is invisible, then x is set to INVISIBLE
+   if it is visible,  then x is set to the vertical angle wrt to viewpoint
+
+ */
+MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
+                                         Viewpoint *vp, ViewOptions viewOptions)
+{
+
+    assert(inputfname && hd && vp);
+    G_verbose_message(_("Start sweeping."));
+
+    /* ------------------------------ */
+    /* create the visibility grid  */
+    MemoryVisibilityGrid *visgrid;
+
+    visgrid = create_inmem_visibilitygrid(*hd, *vp);
+    /* set everything initially invisible */
+    set_inmem_visibilitygrid(visgrid, INVISIBLE);
+    assert(visgrid);
+    G_debug(1, "visibility grid size:  %d x %d x %d B (%d MB)", hd->nrows,
+            hd->ncols, (int)sizeof(float),
+            (int)(((long long)(hd->nrows * hd->ncols * sizeof(float))) >> 20));
+
+    /* ------------------------------ */
+    /* construct the event list corresponding to the given input file
+       and viewpoint; this creates an array of all the cells on the
+       same row as the viewpoint */
+    surface_type **data;
+    size_t nevents;
+
+    Rtimer initEventTime;
+
+    rt_start(initEventTime);
+
+    AEvent *eventList = allocate_eventlist(hd);
+
+    nevents = init_event_list_in_memory(eventList, inputfname, vp, hd,
+                                        viewOptions, &data, visgrid);
+
+    assert(data);
+    rt_stop(initEventTime);
+    G_debug(1, "actual nb events is %lu", (long unsigned int)nevents);
+
+    /* ------------------------------ */
+    /*sort the events radially by angle */
+    Rtimer sortEventTime;
+
+    rt_start(sortEventTime);
+    G_verbose_message(_("Sorting events..."));
+    fflush(stdout);
+
+    /*this is recursive and seg faults for large arrays
+       //qsort(eventList, nevents, sizeof(AEvent), radial_compare_events);
+
+       //this is too slow...
+       //heapsort(eventList, nevents, sizeof(AEvent), radial_compare_events);
+
+       //iostream quicksort */
+    RadialCompare cmpObj;
+
+    quicksort(eventList, nevents, cmpObj);
+    G_verbose_message(_("Done."));
+    fflush(stdout);
+    rt_stop(sortEventTime);
+
+    /* ------------------------------ */
+    /*sweep the event list */
+    Rtimer sweepTime;
+    long nvis; /*number of visible cells */
+
+    G_important_message(_("Computing visibility..."));
+    rt_start(sweepTime);
+    nvis = sweep_event_list_in_memory(eventList, nevents, data, vp, hd,
+                                      viewOptions, visgrid, 1);
+    G_free(data[0]);
+    G_free(data);
     rt_stop(sweepTime);
-    G_percent(1, 1, 1);
 
     G_verbose_message(_("Sweeping done."));
     G_verbose_message(
@@ -426,6 +453,180 @@ MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
     return visgrid;
 }
 
+/* ------------------------------------------------------------ */
+/* return the memory usage (in bytes) of every thread of
+   cumulative_viewshed_in_memory */
+long long get_cumulative_viewshed_memory_usage(GridHeader *hd, int doAngle)
+{
+    long long totalcells = (long long)hd->nrows * (long long)hd->ncols;
+
+    /* event list and visibility grid of one viewpoint, plus the counts
+       (and angles) collected by the thread */
+    return get_viewshed_memory_usage(hd) +
+           totalcells * sizeof(float) * (doAngle ? 2 : 1);
+}
+
+/* ------------------------------------------------------------ */
+/* add the cells of visgrid visible from vp to the cumulative count and
+   angle grids, and mark them invisible again for the next viewpoint */
+static void accumulate_visibility(MemoryVisibilityGrid *visgrid, Viewpoint *vp,
+                                  const ViewOptions &viewOptions, Grid *count,
+                                  Grid *angle)
+{
+    float **vis = visgrid->grid->grid_data;
+    dimensionType minRow, maxRow, minCol, maxCol;
+
+    /* nothing beyond the maximum distance is visible */
+    get_max_dist_extent(*vp, count->hd, viewOptions.maxDist, &minRow, &maxRow,
+                        &minCol, &maxCol);
+
+    for (dimensionType i = minRow; i <= maxRow; i++) {
+        for (dimensionType j = minCol; j <= maxCol; j++) {
+            if (!is_visible(vis[i][j]))
+                continue;
+            count->grid_data[i][j] += 1;
+            /* the viewpoint sees itself at 180 degrees */
+            if (angle && (i != vp->row || j != vp->col) &&
+                vis[i][j] > angle->grid_data[i][j])
+                angle->grid_data[i][j] = vis[i][j];
+            vis[i][j] = INVISIBLE;
+        }
+    }
+}
+
+/*///////////////////////////////////////////////////////////
+   ------------------------------------------------------------
+   Compute the viewsheds of the nvp viewpoints in vps on the elevation
+   grid elev, which is held in memory and shared by all sweeps. count
+   is set to the number of viewpoints every cell is visible from; if
+   angle is not NULL, it is set to the largest vertical angle under
+   which a cell is seen from another viewpoint, INVISIBLE where it is
+   not seen at all.
+
+   The viewpoints are distributed over nthreads threads. Every thread
+   allocates its event list, visibility grid and partial results once
+   and reuses them for all the viewpoints it sweeps; the partial
+   results are added up at the end.
+ */
+void cumulative_viewshed_in_memory(Grid *elev, GridHeader *hd, Viewpoint *vps,
+                                   int nvp, ViewOptions viewOptions,
+                                   int nthreads, Grid *count, Grid *angle)
+{
+    assert(elev && hd && vps && count);
+
+    if (nthreads > nvp)
+        nthreads = nvp;
+    if (nthreads < 1)
+        nthreads = 1;
+
+    /* ------------------------------ */
+    /* allocate the state of every thread; thread 0 adds up directly
+       into the results */
+    AEvent **eventList = (AEvent **)G_malloc(nthreads * sizeof(AEvent *));
+    MemoryVisibilityGrid **visgrid = (MemoryVisibilityGrid **)G_malloc(
+        nthreads * sizeof(MemoryVisibilityGrid *));
+    Grid **tcount = (Grid **)G_malloc(nthreads * sizeof(Grid *));
+    Grid **tangle = (Grid **)G_malloc(nthreads * sizeof(Grid *));
+
+    for (int t = 0; t < nthreads; t++) {
+        eventList[t] = allocate_eventlist(hd);
+        visgrid[t] = create_inmem_visibilitygrid(*hd, vps[0]);
+        set_inmem_visibilitygrid(visgrid[t], INVISIBLE);
+        tcount[t] = count;
+        tangle[t] = angle;
+        if (t > 0) {
+            tcount[t] = create_empty_grid();
+            tcount[t]->hd = (GridHeader *)G_malloc(sizeof(GridHeader));
+            *tcount[t]->hd = *hd;
+            alloc_grid_data(tcount[t]);
+            if (angle) {
+                tangle[t] = create_empty_grid();
+                tangle[t]->hd = (GridHeader *)G_malloc(sizeof(GridHeader));
+                *tangle[t]->hd = *hd;
+                alloc_grid_data(tangle[t]);
+            }
+        }
+        for (dimensionType i = 0; i < hd->nrows; i++) {
+            for (dimensionType j = 0; j < hd->ncols; j++) {
+                tcount[t]->grid_data[i][j] = 0;
+                if (angle)
+                    tangle[t]->grid_data[i][j] = INVISIBLE;
+            }
+        }
+    }
+
+    /* ------------------------------ */
+    /* sweep the viewpoints */
+    G_important_message(_("Computing visibility from %d viewpoints..."), nvp);
+    G_percent(0, nvp, 1);
+
+    int ndone = 0;
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        int t = 0;
+
+#if defined(_OPENMP)
+        t = omp_get_thread_num();
+#endif
+        RadialCompare cmpObj;
+
+#pragma omp for schedule(dynamic)
+        for (int k = 0; k < nvp; k++) {
+            Viewpoint vp = vps[k];
+            surface_type **data;
+            size_t nevents;
+
+            nevents = init_event_list_in_memory_from_grid(
+                eventList[t], elev->grid_data, &vp, hd, viewOptions, &data,
+                visgrid[t]);
+            quicksort(eventList[t], nevents, cmpObj);
+            sweep_event_list_in_memory(eventList[t], nevents, data, &vp, hd,
+                                       viewOptions, visgrid[t], 0);
+            G_free(data[0]);
+            G_free(data);
+
+            accumulate_visibility(visgrid[t], &vp, viewOptions, tcount[t],
+                                  tangle[t]);
+
+            int done;
+
+#pragma omp atomic capture
+            done = ++ndone;
+
+            if (t == 0)
+                G_percent(done, nvp, 1);
+        }
+    }
+    G_percent(1, 1, 1);
+
+    /* ------------------------------ */
+    /* add up the partial results and clean up */
+    for (int t = 0; t < nthreads; t++) {
+        if (t > 0) {
+            for (dimensionType i = 0; i < hd->nrows; i++) {
+                for (dimensionType j = 0; j < hd->ncols; j++) {
+                    count->grid_data[i][j] += tcount[t]->grid_data[i][j];
+                    if (angle &&
+                        tangle[t]->grid_data[i][j] > angle->grid_data[i][j])
+                        angle->grid_data[i][j] = tangle[t]->grid_data[i][j];
+                }
+            }
+            destroy_grid(tcount[t]);
+            if (angle)
+                destroy_grid(tangle[t]);
+        }
+        free_inmem_visibilitygrid(visgrid[t]);
+        G_free(eventList[t]);
+    }
+    G_free(eventList);
+    G_free(visgrid);
+    G_free(tcount);
+    G_free(tangle);
+
+    return;
+}
+
 /*///////////////////////////////////////////////////////////
    ------------------------------------------------------------
    run Viewshed's algorithm on the grid stored in the given file, and
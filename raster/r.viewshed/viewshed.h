@@ -83,6 +83,21 @@ MemoryVisibilityGrid *viewshed_in_memory(char *inputfname, GridHeader *hd,
 IOVisibilityGrid *viewshed_external(char *inputfname, GridHeader *hd,
                                     Viewpoint *vp, ViewOptions viewOptions);
 
+/* ------------------------------------------------------------ */
+/*return the memory usage in bytes of every thread of
+   cumulative_viewshed_in_memory */
+long long get_cumulative_viewshed_memory_usage(GridHeader *hd, int doAngle);
+
+/* ------------------------------------------------------------ */
+/* compute the viewsheds of nvp viewpoints on the elevation grid elev
+   held in memory, using nthreads threads, and count for every cell
+   the viewpoints it is visible from. If angle is not NULL, it is set
+   to the largest vertical angle under which a cell is seen from
+   another viewpoint, INVISIBLE where it is not seen at all. */
+void cumulative_viewshed_in_memory(Grid *elev, GridHeader *hd, Viewpoint *vps,
+                                   int nvp, ViewOptions viewOptions,
+                                   int nthreads, Grid *count, Grid *angle);
+
 void print_viewshed_timings(Rtimer initEventTime, Rtimer sortEventTime,
                             Rtimer sweepTime);
 
@@ -116,6 +116,14 @@ typedef struct viewOptions_ {
     /*determines if atmospheric refraction should be considered
        when calculating.  Only implemented for GRASS version. */
 
+    int doCumulative;
+    /* count for every cell the viewpoints it is visible from, instead
+       of computing the viewshed of a single viewpoint */
+
+    char anglefname[GNAME_MAX];
+    /* in cumulative mode, the name of the raster with the largest
+       vertical angle a cell is seen under; empty if not requested */
+
     double ellps_a;            /* the parameter of the ellipsoid */
     float cellsize;            /* the cell resolution */
     char streamdir[GPATH_MAX]; /* directory for tmp files */
@@ -112,84 +112,65 @@
 #include <grass/gis.h>
 #include <grass/raster.h>
 #include <grass/vector.h>
-#include <grass/segment.h>
+#include <grass/seggrid.h>
+#include <grass/cost.h>
 #include <grass/glocale.h>
-#include "cost.h"
-#include "stash.h"
-#include "flag.h"
 
 #define SEGCOLSIZE 64
 
 struct Cell_head window;
 
-struct rc {
-    int r;
-    int c;
+/* cell record, starts with the members of struct Cost_cell */
+struct cc {
+    double cost_out; /* cumulative costs */
+    double nearest;  /* nearest start point */
+    double dtm;      /* elevation model */
+    double cost_in;  /* friction costs */
 };
 
-static struct rc *stop_pnts = NULL;
-static int n_stop_pnts = 0;
-static int stop_pnts_alloc = 0;
+/* distance factors for moves to the neighbors */
+static double NS_fac, EW_fac, DIAG_fac, H_DIAG_fac, V_DIAG_fac;
 
-int cmp_rc(struct rc *a, struct rc *b)
-{
-    if (a->r == b->r)
-        return (a->c - b->c);
-
-    return (a->r - b->r);
-}
+/* walking energy formula parameters and friction cost weight */
+static double a, b, c, d, lambda, slope_factor;
 
-void add_stop_pnt(int r, int c);
+static double move_cost(const struct Cost_search *, double, void **, int);
+static int passable(const struct Cost_search *, const void *);
 
 int main(int argc, char *argv[])
 {
     const char *cum_cost_layer, *move_dir_layer, *nearest_layer;
     const char *cost_layer, *dtm_layer;
     const char *dtm_mapset, *cost_mapset, *search_mapset;
-    void *dtm_cell, *cost_cell, *cum_cell, *dir_cell, *cell2 = NULL,
-                                                      *nearest_cell;
-    SEGMENT cost_seg, dir_seg, solve_seg;
+    void *dtm_cell, *cost_cell, *cum_cell, *cell2 = NULL, *nearest_cell;
+    SEGGRID cost_seg, dir_seg, solve_seg;
     int have_solver;
-    double *value;
     char buf[400];
     extern struct Cell_head window;
-    double NS_fac, EW_fac, DIAG_fac, H_DIAG_fac, V_DIAG_fac;
-    double fcost_dtm, fcost_cost;
-    double min_cost, old_min_cost;
-    FCELL cur_dir;
+    double min_cost;
     double zero = 0.0;
     int col, row, nrows, ncols;
     int maxcost, par_number;
     int nseg, nbytes;
     int maxmem;
     int segments_in_memory;
-    int cost_fd, cum_fd, dtm_fd, dir_fd, nearest_fd;
+    int cost_fd, cum_fd, dtm_fd, nearest_fd;
     int dir = 0;
-    double my_dtm, my_cost, check_dtm, nearest;
+    double nearest;
     double null_cost, dnullval;
-    double a, b, c, d, lambda, slope_factor;
     int srows, scols;
-    int total_reviewed;
     int keep_nulls = 1;
     int start_with_raster_vals = 1;
-    int neighbor;
-    long n_processed = 0;
     long total_cells;
     struct GModule *module;
     struct Flag *flag2, *flag3, *flag4, *flag5, *flag6;
     struct Option *opt1, *opt2, *opt3, *opt4, *opt5, *opt6, *opt7, *opt8;
     struct Option *opt9, *opt10, *opt11, *opt12, *opt13, *opt14, *opt15, *opt16;
     struct Option *opt_solve;
-    struct cost *pres_cell;
-    struct start_pt *head_start_pt = NULL;
-    struct start_pt *next_start_pt;
-    struct cc {
-        double dtm;      /* elevation model */
-        double cost_in;  /* friction costs */
-        double cost_out; /* cumulative costs */
-        double nearest;  /* nearest start point */
-    } costs;
-    FLAG *visited;
+    struct Cost_search search;
+    struct Cost_start_pt *head_start_pt = NULL;
+    struct Cost_start_pt *next_start_pt;
+    struct cc costs;
 
     void *ptr1, *ptr2;
     RASTER_MAP_TYPE dtm_data_type, cost_data_type,
@@ -201,7 +182,8 @@ int main(int argc, char *argv[])
     double disk_mb, mem_mb, pq_mb;
 
     int dir_bin;
-    DCELL mysolvedir[2], solvedir[2];
+    DCELL *solvedir;
+    struct cc *costrow;
 
     /* Definition for dimension and region check */
     struct Cell_head dtm_cellhd, cost_cellhd;
@@ -378,16 +360,21 @@ int main(int argc, char *argv[])
 
     Rast_set_d_null_value(&null_cost, 1);
 
-    if (flag2->answer)
-        total_reviewed = 16;
-    else
-        total_reviewed = 8;
+    /* Find number of rows and columns in window */
+    nrows = Rast_window_rows();
+    ncols = Rast_window_cols();
+
+    Cost_init_search(&search, nrows, ncols, flag2->answer);
+    search.move_cost = move_cost;
+    search.passable = passable;
 
     keep_nulls = flag3->answer;
 
     start_with_raster_vals = flag4->answer;
 
-    dir_bin = flag6->answer;
+    dir_bin = 0;
+    if (dir)
+        dir_bin = flag6->answer;
 
     {
         int count = 0;
@@ -405,13 +392,14 @@ int main(int argc, char *argv[])
     }
 
     if (opt3->answers) {
-        head_start_pt = process_start_coords(opt3->answers, head_start_pt);
+        head_start_pt =
+            Cost_parse_start_coords(opt3->answers, head_start_pt, &window);
         if (!head_start_pt)
             G_fatal_error(_("No start points"));
     }
 
     if (opt4->answers) {
-        if (!process_stop_coords(opt4->answers))
+        if (!Cost_parse_stop_coords(&search, opt4->answers, &window))
             G_fatal_error(_("No stop points"));
     }
 
@@ -485,10 +473,6 @@ int main(int argc, char *argv[])
     dtm_layer = opt12->answer;
     nearest_layer = opt16->answer;
 
-    /* Find number of rows and columns in window */
-    nrows = Rast_window_rows();
-    ncols = Rast_window_cols();
-
     /* Open cost cell layer for reading */
     dtm_mapset = G_find_raster2(dtm_layer, "");
     if (dtm_mapset == NULL)
@@ -599,41 +583,44 @@ int main(int argc, char *argv[])
     /* Create segmented format files for cost layer and output layer */
     G_verbose_message(_("Creating some temporary files..."));
 
-    if (Segment_open(&cost_seg, G_tempfile(), nrows, ncols, srows, scols,
-                     sizeof(struct cc), segments_in_memory) != 1)
+    if (Seggrid_open_records(&cost_seg, nrows, ncols, srows, scols,
+                             sizeof(struct cc), segments_in_memory) < 0)
         G_fatal_error(_("Can not create temporary file"));
+    /* the search goes around the start points, cells far from the
+     * current one are needed again soon */
+    Segment_set_policy(&cost_seg.seg, SEGMENT_CLOCK);
 
     if (dir == 1) {
-        if (Segment_open(&dir_seg, G_tempfile(), nrows, ncols, srows, scols,
-                         sizeof(FCELL), segments_in_memory) != 1)
+        if (Seggrid_open(&dir_seg, dir_data_type, srows, scols,
+                         segments_in_memory) < 0)
             G_fatal_error(_("Can not create temporary file"));
     }
 
     if (have_solver) {
-        int sfd, dsize;
+        int sfd;
         void *cell;
 
-        if (Segment_open(&solve_seg, G_tempfile(), nrows, ncols, srows, scols,
-                         sizeof(DCELL) * 2, segments_in_memory) != 1)
+        if (Seggrid_open_records(&solve_seg, nrows, ncols, srows, scols,
+                                 sizeof(DCELL) * 2, segments_in_memory) < 0)
             G_fatal_error(_("Can not create temporary file"));
 
+        /* the grids are new, they are filled by rows */
         sfd = Rast_open_old(opt_solve->answer, "");
         cell = Rast_allocate_buf(DCELL_TYPE);
-        Rast_set_d_null_value(&solvedir[1], 1);
-        dsize = Rast_cell_size(DCELL_TYPE);
+        solvedir = G_malloc(ncols * 2 * sizeof(DCELL));
+        for (col = 0; col < ncols; col++)
+            Rast_set_d_null_value(&solvedir[2 * col + 1], 1);
         for (row = 0; row < nrows; row++) {
             G_percent(row, nrows, 2);
             Rast_get_d_row(sfd, cell, row);
-            ptr2 = cell;
-            for (col = 0; col < ncols; col++) {
-                solvedir[0] = *(DCELL *)ptr2;
-                if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                ptr2 = G_incr_void_ptr(ptr2, dsize);
-            }
+            for (col = 0; col < ncols; col++)
+                solvedir[2 * col] = ((DCELL *)cell)[col];
+            if (Seggrid_put_row(&solve_seg, solvedir, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
         }
         Rast_close(sfd);
         G_free(cell);
+        G_free(solvedir);
     }
 
     /* Write the dtm and cost layers in the segmented file */
@@ -658,6 +645,7 @@ int main(int argc, char *argv[])
         cost_dsize = Rast_cell_size(cost_data_type);
         dtm_cell = Rast_allocate_buf(dtm_data_type);
         cost_cell = Rast_allocate_buf(cost_data_type);
+        costrow = G_malloc(ncols * sizeof(struct cc));
         p_dtm = 0.0;
         p_cost = 0.0;
 
@@ -713,35 +701,44 @@ int main(int argc, char *argv[])
                 }
 
                 costs.dtm = p_dtm;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
+                costrow[col] = costs;
                 ptr1 = G_incr_void_ptr(ptr1, cost_dsize);
                 ptr2 = G_incr_void_ptr(ptr2, dtm_dsize);
             }
+            if (Seggrid_put_row(&cost_seg, costrow, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
         }
         G_free(dtm_cell);
         G_free(cost_cell);
+        G_free(costrow);
         G_percent(1, 1, 1);
     }
 
     if (dir == 1) {
-        FCELL fnullval;
+        void *cell;
 
         G_message(_("Initializing directional output..."));
-        Rast_set_f_null_value(&fnullval, 1);
+        cell = Rast_allocate_buf(dir_data_type);
+        Rast_set_null_value(cell, ncols, dir_data_type);
         for (row = 0; row < nrows; row++) {
             G_percent(row, nrows, 2);
-            for (col = 0; col < ncols; col++) {
-                if (Segment_put(&dir_seg, &fnullval, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-            }
+            if (Seggrid_put_row(&dir_seg, cell, row) < 0)
+                G_fatal_error(_("Can not write to temporary file"));
         }
         G_percent(1, 1, 1);
+        G_free(cell);
     }
     /*   Scan the start_points layer searching for starting points.
      *   Create a heap of starting points ordered by increasing costs.
      */
-    init_heap();
+    search.cost_seg = &cost_seg.seg;
+    if (dir == 1)
+        search.dir_seg = &dir_seg.seg;
+    if (have_solver)
+        search.solve_seg = &solve_seg.seg;
+    search.dir_bin = dir_bin;
+    search.max_cost = maxcost;
+    search.total_cells = total_cells;
 
     /* read vector with start points */
     if (opt7->answer) {
@@ -786,8 +783,7 @@ int main(int argc, char *argv[])
             col = (int)Rast_easting_to_col(Points->x[0], &window);
             row = (int)Rast_northing_to_row(Points->y[0], &window);
 
-            next_start_pt =
-                (struct start_pt *)(G_malloc(sizeof(struct start_pt)));
+            next_start_pt = G_malloc(sizeof(struct Cost_start_pt));
 
             next_start_pt->row = row;
             next_start_pt->col = col;
@@ -849,12 +845,12 @@ int main(int argc, char *argv[])
             col = (int)Rast_easting_to_col(Points->x[0], &window);
             row = (int)Rast_northing_to_row(Points->y[0], &window);
 
-            add_stop_pnt(row, col);
+            Cost_add_stop_point(&search, row, col);
         }
 
         Vect_close(&In);
 
-        if (!stop_pnts)
+        if (!search.n_stop_pnts)
             G_fatal_error(_("No stop points found in vector <%s>"),
                           opt8->answer);
     }
@@ -891,25 +887,12 @@ int main(int argc, char *argv[])
                 if (!Rast_is_null_value(ptr2, data_type2)) {
                     double cellval;
 
-                    if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-
                     cellval = Rast_get_d_value(ptr2, data_type2);
-                    if (start_with_raster_vals == 1) {
-                        insert(cellval, row, col);
-                        costs.cost_out = cellval;
-                        costs.nearest = cellval;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
-                    else {
-                        value = &zero;
-                        insert(zero, row, col);
-                        costs.cost_out = *value;
-                        costs.nearest = cellval;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
+                    if (start_with_raster_vals == 1)
+                        Cost_add_start_point(&search, row, col, cellval,
+                                             cellval);
+                    else
+                        Cost_add_start_point(&search, row, col, zero, cellval);
                     got_one = 1;
                 }
                 ptr2 = G_incr_void_ptr(ptr2, dsize2);
@@ -929,45 +912,17 @@ int main(int argc, char *argv[])
 
         next_start_pt = head_start_pt;
         while (next_start_pt != NULL) {
-            value = &zero;
             if (next_start_pt->row < 0 || next_start_pt->row >= nrows ||
                 next_start_pt->col < 0 || next_start_pt->col >= ncols)
                 G_fatal_error(
                     _("Specified starting location outside database window"));
-            insert(zero, next_start_pt->row, next_start_pt->col);
-            if (Segment_get(&cost_seg, &costs, next_start_pt->row,
-                            next_start_pt->col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-            costs.cost_out = *value;
-            costs.nearest = next_start_pt->value;
-
-            if (Segment_put(&cost_seg, &costs, next_start_pt->row,
-                            next_start_pt->col) < 0)
-                G_fatal_error(_("Can not write to temporary file"));
+            Cost_add_start_point(&search, next_start_pt->row,
+                                 next_start_pt->col, zero,
+                                 next_start_pt->value);
             next_start_pt = next_start_pt->next;
         }
     }
 
-    if (n_stop_pnts > 1) {
-        int i, j;
-
-        /* prune stop points */
-        j = 1;
-        for (i = 1; i < n_stop_pnts; i++) {
-            if (stop_pnts[i].r != stop_pnts[j - 1].r ||
-                stop_pnts[i].c != stop_pnts[j - 1].c) {
-                stop_pnts[j].r = stop_pnts[i].r;
-                stop_pnts[j].c = stop_pnts[i].c;
-                j++;
-            }
-        }
-        if (n_stop_pnts > j) {
-            G_message(_("Number of duplicate stop points: %d"),
-                      n_stop_pnts - j);
-            n_stop_pnts = j;
-        }
-    }
-
     /*  Loop through the heap and perform at each cell the following:
      *   1) If an adjacent cell has not already been assigned a value compute
      *      the min cost and assign it.
@@ -978,637 +933,11 @@ int main(int argc, char *argv[])
     G_debug(1, "total cells: %ld", total_cells);
     G_debug(1, "nrows x ncols: %ld", (long)nrows * ncols);
     G_message(_("Finding cost path..."));
-    n_processed = 0;
-    visited = flag_create(nrows, ncols);
-
-    pres_cell = get_lowest();
-    while (pres_cell != NULL) {
-        struct cost *ct;
-        double N_dtm, NE_dtm, E_dtm, SE_dtm, S_dtm, SW_dtm, W_dtm, NW_dtm;
-        double NNE_dtm, ENE_dtm, ESE_dtm, SSE_dtm, SSW_dtm, WSW_dtm, WNW_dtm,
-            NNW_dtm;
-        double N_cost, NE_cost, E_cost, SE_cost, S_cost, SW_cost, W_cost,
-            NW_cost;
-        double NNE_cost, ENE_cost, ESE_cost, SSE_cost, SSW_cost, WSW_cost,
-            WNW_cost, NNW_cost;
-
-        N_dtm = NE_dtm = E_dtm = SE_dtm = S_dtm = SW_dtm = W_dtm = NW_dtm =
-            dnullval;
-        NNE_dtm = ENE_dtm = ESE_dtm = SSE_dtm = SSW_dtm = WSW_dtm = WNW_dtm =
-            NNW_dtm = dnullval;
-
-        N_cost = NE_cost = E_cost = SE_cost = S_cost = SW_cost = W_cost =
-            NW_cost = dnullval;
-        NNE_cost = ENE_cost = ESE_cost = SSE_cost = SSW_cost = WSW_cost =
-            WNW_cost = NNW_cost = dnullval;
-
-        /* If we have surpassed the user specified maximum cost, then quit */
-        if (maxcost && ((double)maxcost < pres_cell->min_cost))
-            break;
-
-        /* If I've already been updated, delete me */
-        if (Segment_get(&cost_seg, &costs, pres_cell->row, pres_cell->col) < 0)
-            G_fatal_error(_("Can not read from temporary file"));
-        old_min_cost = costs.cost_out;
-        if (!Rast_is_d_null_value(&old_min_cost)) {
-            if (pres_cell->min_cost > old_min_cost) {
-                delete(pres_cell);
-                pres_cell = get_lowest();
-                continue;
-            }
-        }
-        my_dtm = costs.dtm;
-        if (Rast_is_d_null_value(&my_dtm)) {
-            delete(pres_cell);
-            pres_cell = get_lowest();
-            continue;
-        }
-        my_cost = costs.cost_in;
-        if (Rast_is_d_null_value(&my_cost)) {
-            delete(pres_cell);
-            pres_cell = get_lowest();
-            continue;
-        }
-        if (FLAG_GET(visited, pres_cell->row, pres_cell->col)) {
-            delete(pres_cell);
-            pres_cell = get_lowest();
-            continue;
-        }
-        FLAG_SET(visited, pres_cell->row, pres_cell->col);
-
-        if (have_solver) {
-            if (Segment_get(&solve_seg, mysolvedir, pres_cell->row,
-                            pres_cell->col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-        }
-
-        nearest = costs.nearest;
-
-        row = pres_cell->row;
-        col = pres_cell->col;
-
-        G_percent(n_processed++, total_cells, 1);
-
-        /*          9    10       Order in which neighbors
-         *       13 5  3  6 14    are visited (Knight move).
-         *          1     2
-         *       16 8  4  7 15
-         *         12    11
-         */
-
-        /* drainage directions in degrees CCW from East
-         * drainage directions are set for each neighbor and must be
-         * read as from neighbor to current cell
-         *
-         * X = neighbor:
-         *
-         *       112.5       67.5
-         * 157.5 135    90   45   22.5
-         *       180     X  360
-         * 202.5 225   270  315   337.5
-         *       247.5      292.5
-         *
-         * X = current cell:
-         *
-         *       292.5      247.5
-         * 337.5 315   270  225    202.5
-         *       360     X  180
-         *  22.5  45    90  135    157.5
-         *        67.5      112.5
-         */
-
-        /* drainage directions bitmask encoded CW from North
-         * drainage directions are set for each neighbor and must be
-         * read as from neighbor to current cell
-         *
-         * bit positions, zero-based, from neighbor to current cell
-         *
-         *     X = neighbor                X = current cell
-         *
-         *      15       8                   11      12
-         *    14 6   7   0  9              10 2   3   4 13
-         *       5   X   1                    1   X   5
-         *    13 4   3   2 10               9 0   7   6 14
-         *      12      11                    8      15
-         */
-
-        for (neighbor = 1; neighbor <= total_reviewed; neighbor++) {
-            switch (neighbor) {
-            case 1:
-                row = pres_cell->row;
-                col = pres_cell->col - 1;
-                cur_dir = 360.0;
-                if (dir_bin)
-                    cur_dir = 1;
-                break;
-            case 2:
-                row = pres_cell->row;
-                col = pres_cell->col + 1;
-                cur_dir = 180.0;
-                if (dir_bin)
-                    cur_dir = 5;
-                break;
-            case 3:
-                row = pres_cell->row - 1;
-                col = pres_cell->col;
-                cur_dir = 270.0;
-                if (dir_bin)
-                    cur_dir = 3;
-                break;
-            case 4:
-                row = pres_cell->row + 1;
-                col = pres_cell->col;
-                cur_dir = 90.0;
-                if (dir_bin)
-                    cur_dir = 7;
-                break;
-            case 5:
-                row = pres_cell->row - 1;
-                col = pres_cell->col - 1;
-                cur_dir = 315.0;
-                if (dir_bin)
-                    cur_dir = 2;
-                break;
-            case 6:
-                row = pres_cell->row - 1;
-                col = pres_cell->col + 1;
-                cur_dir = 225.0;
-                if (dir_bin)
-                    cur_dir = 4;
-                break;
-            case 7:
-                row = pres_cell->row + 1;
-                col = pres_cell->col + 1;
-                cur_dir = 135.0;
-                if (dir_bin)
-                    cur_dir = 6;
-                break;
-            case 8:
-                row = pres_cell->row + 1;
-                col = pres_cell->col - 1;
-                cur_dir = 45.0;
-                if (dir_bin)
-                    cur_dir = 0;
-                break;
-            case 9:
-                row = pres_cell->row - 2;
-                col = pres_cell->col - 1;
-                cur_dir = 292.5;
-                if (dir_bin)
-                    cur_dir = 11;
-                break;
-            case 10:
-                row = pres_cell->row - 2;
-                col = pres_cell->col + 1;
-                cur_dir = 247.5;
-                if (dir_bin)
-                    cur_dir = 12;
-                break;
-            case 11:
-                row = pres_cell->row + 2;
-                col = pres_cell->col + 1;
-                cur_dir = 112.5;
-                if (dir_bin)
-                    cur_dir = 15;
-                break;
-            case 12:
-                row = pres_cell->row + 2;
-                col = pres_cell->col - 1;
-                cur_dir = 67.5;
-                if (dir_bin)
-                    cur_dir = 8;
-                break;
-            case 13:
-                row = pres_cell->row - 1;
-                col = pres_cell->col - 2;
-                cur_dir = 337.5;
-                if (dir_bin)
-                    cur_dir = 10;
-                break;
-            case 14:
-                row = pres_cell->row - 1;
-                col = pres_cell->col + 2;
-                cur_dir = 202.5;
-                if (dir_bin)
-                    cur_dir = 13;
-                break;
-            case 15:
-                row = pres_cell->row + 1;
-                col = pres_cell->col + 2;
-                cur_dir = 157.5;
-                if (dir_bin)
-                    cur_dir = 14;
-                break;
-            case 16:
-                row = pres_cell->row + 1;
-                col = pres_cell->col - 2;
-                cur_dir = 22.5;
-                if (dir_bin)
-                    cur_dir = 9;
-                break;
-            }
-
-            if (row < 0 || row >= nrows)
-                continue;
-            if (col < 0 || col >= ncols)
-                continue;
-
-            /* skip already processed neighbors here ? */
-
-            min_cost = dnullval;
-            if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-
-            switch (neighbor) {
-            case 1:
-                W_dtm = costs.dtm;
-                W_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&W_cost))
-                    continue;
-                check_dtm = (W_dtm - my_dtm) / EW_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(W_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(W_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(W_dtm - my_dtm) * c;
-                fcost_cost = (double)(W_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (EW_fac * a) +
-                           lambda * fcost_cost * EW_fac;
-                break;
-            case 2:
-                E_dtm = costs.dtm;
-                E_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&E_cost))
-                    continue;
-                check_dtm = (E_dtm - my_dtm) / EW_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(E_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(E_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(E_dtm - my_dtm) * c;
-                fcost_cost = (double)(E_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (EW_fac * a) +
-                           lambda * fcost_cost * EW_fac;
-                break;
-            case 3:
-                N_dtm = costs.dtm;
-                N_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&N_cost))
-                    continue;
-                check_dtm = (N_dtm - my_dtm) / NS_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(N_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(N_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(N_dtm - my_dtm) * c;
-                fcost_cost = (double)(N_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (NS_fac * a) +
-                           lambda * fcost_cost * NS_fac;
-                break;
-            case 4:
-                S_dtm = costs.dtm;
-                S_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&S_cost))
-                    continue;
-                check_dtm = (S_dtm - my_dtm) / NS_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(S_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(S_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(S_dtm - my_dtm) * c;
-                fcost_cost = (double)(S_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (NS_fac * a) +
-                           lambda * fcost_cost * NS_fac;
-                break;
-            case 5:
-                NW_dtm = costs.dtm;
-                NW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&NW_cost))
-                    continue;
-                check_dtm = (NW_dtm - my_dtm) / DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(NW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(NW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(NW_dtm - my_dtm) * c;
-                fcost_cost = (double)(NW_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (DIAG_fac * a) +
-                           lambda * fcost_cost * DIAG_fac;
-                break;
-            case 6:
-                NE_dtm = costs.dtm;
-                NE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&NE_cost))
-                    continue;
-                check_dtm = (NE_dtm - my_dtm) / DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(NE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(NE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(NE_dtm - my_dtm) * c;
-                fcost_cost = (double)(NE_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (DIAG_fac * a) +
-                           lambda * fcost_cost * DIAG_fac;
-                break;
-            case 7:
-                SE_dtm = costs.dtm;
-                SE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&SE_cost))
-                    continue;
-                check_dtm = (SE_dtm - my_dtm) / DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(SE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(SE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(SE_dtm - my_dtm) * c;
-                fcost_cost = (double)(SE_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (DIAG_fac * a) +
-                           lambda * fcost_cost * DIAG_fac;
-                break;
-            case 8:
-                SW_dtm = costs.dtm;
-                SW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&SW_cost))
-                    continue;
-                check_dtm = (SW_dtm - my_dtm) / DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(SW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(SW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(SW_dtm - my_dtm) * c;
-                fcost_cost = (double)(SW_cost + my_cost) / 2.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (DIAG_fac * a) +
-                           lambda * fcost_cost * DIAG_fac;
-                break;
-            case 9:
-                NNW_dtm = costs.dtm;
-                NNW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&NNW_cost))
-                    continue;
-                check_dtm = (NNW_dtm - my_dtm) / V_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(NNW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(NNW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(NNW_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(N_cost + NW_cost + NNW_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (V_DIAG_fac * a) +
-                           lambda * fcost_cost * V_DIAG_fac;
-                break;
-            case 10:
-                NNE_dtm = costs.dtm;
-                NNE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&NNE_cost))
-                    continue;
-                check_dtm = ((NNE_dtm - my_dtm) / V_DIAG_fac);
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(NNE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(NNE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(NNE_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(N_cost + NE_cost + NNE_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (V_DIAG_fac * a) +
-                           lambda * fcost_cost * V_DIAG_fac;
-                break;
-            case 11:
-                SSE_dtm = costs.dtm;
-                SSE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&SSE_cost))
-                    continue;
-                check_dtm = (SSE_dtm - my_dtm) / V_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(SSE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(SSE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(SSE_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(S_cost + SE_cost + SSE_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (V_DIAG_fac * a) +
-                           lambda * fcost_cost * V_DIAG_fac;
-                break;
-            case 12:
-                SSW_dtm = costs.dtm;
-                SSW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&SSW_cost))
-                    continue;
-                check_dtm = (SSW_dtm - my_dtm) / V_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(SSW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(SSW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(SSW_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(S_cost + SW_cost + SSW_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (V_DIAG_fac * a) +
-                           lambda * fcost_cost * V_DIAG_fac;
-                break;
-            case 13:
-                WNW_dtm = costs.dtm;
-                WNW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&WNW_cost))
-                    continue;
-                check_dtm = (WNW_dtm - my_dtm) / H_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(WNW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(WNW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(WNW_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(W_cost + NW_cost + WNW_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (H_DIAG_fac * a) +
-                           lambda * fcost_cost * H_DIAG_fac;
-                break;
-            case 14:
-                ENE_dtm = costs.dtm;
-                ENE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&ENE_cost))
-                    continue;
-                check_dtm = (ENE_dtm - my_dtm) / H_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(ENE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(ENE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(ENE_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(E_cost + NE_cost + ENE_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (H_DIAG_fac * a) +
-                           lambda * fcost_cost * H_DIAG_fac;
-                break;
-            case 15:
-                ESE_dtm = costs.dtm;
-                ESE_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&ESE_cost))
-                    continue;
-                check_dtm = (ESE_dtm - my_dtm) / H_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(ESE_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(ESE_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(ESE_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(E_cost + SE_cost + ESE_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (H_DIAG_fac * a) +
-                           lambda * fcost_cost * H_DIAG_fac;
-                break;
-            case 16:
-                WSW_dtm = costs.dtm;
-                WSW_cost = costs.cost_in;
-                if (Rast_is_d_null_value(&WSW_cost))
-                    continue;
-                check_dtm = (WSW_dtm - my_dtm) / H_DIAG_fac;
-                if (check_dtm >= 0)
-                    fcost_dtm = (double)(WSW_dtm - my_dtm) * b;
-                else if (check_dtm < (slope_factor))
-                    fcost_dtm = (double)(WSW_dtm - my_dtm) * d;
-                else
-                    fcost_dtm = (double)(WSW_dtm - my_dtm) * c;
-                fcost_cost =
-                    (double)(W_cost + SW_cost + WSW_cost + my_cost) / 4.0;
-                min_cost = pres_cell->min_cost + fcost_dtm + (H_DIAG_fac * a) +
-                           lambda * fcost_cost * H_DIAG_fac;
-                break;
-            }
-
-            /* skip if costs could not be calculated */
-            if (Rast_is_d_null_value(&min_cost))
-                continue;
-
-            if (Segment_get(&cost_seg, &costs, row, col) < 0)
-                G_fatal_error(_("Can not read from temporary file"));
-            old_min_cost = costs.cost_out;
-
-            /* add to list */
-            if (Rast_is_d_null_value(&old_min_cost)) {
-                costs.cost_out = min_cost;
-                costs.nearest = nearest;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                insert(min_cost, row, col);
-                if (dir == 1) {
-                    if (dir_bin)
-                        cur_dir = (1 << (int)cur_dir);
-                    if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    solvedir[1] = mysolvedir[0];
-                    if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-            }
-            /* update with lower costs */
-            else if (old_min_cost > min_cost) {
-                costs.cost_out = min_cost;
-                costs.nearest = nearest;
-                if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                    G_fatal_error(_("Can not write to temporary file"));
-                insert(min_cost, row, col);
-                if (dir == 1) {
-                    if (dir_bin)
-                        cur_dir = (1 << (int)cur_dir);
-                    if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    solvedir[1] = mysolvedir[0];
-                    if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not write to temporary file"));
-                }
-            }
-            else if (old_min_cost == min_cost && (dir_bin || have_solver) &&
-                     !(FLAG_GET(visited, row, col))) {
-                FCELL old_dir;
-
-                int dir_inv[16] = {4,  5,  6,  7,  0, 1, 2,  3,
-                                   12, 13, 14, 15, 8, 9, 10, 11};
-                int dir_fwd;
-                int equal = 1;
-
-                /* only update neighbors that have not yet been processed,
-                 * otherwise we might get circular paths */
-
-                if (have_solver) {
-                    if (Segment_get(&solve_seg, solvedir, row, col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    equal = (solvedir[1] == mysolvedir[0]);
-                    if (solvedir[1] > mysolvedir[0]) {
-                        solvedir[1] = mysolvedir[0];
-                        if (Segment_put(&solve_seg, solvedir, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-
-                        costs.nearest = nearest;
-                        if (Segment_put(&cost_seg, &costs, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-
-                        if (dir == 1) {
-                            if (dir_bin)
-                                cur_dir = (1 << (int)cur_dir);
-                            if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                                G_fatal_error(
-                                    _("Can not write to temporary file"));
-                        }
-                    }
-                }
-
-                if (dir_bin && equal) {
-                    /* this can create circular paths:
-                     * set only if current cell does not point to neighbor
-                     * does not avoid longer circular paths */
-                    if (Segment_get(&dir_seg, &old_dir, pres_cell->row,
-                                    pres_cell->col) < 0)
-                        G_fatal_error(_("Can not read from temporary file"));
-                    dir_fwd = (1 << dir_inv[(int)cur_dir]);
-                    if (!((int)old_dir & dir_fwd)) {
-                        if (Segment_get(&dir_seg, &old_dir, row, col) < 0)
-                            G_fatal_error(
-                                _("Can not read from temporary file"));
-                        cur_dir = ((1 << (int)cur_dir) | (int)old_dir);
-                        if (Segment_put(&dir_seg, &cur_dir, row, col) < 0)
-                            G_fatal_error(_("Can not write to temporary file"));
-                    }
-                }
-            }
-        }
-
-        if (stop_pnts && time_to_stop(pres_cell->row, pres_cell->col))
-            break;
-
-        ct = pres_cell;
-        delete(pres_cell);
-        pres_cell = get_lowest();
-
-        if (ct == pres_cell)
-            G_warning(_("Error, ct == pres_cell"));
-    }
-    G_percent(1, 1, 1);
-
-    /* free heap */
-    free_heap();
-    flag_destroy(visited);
+    Cost_run_search(&search);
+    Cost_free_search(&search);
 
     if (have_solver) {
-        Segment_close(&solve_seg);
+        Seggrid_close(&solve_seg);
     }
 
     /* Open cumulative cost layer for writing */
@@ -1664,7 +993,7 @@ int main(int argc, char *argv[])
                         continue;
                     }
                 }
-                if (Segment_get(&cost_seg, &costs, row, col) < 0)
+                if (Seggrid_get(&cost_seg, &costs, row, col) < 0)
                     G_fatal_error(_("Can not read from temporary file"));
                 min_cost = costs.cost_out;
                 nearest = costs.nearest;
@@ -1720,38 +1049,19 @@ int main(int argc, char *argv[])
     }
 
     if (dir == 1) {
-        void *p;
-        size_t dir_size = Rast_cell_size(dir_data_type);
-
-        dir_fd = Rast_open_new(move_dir_layer, dir_data_type);
-        dir_cell = Rast_allocate_buf(dir_data_type);
-
         G_message(_("Writing output movement direction raster map <%s>..."),
                   move_dir_layer);
-        for (row = 0; row < nrows; row++) {
-            p = dir_cell;
-            for (col = 0; col < ncols; col++) {
-                if (Segment_get(&dir_seg, &cur_dir, row, col) < 0)
-                    G_fatal_error(_("Can not read from temporary file"));
-                *((FCELL *)p) = cur_dir;
-                p = G_incr_void_ptr(p, dir_size);
-            }
-            Rast_put_row(dir_fd, dir_cell, dir_data_type);
-            G_percent(row, nrows, 2);
-        }
-        G_percent(1, 1, 1);
-        G_free(dir_cell);
+        if (Seggrid_write_raster(&dir_seg, move_dir_layer) < 0)
+            G_fatal_error(_("Can not read from temporary file"));
     }
 
-    Segment_close(&cost_seg); /* release memory  */
+    Seggrid_close(&cost_seg); /* release memory  */
     if (dir == 1)
-        Segment_close(&dir_seg);
+        Seggrid_close(&dir_seg);
 
     Rast_close(dtm_fd);
     Rast_close(cost_fd);
     Rast_close(cum_fd);
-    if (dir == 1)
-        Rast_close(dir_fd);
     if (nearest_layer)
         Rast_close(nearest_fd);
 
@@ -1802,122 +1112,60 @@ int main(int argc, char *argv[])
     exit(EXIT_SUCCESS);
 }
 
-struct start_pt *process_start_coords(char **answers,
-                                      struct start_pt *top_start_pt)
-{
-    int col, row;
-    double east, north;
-    struct start_pt *new_start_pt;
-    int point_no = 0;
-
-    if (!answers)
-        return (0);
-
-    for (; *answers != NULL; answers += 2) {
-        if (!G_scan_easting(*answers, &east, G_projection()))
-            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
-        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
-            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
-
-        if (east < window.west || east > window.east || north < window.south ||
-            north > window.north) {
-            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
-                      north);
-            continue;
-        }
-
-        row = (window.north - north) / window.ns_res;
-        col = (east - window.west) / window.ew_res;
-
-        new_start_pt = (struct start_pt *)(G_malloc(sizeof(struct start_pt)));
-
-        new_start_pt->row = row;
-        new_start_pt->col = col;
-        new_start_pt->value = ++point_no;
-        new_start_pt->next = top_start_pt;
-        top_start_pt = new_start_pt;
-    }
-
-    return top_start_pt;
-}
-
-int process_stop_coords(char **answers)
-{
-    int col, row;
-    double east, north;
-
-    if (!answers)
-        return 0;
-
-    for (; *answers != NULL; answers += 2) {
-        if (!G_scan_easting(*answers, &east, G_projection()))
-            G_fatal_error(_("Illegal x coordinate <%s>"), *answers);
-        if (!G_scan_northing(*(answers + 1), &north, G_projection()))
-            G_fatal_error(_("Illegal y coordinate <%s>"), *(answers + 1));
-
-        if (east < window.west || east > window.east || north < window.south ||
-            north > window.north) {
-            G_warning(_("Warning, ignoring point outside window: %g, %g"), east,
-                      north);
-            continue;
-        }
-
-        row = (window.north - north) / window.ns_res;
-        col = (east - window.west) / window.ew_res;
-
-        add_stop_pnt(row, col);
-    }
-
-    return (stop_pnts != NULL);
-}
-
-void add_stop_pnt(int r, int c)
+/* cumulative cost of moving from cell rec[0] to neighbor rec[neighbor],
+ * knight's moves include the friction costs of the two cells passed */
+static double move_cost(const struct Cost_search *cs, double min_cost,
+                        void **rec, int neighbor)
 {
-    int i;
-    struct rc sp;
-
-    if (n_stop_pnts == stop_pnts_alloc) {
-        stop_pnts_alloc += 100;
-        stop_pnts = (struct rc *)G_realloc(stop_pnts,
-                                           stop_pnts_alloc * sizeof(struct rc));
-    }
+    /* neighbors passed by the knight's moves 9 - 16 */
+    static const int pass1[17] = {0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  3, 3, 4, 4, 1, 2, 2, 1};
+    static const int pass2[17] = {0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                  5, 6, 7, 8, 5, 6, 7, 8};
+    struct cc *cur = rec[0], *nbr = rec[neighbor];
+    double fac, check_dtm, fcost_dtm, fcost_cost, A, B, dnullval;
+
+    Rast_set_d_null_value(&dnullval, 1);
+    if (Rast_is_d_null_value(&nbr->cost_in))
+        return dnullval;
+
+    if (neighbor > 12)
+        fac = H_DIAG_fac;
+    else if (neighbor > 8)
+        fac = V_DIAG_fac;
+    else if (neighbor > 4)
+        fac = DIAG_fac;
+    else if (neighbor > 2)
+        fac = NS_fac;
+    else
+        fac = EW_fac;
 
-    sp.r = r;
-    sp.c = c;
-    i = n_stop_pnts;
-    while (i > 0 && cmp_rc(stop_pnts + i - 1, &sp) > 0) {
-        stop_pnts[i] = stop_pnts[i - 1];
-        i--;
+    check_dtm = (nbr->dtm - cur->dtm) / fac;
+    if (check_dtm >= 0)
+        fcost_dtm = (double)(nbr->dtm - cur->dtm) * b;
+    else if (check_dtm < (slope_factor))
+        fcost_dtm = (double)(nbr->dtm - cur->dtm) * d;
+    else
+        fcost_dtm = (double)(nbr->dtm - cur->dtm) * c;
+
+    if (neighbor > 8) {
+        A = rec[pass1[neighbor]] ? ((struct cc *)rec[pass1[neighbor]])->cost_in
+                                 : dnullval;
+        B = rec[pass2[neighbor]] ? ((struct cc *)rec[pass2[neighbor]])->cost_in
+                                 : dnullval;
+        fcost_cost = (double)(A + B + nbr->cost_in + cur->cost_in) / 4.0;
     }
-    stop_pnts[i] = sp;
+    else
+        fcost_cost = (double)(nbr->cost_in + cur->cost_in) / 2.0;
 
-    n_stop_pnts++;
+    return min_cost + fcost_dtm + (fac * a) + lambda * fcost_cost * fac;
 }
 
-int time_to_stop(int row, int col)
+/* cells without elevation or friction costs are not crossed */
+static int passable(const struct Cost_search *cs, const void *rec)
 {
-    int lo, mid, hi;
-    struct rc sp;
-    static int hits = 0;
-
-    sp.r = row;
-    sp.c = col;
-
-    lo = 0;
-    hi = n_stop_pnts - 1;
-
-    /* bsearch with deferred test for equality
-     * slightly more efficient for worst case: no match */
-    while (lo < hi) {
-        mid = lo + ((hi - lo) >> 1);
-        if (cmp_rc(stop_pnts + mid, &sp) < 0)
-            lo = mid + 1;
-        else
-            hi = mid;
-    }
-    if (cmp_rc(stop_pnts + lo, &sp) == 0) {
-        return (++hits == n_stop_pnts);
-    }
+    const struct cc *costs = rec;
 
-    return 0;
+    return !Rast_is_d_null_value(&costs->dtm) &&
+           !Rast_is_d_null_value(&costs->cost_in);
 }
@@ -0,0 +1,265 @@
+"""Test of r.walk
+
+Cumulative costs are compared with a Dijkstra search over the moves of
+r.walk computed in Python.
+
+@copyright 2026 by the GRASS Development Team
+
+@license This program is free software under the GNU General Public License (>=v2).
+Read the file COPYING that comes with GRASS
+for details
+"""
+
+import heapq
+import math
+
+from grass.gunittest.case import TestCase
+from grass.gunittest.main import test
+import grass.script as gs
+
+# moves as row and column offsets
+MOVES = [(0, -1), (0, 1), (-1, 0), (1, 0), (-1, -1), (-1, 1), (1, 1), (1, -1)]
+KNIGHT_MOVES = [
+    (-2, -1),
+    (-2, 1),
+    (2, 1),
+    (2, -1),
+    (-1, -2),
+    (-1, 2),
+    (1, 2),
+    (1, -2),
+]
+
+# default walk_coeff, lambda and slope_factor
+WALK_COEFF = (0.72, 6.0, 1.9998, -1.9998)
+LAMBDA = 1.0
+SLOPE_FACTOR = -0.2125
+
+
+def read_grid(name):
+    """Return the cells of a map as rows of floats, None for null"""
+    text = gs.read_command(
+        "r.out.ascii", input=name, output="-", flags="h", null_value="*", precision=17
+    )
+    return [
+        [None if value == "*" else float(value) for value in line.split()]
+        for line in text.splitlines()
+    ]
+
+
+def reference_costs(elevation, friction, starts, ns_res, ew_res, knight=False):
+    """Cumulative walking costs from start cells (row, col) like r.walk
+
+    Moves cost the walking time over the distance and the height
+    difference plus the average friction of the cells involved times
+    the distance. Cells without elevation or friction are not crossed.
+    """
+    a, b, c, d = WALK_COEFF
+    nrows, ncols = len(friction), len(friction[0])
+    moves = [(dr, dc, (), ew_res if dr == 0 else ns_res) for dr, dc in MOVES[:4]]
+    diag = math.sqrt(ns_res * ns_res + ew_res * ew_res)
+    moves += [(dr, dc, (), diag) for dr, dc in MOVES[4:]]
+    if knight:
+        for dr, dc in KNIGHT_MOVES:
+            if abs(dr) == 2:
+                passed = ((dr // 2, 0), (dr // 2, dc))
+                fac = math.sqrt(4 * ns_res * ns_res + ew_res * ew_res)
+            else:
+                passed = ((0, dc // 2), (dr, dc // 2))
+                fac = math.sqrt(ns_res * ns_res + 4 * ew_res * ew_res)
+            moves.append((dr, dc, passed, fac))
+
+    def value(grid, row, col):
+        if not (0 <= row < nrows and 0 <= col < ncols):
+            return None
+        return grid[row][col]
+
+    result = {}
+    heap = [(0.0, row, col) for row, col in starts]
+    while heap:
+        cost, row, col = heapq.heappop(heap)
+        if (row, col) in result:
+            continue
+        result[row, col] = cost
+        z = elevation[row][col]
+        if z is None or friction[row][col] is None:
+            continue
+        for dr, dc, passed, fac in moves:
+            costs = [value(friction, row + pr, col + pc) for pr, pc in passed]
+            costs += [value(friction, row + dr, col + dc), friction[row][col]]
+            z_next = value(elevation, row + dr, col + dc)
+            if None in costs or z_next is None:
+                continue
+            dz = z_next - z
+            if dz / fac >= 0:
+                cost_dtm = dz * b
+            elif dz / fac < SLOPE_FACTOR:
+                cost_dtm = dz * d
+            else:
+                cost_dtm = dz * c
+            total = 0.0
+            for friction_cost in costs:
+                total += friction_cost
+            cost_friction = total / len(costs)
+            if (row + dr, col + dc) not in result:
+                heapq.heappush(
+                    heap,
+                    (
+                        cost + cost_dtm + fac * a + LAMBDA * cost_friction * fac,
+                        row + dr,
+                        col + dc,
+                    ),
+                )
+    return result
+
+
+class TestWalk(TestCase):
+    """Cumulative walking costs over sloped terrain with nulls"""
+
+    elevation = "test_walk_elevation"
+    friction = "test_walk_friction"
+    output = "test_walk_output"
+    # 12 rows of 2 m and 15 columns of 1 m
+    ns_res = 2
+    ew_res = 1
+    # start points in cells (row, col)
+    starts = [(2, 3), (9, 11)]
+    coordinates = [3.5, 19, 11.5, 5]
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule(
+            "g.region", n=24, s=0, e=15, w=0, nsres=cls.ns_res, ewres=cls.ew_res
+        )
+        # uphill, gentle and steep downhill moves
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.elevation} = if(row() == 7 && col() == 7, null(),"
+                " double(row()) * 0.3 + double(col()) * 0.15"
+                " + ((row() * 13 + col() * 7) % 9) * 0.05)"
+            ),
+        )
+        cls.runModule(
+            "r.mapcalc",
+            expression=(
+                f"{cls.friction} = if((row() * 3 + col()) % 11 == 0, null(),"
+                " double((row() * 7 + col() * 3) % 5) / 4)"
+            ),
+        )
+        cls.elevations = read_grid(cls.elevation)
+        cls.frictions = read_grid(cls.friction)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule(
+            "g.remove", flags="f", type="raster", name=[cls.elevation, cls.friction]
+        )
+
+    def tearDown(self):
+        self.runModule("g.remove", flags="f", type="raster", name=self.output)
+
+    def run_walk(self, **kwargs):
+        self.assertModule(
+            "r.walk",
+            elevation=self.elevation,
+            friction=self.friction,
+            output=self.output,
+            start_coordinates=self.coordinates,
+            overwrite=True,
+            **kwargs,
+        )
+
+    def assertCostsEqual(self, reference):
+        """Compare the output map with reference costs"""
+        for row, line in enumerate(read_grid(self.output)):
+            for col, value in enumerate(line):
+                expected = reference.get((row, col))
+                if expected is None:
+                    self.assertIsNone(value, msg=f"cell {row}, {col}")
+                else:
+                    self.assertAlmostEqual(
+                        value, expected, delta=1e-9, msg=f"cell {row}, {col}"
+                    )
+
+    def test_costs(self):
+        """Costs match the reference, nulls are not crossed"""
+        self.run_walk()
+        reference = reference_costs(
+            self.elevations, self.frictions, self.starts, self.ns_res, self.ew_res
+        )
+        # the cell without elevation, row() and col() count from 1
+        self.assertNotIn((6, 6), reference)
+        self.assertCostsEqual(reference)
+
+        values = list(reference.values())
+        self.assertRasterFitsUnivar(
+            self.output,
+            reference={
+                "n": len(values),
+                "min": 0,
+                "max": max(values),
+                "mean": sum(values) / len(values),
+            },
+            precision=1e-6,
+        )
+
+    def test_knight(self):
+        """Knight's moves with -k"""
+        self.run_walk(flags="k")
+        self.assertCostsEqual(
+            reference_costs(
+                self.elevations,
+                self.frictions,
+                self.starts,
+                self.ns_res,
+                self.ew_res,
+                knight=True,
+            )
+        )
+
+
+class TestWalkBitmask(TestCase):
+    """-b without outdir on a flat surface with many equal costs"""
+
+    elevation = "test_walk_bitmask_elevation"
+    friction = "test_walk_bitmask_friction"
+    output = "test_walk_bitmask_output"
+    reference = "test_walk_bitmask_reference"
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", n=20, s=0, e=20, w=0, res=1)
+        cls.runModule("r.mapcalc", expression=f"{cls.elevation} = 100.0")
+        cls.runModule("r.mapcalc", expression=f"{cls.friction} = 1.0")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+        cls.runModule(
+            "g.remove",
+            flags="f",
+            type="raster",
+            name=[cls.elevation, cls.friction, cls.output, cls.reference],
+        )
+
+    def test_bitmask_without_outdir(self):
+        """-b has no effect without outdir"""
+        for name, flags in ((self.reference, ""), (self.output, "b")):
+            self.assertModule(
+                "r.walk",
+                elevation=self.elevation,
+                friction=self.friction,
+                output=name,
+                start_coordinates=(10.5, 10.5),
+                flags=flags,
+                overwrite=True,
+            )
+        self.assertRastersNoDifference(self.output, self.reference, precision=0)
+
+
+if __name__ == "__main__":
+    test()
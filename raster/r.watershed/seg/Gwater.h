@@ -13,7 +13,7 @@
 
 #define GW_LARGE_INT off_t
 
-#include "cseg.h"
+#include <grass/seggrid.h>
 #include "flag.h"
 
 #define AR_SIZE              16
@@ -88,7 +88,7 @@ OC_STACK
 extern struct Cell_head window;
 
 extern int mfd, c_fac, abs_acc, ele_scale;
-extern SSEG search_heap;
+extern SEGGRID search_heap;
 extern int nrows, ncols;
 extern GW_LARGE_INT heap_size;
 extern GW_LARGE_INT first_astar, first_cum, nxt_avail_pt, total_cells,
@@ -98,12 +98,12 @@ extern OC_STACK *ocs;
 extern int ocs_alloced;
 extern double half_res, diag, max_length, dep_slope;
 extern int bas_thres, tot_parts;
-extern SSEG astar_pts;
-extern BSEG s_b, rtn;
-extern CSEG dis, bas, haf, r_h, dep;
-extern SSEG watalt, aspflag;
-extern DSEG slp, s_l, s_g, l_s, ril;
-extern SSEG atanb;
+extern SEGGRID astar_pts;
+extern SEGGRID s_b, rtn;
+extern SEGGRID dis, bas, haf, r_h, dep;
+extern SEGGRID watalt, aspflag;
+extern SEGGRID slp, s_l, s_g, l_s, ril;
+extern SEGGRID atanb;
 extern double segs_mb;
 extern char zero, one;
 extern double ril_value, d_zero, d_one;
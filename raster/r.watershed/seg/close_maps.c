@@ -17,14 +17,14 @@ int close_maps(void)
     ASP_FLAG *afbuf;
 
     if (rtn_flag)
-        bseg_close(&rtn);
+        Seggrid_close(&rtn);
 
     if (wat_flag) {
         G_message(_("Closing accumulation map"));
         sum = sum_sqr = stddev = 0.0;
         dbuf = Rast_allocate_d_buf();
         wabuf = G_malloc(ncols * sizeof(WAT_ALT));
-        seg_flush(&watalt);
+        Seggrid_flush(&watalt);
         if (abs_acc) {
             G_message("Writing out only positive flow accumulation values.");
             G_message("Cells with a likely underestimate for flow accumulation "
@@ -36,9 +36,9 @@ int close_maps(void)
         for (r = 0; r < nrows; r++) {
             G_percent(r, nrows, 1);
             Rast_set_d_null_value(dbuf, ncols); /* reset row to all NULL */
-            seg_get_row(&watalt, (char *)wabuf, r);
+            Seggrid_get_row(&watalt, wabuf, r);
             for (c = 0; c < ncols; c++) {
-                /* dseg_get(&wat, &dvalue, r, c); */
+                /* Seggrid_get(&wat, &dvalue, r, c); */
                 dvalue = wabuf[c].wat;
                 if (!Rast_is_d_null_value(&dvalue)) {
                     if (abs_acc) {
@@ -146,9 +146,9 @@ int close_maps(void)
         sum = sum_sqr = stddev = 0.0;
         sum2 = sum_sqr2 = 0.0;
         wabuf = G_malloc(ncols * sizeof(WAT_ALT));
-        seg_flush(&atanb);
+        Seggrid_flush(&atanb);
         if (!wat_flag)
-            seg_flush(&watalt);
+            Seggrid_flush(&watalt);
 
         fd = fd2 = -1;
         dbuf = dbuf2 = NULL;
@@ -168,7 +168,7 @@ int close_maps(void)
             if (spi_flag)
                 Rast_set_d_null_value(dbuf2, ncols); /* reset row to all NULL */
             for (c = 0; c < ncols; c++) {
-                seg_get(&atanb, (char *)&sca_tanb, r, c);
+                Seggrid_get(&atanb, &sca_tanb, r, c);
                 if (!Rast_is_d_null_value(&sca_tanb.tanb)) {
 
                     if (tci_flag) {
@@ -193,7 +193,7 @@ int close_maps(void)
         G_percent(r, nrows, 1); /* finish it */
 
         G_free(wabuf);
-        seg_close(&atanb);
+        Seggrid_close(&atanb);
 
         if (tci_flag) {
             Rast_close(fd);
@@ -303,19 +303,19 @@ int close_maps(void)
         }
     }
 
-    seg_close(&watalt);
+    Seggrid_close(&watalt);
     if (asp_flag) {
         G_message(_("Closing flow direction map"));
         cbuf = Rast_allocate_c_buf();
         afbuf = G_malloc(ncols * sizeof(ASP_FLAG));
-        seg_flush(&aspflag);
+        Seggrid_flush(&aspflag);
 
         fd = Rast_open_new(asp_name, CELL_TYPE);
 
         for (r = 0; r < nrows; r++) {
             G_percent(r, nrows, 1);
             Rast_set_c_null_value(cbuf, ncols); /* reset row to all NULL */
-            seg_get_row(&aspflag, (char *)afbuf, r);
+            Seggrid_get_row(&aspflag, afbuf, r);
             for (c = 0; c < ncols; c++) {
                 if (!FLAG_GET(afbuf[c].flag, NULLFLAG)) {
                     cbuf[c] = afbuf[c].asp;
@@ -332,35 +332,35 @@ int close_maps(void)
         Rast_make_aspect_colors(&colors, -8, 8);
         Rast_write_colors(asp_name, this_mapset, &colors);
     }
-    seg_close(&aspflag);
+    Seggrid_close(&aspflag);
     if (ls_flag) {
         G_message(_("Closing LS map"));
-        dseg_write_cellfile(&l_s, ls_name);
-        dseg_close(&l_s);
+        Seggrid_write_raster(&l_s, ls_name);
+        Seggrid_close(&l_s);
     }
     if (sl_flag) {
         G_message(_("Closing SL map"));
         for (r = 0; r < nrows; r++) {
             G_percent(r, nrows, 1);
             for (c = 0; c < ncols; c++) {
-                dseg_get(&s_l, &dvalue, r, c);
+                Seggrid_get(&s_l, &dvalue, r, c);
                 if (dvalue > max_length)
-                    dseg_put(&s_l, &max_length, r, c);
+                    Seggrid_put(&s_l, &max_length, r, c);
             }
         }
         G_percent(r, nrows, 1); /* finish it */
-        dseg_write_cellfile(&s_l, sl_name);
+        Seggrid_write_raster(&s_l, sl_name);
     }
     if (sl_flag || ls_flag || sg_flag)
-        dseg_close(&s_l);
+        Seggrid_close(&s_l);
     if (ril_flag)
-        dseg_close(&ril);
+        Seggrid_close(&ril);
     if (sg_flag)
-        dseg_write_cellfile(&s_g, sg_name);
+        Seggrid_write_raster(&s_g, sg_name);
     if (sg_flag)
-        dseg_close(&s_g);
+        Seggrid_close(&s_g);
     if (ls_flag || sg_flag)
-        cseg_close(&r_h);
+        Seggrid_close(&r_h);
 
     return 0;
 }
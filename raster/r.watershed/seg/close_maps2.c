@@ -10,7 +10,7 @@ int close_array_seg(void)
     int c, r, map_fd;
     CELL *cellrow;
 
-    /* CSEG *theseg; */
+    /* SEGGRID *theseg; */
     ASP_FLAG af;
 
     if (seg_flag || bas_flag || haf_flag) {
@@ -24,7 +24,7 @@ int close_array_seg(void)
         /*
            for (r = 0; r < nrows; r++) {
            for (c = 0; c < ncols; c++) {
-           cseg_get(theseg, &value, r, c);
+           Seggrid_get(theseg, &value, r, c);
            if (value > max)
            max = value;
            }
@@ -94,11 +94,11 @@ int close_array_seg(void)
             G_percent(r, nrows, 1);
             Rast_set_c_null_value(cellrow, ncols); /* reset row to all NULL */
             for (c = 0; c < ncols; c++) {
-                /* bseg_get(&swale, &cvalue, r, c); */
+                /* Seggrid_get(&swale, &cvalue, r, c); */
                 /* if (cvalue) */
-                seg_get(&aspflag, (char *)&af, r, c);
+                Seggrid_get(&aspflag, &af, r, c);
                 if (FLAG_GET(af.flag, SWALEFLAG))
-                    cseg_get(&bas, &(cellrow[c]), r, c);
+                    Seggrid_get(&bas, &(cellrow[c]), r, c);
             }
             Rast_put_row(map_fd, cellrow, CELL_TYPE);
         }
@@ -111,21 +111,21 @@ int close_array_seg(void)
     /* basins map */
     if (bas_flag) {
         G_message(_("Closing basins map"));
-        cseg_write_cellfile(&bas, bas_name);
+        Seggrid_write_raster(&bas, bas_name);
         Rast_write_colors(bas_name, this_mapset, &colors);
     }
 
     /* half.basins map */
     if (haf_flag) {
         G_message(_("Closing half basins map"));
-        cseg_write_cellfile(&haf, haf_name);
+        Seggrid_write_raster(&haf, haf_name);
         Rast_write_colors(haf_name, this_mapset, &colors);
     }
 
     if (seg_flag || bas_flag || haf_flag)
         Rast_free_colors(&colors);
-    cseg_close(&haf);
-    cseg_close(&bas);
+    Seggrid_close(&haf);
+    Seggrid_close(&bas);
     if (arm_flag)
         fclose(fp);
 
@@ -10,14 +10,14 @@ CELL def_basin(int row, int col, CELL basin_num, double stream_length,
     ASP_FLAG af;
 
     for (;;) {
-        cseg_put(&bas, &basin_num, row, col);
+        Seggrid_put(&bas, &basin_num, row, col);
         ct = 0;
         for (r = row - 1, rr = 0; rr < 3; r++, rr++) {
             for (c = col - 1, cc = 0; cc < 3; c++, cc++) {
                 if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
                     if (r == row && c == col)
                         continue;
-                    seg_get(&aspflag, (char *)&af, r, c);
+                    Seggrid_get(&aspflag, &af, r, c);
                     asp_value = af.asp;
                     if (asp_value < 0)
                         asp_value = -asp_value;
@@ -40,7 +40,7 @@ CELL def_basin(int row, int col, CELL basin_num, double stream_length,
             return (basin_num);
         }
         oldupdir = drain[row - new_r[1] + 1][col - new_c[1] + 1];
-        seg_get(&aspflag, (char *)&af, row, col);
+        Seggrid_get(&aspflag, &af, row, col);
         downdir = af.asp;
         if (downdir < 0)
             downdir = -downdir;
@@ -50,7 +50,7 @@ CELL def_basin(int row, int col, CELL basin_num, double stream_length,
                 if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
                     if (r == row && c == col)
                         continue;
-                    seg_get(&aspflag, (char *)&af, r, c);
+                    Seggrid_get(&aspflag, &af, r, c);
                     direction = af.asp;
                     if (direction == drain[rr][cc]) {
                         thisdir = updrain[rr][cc];
@@ -73,10 +73,10 @@ CELL def_basin(int row, int col, CELL basin_num, double stream_length,
         }
         if (leftflag > riteflag) {
             value = basin_num - 1;
-            cseg_put(&haf, &value, row, col);
+            Seggrid_put(&haf, &value, row, col);
         }
         else {
-            cseg_put(&haf, &basin_num, row, col);
+            Seggrid_put(&haf, &basin_num, row, col);
         }
         if (arm_flag) {
             if (sides == 8) {
@@ -89,7 +89,7 @@ CELL def_basin(int row, int col, CELL basin_num, double stream_length,
             }
             else { /* sides == 4 */
 
-                seg_get(&aspflag, (char *)&af, row, col);
+                Seggrid_get(&aspflag, &af, row, col);
                 asp_value = af.asp;
                 if (asp_value < 0)
                     asp_value = -asp_value;
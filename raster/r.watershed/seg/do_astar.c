@@ -75,13 +75,13 @@ int do_astar(void)
             alt_nbr[ct_dir] = 0;
             /* check if upr, upc are within region */
             if (upr >= 0 && upr < nrows && upc >= 0 && upc < ncols) {
-                seg_get(&aspflag, (char *)&af, upr, upc);
+                Seggrid_get(&aspflag, &af, upr, upc);
                 is_in_list = FLAG_GET(af.flag, INLISTFLAG);
                 is_worked = FLAG_GET(af.flag, WORKEDFLAG);
                 skip_diag = 0;
                 /* avoid diagonal flow direction bias */
                 if (!is_worked) {
-                    seg_get(&watalt, (char *)&wa, upr, upc);
+                    Seggrid_get(&watalt, &wa, upr, upc);
                     alt_nbr[ct_dir] = wa.ele;
                     slope[ct_dir] = get_slope2(alt_val, alt_nbr[ct_dir],
                                                dist_to_nbr[ct_dir]);
@@ -112,43 +112,43 @@ int do_astar(void)
                         af.asp = drain[upr - r + 1][upc - c + 1];
                         add_pt(upr, upc, alt_nbr[ct_dir]);
                         FLAG_SET(af.flag, INLISTFLAG);
-                        seg_put(&aspflag, (char *)&af, upr, upc);
+                        Seggrid_put(&aspflag, &af, upr, upc);
                     }
                     else if (!is_worked) {
                         /* neighbour is edge in list, not yet worked */
                         if (af.asp < 0 && slope[ct_dir] > 0) {
                             /* adjust flow direction for edge cell */
                             af.asp = drain[upr - r + 1][upc - c + 1];
-                            seg_put(&aspflag, (char *)&af, upr, upc);
-                            seg_get(&watalt, (char *)&wa, r, c);
+                            Seggrid_put(&aspflag, &af, upr, upc);
+                            Seggrid_get(&watalt, &wa, r, c);
                             if (wa.wat > 0) {
                                 wa.wat = -wa.wat;
-                                seg_put(&watalt, (char *)&wa, r, c);
+                                Seggrid_put(&watalt, &wa, r, c);
                             }
                         }
                         /* neighbour is inside real depression, not yet worked
                          */
                         else if (af.asp == 0) {
                             af.asp = drain[upr - r + 1][upc - c + 1];
-                            seg_put(&aspflag, (char *)&af, upr, upc);
+                            Seggrid_put(&aspflag, &af, upr, upc);
                         }
                     }
                 }
             }
         }
         /* add astar points to sorted list for flow accumulation */
-        seg_put(&astar_pts, (char *)&heap_p.pnt, 0, doer);
+        Seggrid_put(&astar_pts, &heap_p.pnt, 0, doer);
         doer--;
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
         FLAG_SET(af.flag, WORKEDFLAG);
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
     }
     if (doer != -1)
         G_fatal_error(_("bug in A* Search: doer %" PRId64 " heap size %" PRId64
                         " count %" PRId64),
                       doer, heap_size, count);
 
-    seg_close(&search_heap);
+    Seggrid_close(&search_heap);
 
     G_percent(count, do_points, 1); /* finish it */
 
@@ -178,11 +178,11 @@ static int sift_up(GW_LARGE_INT start, HEAP_PNT child_p)
 
     while (child > 1) {
         parent = GET_PARENT(child);
-        seg_get(&search_heap, (char *)&heap_p, 0, parent);
+        Seggrid_get(&search_heap, &heap_p, 0, parent);
 
         /* push parent point down if child is smaller */
         if (cmp_pnt(&child_p, &heap_p)) {
-            seg_put(&search_heap, (char *)&heap_p, 0, child);
+            Seggrid_put(&search_heap, &heap_p, 0, child);
             child = parent;
         }
         /* no more sifting up, found slot for child */
@@ -191,7 +191,7 @@ static int sift_up(GW_LARGE_INT start, HEAP_PNT child_p)
     }
 
     /* add child to heap */
-    seg_put(&search_heap, (char *)&child_p, 0, child);
+    Seggrid_put(&search_heap, &child_p, 0, child);
 
     return 0;
 }
@@ -221,12 +221,11 @@ int add_pt(int r, int c, CELL ele)
 /* drop point routine for min heap */
 HEAP_PNT drop_pt(void)
 {
-    int child, childr, parent;
-    int i;
+    GW_LARGE_INT child, childr, parent, i;
     HEAP_PNT child_p, childr_p, last_p, root_p;
 
-    seg_get(&search_heap, (char *)&last_p, 0, heap_size);
-    seg_get(&search_heap, (char *)&root_p, 0, 1);
+    Seggrid_get(&search_heap, &last_p, 0, heap_size);
+    Seggrid_get(&search_heap, &root_p, 0, 1);
 
     /* sift down: move hole back towards bottom of heap */
     parent = 1;
@@ -234,12 +233,12 @@ HEAP_PNT drop_pt(void)
         /* select child with lower ele, if both are equal, older child
          * older child is older startpoint for flow path, important */
 
-        seg_get(&search_heap, (char *)&child_p, 0, child);
+        Seggrid_get(&search_heap, &child_p, 0, child);
         if (child < heap_size) {
             childr = child + 1;
             i = child + 4;
             while (childr < i && childr < heap_size) {
-                seg_get(&search_heap, (char *)&childr_p, 0, childr);
+                Seggrid_get(&search_heap, &childr_p, 0, childr);
                 if (cmp_pnt(&childr_p, &child_p)) {
                     child = childr;
                     child_p = childr_p;
@@ -253,11 +252,11 @@ HEAP_PNT drop_pt(void)
         }
 
         /* move hole down */
-        seg_put(&search_heap, (char *)&child_p, 0, parent);
+        Seggrid_put(&search_heap, &child_p, 0, parent);
         parent = child;
     }
 
-    seg_put(&search_heap, (char *)&last_p, 0, parent);
+    Seggrid_put(&search_heap, &last_p, 0, parent);
 
     /* the actual drop */
     heap_size--;
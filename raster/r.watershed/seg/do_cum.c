@@ -133,10 +133,10 @@ int do_cum(void)
         threshold = bas_thres;
     for (killer = 0; killer < do_points; killer++) {
         G_percent(killer, do_points, 1);
-        seg_get(&astar_pts, (char *)&point, 0, killer);
+        Seggrid_get(&astar_pts, &point, 0, killer);
         r = point.r;
         c = point.c;
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
         if (af.asp) {
             dr = r + asp_r[ABS(af.asp)];
             dc = c + asp_c[ABS(af.asp)];
@@ -165,20 +165,20 @@ int do_cum(void)
                 if (FLAG_GET(af.flag, SWALEFLAG) && af.asp > 0) {
                     af.asp = -1 * drain[r - dr + 1][c - dc + 1];
                 }
-                seg_put(&aspflag, (char *)&af, r, c);
-                seg_get(&watalt, (char *)&wadown, dr, dc);
+                Seggrid_put(&aspflag, &af, r, c);
+                Seggrid_get(&watalt, &wadown, dr, dc);
                 valued = wadown.wat;
                 if (valued > 0) {
                     wadown.wat = -valued;
-                    seg_put(&watalt, (char *)&wadown, dr, dc);
+                    Seggrid_put(&watalt, &wadown, dr, dc);
                 }
                 continue;
             }
 
-            seg_get(&watalt, (char *)&wa, r, c);
+            Seggrid_get(&watalt, &wa, r, c);
             value = wa.wat;
             if (rtn_flag) {
-                bseg_get(&rtn, (char *)&rtn_value, dr, dc);
+                Seggrid_get(&rtn, &rtn_value, dr, dc);
                 value *= rtn_value / 100.0;
             }
             is_swale = FLAG_GET(af.flag, SWALEFLAG);
@@ -186,7 +186,7 @@ int do_cum(void)
                 is_swale = 1;
                 FLAG_SET(af.flag, SWALEFLAG);
             }
-            seg_get(&watalt, (char *)&wadown, dr, dc);
+            Seggrid_get(&watalt, &wadown, dr, dc);
             valued = wadown.wat;
             if (value > 0) {
                 if (valued > 0)
@@ -201,7 +201,7 @@ int do_cum(void)
                     valued = value - valued;
             }
             wadown.wat = valued;
-            seg_put(&watalt, (char *)&wadown, dr, dc);
+            Seggrid_put(&watalt, &wadown, dr, dc);
 
             /* topographic wetness index ln(a / tan(beta)) and
              * stream power index a * tan(beta) */
@@ -210,28 +210,28 @@ int do_cum(void)
 
                 sca_tanb.tanb =
                     get_slope_tci(wa.ele, wadown.ele, dist_to_nbr[np_side]);
-                seg_put(&atanb, (char *)&sca_tanb, r, c);
+                Seggrid_put(&atanb, &sca_tanb, r, c);
             }
 
             /* update asp for depression */
             if (is_swale || fabs(valued) >= threshold) {
-                seg_get(&aspflag, (char *)&afdown, dr, dc);
+                Seggrid_get(&aspflag, &afdown, dr, dc);
                 FLAG_SET(afdown.flag, SWALEFLAG);
-                seg_put(&aspflag, (char *)&afdown, dr, dc);
+                Seggrid_put(&aspflag, &afdown, dr, dc);
                 is_swale = 1;
             }
             else {
-                seg_get(&aspflag, (char *)&afdown, dr, dc);
+                Seggrid_get(&aspflag, &afdown, dr, dc);
                 if (er_flag && !is_swale &&
                     !FLAG_GET(afdown.flag, RUSLEBLOCKFLAG))
                     slope_length(r, c, dr, dc);
             }
         }
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
     }
     G_percent(do_points, do_points, 1); /* finish it */
 
-    seg_close(&astar_pts);
+    Seggrid_close(&astar_pts);
     G_free(dist_to_nbr);
     G_free(contour);
 
@@ -337,10 +337,10 @@ int do_cum_mfd(void)
 
     for (killer = 0; killer < do_points; killer++) {
         G_percent(killer, do_points, 1);
-        seg_get(&astar_pts, (char *)&point, 0, killer);
+        Seggrid_get(&astar_pts, &point, 0, killer);
         r = point.r;
         c = point.c;
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
         if (af.asp) {
             dr = r + asp_r[ABS(af.asp)];
             dc = c + asp_c[ABS(af.asp)];
@@ -357,10 +357,10 @@ int do_cum_mfd(void)
             r_max = dr;
             c_max = dc;
 
-            seg_get(&watalt, (char *)&wa, r, c);
+            Seggrid_get(&watalt, &wa, r, c);
             value = wa.wat;
             if (rtn_flag) {
-                bseg_get(&rtn, (char *)&rtn_value, dr, dc);
+                Seggrid_get(&rtn, &rtn_value, dr, dc);
                 value *= rtn_value / 100.0;
             }
 
@@ -391,9 +391,9 @@ int do_cum_mfd(void)
                     if (dr == r_nbr && dc == c_nbr)
                         np_side = ct_dir;
 
-                    seg_get(&aspflag, (char *)&afdown, r_nbr, c_nbr);
+                    Seggrid_get(&aspflag, &afdown, r_nbr, c_nbr);
                     flag_nbr[ct_dir] = afdown.flag;
-                    seg_get(&watalt, (char *)&wa, r_nbr, c_nbr);
+                    Seggrid_get(&watalt, &wa, r_nbr, c_nbr);
                     wat_nbr[ct_dir] = wa.wat;
                     ele_nbr[ct_dir] = wa.ele;
 
@@ -423,7 +423,7 @@ int do_cum_mfd(void)
                             }
                             if (value < 0 && wat_nbr[ct_dir] > 0) {
                                 wa.wat = -wat_nbr[ct_dir];
-                                seg_put(&watalt, (char *)&wa, r_nbr, c_nbr);
+                                Seggrid_put(&watalt, &wa, r_nbr, c_nbr);
                             }
                         }
                     }
@@ -435,7 +435,7 @@ int do_cum_mfd(void)
             }
             /* do not continue streams along edges, this causes artifacts */
             if (edge) {
-                seg_put(&aspflag, (char *)&af, r, c);
+                Seggrid_put(&aspflag, &af, r, c);
                 continue;
             }
 
@@ -496,7 +496,7 @@ int do_cum_mfd(void)
                             valued = wat_nbr[ct_dir];
                             wa.wat = valued;
                             wa.ele = ele_nbr[ct_dir];
-                            seg_put(&watalt, (char *)&wa, r_nbr, c_nbr);
+                            Seggrid_put(&watalt, &wa, r_nbr, c_nbr);
                         }
                         else if (ct_dir == np_side) {
                             /* check for consistency with A * path */
@@ -535,7 +535,7 @@ int do_cum_mfd(void)
                 }
                 wa.wat = valued;
                 wa.ele = ele_nbr[np_side];
-                seg_put(&watalt, (char *)&wa, dr, dc);
+                Seggrid_put(&watalt, &wa, dr, dc);
 
                 if (atanb_flag) {
                     sum_contour = contour[np_side];
@@ -548,10 +548,10 @@ int do_cum_mfd(void)
              * stream power index a * tan(beta) */
             if (atanb_flag) {
                 sca_tanb.sca = fabs(value) * (cell_size / sum_contour);
-                seg_put(&atanb, (char *)&sca_tanb, r, c);
+                Seggrid_put(&atanb, &sca_tanb, r, c);
             }
         }
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
     }
     G_percent(do_points, do_points, 1); /* finish it */
 
@@ -564,10 +564,10 @@ int do_cum_mfd(void)
 
     for (killer = 0; killer < do_points; killer++) {
         G_percent(killer, do_points, 1);
-        seg_get(&astar_pts, (char *)&point, 0, killer);
+        Seggrid_get(&astar_pts, &point, 0, killer);
         r = point.r;
         c = point.c;
-        seg_get(&aspflag, (char *)&af, r, c);
+        Seggrid_get(&aspflag, &af, r, c);
         if (af.asp) {
             dr = r + asp_r[ABS(af.asp)];
             dc = c + asp_c[ABS(af.asp)];
@@ -582,7 +582,7 @@ int do_cum_mfd(void)
             r_max = dr;
             c_max = dc;
 
-            seg_get(&watalt, (char *)&wa, r, c);
+            Seggrid_get(&watalt, &wa, r, c);
             value = wa.wat;
 
             /* get max flow accumulation */
@@ -611,9 +611,9 @@ int do_cum_mfd(void)
                 if (r_nbr >= 0 && r_nbr < nrows && c_nbr >= 0 &&
                     c_nbr < ncols) {
 
-                    seg_get(&aspflag, (char *)&afdown, r_nbr, c_nbr);
+                    Seggrid_get(&aspflag, &afdown, r_nbr, c_nbr);
                     flag_nbr[ct_dir] = afdown.flag;
-                    seg_get(&watalt, (char *)&wa, r_nbr, c_nbr);
+                    Seggrid_get(&watalt, &wa, r_nbr, c_nbr);
                     wat_nbr[ct_dir] = wa.wat;
                     ele_nbr[ct_dir] = wa.ele;
 
@@ -655,7 +655,7 @@ int do_cum_mfd(void)
                 if (is_swale && af.asp > 0) {
                     af.asp = -1 * drain[r - r_nbr + 1][c - c_nbr + 1];
                 }
-                seg_put(&aspflag, (char *)&af, r, c);
+                Seggrid_put(&aspflag, &af, r, c);
                 continue;
             }
             /* update asp */
@@ -680,19 +680,19 @@ int do_cum_mfd(void)
             }
             /* continue stream */
             if (is_swale) {
-                seg_get(&aspflag, (char *)&afdown, r_max, c_max);
+                Seggrid_get(&aspflag, &afdown, r_max, c_max);
                 FLAG_SET(afdown.flag, SWALEFLAG);
-                seg_put(&aspflag, (char *)&afdown, r_max, c_max);
+                Seggrid_put(&aspflag, &afdown, r_max, c_max);
             }
             else {
                 if (er_flag && !is_swale && !FLAG_GET(af.flag, RUSLEBLOCKFLAG))
                     slope_length(r, c, r_max, c_max);
             }
         }
-        seg_put(&aspflag, (char *)&af, r, c);
+        Seggrid_put(&aspflag, &af, r, c);
     }
 
-    seg_close(&astar_pts);
+    Seggrid_close(&astar_pts);
 
     G_free(dist_to_nbr);
     G_free(weight);
@@ -19,13 +19,13 @@ int find_pourpts(void)
         G_percent(row, nrows, 1);
         northing = window.north - (row + .5) * window.ns_res;
         for (col = 0; col < ncols; col++) {
-            seg_get(&aspflag, (char *)&af, row, col);
-            cseg_get(&bas, &curr_basin, row, col);
+            Seggrid_get(&aspflag, &af, row, col);
+            Seggrid_get(&bas, &curr_basin, row, col);
             if (curr_basin == 0)
-                cseg_put(&bas, &no_basin, row, col);
-            cseg_get(&haf, &curr_basin, row, col);
+                Seggrid_put(&bas, &no_basin, row, col);
+            Seggrid_get(&haf, &curr_basin, row, col);
             if (curr_basin == 0)
-                cseg_put(&haf, &no_basin, row, col);
+                Seggrid_put(&haf, &no_basin, row, col);
             is_swale = FLAG_GET(af.flag, SWALEFLAG);
             if (af.asp <= 0 && is_swale > 0) {
                 basin_num += 2;
@@ -42,7 +42,7 @@ int find_pourpts(void)
                     else {
                         stream_length = 0.0;
                     }
-                    seg_get(&watalt, (char *)&wa, row, col);
+                    Seggrid_get(&watalt, &wa, row, col);
                     old_elev = wa.ele;
                 }
                 basin_num =
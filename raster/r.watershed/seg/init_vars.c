@@ -19,8 +19,8 @@ int init_vars(int argc, char *argv[])
     char asp_value;
     DCELL wat_value;
     DCELL dvalue;
-    WAT_ALT wa, *wabuf;
-    ASP_FLAG af, af_nbr, *afbuf;
+    WAT_ALT *wabuf;
+    ASP_FLAG *afbuf, *afrow[3];
     A_TANB sca_tanb;
     void *elebuf, *ptr, *watbuf, *watptr;
     int ele_map_type, wat_map_type;
@@ -256,25 +256,25 @@ int init_vars(int argc, char *argv[])
                           disk_space / 1024.0, disk_space);
 
     if (er_flag) {
-        cseg_open(&r_h, seg_rows, seg_cols, num_open_segs);
-        cseg_read_cell(&r_h, ele_name, "");
+        Seggrid_open(&r_h, CELL_TYPE, seg_rows, seg_cols, num_open_segs);
+        Seggrid_read_raster(&r_h, ele_name, "");
     }
 
     if (rtn_flag) {
-        bseg_open(&rtn, seg_rows, seg_cols, num_open_segs);
+        Seggrid_open(&rtn, SEGGRID_BYTE, seg_rows, seg_cols, num_open_segs);
     }
 
     /* read elevation input and mark NULL/masked cells */
 
     /* scattered access: alt, watalt, bitflags, asp */
-    seg_open(&watalt, nrows, ncols, seg_rows, seg_cols, num_open_segs * 2,
-             sizeof(WAT_ALT));
-    seg_open(&aspflag, nrows, ncols, seg_rows, seg_cols, num_open_segs * 4,
-             sizeof(ASP_FLAG));
+    Seggrid_open_records(&watalt, nrows, ncols, seg_rows, seg_cols,
+                         sizeof(WAT_ALT), num_open_segs * 2);
+    Seggrid_open_records(&aspflag, nrows, ncols, seg_rows, seg_cols,
+                         sizeof(ASP_FLAG), num_open_segs * 4);
 
     if (atanb_flag) {
-        seg_open(&atanb, nrows, ncols, seg_rows, seg_cols, num_open_segs,
-                 sizeof(A_TANB));
+        Seggrid_open_records(&atanb, nrows, ncols, seg_rows, seg_cols,
+                             sizeof(A_TANB), num_open_segs);
         Rast_set_d_null_value(&sca_tanb.sca, 1);
         Rast_set_d_null_value(&sca_tanb.tanb, 1);
     }
@@ -374,18 +374,18 @@ int init_vars(int argc, char *argv[])
             wabuf[c].ele = alt_value;
             alt_value_buf[c] = alt_value;
             if (atanb_flag) {
-                seg_put(&atanb, (char *)&sca_tanb, r, c);
+                Seggrid_put(&atanb, &sca_tanb, r, c);
             }
             ptr = G_incr_void_ptr(ptr, ele_size);
             if (run_flag) {
                 watptr = G_incr_void_ptr(watptr, wat_size);
             }
         }
-        seg_put_row(&watalt, (char *)wabuf, r);
-        seg_put_row(&aspflag, (char *)afbuf, r);
+        Seggrid_put_row(&watalt, wabuf, r);
+        Seggrid_put_row(&aspflag, afbuf, r);
 
         if (er_flag) {
-            cseg_put_row(&r_h, alt_value_buf, r);
+            Seggrid_put_row(&r_h, alt_value_buf, r);
         }
     }
     G_percent(nrows, nrows, 1); /* finish it */
@@ -418,7 +418,7 @@ int init_vars(int argc, char *argv[])
                         block_value = 100;
                 }
                 rtn_value = block_value;
-                bseg_put(&rtn, &rtn_value, r, c);
+                Seggrid_put(&rtn, &rtn_value, r, c);
             }
         }
         G_percent(nrows, nrows, 1); /* finish it */
@@ -431,35 +431,38 @@ int init_vars(int argc, char *argv[])
         if (ob_flag) {
             fd = Rast_open_old(ob_name, "");
             buf = Rast_allocate_c_buf();
+            /* rows only: no segments are cached before the A* search */
+            afbuf = G_malloc(ncols * sizeof(ASP_FLAG));
             for (r = 0; r < nrows; r++) {
                 G_percent(r, nrows, 1);
                 Rast_get_c_row(fd, buf, r);
+                Seggrid_get_row(&aspflag, afbuf, r);
                 for (c = 0; c < ncols; c++) {
                     block_value = buf[c];
                     if (!Rast_is_c_null_value(&block_value) && block_value) {
-                        seg_get(&aspflag, (char *)&af, r, c);
-                        FLAG_SET(af.flag, RUSLEBLOCKFLAG);
-                        seg_put(&aspflag, (char *)&af, r, c);
+                        FLAG_SET(afbuf[c].flag, RUSLEBLOCKFLAG);
                     }
                 }
+                Seggrid_put_row(&aspflag, afbuf, r);
             }
             G_percent(nrows, nrows, 1); /* finish it */
             Rast_close(fd);
             G_free(buf);
+            G_free(afbuf);
         }
 
         if (ril_flag) {
-            dseg_open(&ril, seg_rows, seg_cols, num_open_segs);
-            dseg_read_cell(&ril, ril_name, "");
+            Seggrid_open(&ril, DCELL_TYPE, seg_rows, seg_cols, num_open_segs);
+            Seggrid_read_raster(&ril, ril_name, "");
         }
 
-        /* dseg_open(&slp, SROW, SCOL, num_open_segs); */
+        /* Seggrid_open(&slp, DCELL_TYPE, SROW, SCOL, num_open_segs); */
 
-        dseg_open(&s_l, seg_rows, seg_cols, num_open_segs);
+        Seggrid_open(&s_l, DCELL_TYPE, seg_rows, seg_cols, num_open_segs);
         if (sg_flag)
-            dseg_open(&s_g, seg_rows, seg_cols, num_open_segs);
+            Seggrid_open(&s_g, DCELL_TYPE, seg_rows, seg_cols, num_open_segs);
         if (ls_flag)
-            dseg_open(&l_s, seg_rows, seg_cols, num_open_segs);
+            Seggrid_open(&l_s, DCELL_TYPE, seg_rows, seg_cols, num_open_segs);
     }
 
     G_debug(1, "open segments for A* points");
@@ -475,8 +478,8 @@ int init_vars(int argc, char *argv[])
     if (num_open_array_segs < 1)
         num_open_array_segs = 1;
 
-    seg_open(&astar_pts, 1, do_points, 1, seg_cols, num_open_array_segs,
-             sizeof(POINT));
+    Seggrid_open_records(&astar_pts, 1, do_points, 1, seg_cols, sizeof(POINT),
+                         num_open_array_segs);
 
     /* one-based d-ary search_heap with astar_pts */
     G_debug(1, "open segments for A* search heap");
@@ -499,8 +502,8 @@ int init_vars(int argc, char *argv[])
     /* the search heap will not hold more than 5% of all points at any given
      * time ? */
     /* chances are good that the heap will fit into one large segment */
-    seg_open(&search_heap, 1, do_points + 1, 1, seg_cols, num_open_array_segs,
-             sizeof(HEAP_PNT));
+    Seggrid_open_records(&search_heap, 1, do_points + 1, 1, seg_cols,
+                         sizeof(HEAP_PNT), num_open_array_segs);
 
     G_message(_("SECTION 1b: Determining Offmap Flow."));
 
@@ -515,26 +518,33 @@ int init_vars(int argc, char *argv[])
         buf = NULL;
     first_astar = first_cum = -1;
 
+    /* the current row and its neighbours above and below are kept in
+     * memory: each cell is read once instead of once for every
+     * neighbour, cells are still added to the heap in the same order.
+     * Flags and elevation have only been accessed by rows so far,
+     * no segments are cached that could be out of date. */
+    wabuf = G_malloc(ncols * sizeof(WAT_ALT));
+    afrow[0] = G_malloc(ncols * sizeof(ASP_FLAG));
+    afrow[1] = G_malloc(ncols * sizeof(ASP_FLAG));
+    afrow[2] = G_malloc(ncols * sizeof(ASP_FLAG));
+    Seggrid_get_row(&aspflag, afrow[1], 0);
+    if (nrows > 1)
+        Seggrid_get_row(&aspflag, afrow[2], 1);
+
     for (r = 0; r < nrows; r++) {
         G_percent(r, nrows, 1);
         if (pit_flag)
             Rast_get_c_row(fd, buf, r);
+        afbuf = afrow[1];
+        Seggrid_get_row(&watalt, wabuf, r);
         for (c = 0; c < ncols; c++) {
-            seg_get(&aspflag, (char *)&af, r, c);
-            if (!FLAG_GET(af.flag, NULLFLAG)) {
+            if (!FLAG_GET(afbuf[c].flag, NULLFLAG)) {
                 if (er_flag)
-                    dseg_put(&s_l, &half_res, r, c);
-                asp_value = af.asp;
+                    Seggrid_put(&s_l, &half_res, r, c);
+                asp_value = afbuf[c].asp;
                 if (r == 0 || c == 0 || r == nrows - 1 || c == ncols - 1) {
-                    /* dseg_get(&wat, &wat_value, r, c); */
-                    seg_get(&watalt, (char *)&wa, r, c);
-                    wat_value = wa.wat;
-                    if (wat_value > 0) {
-                        wat_value = -wat_value;
-                        /* dseg_put(&wat, &wat_value, r, c); */
-                        wa.wat = wat_value;
-                        seg_put(&watalt, (char *)&wa, r, c);
-                    }
+                    if (wabuf[c].wat > 0)
+                        wabuf[c].wat = -wabuf[c].wat;
                     if (r == 0)
                         asp_value = -2;
                     else if (c == 0)
@@ -543,33 +553,26 @@ int init_vars(int argc, char *argv[])
                         asp_value = -6;
                     else if (c == ncols - 1)
                         asp_value = -8;
-                    /* cseg_get(&alt, &alt_value, r, c); */
-                    alt_value = wa.ele;
-                    add_pt(r, c, alt_value);
-                    FLAG_SET(af.flag, INLISTFLAG);
-                    FLAG_SET(af.flag, EDGEFLAG);
-                    af.asp = asp_value;
-                    seg_put(&aspflag, (char *)&af, r, c);
+                    add_pt(r, c, wabuf[c].ele);
+                    FLAG_SET(afbuf[c].flag, INLISTFLAG);
+                    FLAG_SET(afbuf[c].flag, EDGEFLAG);
+                    afbuf[c].asp = asp_value;
                 }
                 else {
-                    seg_get(&watalt, (char *)&wa, r, c);
                     for (ct_dir = 0; ct_dir < sides; ct_dir++) {
                         /* get r, c (r_nbr, c_nbr) for neighbours */
                         r_nbr = r + nextdr[ct_dir];
                         c_nbr = c + nextdc[ct_dir];
 
-                        seg_get(&aspflag, (char *)&af_nbr, r_nbr, c_nbr);
-                        if (FLAG_GET(af_nbr.flag, NULLFLAG)) {
-                            af.asp = -1 * drain[r - r_nbr + 1][c - c_nbr + 1];
-                            add_pt(r, c, wa.ele);
-                            FLAG_SET(af.flag, INLISTFLAG);
-                            FLAG_SET(af.flag, EDGEFLAG);
-                            seg_put(&aspflag, (char *)&af, r, c);
-                            wat_value = wa.wat;
-                            if (wat_value > 0) {
-                                wa.wat = -wat_value;
-                                seg_put(&watalt, (char *)&wa, r, c);
-                            }
+                        if (FLAG_GET(afrow[r_nbr - r + 1][c_nbr].flag,
+                                     NULLFLAG)) {
+                            afbuf[c].asp =
+                                -1 * drain[r - r_nbr + 1][c - c_nbr + 1];
+                            add_pt(r, c, wabuf[c].ele);
+                            FLAG_SET(afbuf[c].flag, INLISTFLAG);
+                            FLAG_SET(afbuf[c].flag, EDGEFLAG);
+                            if (wabuf[c].wat > 0)
+                                wabuf[c].wat = -wabuf[c].wat;
                             break;
                         }
                     }
@@ -577,25 +580,33 @@ int init_vars(int argc, char *argv[])
                 /* real depression ? */
                 if (pit_flag && asp_value == 0) {
                     if (!Rast_is_c_null_value(&buf[c]) && buf[c] != 0) {
+                        add_pt(r, c, wabuf[c].ele);
 
-                        seg_get(&watalt, (char *)&wa, r, c);
-                        add_pt(r, c, wa.ele);
-
-                        FLAG_SET(af.flag, INLISTFLAG);
-                        FLAG_SET(af.flag, EDGEFLAG);
-                        seg_put(&aspflag, (char *)&af, r, c);
-                        wat_value = wa.wat;
-                        if (wat_value > 0) {
-                            wa.wat = -wat_value;
-                            seg_put(&watalt, (char *)&wa, r, c);
-                        }
+                        FLAG_SET(afbuf[c].flag, INLISTFLAG);
+                        FLAG_SET(afbuf[c].flag, EDGEFLAG);
+                        if (wabuf[c].wat > 0)
+                            wabuf[c].wat = -wabuf[c].wat;
                     }
                 }
 
             } /* end non-NULL cell */
         } /* end column */
+        Seggrid_put_row(&aspflag, afbuf, r);
+        Seggrid_put_row(&watalt, wabuf, r);
+
+        /* move on to the next row */
+        afbuf = afrow[0];
+        afrow[0] = afrow[1];
+        afrow[1] = afrow[2];
+        afrow[2] = afbuf;
+        if (r + 2 < nrows)
+            Seggrid_get_row(&aspflag, afrow[2], r + 2);
     }
     G_percent(r, nrows, 1); /* finish it */
+    G_free(wabuf);
+    G_free(afrow[0]);
+    G_free(afrow[1]);
+    G_free(afrow[2]);
 
     return 0;
 }
@@ -25,7 +25,7 @@
 struct Cell_head window;
 
 int mfd, c_fac, abs_acc, ele_scale;
-SSEG search_heap;
+SEGGRID search_heap;
 int nrows, ncols;
 GW_LARGE_INT heap_size;
 GW_LARGE_INT first_astar, first_cum, nxt_avail_pt, total_cells, do_points;
@@ -34,12 +34,12 @@ OC_STACK *ocs;
 int ocs_alloced;
 double half_res, diag, max_length, dep_slope;
 int bas_thres, tot_parts;
-SSEG astar_pts;
-BSEG s_b, rtn;
-CSEG dis, alt, bas, haf, r_h, dep;
-SSEG watalt, aspflag;
-DSEG slp, s_l, s_g, l_s, ril;
-SSEG atanb;
+SEGGRID astar_pts;
+SEGGRID s_b, rtn;
+SEGGRID dis, alt, bas, haf, r_h, dep;
+SEGGRID watalt, aspflag;
+SEGGRID slp, s_l, s_g, l_s, ril;
+SEGGRID atanb;
 double segs_mb;
 char zero, one;
 double ril_value, d_zero, d_one;
@@ -97,8 +97,8 @@ int main(int argc, char *argv[])
         if (num_open_segs > (ncols / SCOL + 1) * (nrows / SROW + 1)) {
             num_open_segs = (ncols / SCOL + 1) * (nrows / SROW + 1);
         }
-        cseg_open(&bas, SROW, SCOL, num_open_segs);
-        cseg_open(&haf, SROW, SCOL, num_open_segs);
+        Seggrid_open(&bas, CELL_TYPE, SROW, SCOL, num_open_segs);
+        Seggrid_open(&haf, CELL_TYPE, SROW, SCOL, num_open_segs);
         G_message(_("SECTION %d: Watershed determination."), tot_parts - 1);
         find_pourpts();
         G_message(_("SECTION %d: Closing Maps."), tot_parts);
@@ -13,7 +13,7 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
     ASP_FLAG af;
 
     while (1) {
-        cseg_put(&bas, &basin_num, row, col);
+        Seggrid_put(&bas, &basin_num, row, col);
         max_drain = -1;
         for (r = row - 1, rr = 0; r <= row + 1; r++, rr++) {
             for (c = col - 1, cc = 0; c <= col + 1; c++, cc++) {
@@ -21,10 +21,10 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
                     if (r == row && c == col)
                         continue;
 
-                    seg_get(&aspflag, (char *)&af, r, c);
+                    Seggrid_get(&aspflag, &af, r, c);
                     aspect = af.asp;
                     if (aspect == drain[rr][cc]) {
-                        seg_get(&watalt, (char *)&wa, r, c);
+                        Seggrid_get(&watalt, &wa, r, c);
                         dvalue = wa.wat;
                         if (dvalue < 0)
                             dvalue = -dvalue;
@@ -39,7 +39,7 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
         }
         if (max_drain > -1) {
             updir = drain[row - uprow + 1][col - upcol + 1];
-            seg_get(&aspflag, (char *)&af, row, col);
+            Seggrid_get(&aspflag, &af, row, col);
             downdir = af.asp;
             if (downdir < 0)
                 downdir = -downdir;
@@ -53,7 +53,7 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
                         stream_length += window.ew_res;
                 }
                 else { /* sides == 4 */
-                    seg_get(&aspflag, (char *)&af, uprow, upcol);
+                    Seggrid_get(&aspflag, &af, uprow, upcol);
                     asp_value = af.asp;
                     if (downdir == 2 || downdir == 6) {
                         if (asp_value == 2 || asp_value == 6)
@@ -74,7 +74,7 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
             for (r = row - 1, rr = 0; rr < 3; r++, rr++) {
                 for (c = col - 1, cc = 0; cc < 3; c++, cc++) {
                     if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
-                        seg_get(&aspflag, (char *)&af, r, c);
+                        Seggrid_get(&aspflag, &af, r, c);
                         aspect = af.asp;
                         if (aspect == drain[rr][cc]) {
                             thisdir = updrain[rr][cc];
@@ -97,23 +97,23 @@ int no_stream(int row, int col, CELL basin_num, double stream_length,
             }
             if (leftflag > riteflag) {
                 value = basin_num - 1;
-                cseg_put(&haf, &value, row, col);
+                Seggrid_put(&haf, &value, row, col);
             }
             else
-                cseg_put(&haf, &basin_num, row, col);
+                Seggrid_put(&haf, &basin_num, row, col);
             row = uprow;
             col = upcol;
         }
         else {
             if (arm_flag) {
-                seg_get(&watalt, (char *)&wa, row, col);
+                Seggrid_get(&watalt, &wa, row, col);
                 hih_ele = wa.ele;
                 slope = (hih_ele - old_elev) / stream_length;
                 if (slope < MIN_SLOPE)
                     slope = MIN_SLOPE;
                 fprintf(fp, " %f %f\n", slope, stream_length);
             }
-            cseg_put(&haf, &basin_num, row, col);
+            Seggrid_put(&haf, &basin_num, row, col);
             return 0;
         }
     }
@@ -9,15 +9,15 @@ int overland_cells_recursive(int row, int col, CELL basin_num, CELL haf_num,
     char aspect;
     ASP_FLAG af;
 
-    cseg_put(&bas, &basin_num, row, col);
-    cseg_put(&haf, &haf_num, row, col);
+    Seggrid_put(&bas, &basin_num, row, col);
+    Seggrid_put(&haf, &haf_num, row, col);
     /* new_max_ele = BIGNEG; */
     for (r = row - 1, rr = 0; r <= row + 1; r++, rr++) {
         for (c = col - 1, cc = 0; c <= col + 1; c++, cc++) {
             if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
                 if (r == row && c == col)
                     continue;
-                seg_get(&aspflag, (char *)&af, r, c);
+                Seggrid_get(&aspflag, &af, r, c);
                 aspect = af.asp;
                 if (aspect == drain[rr][cc]) {
                     overland_cells(r, c, basin_num, haf_num, &new_ele);
@@ -28,7 +28,7 @@ int overland_cells_recursive(int row, int col, CELL basin_num, CELL haf_num,
     /*
        if (arm_flag) {
        if (new_max_ele == BIGNEG) {
-       cseg_get(&alt, hih_ele, row, col);
+       Seggrid_get(&alt, hih_ele, row, col);
        }
        else {
        *hih_ele = new_max_ele;
@@ -51,8 +51,8 @@ int overland_cells(int row, int col, CELL basin_num, CELL haf_num,
     /* put root on stack */
     ocs[top].row = row;
     ocs[top].col = col;
-    cseg_put(&bas, &basin_num, row, col);
-    cseg_put(&haf, &haf_num, row, col);
+    Seggrid_put(&bas, &basin_num, row, col);
+    Seggrid_put(&haf, &haf_num, row, col);
 
     top++;
 
@@ -67,7 +67,7 @@ int overland_cells(int row, int col, CELL basin_num, CELL haf_num,
                 if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
                     if (r == row && c == col)
                         continue;
-                    seg_get(&aspflag, (char *)&af, r, c);
+                    Seggrid_get(&aspflag, &af, r, c);
                     aspect = af.asp;
                     if (aspect == drain[rr][cc]) {
                         if (top >= ocs_alloced) {
@@ -77,8 +77,8 @@ int overland_cells(int row, int col, CELL basin_num, CELL haf_num,
                         }
                         ocs[top].row = r;
                         ocs[top].col = c;
-                        cseg_put(&bas, &basin_num, r, c);
-                        cseg_put(&haf, &haf_num, r, c);
+                        Seggrid_put(&bas, &basin_num, r, c);
+                        Seggrid_put(&haf, &haf_num, r, c);
                         top++;
                     }
                 }
@@ -89,7 +89,7 @@ int overland_cells(int row, int col, CELL basin_num, CELL haf_num,
     /*
        if (arm_flag) {
        if (new_max_ele == BIGNEG) {
-       cseg_get(&alt, hih_ele, row, col);
+       Seggrid_get(&alt, hih_ele, row, col);
        }
        else {
        *hih_ele = new_max_ele;
@@ -14,14 +14,14 @@ int sg_factor(void)
     for (r = nrows - 1; r >= 0; r--) {
         G_percent(nrows - r, nrows, 3);
         for (c = ncols - 1; c >= 0; c--) {
-            seg_get(&aspflag, (char *)&af, r, c);
+            Seggrid_get(&aspflag, &af, r, c);
             if (FLAG_GET(af.flag, NULLFLAG))
                 continue;
 
-            seg_get(&watalt, (char *)&wa, r, c);
+            Seggrid_get(&watalt, &wa, r, c);
             low_elev = wa.ele;
-            cseg_get(&r_h, &hih_elev, r, c);
-            dseg_get(&s_l, &length, r, c);
+            Seggrid_get(&r_h, &hih_elev, r, c);
+            Seggrid_get(&s_l, &length, r, c);
             height = 1.0 * (hih_elev - low_elev) / ele_scale;
             if (length > max_length) {
                 height *= max_length / length;
@@ -37,7 +37,7 @@ int sg_factor(void)
                 len_slp_equ(length, sin_theta, S, r, c);
             }
             if (sg_flag) {
-                dseg_put(&s_g, &S, r, c);
+                Seggrid_put(&s_g, &S, r, c);
             }
         }
     }
@@ -54,7 +54,7 @@ int len_slp_equ(double slope_length, double sin_theta, double S, int r, int c)
 
     rill_ratio = (sin_theta / 0.0896) / (3.0 * pow(sin_theta, 0.8) + 0.56);
     if (ril_flag) {
-        dseg_get(&ril, &rill, r, c);
+        Seggrid_get(&ril, &rill, r, c);
     }
     else if (ril_value >= 0.0) {
         rill = ril_value;
@@ -65,7 +65,7 @@ int len_slp_equ(double slope_length, double sin_theta, double S, int r, int c)
     rill_ratio *= .5 + .005 * rill + .0001 * rill * rill;
     s_l_exp = rill_ratio / (1 + rill_ratio);
     LS = S * pow((slope_length / 72.6), s_l_exp);
-    dseg_put(&l_s, &LS, r, c);
+    Seggrid_put(&l_s, &LS, r, c);
 
     return 0;
 }
@@ -17,7 +17,7 @@ CELL split_stream(int row, int col, int new_r[], int new_c[], int ct,
     for (ctr = 1; ctr <= ct; ctr++)
         splitdir[ctr] = drain[row - new_r[ctr] + 1][col - new_c[ctr] + 1];
     updir = splitdir[1];
-    seg_get(&aspflag, (char *)&af, row, col);
+    Seggrid_get(&aspflag, &af, row, col);
     downdir = af.asp;
     if (downdir < 0)
         downdir = -downdir;
@@ -27,7 +27,7 @@ CELL split_stream(int row, int col, int new_r[], int new_c[], int ct,
             if (r >= 0 && c >= 0 && r < nrows && c < ncols) {
                 if (r == row && c == col)
                     continue;
-                seg_get(&aspflag, (char *)&af, r, c);
+                Seggrid_get(&aspflag, &af, r, c);
                 aspect = af.asp;
                 if (aspect == drain[rr][cc]) {
                     doit = 1;
@@ -59,14 +59,14 @@ CELL split_stream(int row, int col, int new_r[], int new_c[], int ct,
     }
     if (leftflag >= riteflag) {
         old_basin = basin_num - 1;
-        cseg_put(&haf, &old_basin, row, col);
+        Seggrid_put(&haf, &old_basin, row, col);
     }
     else {
-        cseg_put(&haf, &basin_num, row, col);
+        Seggrid_put(&haf, &basin_num, row, col);
     }
     old_basin = basin_num;
     if (arm_flag) {
-        seg_get(&watalt, (char *)&wa, row, col);
+        Seggrid_get(&watalt, &wa, row, col);
         new_elev = wa.ele;
         if ((slope = (new_elev - old_elev) / stream_length) < MIN_SLOPE)
             slope = MIN_SLOPE;
@@ -216,5 +216,58 @@ class TestWatershed(TestCase):
         )
 
 
+class TestWatershedSegmented(TestCase):
+    """The segmented version (-m) gives the outputs of the in-memory one"""
+
+    elevation = "elevation"
+    outputs = ("accumulation", "drainage", "basin", "stream")
+
+    @classmethod
+    def setUpClass(cls):
+        cls.use_temp_region()
+        cls.runModule("g.region", raster=cls.elevation)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.del_temp_region()
+
+    def tearDown(self):
+        self.runModule(
+            "g.remove", flags="f", type="raster", pattern="test_watershed_seg_*"
+        )
+
+    def run_watershed(self, prefix, flags):
+        """Run r.watershed writing the outputs named prefix_output"""
+        self.assertModule(
+            "r.watershed",
+            elevation=self.elevation,
+            threshold=10000,
+            # far less than the map needs, segments are swapped
+            memory=10,
+            flags=flags,
+            overwrite=True,
+            **{output: f"{prefix}_{output}" for output in self.outputs},
+        )
+
+    def assertOutputsEqual(self, flags):
+        """Compare the outputs of both versions run with the same flags"""
+        self.run_watershed("test_watershed_seg_ram", flags)
+        self.run_watershed("test_watershed_seg_seg", flags + "m")
+        for output in self.outputs:
+            self.assertRastersNoDifference(
+                f"test_watershed_seg_seg_{output}",
+                f"test_watershed_seg_ram_{output}",
+                precision=1e-6 if output == "accumulation" else 0,
+            )
+
+    def test_mfd(self):
+        """Multiple flow direction"""
+        self.assertOutputsEqual("")
+
+    def test_sfd(self):
+        """Single flow direction"""
+        self.assertOutputsEqual("s")
+
+
 if __name__ == "__main__":
     test()
@@ -232,6 +232,8 @@ int main(int argc, char *argv[])
 
         strcpy(name, *ptr);
         fd[nfiles] = Rast_open_old(name, "");
+        /* points are queried in any row order */
+        Rast_set_mmap(fd[nfiles], 1);
 
         out_type[nfiles] = Rast_get_map_type(fd[nfiles]);
         if (flg.cat_int->answer)